@@ -243,6 +243,7 @@ enum RESOURCE_USAGE
     RESOURCE_USAGE_COPY_SRC                 = 0x100,   //!< コピー元として使用します.
     RESOURCE_USAGE_COPY_DST                 = 0x200,   //!< コピー先として使用します.
     RESOURCE_USAGE_QUERY_BUFFER             = 0x300,   //!< クエリバッファとして使用します.
+    RESOURCE_USAGE_STATE_TRACKING           = 0x400,   //!< サブリソース単位でリソースステートを追跡します(Vulkanのみ).
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -442,6 +443,18 @@ enum DESCRIPTOR_TYPE
     DESCRIPTOR_TYPE_SMP = 3,        //!< サンプラーです.
     DESCRIPTOR_TYPE_RTV = 4,        //!< カラーターゲットビューです.
     DESCRIPTOR_TYPE_DSV = 5,        //!< 深度ステンシルビューです.
+    DESCRIPTOR_TYPE_CBV_DYNAMIC = 6,    //!< 動的オフセット付きの定数バッファビューです(Vulkanのみ).
+    DESCRIPTOR_TYPE_UAV_DYNAMIC = 7,    //!< 動的オフセット付きのストレージバッファビューです(Vulkanのみ).
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! @enum   DESCRIPTOR_SET_LAYOUT_FLAG
+//! @brief  ディスクリプタセットレイアウトフラグです.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum DESCRIPTOR_SET_LAYOUT_FLAG
+{
+    DESCRIPTOR_SET_LAYOUT_FLAG_NONE     = 0x0,  //!< 指定無しです.
+    DESCRIPTOR_SET_LAYOUT_FLAG_BINDLESS = 0x1,  //!< バインドレスディスクリプタヒープを set = 0 として使用します. エントリーは set = 1 となります(Vulkanのみ).
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -612,6 +625,18 @@ enum QUERY_TYPE
     QUERY_TYPE_PIPELINE_STATISTICS  = 2,    //!< パイプライン統計問い合わせです.
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! @enum   QUERY_RESULT_FLAG
+//! @brief  クエリ結果取得フラグです.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum QUERY_RESULT_FLAG
+{
+    QUERY_RESULT_FLAG_NONE              = 0x0,  //!< 指定無しです. 揃っていない結果は書き込みません.
+    QUERY_RESULT_FLAG_WAIT              = 0x1,  //!< 全ての結果が揃うまで待機します.
+    QUERY_RESULT_FLAG_WITH_AVAILABILITY = 0x2,  //!< 各結果の直後に結果が有効かどうかを示す uint64_t 値を書き込みます.
+    QUERY_RESULT_FLAG_PARTIAL           = 0x4,  //!< 揃っていない結果についても途中の値を書き込みます(タイムスタンプ問い合わせには指定できません).
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //! @enum   INPUT_CLASSIFICATION
 //! @brief  入力データの分類です.
@@ -1072,6 +1097,7 @@ struct DescriptorSetLayoutDesc
     uint32_t            MaxSetCount;    //!< 生成可能な最大ディスクリプタセット数です.
     uint32_t            EntryCount;     //!< エントリー数です.
     DescriptorEntry     Entries[64];    //!< エントリー情報です.
+    uint32_t            Flags;          //!< DESCRIPTOR_SET_LAYOUT_FLAG の組み合わせです.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1161,6 +1187,85 @@ struct QueryPoolDesc
     uint32_t        Count;      //!< クエリ数です.
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuProfilerDesc structure
+//! @brief  GPUプロファイラーの設定です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct GpuProfilerDesc
+{
+    uint32_t        MaxScopeCount;  //!< 1フレームあたりの最大スコープ数です.
+    uint32_t        FrameLatency;   //!< 計測結果を取得するまでの遅延フレーム数です. GPUで同時に処理中となるフレーム数より大きくしてください. 0 の場合は 3 として扱います.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuProfileFrame structure
+//! @brief  GPUプロファイラーのフレーム計測結果です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct GpuProfileFrame
+{
+    uint64_t        FrameIndex;     //!< 計測したフレーム番号です.
+    double          ElapsedMsec;    //!< BeginFrame() から EndFrame() までのGPU時間です(ミリ秒単位).
+    uint32_t        ScopeCount;     //!< 計測したスコープ数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuProfileScope structure
+//! @brief  GPUプロファイラーのスコープ計測結果です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct GpuProfileScope
+{
+    const char*     Tag;            //!< マーカー名です. 次の IGpuProfiler::BeginFrame() 呼び出しまで有効です.
+    uint32_t        Depth;          //!< 入れ子の深さです. 最も外側のスコープが 0 となります.
+    double          ElapsedMsec;    //!< スコープ内のGPU時間です(ミリ秒単位).
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// UploadRingDesc structure
+//! @brief  アップロードリングの設定です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct UploadRingDesc
+{
+    uint64_t        Size;           //!< リングバッファのサイズです(バイト単位).
+    uint32_t        Usage;          //!< バッファの使用用途です. 0 の場合は定数バッファとして扱います.
+    uint32_t        MaxFrameCount;  //!< GPUで同時に処理中となる最大フレーム数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// UploadAllocation structure
+//! @brief  アップロードリングから割り当てた領域です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct UploadAllocation
+{
+    void*           pCpuAddress;    //!< 書き込み先のCPUアドレスです.
+    IBuffer*        pBuffer;        //!< 割り当て元のバッファです(参照カウントは増えません).
+    uint64_t        Offset;         //!< バッファ先頭からのオフセットです.
+    uint64_t        Size;           //!< 割り当てサイズです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ReadbackServiceDesc structure
+//! @brief  読み戻しサービスの設定です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ReadbackServiceDesc
+{
+    uint64_t        Size;           //!< ステージングリングのサイズです(バイト単位).
+    uint32_t        MaxBatchCount;  //!< GPUで同時に処理中となる最大バッチ数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ReadbackResult structure
+//! @brief  読み戻し結果です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ReadbackResult
+{
+    uint64_t        Ticket;         //!< 読み戻し要求時に発行されたチケットです.
+    const void*     pData;          //!< 読み戻したデータです. コールバック中のみ有効です.
+    uint64_t        Size;           //!< データサイズです.
+    uint64_t        RowPitch;       //!< 1行あたりのバイト数です. バッファの場合はデータサイズと同じです.
+    uint64_t        RowCount;       //!< 行数です. バッファの場合は 1 です.
+    uint64_t        SlicePitch;     //!< 1スライスあたりのバイト数です.
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // SwapChainDesc structure
 //! @brief  スワップチェインの設定です.
@@ -1176,6 +1281,21 @@ struct SwapChainDesc
     void*               InstanceHandle;     //!< インスタンスハンドルです.
     void*               WindowHandle;       //!< ウィンドウハンドルです.
     bool                EnableFullScreen;   //!< フルスクリーン化する場合は true を指定.
+    uint32_t            MaxFrameLatency;    //!< CPUがGPUに先行できる最大フレーム数です. 0 の場合は 2 として扱います(Vulkanのみ).
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameImage structure
+//! @brief  ヘッドレススワップチェインから読み戻したフレームです.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FrameImage
+{
+    const void*         pPixels;            //!< ピクセルデータです. コールバック中のみ有効です.
+    uint32_t            Width;              //!< 横幅です.
+    uint32_t            Height;             //!< 縦幅です.
+    uint32_t            RowPitch;           //!< 1行あたりのバイト数です.
+    RESOURCE_FORMAT     Format;             //!< フォーマットです.
+    uint64_t            FrameIndex;         //!< 表示した順に割り振られるフレーム番号です.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1260,6 +1380,8 @@ struct DeviceDesc
     uint32_t        MaxComputeQueueSubmitCount;     //!< コンピュートキューへの最大サブミット数です.
     uint32_t        MaxCopyQueueSubmitCount;        //!< コピーキューへの最大サブミット数です.
     bool            EnableDebug;                    //!< デバッグモードを有効にします.
+    bool            EnableBindless;                 //!< バインドレスディスクリプタヒープを有効にします(Vulkanのみ).
+    IBlob*          pPipelineCache;                 //!< パイプラインキャッシュの初期データです(nullptr可).
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1390,6 +1512,49 @@ struct IAllocator
     virtual void Free(void* ptr) noexcept = 0;
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IFrameCallback interface
+//! @brief      ヘッドレススワップチェインのフレーム受け取りインタフェースです.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct IFrameCallback
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual ~IFrameCallback()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの読み戻しが完了した際に呼び出されます.
+    //!
+    //! @param[in]      image       読み戻したフレームです.
+    //! @note       ISwapChain の表示・待機処理を呼び出したスレッドから，表示した順に呼び出されます.
+    //---------------------------------------------------------------------------------------------
+    virtual void OnFrame(const FrameImage& image) noexcept = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IReadbackCallback interface
+//! @brief      読み戻し完了を受け取るインタフェースです.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct IReadbackCallback
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual ~IReadbackCallback()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み戻しが完了した際に呼び出されます.
+    //!
+    //! @param[in]      result      読み戻し結果です.
+    //! @note       IReadbackService::Poll() または IReadbackService::Wait() を呼び出したスレッドから，
+    //!             要求した順に呼び出されます. コールバック内から IReadbackService を操作しないでください.
+    //---------------------------------------------------------------------------------------------
+    virtual void OnReadback(const ReadbackResult& result) noexcept = 0;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // IReference interface
 //! @brief      参照カウンタインタフェースです.
@@ -1491,6 +1656,17 @@ struct A3D_API ISampler : public IDeviceChild
     //---------------------------------------------------------------------------------------------
     virtual A3D_APIENTRY ~ISampler()
     { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バインドレスディスクリプタヒープ上の番号を取得します.
+    //!
+    //! @return     ヒープ上の番号を返却します. ヒープに登録されていない場合は UINT32_MAX を返却します.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             DeviceDesc::EnableBindless を有効にしてデバイスを生成した場合のみ登録されます.
+    //!             サンプラー配列 (binding = 2) の番号となります.
+    //---------------------------------------------------------------------------------------------
+    virtual uint32_t A3D_APIENTRY GetDescriptorIndex() const
+    { return UINT32_MAX; }
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1570,6 +1746,17 @@ struct A3D_API IBufferView : public IDeviceChild
     //! @return     リソースを返却します.
     //---------------------------------------------------------------------------------------------
     virtual IBuffer* A3D_APIENTRY GetResource() const = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バインドレスディスクリプタヒープ上の番号を取得します.
+    //!
+    //! @return     ヒープ上の番号を返却します. ヒープに登録されていない場合は UINT32_MAX を返却します.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             DeviceDesc::EnableBindless を有効にしてデバイスを生成した場合のみ登録されます.
+    //!             ストレージバッファ配列 (binding = 1) の番号となるため, RESOURCE_USAGE_UNORDERED_ACCESS_VIEW を持つバッファのみ登録されます.
+    //---------------------------------------------------------------------------------------------
+    virtual uint32_t A3D_APIENTRY GetDescriptorIndex() const
+    { return UINT32_MAX; }
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1625,6 +1812,17 @@ struct A3D_API ITextureView : public IDeviceChild
     //! @return     リソースを返却します.
     //---------------------------------------------------------------------------------------------
     virtual ITexture* A3D_APIENTRY GetResource() const = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バインドレスディスクリプタヒープ上の番号を取得します.
+    //!
+    //! @return     ヒープ上の番号を返却します. ヒープに登録されていない場合は UINT32_MAX を返却します.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             DeviceDesc::EnableBindless を有効にしてデバイスを生成した場合のみ登録されます.
+    //!             サンプルイメージ配列 (binding = 0) の番号となるため, RESOURCE_USAGE_SHADER_RESOURCE を持つテクスチャのみ登録されます.
+    //---------------------------------------------------------------------------------------------
+    virtual uint32_t A3D_APIENTRY GetDescriptorIndex() const
+    { return UINT32_MAX; }
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1774,6 +1972,31 @@ struct A3D_API IPipelineState : public IDeviceChild
     //! @note       Vulkan, D3D12環境でのみサポートされます.
     //---------------------------------------------------------------------------------------------
     virtual bool A3D_APIENTRY GetCachedBlob(IBlob** ppBlob) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインステートの生成処理が完了しているかどうかチェックします.
+    //!
+    //! @retval true    生成処理が完了しています.
+    //! @retval false   生成処理中です.
+    //! @note       非同期生成したパイプラインステート以外は常に true を返却します.
+    //!             生成に失敗した場合も true を返却するため，結果は Wait() で確認してください.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY IsReady() const
+    { return true; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインステートの生成完了を待機します.
+    //!
+    //! @param[in]      timeoutMsec     タイムアウト時間(ミリ秒)です.
+    //! @retval true    生成に成功.
+    //! @retval false   タイムアウトしたか，生成に失敗.
+    //! @note       非同期生成したパイプラインステート以外は常に true を返却します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY Wait(uint32_t timeoutMsec)
+    {
+        A3D_UNUSED(timeoutMsec);
+        return true;
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1794,6 +2017,36 @@ struct A3D_API IQueryPool : public IDeviceChild
     //! @return     構成設定を返却します.
     //---------------------------------------------------------------------------------------------
     virtual QueryPoolDesc A3D_APIENTRY GetDesc() const = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      GPUへのコピーを介さずにクエリ結果を取得します.
+    //!
+    //! @param[in]      startIndex      取得するクエリのオフセットです.
+    //! @param[in]      queryCount      取得するクエリ数です.
+    //! @param[in]      dataSize        書き込み先のサイズです(バイト単位).
+    //! @param[out]     pData           書き込み先です.
+    //! @param[in]      flags           QUERY_RESULT_FLAG の組み合わせです.
+    //! @retval true    全ての結果が揃っています.
+    //! @retval false   揃っていない結果があるか，引数が不正です.
+    //! @note       結果はクエリ1つにつき，隠蔽問い合わせとタイムスタンプ問い合わせは uint64_t,
+    //!             パイプライン統計問い合わせは PipelineStatistics として書き込まれます.
+    //!             QUERY_RESULT_FLAG_WITH_AVAILABILITY を指定した場合は，それぞれの直後に uint64_t が続きます.
+    //!             このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY GetResults(
+        uint32_t    startIndex,
+        uint32_t    queryCount,
+        size_t      dataSize,
+        void*       pData,
+        uint32_t    flags)
+    {
+        A3D_UNUSED(startIndex);
+        A3D_UNUSED(queryCount);
+        A3D_UNUSED(dataSize);
+        A3D_UNUSED(pData);
+        A3D_UNUSED(flags);
+        return false;
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1824,6 +2077,197 @@ struct A3D_API IFence : public IDeviceChild
     //! @retval false   処理未完了です.
     //---------------------------------------------------------------------------------------------
     virtual bool A3D_APIENTRY Wait(uint32_t timeoutMsec) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      CPU側からタイムライン値をシグナルします.
+    //!
+    //! @param[in]      value           設定する値です. 現在の値より大きくなければなりません.
+    //! @retval true    シグナルに成功.
+    //! @retval false   シグナルに失敗.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY Signal(uint64_t value)
+    {
+        A3D_UNUSED(value);
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了済みのタイムライン値を取得します.
+    //!
+    //! @return     完了済みのタイムライン値を返却します.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual uint64_t A3D_APIENTRY GetCompletedValue() const
+    { return 0; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      タイムライン値が指定値に達するまで待機します.
+    //!
+    //! @param[in]      value           待機する値です.
+    //! @param[in]      timeoutMsec     タイムアウト時間です(ミリ秒単位).
+    //! @retval true    処理完了です.
+    //! @retval false   処理未完了です.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY Wait(uint64_t value, uint32_t timeoutMsec)
+    {
+        A3D_UNUSED(value);
+        A3D_UNUSED(timeoutMsec);
+        return false;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IUploadRing interface
+//! @brief      アップロードリングインタフェースです.
+//! @note       常時マップされたバッファからフレーム単位で線形に領域を割り当てます.
+//!             スレッドセーフではありません.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct A3D_API IUploadRing : public IDeviceChild
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual A3D_APIENTRY ~IUploadRing()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //!
+    //! @return     構成設定を返却します.
+    //---------------------------------------------------------------------------------------------
+    virtual UploadRingDesc A3D_APIENTRY GetDesc() const = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      割り当て元のバッファを取得します.
+    //!
+    //! @param[out]     ppBuffer        バッファの格納先です.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY GetBuffer(IBuffer** ppBuffer) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      領域を割り当てます.
+    //!
+    //! @param[in]      size            割り当てサイズです(バイト単位).
+    //! @param[out]     pResult         割り当て結果の格納先です.
+    //! @retval true    割り当てに成功.
+    //! @retval false   空き領域が不足しています.
+    //! @note       オフセットは DeviceInfo::ConstantBufferMemoryAlignment に揃えられます.
+    //!             空き領域が不足している場合のみ完了済みフレームの回収を試みます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY Allocate(uint64_t size, UploadAllocation* pResult) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームを終了し，割り当てた領域をフェンスに関連付けます.
+    //!
+    //! @param[in]      pFence          フレームの完了を通知するフェンスです.
+    //! @param[in]      value           フレーム完了時のタイムライン値です.
+    //! @note       IFence::GetCompletedValue() が value 以上になると領域は回収されます.
+    //!             処理中のフレーム数が UploadRingDesc::MaxFrameCount に達している場合は
+    //!             最も古いフレームの完了を待機します.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY EndFrame(IFence* pFence, uint64_t value) = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IReadbackService interface
+//! @brief      読み戻しサービスインタフェースです.
+//! @note       常時マップされたステージングリングへのコピーをバッチ単位でグラフィックスキューに投入し，
+//!             完了したバッチの領域はフェンスの完了に合わせて再利用します.
+//!             スレッドセーフではありません.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct A3D_API IReadbackService : public IDeviceChild
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual A3D_APIENTRY ~IReadbackService()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //!
+    //! @return     構成設定を返却します.
+    //---------------------------------------------------------------------------------------------
+    virtual ReadbackServiceDesc A3D_APIENTRY GetDesc() const = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファの読み戻しを要求します.
+    //!
+    //! @param[in]      pSrcBuffer      読み戻すバッファです.
+    //! @param[in]      srcOffset       読み戻す領域のオフセットです.
+    //! @param[in]      size            読み戻すサイズです(バイト単位).
+    //! @param[in]      pCallback       完了を受け取るコールバックです.
+    //! @param[out]     pTicket         チケットの格納先です. 不要な場合は nullptr を指定します.
+    //! @retval true    要求に成功.
+    //! @retval false   要求に失敗.
+    //! @note       コピーは Submit() するまでGPUに投入されません.
+    //!             ステージングリングに空きが無い場合は最も古いバッチの完了を待機します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY ReadBuffer(
+        IBuffer*            pSrcBuffer,
+        uint64_t            srcOffset,
+        uint64_t            size,
+        IReadbackCallback*  pCallback,
+        uint64_t*           pTicket) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャの読み戻しを要求します.
+    //!
+    //! @param[in]      pSrcTexture     読み戻すテクスチャです.
+    //! @param[in]      srcSubresource  読み戻すサブリソースです.
+    //! @param[in]      srcState        読み戻す時点のリソースステートです. コピー後はこの状態に戻ります.
+    //! @param[in]      srcOffset       読み戻す領域のオフセットです.
+    //! @param[in]      srcExtent       読み戻す領域の大きさです.
+    //! @param[in]      pCallback       完了を受け取るコールバックです.
+    //! @param[out]     pTicket         チケットの格納先です. 不要な場合は nullptr を指定します.
+    //! @retval true    要求に成功.
+    //! @retval false   要求に失敗.
+    //! @note       読み戻したデータは行間に隙間の無いレイアウトで格納されます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY ReadTexture(
+        ITexture*           pSrcTexture,
+        uint32_t            srcSubresource,
+        RESOURCE_STATE      srcState,
+        Offset3D            srcOffset,
+        Extent3D            srcExtent,
+        IReadbackCallback*  pCallback,
+        uint64_t*           pTicket) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要求済みのコピーをGPUに投入します.
+    //!
+    //! @note       先に投入されたコマンドの完了後にコピーが実行されるよう，描画結果を投入した後に呼び出してください.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY Submit() = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了済みのバッチを待機せずに回収し，コールバックに引き渡します.
+    //!
+    //! @return     引き渡した要求数を返却します.
+    //---------------------------------------------------------------------------------------------
+    virtual uint32_t A3D_APIENTRY Poll() = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定したチケットまでの読み戻しが完了するまで待機します.
+    //!
+    //! @param[in]      ticket          待機するチケットです.
+    //! @param[in]      timeoutMsec     タイムアウト時間です(ミリ秒単位).
+    //! @retval true    完了し，コールバックへの引き渡しも済んでいます.
+    //! @retval false   タイムアウトしたか，不正なチケットです.
+    //! @note       チケットが未投入の場合は Submit() してから待機します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY Wait(uint64_t ticket, uint32_t timeoutMsec) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定したチケットがコールバックに引き渡し済みかどうかチェックします.
+    //!
+    //! @param[in]      ticket          チェックするチケットです.
+    //! @retval true    引き渡し済みです.
+    //! @retval false   処理中です.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY IsCompleted(uint64_t ticket) const = 0;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1911,6 +2355,49 @@ struct A3D_API ICommandList : public IDeviceChild
     //---------------------------------------------------------------------------------------------
     virtual void A3D_APIENTRY SetDescriptorSet(IDescriptorSet* pDescriptorSet) = 0;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      動的オフセットを指定してディスクリプタセットを設定します.
+    //!
+    //! @param[in]      pDescriptorSet      設定するディスクリプタセットです.
+    //! @param[in]      offsetCount         動的オフセット数です.
+    //! @param[in]      pOffsets            動的オフセットです(バイト単位).
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             オフセットは DESCRIPTOR_TYPE_CBV_DYNAMIC, DESCRIPTOR_TYPE_UAV_DYNAMIC のエントリーに
+    //!             エントリー順に対応し，設定したビューのオフセットに加算されます.
+    //!             不足分は 0 として扱います.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY SetDescriptorSet(
+        IDescriptorSet* pDescriptorSet,
+        uint32_t        offsetCount,
+        const uint32_t* pOffsets)
+    {
+        A3D_UNUSED(offsetCount);
+        A3D_UNUSED(pOffsets);
+        SetDescriptorSet(pDescriptorSet);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      一時ディスクリプタセットを割り当てます.
+    //!
+    //! @param[in]      pLayout             ディスクリプタセットレイアウトです.
+    //! @param[out]     ppDescriptorSet     ディスクリプタセットの格納先です.
+    //! @retval true    割り当てに成功.
+    //! @retval false   割り当てに失敗.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             割り当てたディスクリプタセットはコマンドリストが所有し, 次の Begin() 呼び出しで再利用されます.
+    //!             参照カウントは増えないため Release() を呼び出さないでください.
+    //!             通常のディスクリプタセットと同様に設定後 IDescriptorSet::Update() を呼び出してから
+    //!             SetDescriptorSet() で設定してください.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY AllocateTransientDescriptorSet(
+        IDescriptorSetLayout*   pLayout,
+        IDescriptorSet**        ppDescriptorSet)
+    {
+        A3D_UNUSED(pLayout);
+        A3D_UNUSED(ppDescriptorSet);
+        return false;
+    }
+
     //---------------------------------------------------------------------------------------------
     //! @brief      頂点バッファを設定します.
     //!
@@ -1959,6 +2446,52 @@ struct A3D_API ICommandList : public IDeviceChild
         RESOURCE_STATE  prevState,
         RESOURCE_STATE  nextState) = 0;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡対象テクスチャのサブリソースを指定状態に遷移させます.
+    //!
+    //! @param[in]      pResource           RESOURCE_USAGE_STATE_TRACKING 付きで生成したテクスチャです.
+    //! @param[in]      mipSlice            最初のミップレベルです.
+    //! @param[in]      mipLevels           ミップレベル数です. UINT32_MAX の場合は残り全てです.
+    //! @param[in]      firstArraySlice     最初の配列番号です.
+    //! @param[in]      arraySize           配列数です. UINT32_MAX の場合は残り全てです.
+    //! @param[in]      nextState           変更後の状態です.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             コマンドリスト内で最初に使用する際の遷移は IQueue::Execute() 時に補われます.
+    //!             追跡対象のリソースに対して TextureBarrier() を併用しないでください.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY TransitionTexture(
+        ITexture*       pResource,
+        uint32_t        mipSlice,
+        uint32_t        mipLevels,
+        uint32_t        firstArraySlice,
+        uint32_t        arraySize,
+        RESOURCE_STATE  nextState)
+    {
+        A3D_UNUSED(pResource);
+        A3D_UNUSED(mipSlice);
+        A3D_UNUSED(mipLevels);
+        A3D_UNUSED(firstArraySlice);
+        A3D_UNUSED(arraySize);
+        A3D_UNUSED(nextState);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡対象バッファを指定状態に遷移させます.
+    //!
+    //! @param[in]      pResource       RESOURCE_USAGE_STATE_TRACKING 付きで生成したバッファです.
+    //! @param[in]      nextState       変更後の状態です.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             コマンドリスト内で最初に使用する際の遷移は IQueue::Execute() 時に補われます.
+    //!             追跡対象のリソースに対して BufferBarrier() を併用しないでください.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY TransitionBuffer(
+        IBuffer*        pResource,
+        RESOURCE_STATE  nextState)
+    {
+        A3D_UNUSED(pResource);
+        A3D_UNUSED(nextState);
+    }
+
     //---------------------------------------------------------------------------------------------
     //! @brief      インスタンス描画します.
     //!
@@ -2173,6 +2706,29 @@ struct A3D_API ICommandList : public IDeviceChild
     //---------------------------------------------------------------------------------------------
     virtual void A3D_APIENTRY ExecuteBundle(ICommandList* pCommandList) = 0;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      並列記録用のコンテキストを開きます.
+    //!
+    //! @param[in]      count           開くコンテキスト数です.
+    //! @param[out]     ppContexts      コンテキストの格納先です. count 個の要素が必要です.
+    //! @retval true    コンテキストを開くのに成功.
+    //! @retval false   コンテキストを開くのに失敗.
+    //! @note       このAPIはDirect3D11のみでサポートされます.
+    //!             各コンテキストは記録開始済みの状態で返却され, それぞれ別スレッドから記録できます.
+    //!             コンテキストに対して Begin() と End() を呼び出さないでください.
+    //!             記録内容は End() 呼び出し時に, このAPIを呼び出した位置へインデックス順に連結されます.
+    //!             End() は全てのコンテキストの記録が終わってから呼び出してください.
+    //!             コンテキストはコマンドリストが所有し, 参照カウントは増えないため Release() を呼び出さないでください.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY OpenParallelContexts(
+        uint32_t        count,
+        ICommandList**  ppContexts)
+    {
+        A3D_UNUSED(count);
+        A3D_UNUSED(ppContexts);
+        return false;
+    }
+
     //---------------------------------------------------------------------------------------------
     //! @brief      デバッグマーカーをプッシュします.
     //!
@@ -2191,6 +2747,81 @@ struct A3D_API ICommandList : public IDeviceChild
     virtual void A3D_APIENTRY End() = 0;
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IGpuProfiler interface
+//! @brief      GPUプロファイラーインタフェースです.
+//! @note       フレーム毎にタイムスタンプクエリプールを切り替えて計測し，
+//!             FrameLatency フレーム後に待機せずに結果を取得します.
+//!             結果が揃っていないフレームは破棄されます. スレッドセーフではありません.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct A3D_API IGpuProfiler : public IDeviceChild
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual A3D_APIENTRY ~IGpuProfiler()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //!
+    //! @return     構成設定を返却します.
+    //---------------------------------------------------------------------------------------------
+    virtual GpuProfilerDesc A3D_APIENTRY GetDesc() const = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの計測を開始します.
+    //!
+    //! @param[in]      pCommandList    計測するコマンドリストです.
+    //! @note       FrameLatency フレーム前の結果を回収し，クエリをリセットします.
+    //!             レンダーパスの外で呼び出してください.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY BeginFrame(ICommandList* pCommandList) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの計測を終了します.
+    //!
+    //! @param[in]      pCommandList    計測するコマンドリストです.
+    //! @note       閉じられていないスコープはここで閉じられます.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY EndFrame(ICommandList* pCommandList) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバッグマーカーをプッシュし，スコープの計測を開始します.
+    //!
+    //! @param[in]      pCommandList    計測するコマンドリストです.
+    //! @param[in]      tag             マーカー名です.
+    //! @note       最大スコープ数を超えた場合はデバッグマーカーのみプッシュされます.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY PushMarker(ICommandList* pCommandList, const char* tag) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバッグマーカーをポップし，スコープの計測を終了します.
+    //!
+    //! @param[in]      pCommandList    計測するコマンドリストです.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY PopMarker(ICommandList* pCommandList) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最後に回収したフレームの計測結果を取得します.
+    //!
+    //! @param[out]     pFrame          計測結果の格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   回収済みのフレームがありません.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY GetFrame(GpuProfileFrame* pFrame) const = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最後に回収したフレームのスコープ計測結果を取得します.
+    //!
+    //! @param[in]      index           スコープ番号です. プッシュした順に割り振られます.
+    //! @param[out]     pScope          計測結果の格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   スコープ番号が範囲外です.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY GetScope(uint32_t index, GpuProfileScope* pScope) const = 0;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // IQueue interface
 //! @brief      コマンドキューインタフェースです.
@@ -2212,6 +2843,23 @@ struct A3D_API IQueue : IDeviceChild
     //---------------------------------------------------------------------------------------------
     virtual bool A3D_APIENTRY Submit( ICommandList* pCommandList ) = 0;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ソートキーを指定してコマンドリストを登録します.
+    //!
+    //! @param[in]      pCommandList        登録するコマンドリストです.
+    //! @param[in]      sortKey             実行順を決めるソートキーです.
+    //! @retval true    登録に成功.
+    //! @retval false   登録に失敗.
+    //! @note       複数スレッドから同時に呼び出すことができます.
+    //!             Execute()時にソートキーの昇順で実行され，同じキーの場合は登録順になります.
+    //!             Vulkan以外ではソートキーは無視され，登録順で実行されます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY Submit( ICommandList* pCommandList, uint64_t sortKey )
+    {
+        A3D_UNUSED(sortKey);
+        return Submit(pCommandList);
+    }
+
     //---------------------------------------------------------------------------------------------
     //! @brief      登録したコマンドリストを実行します.
     //!
@@ -2219,6 +2867,39 @@ struct A3D_API IQueue : IDeviceChild
     //---------------------------------------------------------------------------------------------
     virtual void A3D_APIENTRY Execute( IFence* pFence ) = 0;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フェンスのタイムライン値が指定値に達するまでGPU側で待機させます.
+    //!
+    //! @param[in]      pFence          待機するフェンスです.
+    //! @param[in]      value           待機する値です.
+    //! @retval true    登録に成功.
+    //! @retval false   登録に失敗.
+    //! @note       次回の Execute() で実行されるコマンドリストが待機対象になります.
+    //!             このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY Wait( IFence* pFence, uint64_t value )
+    {
+        A3D_UNUSED(pFence);
+        A3D_UNUSED(value);
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      それまでに実行したコマンドリストの完了時にフェンスのタイムライン値をシグナルします.
+    //!
+    //! @param[in]      pFence          シグナルするフェンスです.
+    //! @param[in]      value           設定する値です.
+    //! @retval true    シグナルの発行に成功.
+    //! @retval false   シグナルの発行に失敗.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY Signal( IFence* pFence, uint64_t value )
+    {
+        A3D_UNUSED(pFence);
+        A3D_UNUSED(value);
+        return false;
+    }
+
     //---------------------------------------------------------------------------------------------
     //! @brief      コマンドリストの実行完了を待機します.
     //---------------------------------------------------------------------------------------------
@@ -2323,6 +3004,39 @@ struct A3D_API ISwapChain : public IDeviceChild
     //! @note       この関数は D3D11(Windows10), D3D12のみサポートされます.
     //---------------------------------------------------------------------------------------------
     virtual bool A3D_APIENTRY SetColorSpace(COLOR_SPACE_TYPE type) = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      CPUがGPUに先行できる最大フレーム数を設定します.
+    //!
+    //! @param[in]      count       最大フレーム数です(1 ～ 8).
+    //! @retval true    設定に成功.
+    //! @retval false   設定に失敗.
+    //! @note       処理中のフレームが全て完了するまで待機してから切り替えます.
+    //!             バックバッファ数を超える値はバックバッファ数に制限されます.
+    //!             このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY SetMaxFrameLatency(uint32_t count)
+    {
+        A3D_UNUSED(count);
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      次のフレームを記録できるようになるまで待機します.
+    //!
+    //! @param[in]      timeoutMsec     タイムアウト時間です(ミリ秒単位).
+    //! @retval true    次のフレームのバックバッファを取得済みです.
+    //! @retval false   タイムアウトしました.
+    //! @note       CPUが MaxFrameLatency 分先行している場合のみ待機します.
+    //!             入力の取得前など，待機する位置をアプリケーション側で制御したい場合に呼び出します.
+    //!             呼び出さない場合は GetCurrentBufferIndex() 内で待機します.
+    //!             このAPIはVulkanのみでサポートされます. 他のAPIでは何もせずに true を返却します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY WaitForFrameSlot(uint32_t timeoutMsec)
+    {
+        A3D_UNUSED(timeoutMsec);
+        return true;
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2517,6 +3231,105 @@ struct A3D_API IDevice : public IReference
         const GeometryPipelineStateDesc*    pDesc,
         IPipelineState**                    ppPipelineState) = 0;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      グラフィックスパイプラインを非同期で生成します.
+    //!
+    //! @param[in]      count               生成数です.
+    //! @param[in]      pDescs              構成設定の配列です.
+    //! @param[out]     ppPipelineStates    パイプラインステートの格納先配列です.
+    //! @retval true    生成要求に成功.
+    //! @retval false   生成要求に失敗.
+    //! @note       格納されたパイプラインステートは IPipelineState::IsReady() が true になるまで使用できません.
+    //!             構成設定はこの関数から戻った後に破棄して構いません.
+    //!             非同期生成をサポートしない環境では同期生成します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY CreateGraphicsPipelinesAsync(
+        uint32_t                            count,
+        const GraphicsPipelineStateDesc*    pDescs,
+        IPipelineState**                    ppPipelineStates)
+    {
+        if (pDescs == nullptr || ppPipelineStates == nullptr)
+        { return false; }
+
+        for(auto i=0u; i<count; ++i)
+        {
+            if (!CreateGraphicsPipeline(&pDescs[i], &ppPipelineStates[i]))
+            {
+                for(auto j=0u; j<i; ++j)
+                { SafeRelease(ppPipelineStates[j]); }
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンピュートパイプラインを非同期で生成します.
+    //!
+    //! @param[in]      count               生成数です.
+    //! @param[in]      pDescs              構成設定の配列です.
+    //! @param[out]     ppPipelineStates    パイプラインステートの格納先配列です.
+    //! @retval true    生成要求に成功.
+    //! @retval false   生成要求に失敗.
+    //! @note       格納されたパイプラインステートは IPipelineState::IsReady() が true になるまで使用できません.
+    //!             構成設定はこの関数から戻った後に破棄して構いません.
+    //!             非同期生成をサポートしない環境では同期生成します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY CreateComputePipelinesAsync(
+        uint32_t                            count,
+        const ComputePipelineStateDesc*     pDescs,
+        IPipelineState**                    ppPipelineStates)
+    {
+        if (pDescs == nullptr || ppPipelineStates == nullptr)
+        { return false; }
+
+        for(auto i=0u; i<count; ++i)
+        {
+            if (!CreateComputePipeline(&pDescs[i], &ppPipelineStates[i]))
+            {
+                for(auto j=0u; j<i; ++j)
+                { SafeRelease(ppPipelineStates[j]); }
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ジオメトリパイプラインを非同期で生成します.
+    //!
+    //! @param[in]      count               生成数です.
+    //! @param[in]      pDescs              構成設定の配列です.
+    //! @param[out]     ppPipelineStates    パイプラインステートの格納先配列です.
+    //! @retval true    生成要求に成功.
+    //! @retval false   生成要求に失敗.
+    //! @note       格納されたパイプラインステートは IPipelineState::IsReady() が true になるまで使用できません.
+    //!             構成設定はこの関数から戻った後に破棄して構いません.
+    //!             非同期生成をサポートしない環境では同期生成します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY CreateGeometryPipelinesAsync(
+        uint32_t                            count,
+        const GeometryPipelineStateDesc*    pDescs,
+        IPipelineState**                    ppPipelineStates)
+    {
+        if (pDescs == nullptr || ppPipelineStates == nullptr)
+        { return false; }
+
+        for(auto i=0u; i<count; ++i)
+        {
+            if (!CreateGeometryPipeline(&pDescs[i], &ppPipelineStates[i]))
+            {
+                for(auto j=0u; j<i; ++j)
+                { SafeRelease(ppPipelineStates[j]); }
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     //---------------------------------------------------------------------------------------------
     //! @brief      ディスクリプタセットレイアウトを生成します.
     //!
@@ -2578,6 +3391,100 @@ struct A3D_API IDevice : public IReference
     //! @brief      アイドル状態になるまで待機します.
     //---------------------------------------------------------------------------------------------
     virtual void A3D_APIENTRY WaitIdle() = 0;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスが保持するパイプラインキャッシュをシリアライズします.
+    //!
+    //! @param[out]     ppBlob          パイプラインキャッシュデータの格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             取得したデータを DeviceDesc::pPipelineCache に設定するとデバイス生成時に読み込まれます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY GetPipelineCacheBlob(IBlob** ppBlob)
+    {
+        A3D_UNUSED(ppBlob);
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アップロードリングを生成します.
+    //!
+    //! @param[in]      pDesc           構成設定です.
+    //! @param[out]     ppUploadRing    アップロードリングの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //!             タイムラインセマフォ(VK_KHR_timeline_semaphore)が利用できない場合は生成に失敗します.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY CreateUploadRing(
+        const UploadRingDesc*   pDesc,
+        IUploadRing**           ppUploadRing)
+    {
+        A3D_UNUSED(pDesc);
+        A3D_UNUSED(ppUploadRing);
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ウィンドウを持たないヘッドレススワップチェインを生成します.
+    //!
+    //! @param[in]      pDesc           構成設定です. ウィンドウ関連の設定は無視されます.
+    //! @param[in]      pCallback       フレームを受け取るコールバックです. 不要な場合は nullptr を指定します.
+    //! @param[out]     ppSwapChain     スワップチェインの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //! @note       GetBuffer(), GetCurrentBufferIndex(), IQueue::Present() は通常のスワップチェインと同様に使用できます.
+    //!             コールバックを指定しない場合，VK_EXT_headless_surface が利用可能であればそれを使用し，
+    //!             それ以外はオフスクリーンのイメージと読み戻し用バッファで表示処理を代替します.
+    //!             このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY CreateHeadlessSwapChain(
+        const SwapChainDesc*    pDesc,
+        IFrameCallback*         pCallback,
+        ISwapChain**            ppSwapChain)
+    {
+        A3D_UNUSED(pDesc);
+        A3D_UNUSED(pCallback);
+        A3D_UNUSED(ppSwapChain);
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み戻しサービスを生成します.
+    //!
+    //! @param[in]      pDesc               構成設定です.
+    //! @param[out]     ppReadbackService   読み戻しサービスの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY CreateReadbackService(
+        const ReadbackServiceDesc*  pDesc,
+        IReadbackService**          ppReadbackService)
+    {
+        A3D_UNUSED(pDesc);
+        A3D_UNUSED(ppReadbackService);
+        return false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      GPUプロファイラーを生成します.
+    //!
+    //! @param[in]      pDesc           構成設定です.
+    //! @param[out]     ppProfiler      GPUプロファイラーの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //! @note       このAPIはVulkanのみでサポートされます.
+    //---------------------------------------------------------------------------------------------
+    virtual bool A3D_APIENTRY CreateGpuProfiler(
+        const GpuProfilerDesc*  pDesc,
+        IGpuProfiler**          ppProfiler)
+    {
+        A3D_UNUSED(pDesc);
+        A3D_UNUSED(ppProfiler);
+        return false;
+    }
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -8,8 +8,16 @@
 //-------------------------------------------------------------------------------------------------
 // Includes
 //-------------------------------------------------------------------------------------------------
-#include "container/a3dList.h"
+#include <cstdint>
+#include <cstddef>
 #include <mutex>
+#include <vector>
+#include "allocator/a3dBaseAllocator.h"
+#include "allocator/a3dStdAllocator.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 
 namespace a3d {
@@ -22,6 +30,7 @@ struct Block
     ptrdiff_t   Offset;     //!< オフセットです.
     size_t      Size;       //!< 確保サイズです.
     size_t      Alignment;  //!< アライメントです.
+    uint32_t    Node;       //!< BlockAllocator 内部のノード番号です. 解放時に使用します.
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -37,9 +46,26 @@ inline bool operator <  (const Block& lhs, const Block& rhs)
 { return lhs.Offset < rhs.Offset; }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BlockStatistics structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BlockStatistics
+{
+    size_t      TotalSize;          //!< 管理している全体のサイズです.
+    size_t      UsedSize;           //!< 使用中のサイズです.
+    size_t      FreeSize;           //!< 空きサイズです.
+    size_t      LargestFreeBlock;   //!< 最大の空きブロックのサイズです.
+    uint32_t    AllocationCount;    //!< 確保中のブロック数です.
+    uint32_t    FreeBlockCount;     //!< 空きブロック数です.
+    float       Fragmentation;      //!< 断片化率です (1 - 最大空きブロック / 空きサイズ). 0 で断片化なしです.
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // BlockAllocator class
 // ※オフセットとサイズのみ管理します. 実メモリは管理しません.
+// ※2レベル分離適合(TLSF)方式で空きブロックを管理し, 確保・解放とも定数時間で処理します.
+//   解放時には隣接する空きブロックと即座に連結するため, コンパクションは不要です.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 class BlockAllocator
 {
@@ -67,11 +93,13 @@ public:
     //! @brief      コンストラクタです.
     //---------------------------------------------------------------------------------------------
     BlockAllocator()
-    : m_Size     (0)
-    , m_Offset   (0)
-    , m_CurOffset(0)
-    , m_UsedSize (0)
-    { /* DO_NOTHING */ }
+    : m_Size            (0)
+    , m_Offset          (0)
+    , m_UsedSize        (0)
+    , m_AllocCount      (0)
+    , m_FreeBlockCount  (0)
+    , m_FirstLevelMap   (0)
+    { ClearBins(); }
 
     //---------------------------------------------------------------------------------------------
     //! @brief      デストラクタです.
@@ -81,14 +109,35 @@ public:
 
     //---------------------------------------------------------------------------------------------
     //! @brief      初期化を行います.
+    //!
+    //! @param[in]      size        管理するサイズです.
+    //! @param[in]      offset      先頭オフセットです.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
     //---------------------------------------------------------------------------------------------
     bool Init(size_t size, ptrdiff_t offset)
     {
-        m_Size      = size;
-        m_Offset    = offset;
-        m_CurOffset = 0;
-        m_UsedSize  = 0;
-        m_FreeBlocks.clear();
+        Locker locker(m_Mutex);
+
+        m_Size           = size;
+        m_Offset         = offset;
+        m_UsedSize       = 0;
+        m_AllocCount     = 0;
+        m_FreeBlockCount = 0;
+        m_Nodes.clear();
+        m_FreeNodes.clear();
+        ClearBins();
+
+        if (size == 0)
+        { return true; }
+
+        // 全体を1つの空きブロックとして登録.
+        auto index = NewNode();
+        auto& node = m_Nodes[index];
+        node.Offset = 0;
+        node.Size   = size;
+        InsertFreeNode(index);
+
         return true;
     }
 
@@ -98,11 +147,16 @@ public:
     void Term()
     {
         Locker locker(m_Mutex);
-        m_Size      = 0;
-        m_Offset    = 0;
-        m_CurOffset = 0;
-        m_UsedSize  = 0;
-        m_FreeBlocks.clear();
+        m_Size           = 0;
+        m_Offset         = 0;
+        m_UsedSize       = 0;
+        m_AllocCount     = 0;
+        m_FreeBlockCount = 0;
+        m_Nodes.clear();
+        m_Nodes.shrink_to_fit();
+        m_FreeNodes.clear();
+        m_FreeNodes.shrink_to_fit();
+        ClearBins();
     }
 
     //---------------------------------------------------------------------------------------------
@@ -110,92 +164,127 @@ public:
     //---------------------------------------------------------------------------------------------
     bool CanAlloc( size_t size, size_t alignment ) const
     {
-        auto allocSize = RoundUp( size, alignment );
-        if (m_CurOffset + allocSize <= m_Size)
-        { return true; }
+        Locker locker(m_Mutex);
 
-        for(auto& itr : m_FreeBlocks)
-        {
-            if (allocSize <= itr.Size)
-            { return true; }
-        }
+        if (alignment == 0)
+        { alignment = 1; }
 
-        return false;
+        return FindFreeNode(size, alignment) != InvalidIndex;
     }
 
     //---------------------------------------------------------------------------------------------
     //! @brief      ブロックを確保します.
+    //!
+    //! @param[in]      size        確保サイズです.
+    //! @param[in]      alignment   アライメントです. 2の累乗である必要があります.
+    //! @return     確保したブロックを返却します. 確保に失敗した場合はサイズがゼロのブロックを返却します.
     //---------------------------------------------------------------------------------------------
     Block Alloc( size_t size, size_t alignment )
     {
         Locker locker(m_Mutex);
 
-        auto allocSize = RoundUp( size, alignment );
-
-        if (m_CurOffset + allocSize <= m_Size)
-        {
-            auto prevOffset = m_Offset + m_CurOffset;
-            auto currOffset = RoundUp( prevOffset, alignment );
-
-            Block result  = {};
-            result.Size      = size;
-            result.Offset    = currOffset;
-            result.Alignment = alignment;
-
-            auto usedSize = (currOffset - prevOffset) + size;
-            m_CurOffset += usedSize;
-            m_UsedSize  += usedSize;
-            return result;
-        }
-
         Block result = {};
 
-        // 空いているブロックを探す.
-        if (FindFreeBlock(size, alignment, result))
+        if (alignment == 0)
+        { alignment = 1; }
+
+        auto index = FindFreeNode(size, alignment);
+        if (index == InvalidIndex)
         { return result; }
 
-        // 空きサイズが十分かどうかチェック.
-        if (m_UsedSize + allocSize <= m_Size)
-        {
-            // 一回メモリコンパクションを行う.
-            InnerCompact();
+        RemoveFreeNode(index);
 
-            // 綺麗になった状態で，もう一度確保できるか実行する.
-            if (FindFreeBlock(size, alignment, result))
-            { return result; }
-        }
+        auto start   = m_Nodes[index].Offset;
+        auto aligned = RoundUp(size_t(m_Offset) + start, alignment) - size_t(m_Offset);
+
+        // アライメント調整で生じた先頭の余りを空きブロックとして切り出す.
+        if (aligned > start)
+        { SplitFront(index, aligned - start); }
+
+        // 後方の余りを空きブロックとして切り出す.
+        if (m_Nodes[index].Size > size)
+        { SplitBack(index, size); }
 
-        // ダメだったら空ブロックを返す.
-        Block empty = {};
-        return empty;
+        m_Nodes[index].Used = true;
+        m_UsedSize += size;
+        m_AllocCount++;
+
+        result.Offset    = m_Offset + ptrdiff_t(aligned);
+        result.Size      = size;
+        result.Alignment = alignment;
+        result.Node      = index;
+        return result;
     }
 
     //---------------------------------------------------------------------------------------------
     //! @brief      ブロックを解放します.
+    //!
+    //! @param[in]      block       Alloc() で確保したブロックです.
     //---------------------------------------------------------------------------------------------
     void Free( const Block& block )
     {
         Locker locker(m_Mutex);
 
-        auto offset   = RoundDown(block.Offset, block.Alignment);
-        auto usedSize = (block.Offset - offset) + block.Size;
+        if (block.Size == 0 || block.Node >= m_Nodes.size())
+        { return; }
+
+        auto index = block.Node;
+        A3D_ASSERT(m_Nodes[index].Used);
+        A3D_ASSERT(m_Offset + ptrdiff_t(m_Nodes[index].Offset) == block.Offset);
+
+        m_UsedSize -= m_Nodes[index].Size;
+        m_AllocCount--;
+        m_Nodes[index].Used = false;
+
+        // 前方の空きブロックと連結.
+        auto prev = m_Nodes[index].NeighborPrev;
+        if (prev != InvalidIndex && !m_Nodes[prev].Used)
+        {
+            RemoveFreeNode(prev);
+            m_Nodes[index].Offset  = m_Nodes[prev].Offset;
+            m_Nodes[index].Size   += m_Nodes[prev].Size;
+            LinkNeighbor(m_Nodes[prev].NeighborPrev, index);
+            ReleaseNode(prev);
+        }
 
-        Block freeBlock = {};
-        freeBlock.Offset    = offset;
-        freeBlock.Size      = usedSize;
-        freeBlock.Alignment = 0;
+        // 後方の空きブロックと連結.
+        auto next = m_Nodes[index].NeighborNext;
+        if (next != InvalidIndex && !m_Nodes[next].Used)
+        {
+            RemoveFreeNode(next);
+            m_Nodes[index].Size += m_Nodes[next].Size;
+            LinkNeighbor(index, m_Nodes[next].NeighborNext);
+            ReleaseNode(next);
+        }
 
-        m_UsedSize -= usedSize;
-        m_FreeBlocks.push_back(freeBlock);
+        InsertFreeNode(index);
     }
 
     //---------------------------------------------------------------------------------------------
     //! @brief      メモリコンパクションを行います.
+    //! @note       解放時に隣接ブロックと連結済みのため何もしません. 互換性のために残しています.
     //---------------------------------------------------------------------------------------------
     void Compact()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      統計情報を取得します.
+    //---------------------------------------------------------------------------------------------
+    BlockStatistics GetStatistics() const
     {
         Locker locker(m_Mutex);
-        InnerCompact();
+
+        BlockStatistics result = {};
+        result.TotalSize        = m_Size;
+        result.UsedSize         = m_UsedSize;
+        result.FreeSize         = m_Size - m_UsedSize;
+        result.LargestFreeBlock = GetLargestFreeBlock();
+        result.AllocationCount  = m_AllocCount;
+        result.FreeBlockCount   = m_FreeBlockCount;
+        result.Fragmentation    = (result.FreeSize > 0)
+            ? 1.0f - float(double(result.LargestFreeBlock) / double(result.FreeSize))
+            : 0.0f;
+        return result;
     }
 
     //---------------------------------------------------------------------------------------------
@@ -214,18 +303,43 @@ public:
     //! @brief      使用サイズがゼロかどうかチェックします.
     //---------------------------------------------------------------------------------------------
     bool IsEmpty() const
-    { return m_UsedSize == 0; }
+    { return m_AllocCount == 0; }
 
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Node structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Node
+    {
+        size_t      Offset;         //!< 先頭からのオフセットです.
+        size_t      Size;           //!< ブロックサイズです.
+        uint32_t    BinPrev;        //!< 同じビン内の前の空きノードです.
+        uint32_t    BinNext;        //!< 同じビン内の次の空きノードです.
+        uint32_t    NeighborPrev;   //!< 物理的に前に隣接するノードです.
+        uint32_t    NeighborNext;   //!< 物理的に後に隣接するノードです.
+        bool        Used;           //!< 使用中かどうか.
+    };
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    size_t              m_Size;         //!< ブロック全体のサイズ.
-    ptrdiff_t           m_Offset;       //!< 先頭オフセット.
-    ptrdiff_t           m_CurOffset;    //!< 現在のオフセット.
-    a3d::list<Block>    m_FreeBlocks;   //!< 解放済みブロック.
-    std::mutex          m_Mutex;        //!< ミューテックス.
-    size_t              m_UsedSize;     //!< 使用中のメモリサイズ.
+    static const uint32_t   InvalidIndex     = ~0u;                                 //!< 無効なノード番号です.
+    static const uint32_t   SecondLevelBits  = 3;                                   //!< 第2レベルの分割ビット数です.
+    static const uint32_t   SecondLevelCount = 1u << SecondLevelBits;               //!< 第2レベルの分割数です.
+    static const uint32_t   FirstLevelCount  = 64 - SecondLevelBits + 1;            //!< 第1レベルの分割数です.
+    static const uint32_t   BinCount         = FirstLevelCount * SecondLevelCount;  //!< ビン数です.
+
+    size_t                                      m_Size;                             //!< ブロック全体のサイズ.
+    ptrdiff_t                                   m_Offset;                           //!< 先頭オフセット.
+    size_t                                      m_UsedSize;                         //!< 使用中のメモリサイズ.
+    uint32_t                                    m_AllocCount;                       //!< 確保中のブロック数.
+    uint32_t                                    m_FreeBlockCount;                   //!< 空きブロック数.
+    uint64_t                                    m_FirstLevelMap;                    //!< 第1レベルのビットマップ.
+    uint8_t                                     m_SecondLevelMap[FirstLevelCount];  //!< 第2レベルのビットマップ.
+    uint32_t                                    m_BinHeads[BinCount];               //!< ビン毎の空きノードリストの先頭.
+    std::vector<Node, StdAllocator<Node>>       m_Nodes;                            //!< ノード.
+    std::vector<uint32_t, StdAllocator<uint32_t>> m_FreeNodes;                      //!< 再利用可能なノード番号.
+    mutable std::mutex                          m_Mutex;                            //!< ミューテックス.
 
     //=============================================================================================
     // private methods.
@@ -238,80 +352,310 @@ private:
     { return ( value + ( base - 1 ) ) & ~( base - 1 ); }
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      指定された倍数に切り下げます.
+    //! @brief      最上位ビットの位置を取得します. value はゼロ以外である必要があります.
+    //---------------------------------------------------------------------------------------------
+    static uint32_t FindLastSet(uint64_t value)
+    {
+    #if defined(_MSC_VER)
+        unsigned long result;
+        _BitScanReverse64(&result, value);
+        return uint32_t(result);
+    #else
+        return uint32_t(63 - __builtin_clzll(value));
+    #endif
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最下位ビットの位置を取得します. value はゼロ以外である必要があります.
     //---------------------------------------------------------------------------------------------
-    static size_t RoundDown(size_t value, size_t base)
-    { return value & ~( base - 1 ); }
+    static uint32_t FindFirstSet(uint64_t value)
+    {
+    #if defined(_MSC_VER)
+        unsigned long result;
+        _BitScanForward64(&result, value);
+        return uint32_t(result);
+    #else
+        return uint32_t(__builtin_ctzll(value));
+    #endif
+    }
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      メモリコンパクションを行います.
+    //! @brief      サイズを格納するビン番号を取得します (切り下げ).
     //---------------------------------------------------------------------------------------------
-    void InnerCompact()
+    static uint32_t GetBinFloor(size_t size)
     {
-        m_FreeBlocks.sort();
+        auto fl = FindLastSet(uint64_t(size));
+        if (fl < SecondLevelBits)
+        { return uint32_t(size); }
 
-        Block prev = {};
-        auto itr = std::begin(m_FreeBlocks);
+        auto sl = uint32_t(uint64_t(size) >> (fl - SecondLevelBits)) & (SecondLevelCount - 1);
+        return (fl - SecondLevelBits + 1) * SecondLevelCount + sl;
+    }
 
-        while (itr != std::end(m_FreeBlocks))
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのブロックがサイズ以上となるビン番号を取得します (切り上げ).
+    //---------------------------------------------------------------------------------------------
+    static uint32_t GetBinCeil(size_t size)
+    {
+        auto fl = FindLastSet(uint64_t(size));
+        if (fl >= SecondLevelBits)
         {
-            if (prev.Offset + prev.Size == itr->Offset)
-            {
-                // ブロックを連結.
-                Block comb = {};
-                comb.Offset = prev.Offset;
-                comb.Size   = prev.Size + itr->Size;
+            auto round = (size_t(1) << (fl - SecondLevelBits)) - 1;
+            if (size + round < size)
+            { return BinCount; }
+            size += round;
+        }
 
-                itr = m_FreeBlocks.erase ( itr );
-                itr = m_FreeBlocks.insert( itr, comb );
-                m_FreeBlocks.remove( prev );
+        return GetBinFloor(size);
+    }
 
-                prev.Offset = comb.Offset;
-                prev.Size   = comb.Size;
-            }
-            else
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アライメントを考慮した探索サイズを求めます. 確保できない場合はゼロを返します.
+    //---------------------------------------------------------------------------------------------
+    static size_t GetRequestSize(size_t size, size_t alignment)
+    {
+        if (size == 0)
+        { return 0; }
+
+        // 最悪ケースのアライメント調整分を加えておけば, どのブロックを選んでも収まる.
+        auto padding = (alignment > 1) ? alignment - 1 : 0;
+        if (size + padding < size)
+        { return 0; }
+
+        return size + padding;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アライメント調整後に指定サイズが収まるかチェックします.
+    //---------------------------------------------------------------------------------------------
+    bool IsFit(uint32_t index, size_t size, size_t alignment) const
+    {
+        auto& node    = m_Nodes[index];
+        auto  aligned = RoundUp(size_t(m_Offset) + node.Offset, alignment) - size_t(m_Offset);
+        auto  padding = aligned - node.Offset;
+        return padding <= node.Size && size <= node.Size - padding;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保に使用する空きノードを探します. 見つからない場合は InvalidIndex を返します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t FindFreeNode(size_t size, size_t alignment) const
+    {
+        if (size == 0)
+        { return InvalidIndex; }
+
+        // 要求サイズ以上が保証されるビンがあれば, 先頭のノードで必ず収まる.
+        auto request = GetRequestSize(size, alignment);
+        auto limit   = (request != 0) ? GetBinCeil(request) : BinCount;
+        if (request != 0)
+        {
+            auto bin = FindBin(limit);
+            if (bin != InvalidIndex)
+            { return m_BinHeads[bin]; }
+        }
+
+        // 最悪ケースのパディングでは見つからなくても, 実際のオフセットでは収まるブロックがありうる.
+        // (例: 全体と同じサイズを整列済みの先頭から確保する場合.)
+        // サイズを含みうるビンから探索済みのビンの手前までを走査する.
+        for (auto bin = FindBin(GetBinFloor(size)); bin != InvalidIndex && bin < limit; bin = FindBin(bin + 1))
+        {
+            for (auto index = m_BinHeads[bin]; index != InvalidIndex; index = m_Nodes[index].BinNext)
             {
-                prev.Offset = itr->Offset;
-                prev.Size   = itr->Size;
-                itr++;
+                if (IsFit(index, size, alignment))
+                { return index; }
             }
         }
+
+        return InvalidIndex;
     }
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      空きブロックリストから割り当て可能なブロックを探します.
+    //! @brief      指定ビン以降で空きブロックを持つビンを探します.
     //---------------------------------------------------------------------------------------------
-    bool FindFreeBlock(size_t size, size_t alignment, Block& result)
+    uint32_t FindBin(uint32_t minBin) const
     {
-        auto allocSize = RoundUp( size, alignment );
+        if (minBin >= BinCount)
+        { return InvalidIndex; }
 
-        for(auto& itr : m_FreeBlocks)
+        auto fl = minBin / SecondLevelCount;
+        auto sl = minBin % SecondLevelCount;
+
+        uint32_t slMap = m_SecondLevelMap[fl] & (0xffu << sl) & 0xffu;
+        if (slMap == 0)
         {
-            if (allocSize <= itr.Size)
-            {
-                auto prevOffset = itr.Offset;
-                auto currOffset = RoundUp( prevOffset, alignment );
+            if (fl + 1 >= FirstLevelCount)
+            { return InvalidIndex; }
 
-                result.Size      = size;
-                result.Offset    = currOffset;
-                result.Alignment = alignment;
+            auto flMap = m_FirstLevelMap & (~uint64_t(0) << (fl + 1));
+            if (flMap == 0)
+            { return InvalidIndex; }
 
-                auto usedSize = (currOffset - prevOffset) + size;
+            fl    = FindFirstSet(flMap);
+            slMap = m_SecondLevelMap[fl];
+        }
 
-                m_UsedSize += usedSize;
+        return fl * SecondLevelCount + FindFirstSet(slMap);
+    }
 
-                Block free  = {};
-                free.Size       = itr.Size   - usedSize;
-                free.Offset     = itr.Offset + usedSize;
-                free.Alignment  = 0;
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最大の空きブロックサイズを取得します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetLargestFreeBlock() const
+    {
+        if (m_FirstLevelMap == 0)
+        { return 0; }
 
-                m_FreeBlocks.remove( itr );
-                m_FreeBlocks.push_back( free );
-                return true;
-            }
+        auto fl  = FindLastSet(m_FirstLevelMap);
+        auto bin = fl * SecondLevelCount + FindLastSet(m_SecondLevelMap[fl]);
+
+        // 最上位ビン内のみ走査すれば良い.
+        size_t result = 0;
+        for (auto index = m_BinHeads[bin]; index != InvalidIndex; index = m_Nodes[index].BinNext)
+        {
+            if (m_Nodes[index].Size > result)
+            { result = m_Nodes[index].Size; }
+        }
+
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ビンを初期化します.
+    //---------------------------------------------------------------------------------------------
+    void ClearBins()
+    {
+        m_FirstLevelMap = 0;
+        for (auto i = 0u; i < FirstLevelCount; ++i)
+        { m_SecondLevelMap[i] = 0; }
+        for (auto i = 0u; i < BinCount; ++i)
+        { m_BinHeads[i] = InvalidIndex; }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ノードを生成します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t NewNode()
+    {
+        uint32_t index;
+        if (!m_FreeNodes.empty())
+        {
+            index = m_FreeNodes.back();
+            m_FreeNodes.pop_back();
+        }
+        else
+        {
+            index = uint32_t(m_Nodes.size());
+            m_Nodes.push_back(Node());
+        }
+
+        auto& node = m_Nodes[index];
+        node.Offset       = 0;
+        node.Size         = 0;
+        node.BinPrev      = InvalidIndex;
+        node.BinNext      = InvalidIndex;
+        node.NeighborPrev = InvalidIndex;
+        node.NeighborNext = InvalidIndex;
+        node.Used         = false;
+        return index;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ノードを返却します.
+    //---------------------------------------------------------------------------------------------
+    void ReleaseNode(uint32_t index)
+    { m_FreeNodes.push_back(index); }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物理的な隣接関係を設定します.
+    //---------------------------------------------------------------------------------------------
+    void LinkNeighbor(uint32_t prev, uint32_t next)
+    {
+        if (prev != InvalidIndex)
+        { m_Nodes[prev].NeighborNext = next; }
+        if (next != InvalidIndex)
+        { m_Nodes[next].NeighborPrev = prev; }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ノードの先頭から指定サイズを空きブロックとして切り出します.
+    //---------------------------------------------------------------------------------------------
+    void SplitFront(uint32_t index, size_t size)
+    {
+        auto front = NewNode();
+        m_Nodes[front].Offset = m_Nodes[index].Offset;
+        m_Nodes[front].Size   = size;
+        LinkNeighbor(m_Nodes[index].NeighborPrev, front);
+        LinkNeighbor(front, index);
+
+        m_Nodes[index].Offset += size;
+        m_Nodes[index].Size   -= size;
+        InsertFreeNode(front);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ノードを指定サイズに縮め, 残りを空きブロックとして切り出します.
+    //---------------------------------------------------------------------------------------------
+    void SplitBack(uint32_t index, size_t size)
+    {
+        auto back = NewNode();
+        m_Nodes[back].Offset = m_Nodes[index].Offset + size;
+        m_Nodes[back].Size   = m_Nodes[index].Size   - size;
+        LinkNeighbor(back, m_Nodes[index].NeighborNext);
+        LinkNeighbor(index, back);
+
+        m_Nodes[index].Size = size;
+        InsertFreeNode(back);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      空きノードをビンに登録します.
+    //---------------------------------------------------------------------------------------------
+    void InsertFreeNode(uint32_t index)
+    {
+        auto bin  = GetBinFloor(m_Nodes[index].Size);
+        auto head = m_BinHeads[bin];
+
+        m_Nodes[index].Used    = false;
+        m_Nodes[index].BinPrev = InvalidIndex;
+        m_Nodes[index].BinNext = head;
+        if (head != InvalidIndex)
+        { m_Nodes[head].BinPrev = index; }
+        m_BinHeads[bin] = index;
+
+        auto fl = bin / SecondLevelCount;
+        m_SecondLevelMap[fl] |= uint8_t(1u << (bin % SecondLevelCount));
+        m_FirstLevelMap      |= uint64_t(1) << fl;
+        m_FreeBlockCount++;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      空きノードをビンから取り除きます.
+    //---------------------------------------------------------------------------------------------
+    void RemoveFreeNode(uint32_t index)
+    {
+        auto& node = m_Nodes[index];
+        auto  bin  = GetBinFloor(node.Size);
+
+        if (node.BinPrev != InvalidIndex)
+        { m_Nodes[node.BinPrev].BinNext = node.BinNext; }
+        else
+        { m_BinHeads[bin] = node.BinNext; }
+
+        if (node.BinNext != InvalidIndex)
+        { m_Nodes[node.BinNext].BinPrev = node.BinPrev; }
+
+        node.BinPrev = InvalidIndex;
+        node.BinNext = InvalidIndex;
+
+        if (m_BinHeads[bin] == InvalidIndex)
+        {
+            auto fl = bin / SecondLevelCount;
+            m_SecondLevelMap[fl] &= uint8_t(~(1u << (bin % SecondLevelCount)));
+            if (m_SecondLevelMap[fl] == 0)
+            { m_FirstLevelMap &= ~(uint64_t(1) << fl); }
         }
 
-        return false;
+        m_FreeBlockCount--;
     }
 };
 
@@ -0,0 +1,310 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dRingAllocator.h
+// Desc : Ring Allocator.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include "allocator/a3dBlockAllocator.h"
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RingAllocator class
+// ※オフセットとサイズのみ管理します. 実メモリは管理しません.
+// ※FIFO順に割り当て, フレーム単位でフェンス値に関連付けて古い順に回収します.
+//   個別の解放は行わないため, 空きブロックの管理は不要です.
+// ※スレッドセーフではありません.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class RingAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    RingAllocator()
+    : m_Size        (0)
+    , m_Offset      (0)
+    , m_Head        (0)
+    , m_Tail        (0)
+    , m_UsedSize    (0)
+    , m_FrameSize   (0)
+    , m_FrameHead   (0)
+    , m_FrameCount  (0)
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~RingAllocator()
+    { Term(); }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化を行います.
+    //!
+    //! @param[in]      size            管理するサイズです.
+    //! @param[in]      offset          先頭オフセットです.
+    //! @param[in]      maxFrameCount   同時に処理中にできる最大フレーム数です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(size_t size, ptrdiff_t offset, uint32_t maxFrameCount)
+    {
+        if (size == 0 || maxFrameCount == 0)
+        { return false; }
+
+        m_Size       = size;
+        m_Offset     = offset;
+        m_Head       = 0;
+        m_Tail       = 0;
+        m_UsedSize   = 0;
+        m_FrameSize  = 0;
+        m_FrameHead  = 0;
+        m_FrameCount = 0;
+
+        Frame frame = {};
+        m_Frames.assign(maxFrameCount, frame);
+
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term()
+    {
+        m_Size       = 0;
+        m_Offset     = 0;
+        m_Head       = 0;
+        m_Tail       = 0;
+        m_UsedSize   = 0;
+        m_FrameSize  = 0;
+        m_FrameHead  = 0;
+        m_FrameCount = 0;
+        m_Frames.clear();
+        m_Frames.shrink_to_fit();
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ブロックを確保します.
+    //!
+    //! @param[in]      size        確保サイズです.
+    //! @param[in]      alignment   アライメントです. 2の累乗である必要があります.
+    //! @return     確保したブロックを返却します. 確保に失敗した場合はサイズがゼロのブロックを返却します.
+    //---------------------------------------------------------------------------------------------
+    Block Alloc( size_t size, size_t alignment )
+    {
+        Block result = {};
+
+        if (size == 0 || size > m_Size)
+        { return result; }
+
+        if (alignment == 0)
+        { alignment = 1; }
+
+        // 空であれば先頭から使い直す.
+        if (m_UsedSize == 0)
+        {
+            m_Head = 0;
+            m_Tail = 0;
+        }
+
+        auto offset  = InvalidOffset;
+        auto padding = size_t(0);
+
+        if (m_Head >= m_Tail && m_UsedSize < m_Size)
+        {
+            auto aligned = AlignOffset(m_Head, alignment);
+            if (aligned + size <= m_Size)
+            {
+                offset  = aligned;
+                padding = aligned - m_Head;
+            }
+            else
+            {
+                // 終端の余りは捨てて先頭に折り返す.
+                aligned = AlignOffset(0, alignment);
+                if (aligned + size <= m_Tail)
+                {
+                    offset  = aligned;
+                    padding = (m_Size - m_Head) + aligned;
+                }
+            }
+        }
+        else if (m_Head < m_Tail)
+        {
+            auto aligned = AlignOffset(m_Head, alignment);
+            if (aligned + size <= m_Tail)
+            {
+                offset  = aligned;
+                padding = aligned - m_Head;
+            }
+        }
+
+        if (offset == InvalidOffset)
+        { return result; }
+
+        m_Head       = offset + size;
+        m_UsedSize  += size + padding;
+        m_FrameSize += size + padding;
+
+        if (m_Head == m_Size)
+        { m_Head = 0; }
+
+        result.Offset    = m_Offset + ptrdiff_t(offset);
+        result.Size      = size;
+        result.Alignment = alignment;
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームを終了し, 前回からの割り当てをフェンス値に関連付けます.
+    //!
+    //! @param[in]      value       フレーム完了時のフェンス値です.
+    //! @retval true    関連付けに成功.
+    //! @retval false   処理中のフレーム数が上限に達しています. 先に PopFrame() で回収してください.
+    //---------------------------------------------------------------------------------------------
+    bool EndFrame(uint64_t value)
+    {
+        if (m_FrameCount >= uint32_t(m_Frames.size()))
+        { return false; }
+
+        auto& frame = m_Frames[(m_FrameHead + m_FrameCount) % m_Frames.size()];
+        frame.Value = value;
+        frame.End   = m_Head;
+        frame.Size  = m_FrameSize;
+
+        m_FrameCount++;
+        m_FrameSize = 0;
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了済みのフレームが使用していた領域を回収します.
+    //!
+    //! @param[in]      completedValue      完了済みのフェンス値です.
+    //---------------------------------------------------------------------------------------------
+    void Retire(uint64_t completedValue)
+    {
+        while (m_FrameCount > 0 && m_Frames[m_FrameHead].Value <= completedValue)
+        { PopFrame(); }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最も古いフレームが使用していた領域を回収します.
+    //---------------------------------------------------------------------------------------------
+    void PopFrame()
+    {
+        if (m_FrameCount == 0)
+        { return; }
+
+        auto& frame = m_Frames[m_FrameHead];
+
+        // 割り当てが無かったフレームの終端は古い可能性があるので使わない.
+        if (frame.Size > 0)
+        { m_Tail = frame.End; }
+        m_UsedSize -= frame.Size;
+
+        frame.Value = 0;
+        frame.End   = 0;
+        frame.Size  = 0;
+
+        m_FrameHead = (m_FrameHead + 1) % uint32_t(m_Frames.size());
+        m_FrameCount--;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      処理中のフレーム数を取得します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetFrameCount() const
+    { return m_FrameCount; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最も古い処理中フレームのフェンス値を取得します.
+    //---------------------------------------------------------------------------------------------
+    uint64_t GetOldestFrameValue() const
+    { return (m_FrameCount > 0) ? m_Frames[m_FrameHead].Value : 0; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全体のサイズを取得します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetSize() const
+    { return m_Size; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      先頭オフセットを取得します.
+    //---------------------------------------------------------------------------------------------
+    ptrdiff_t GetOffset() const
+    { return m_Offset; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用サイズを取得します. 折り返しやアライメントで捨てた領域も含みます.
+    //---------------------------------------------------------------------------------------------
+    size_t GetUsedSize() const
+    { return m_UsedSize; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用サイズがゼロかどうかチェックします.
+    //---------------------------------------------------------------------------------------------
+    bool IsEmpty() const
+    { return m_UsedSize == 0; }
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Frame structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        uint64_t    Value;      //!< フレーム完了時のフェンス値です.
+        size_t      End;        //!< フレームで使用した領域の終端です.
+        size_t      Size;       //!< フレームで使用したサイズです.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    static const size_t InvalidOffset = ~size_t(0);     //!< 無効なオフセットです.
+
+    size_t                                  m_Size;         //!< ブロック全体のサイズ.
+    ptrdiff_t                               m_Offset;       //!< 先頭オフセット.
+    size_t                                  m_Head;         //!< 次に割り当てる位置.
+    size_t                                  m_Tail;         //!< 使用中領域の先頭.
+    size_t                                  m_UsedSize;     //!< 使用中のサイズ.
+    size_t                                  m_FrameSize;    //!< 現在のフレームで使用したサイズ.
+    std::vector<Frame, StdAllocator<Frame>> m_Frames;       //!< 処理中のフレーム.
+    uint32_t                                m_FrameHead;    //!< 最も古いフレームの位置.
+    uint32_t                                m_FrameCount;   //!< 処理中のフレーム数.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      先頭オフセットを考慮して位置をアライメントに揃えます.
+    //---------------------------------------------------------------------------------------------
+    size_t AlignOffset(size_t position, size_t alignment) const
+    {
+        auto value = size_t(m_Offset) + position;
+        return ((value + (alignment - 1)) & ~(alignment - 1)) - size_t(m_Offset);
+    }
+};
+
+} // namespace a3d
@@ -0,0 +1,182 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dStackAllocator.h
+// Desc : Stack Allocator.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <atomic>
+#include "allocator/a3dBlockAllocator.h"
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// StackAllocator class
+// ※オフセットとサイズのみ管理します. 実メモリは管理しません.
+// ※先頭から線形に割り当て, Mark() で記録した位置まで Rewind() で一括して巻き戻します.
+//   Alloc() はロックを使用せず複数スレッドから呼び出せますが,
+//   Mark(), Rewind(), Reset() は Alloc() と同時に呼び出さないでください.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class StackAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //---------------------------------------------------------------------------------------------
+    // Using Alias
+    //---------------------------------------------------------------------------------------------
+    using Marker = size_t;
+
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    StackAllocator()
+    : m_Size    (0)
+    , m_Offset  (0)
+    , m_Top     (0)
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~StackAllocator()
+    { Term(); }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化を行います.
+    //!
+    //! @param[in]      size        管理するサイズです.
+    //! @param[in]      offset      先頭オフセットです.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(size_t size, ptrdiff_t offset)
+    {
+        m_Size   = size;
+        m_Offset = offset;
+        m_Top.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term()
+    {
+        m_Size   = 0;
+        m_Offset = 0;
+        m_Top.store(0, std::memory_order_relaxed);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ブロックを確保します.
+    //!
+    //! @param[in]      size        確保サイズです.
+    //! @param[in]      alignment   アライメントです. 2の累乗である必要があります.
+    //! @return     確保したブロックを返却します. 確保に失敗した場合はサイズがゼロのブロックを返却します.
+    //---------------------------------------------------------------------------------------------
+    Block Alloc( size_t size, size_t alignment )
+    {
+        Block result = {};
+
+        if (size == 0)
+        { return result; }
+
+        if (alignment == 0)
+        { alignment = 1; }
+
+        auto top = m_Top.load(std::memory_order_relaxed);
+        size_t aligned;
+        do
+        {
+            auto value = size_t(m_Offset) + top;
+            aligned = ((value + (alignment - 1)) & ~(alignment - 1)) - size_t(m_Offset);
+
+            if (aligned < top || aligned > m_Size || size > m_Size - aligned)
+            { return result; }
+        }
+        while (!m_Top.compare_exchange_weak(top, aligned + size, std::memory_order_relaxed));
+
+        result.Offset    = m_Offset + ptrdiff_t(aligned);
+        result.Size      = size;
+        result.Alignment = alignment;
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在の位置を記録します.
+    //---------------------------------------------------------------------------------------------
+    Marker Mark() const
+    { return m_Top.load(std::memory_order_relaxed); }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      Mark() で記録した位置まで巻き戻します. それ以降に確保したブロックは全て無効になります.
+    //---------------------------------------------------------------------------------------------
+    void Rewind(Marker marker)
+    {
+        if (marker <= m_Top.load(std::memory_order_relaxed))
+        { m_Top.store(marker, std::memory_order_relaxed); }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのブロックを解放します.
+    //---------------------------------------------------------------------------------------------
+    void Reset()
+    { m_Top.store(0, std::memory_order_relaxed); }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全体のサイズを取得します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetSize() const
+    { return m_Size; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      先頭オフセットを取得します.
+    //---------------------------------------------------------------------------------------------
+    ptrdiff_t GetOffset() const
+    { return m_Offset; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用サイズを取得します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetUsedSize() const
+    { return m_Top.load(std::memory_order_relaxed); }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      使用サイズがゼロかどうかチェックします.
+    //---------------------------------------------------------------------------------------------
+    bool IsEmpty() const
+    { return GetUsedSize() == 0; }
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    size_t              m_Size;     //!< ブロック全体のサイズ.
+    ptrdiff_t           m_Offset;   //!< 先頭オフセット.
+    std::atomic<size_t> m_Top;      //!< 次に割り当てる位置.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    StackAllocator  (const StackAllocator&) = delete;
+    void operator = (const StackAllocator&) = delete;
+};
+
+} // namespace a3d
@@ -9,15 +9,18 @@
 // Includes
 //-------------------------------------------------------------------------------------------------
 #include <cstdint>
-#include <mutex>
 #include <cstdlib>
-#include <functional>
+#include <atomic>
+#include <new>
+#include <type_traits>
 
 
 namespace a3d {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Pool class
+//! @brief      スレッドセーフなアイテムプールです.
+//! @note       未使用アイテムはタグ付きインデックスのスタックで管理し, ロックを使用しません.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename T>
 class Pool
@@ -32,13 +35,113 @@ public:
     // public variablse.
     //=============================================================================================
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アイテムハンドルです.
+    //! @note       上位32bitが世代, 下位32bitがインデックスです.
+    //!             解放済みのアイテムを指すハンドルは世代が一致しないため無効になります.
+    //---------------------------------------------------------------------------------------------
+    using Handle = uint64_t;
+
+    static const Handle     InvalidHandle = ~Handle(0);     //!< 無効なハンドルです.
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Magazine class
+    //! @brief      スレッド毎のアイテムキャッシュです.
+    //! @note       インデックスをまとめて取得・返却することで共有スタックへのアクセスを減らします.
+    //!             1つのマガジンは1つのスレッドからのみ使用してください.
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    class Magazine
+    {
+    public:
+        static const uint32_t Capacity = 32;    //!< キャッシュできるアイテム数です.
+
+        //-----------------------------------------------------------------------------------------
+        //! @brief      コンストラクタです.
+        //!
+        //! @param[in]      pPool       アイテムを取得するプールです.
+        //-----------------------------------------------------------------------------------------
+        explicit Magazine(Pool* pPool)
+        : m_pPool (pPool)
+        , m_Count (0)
+        { /* DO_NOTHING */ }
+
+        //-----------------------------------------------------------------------------------------
+        //! @brief      デストラクタです.
+        //-----------------------------------------------------------------------------------------
+        ~Magazine()
+        { Flush(); }
+
+        //-----------------------------------------------------------------------------------------
+        //! @brief      アイテムを確保します.
+        //!
+        //! @param[in]      func        ユーザによる初期化処理です.
+        //! @return     確保したアイテムへのポインタ. 確保に失敗した場合は nullptr が返却されます.
+        //-----------------------------------------------------------------------------------------
+        template<typename Func>
+        T* Alloc(Func func)
+        {
+            if (m_Count == 0)
+            {
+                m_Count = m_pPool->PopBatch(m_Indices, Capacity / 2);
+                if (m_Count == 0)
+                { return nullptr; }
+            }
+
+            return m_pPool->Construct(m_Indices[--m_Count], func);
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //! @brief      アイテムを確保します.
+        //!
+        //! @return     確保したアイテムへのポインタ. 確保に失敗した場合は nullptr が返却されます.
+        //-----------------------------------------------------------------------------------------
+        T* Alloc()
+        { return Alloc(NoInit()); }
+
+        //-----------------------------------------------------------------------------------------
+        //! @brief      アイテムを解放します.
+        //!
+        //! @param[in]      pValue      解放するアイテムへのポインタ.
+        //-----------------------------------------------------------------------------------------
+        void Free(T* pValue)
+        {
+            if (pValue == nullptr)
+            { return; }
+
+            // 満杯の場合は半分を共有スタックに返却する.
+            if (m_Count == Capacity)
+            {
+                m_pPool->PushBatch(m_Indices + Capacity / 2, Capacity / 2);
+                m_Count = Capacity / 2;
+            }
+
+            m_Indices[m_Count++] = m_pPool->Retire(pValue);
+        }
+
+        //-----------------------------------------------------------------------------------------
+        //! @brief      キャッシュしているアイテムを全てプールに返却します.
+        //-----------------------------------------------------------------------------------------
+        void Flush()
+        {
+            m_pPool->PushBatch(m_Indices, m_Count);
+            m_Count = 0;
+        }
+
+    private:
+        Pool*       m_pPool;                //!< プールです.
+        uint32_t    m_Indices[Capacity];    //!< キャッシュしているインデックスです.
+        uint32_t    m_Count;                //!< キャッシュしているインデックス数です.
+
+        Magazine        (const Magazine&) = delete;
+        void operator = (const Magazine&) = delete;
+    };
+
     //---------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //---------------------------------------------------------------------------------------------
     Pool()
-    : m_pBuffer (nullptr)
-    , m_pActive (nullptr)
-    , m_pFree   (nullptr)
+    : m_pItems  (nullptr)
+    , m_FreeHead(MakeHead(0, InvalidIndex))
     , m_Capacity(0)
     , m_Count   (0)
     { /* DO_NOTHING */ }
@@ -55,41 +158,31 @@ public:
     //! @param[in]      count       確保するアイテム数です.
     //! @retval true    初期化に成功.
     //! @retval false   初期化に失敗.
+    //! @note       初期化処理と終了処理はスレッドセーフではありません.
     //---------------------------------------------------------------------------------------------
     bool Init(uint32_t count)
     {
-        std::lock_guard<std::mutex> guard(m_Mutex);
+        Term();
 
-        m_pBuffer = static_cast<uint8_t*>(malloc(sizeof(Item) * (count + 2)));
-        if ( m_pBuffer == nullptr )
+        if (count == 0 || count == InvalidIndex)
         { return false; }
 
-        m_Capacity = count;
-
-        // インデックスを振る.
-        for(auto i=2u, j=0u; i<m_Capacity + 2; ++i, ++j)
-        {
-            auto item = GetItem(i);
-            item->m_Index = j;
-        }
-
-        m_pActive = GetItem(0);
-        m_pActive->m_pPrev = m_pActive->m_pNext = m_pActive;
-        m_pActive->m_Index = uint32_t(-1);
+        m_pItems = static_cast<Item*>(malloc(sizeof(Item) * count));
+        if ( m_pItems == nullptr )
+        { return false; }
 
-        m_pFree = GetItem(1);
-        m_pFree->m_Index = uint32_t(-2);
+        m_Capacity = count;
 
-        for(auto i=1u; i<m_Capacity + 2; ++i)
+        // インデックス順に取り出されるようにスタックを積む.
+        for(auto i=0u; i<m_Capacity; ++i)
         {
-            GetItem(i)->m_pPrev = nullptr;
-            GetItem(i)->m_pNext = GetItem( i + 1 );
+            auto item = new (&m_pItems[i]) Item();
+            item->m_Next      .store((i + 1 < m_Capacity) ? i + 1 : InvalidIndex, std::memory_order_relaxed);
+            item->m_Generation.store(0, std::memory_order_relaxed);
         }
 
-        GetItem( m_Capacity + 1 )->m_pPrev = m_pFree;
-
-
-        m_Count = 0;
+        m_FreeHead.store(MakeHead(0, 0), std::memory_order_release);
+        m_Count   .store(0, std::memory_order_relaxed);
 
         return true;
     }
@@ -99,73 +192,93 @@ public:
     //---------------------------------------------------------------------------------------------
     void Term()
     {
-        std::lock_guard<std::mutex> guard(m_Mutex);
-
-        if ( m_pBuffer )
+        if ( m_pItems )
         {
-            free(m_pBuffer);
-            m_pBuffer = nullptr;
+            for(auto i=0u; i<m_Capacity; ++i)
+            { m_pItems[i].~Item(); }
+
+            free(m_pItems);
+            m_pItems = nullptr;
         }
 
-        m_pActive   = nullptr;
-        m_pFree     = nullptr;
+        m_FreeHead.store(MakeHead(0, InvalidIndex), std::memory_order_relaxed);
         m_Capacity  = 0;
-        m_Count     = 0;
+        m_Count.store(0, std::memory_order_relaxed);
     }
 
     //---------------------------------------------------------------------------------------------
     //! @brief      アイテムを確保します.
     //!
-    //! @param[in]      func        ユーザによる初期化処理です.
+    //! @param[in]      func        ユーザによる初期化処理です. void(uint32_t index, T* pValue) の形式で呼び出されます.
     //! @return     確保したアイテムへのポインタ. 確保に失敗した場合は nullptr が返却されます.
     //---------------------------------------------------------------------------------------------
-    T* Alloc(std::function<void(uint32_t, T*)> func = nullptr)
+    template<typename Func>
+    T* Alloc(Func func)
     {
-        std::lock_guard<std::mutex> guard(m_Mutex);
-
-        if ( m_pFree->m_pNext == m_pFree || m_Count + 1 > m_Capacity )
+        uint32_t index;
+        if (PopBatch(&index, 1) == 0)
         { return nullptr; }
 
-        auto item = m_pFree->m_pNext;
-        m_pFree->m_pNext = item->m_pNext;
-
-        item->m_pPrev = m_pActive->m_pPrev;
-        item->m_pNext = m_pActive;
-        item->m_pPrev->m_pNext = item->m_pNext->m_pPrev = item;
-
-        m_Count++;
-
-        // メモリ割り当て.
-        auto val = new ((void*)item) T();
-
-        // 初期化の必要があれば呼び出す.
-        if (func != nullptr)
-        { func(item->m_Index, val); }
-
-        return val;
+        return Construct(index, func);
     }
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アイテムを確保します.
+    //!
+    //! @return     確保したアイテムへのポインタ. 確保に失敗した場合は nullptr が返却されます.
+    //---------------------------------------------------------------------------------------------
+    T* Alloc()
+    { return Alloc(NoInit()); }
+
     //---------------------------------------------------------------------------------------------
     //! @brief      アイテムを解放します.
     //!
     //! @param[in]      pValue      解放するアイテムへのポインタ.
+    //! @note       デストラクタは呼び出されません.
     //---------------------------------------------------------------------------------------------
     void Free(T* pValue)
     {
         if (pValue == nullptr)
         { return; }
 
-        std::lock_guard<std::mutex> guard(m_Mutex);
+        auto index = Retire(pValue);
+        PushBatch(&index, 1);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アイテムのハンドルを取得します.
+    //!
+    //! @param[in]      pValue      確保済みのアイテムへのポインタです.
+    //! @return     アイテムのハンドルを返却します.
+    //---------------------------------------------------------------------------------------------
+    Handle GetHandle(const T* pValue) const
+    {
+        if (pValue == nullptr)
+        { return InvalidHandle; }
+
+        auto index = GetIndex(pValue);
+        auto gen   = m_pItems[index].m_Generation.load(std::memory_order_acquire);
+        return (Handle(gen) << 32) | index;
+    }
 
-        auto item = reinterpret_cast<Item*>(pValue);
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ハンドルからアイテムを取得します.
+    //!
+    //! @param[in]      handle      アイテムのハンドルです.
+    //! @return     アイテムへのポインタを返却します. 解放済みのアイテムを指す場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    T* Resolve(Handle handle) const
+    {
+        auto index = static_cast<uint32_t>(handle & 0xffffffff);
+        auto gen   = static_cast<uint32_t>(handle >> 32);
+        if (index >= m_Capacity)
+        { return nullptr; }
 
-        item->m_pPrev->m_pNext = item->m_pNext;
-        item->m_pNext->m_pPrev = item->m_pPrev;
+        auto& item = m_pItems[index];
+        if (item.m_Generation.load(std::memory_order_acquire) != gen)
+        { return nullptr; }
 
-        item->m_pPrev = nullptr;
-        item->m_pNext = m_pFree->m_pNext;
-        m_pFree->m_pNext = item;
-        m_Count--;
+        return reinterpret_cast<T*>(&item.m_Storage);
     }
 
     //--------------------------------------------------------------------------------------------
@@ -182,15 +295,16 @@ public:
     //! @return     使用中のアイテム数を返却します.
     //--------------------------------------------------------------------------------------------
     uint32_t GetUsedCount() const
-    { return m_Count; }
+    { return m_Count.load(std::memory_order_relaxed); }
 
     //--------------------------------------------------------------------------------------------
     //! @brief      利用可能なアイテム数を取得します.
     //!
     //! @return     利用可能なアイテム数を返却します.
+    //! @note       マガジンにキャッシュされているアイテムも含まれます.
     //--------------------------------------------------------------------------------------------
     uint32_t GetAvailableCount() const
-    { return m_Capacity - m_Count; }
+    { return m_Capacity - GetUsedCount(); }
 
 private:
     ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -198,63 +312,162 @@ private:
     ///////////////////////////////////////////////////////////////////////////////////////////////
     struct Item
     {
-        T           m_Value;        //!< 値です.
-        uint32_t    m_Index;        //!< インデックスです.
-        Item*       m_pNext;        //!< 次のアイテムへのポインタ.
-        Item*       m_pPrev;        //!< 前のアイテムへのポインタ.
-
-        Item()
-        : m_Value()
-        , m_Index(0)
-        , m_pNext(nullptr)
-        , m_pPrev(nullptr)
-        { /* DO_NOTHING */ }
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type  m_Storage;      //!< 値の格納領域です.
+        std::atomic<uint32_t>                                       m_Next;         //!< 次の未使用アイテムのインデックスです.
+        std::atomic<uint32_t>                                       m_Generation;   //!< 世代です. 奇数の場合は使用中です.
+    };
 
-        ~Item()
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // NoInit structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct NoInit
+    {
+        void operator()(uint32_t, T*) const
         { /* DO_NOTHING */ }
     };
 
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    uint8_t*    m_pBuffer;      //!< バッファです.
-    Item*       m_pActive;      //!< アクティブアイテムの先頭です.
-    Item*       m_pFree;        //!< フリーアイテムの先頭です.
-    uint32_t    m_Capacity;     //!< 総アイテム数です.
-    uint32_t    m_Count;        //!< 確保したアイテム数です.
-    std::mutex  m_Mutex;        //!< ミューテックスです.
+    static const uint32_t   InvalidIndex = ~uint32_t(0);    //!< 無効なインデックスです.
+
+    Item*                   m_pItems;       //!< アイテムの配列です.
+    std::atomic<uint64_t>   m_FreeHead;     //!< 未使用スタックの先頭です. 上位32bitがタグ, 下位32bitがインデックスです.
+    uint32_t                m_Capacity;     //!< 総アイテム数です.
+    std::atomic<uint32_t>   m_Count;        //!< 確保したアイテム数です.
 
     //=============================================================================================
     // private methods.
     //=============================================================================================
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      アイテムを取得します.
+    //! @brief      スタックの先頭値を生成します.
+    //!
+    //! @param[in]      tag         ABA対策のタグです.
+    //! @param[in]      index       先頭のインデックスです.
+    //! @return     スタックの先頭値を返却します.
+    //---------------------------------------------------------------------------------------------
+    static uint64_t MakeHead(uint32_t tag, uint32_t index)
+    { return (uint64_t(tag) << 32) | index; }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アイテムのインデックスを取得します.
+    //!
+    //! @param[in]      pValue      アイテムへのポインタです.
+    //! @return     アイテムのインデックスを返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetIndex(const T* pValue) const
+    {
+        auto item  = reinterpret_cast<const Item*>(pValue);
+        auto index = static_cast<uint32_t>(item - m_pItems);
+        A3D_ASSERT(index < m_Capacity);
+        return index;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      未使用スタックからインデックスを取り出します.
+    //!
+    //! @param[out]     pIndices    インデックスの格納先です.
+    //! @param[in]      count       取り出す最大数です.
+    //! @return     取り出したインデックス数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t PopBatch(uint32_t* pIndices, uint32_t count)
+    {
+        auto popped = 0u;
+        auto head   = m_FreeHead.load(std::memory_order_acquire);
+
+        while(popped < count)
+        {
+            auto index = static_cast<uint32_t>(head & 0xffffffff);
+            if (index == InvalidIndex)
+            { break; }
+
+            // 他スレッドが先に取り出していた場合はタグが変わっているので CAS が失敗する.
+            auto next    = m_pItems[index].m_Next.load(std::memory_order_relaxed);
+            auto newHead = MakeHead(static_cast<uint32_t>(head >> 32) + 1, next);
+            if (m_FreeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                pIndices[popped++] = index;
+                head = newHead;
+            }
+        }
+
+        return popped;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      未使用スタックにインデックスをまとめて積みます.
+    //!
+    //! @param[in]      pIndices    インデックスの配列です.
+    //! @param[in]      count       インデックス数です.
+    //---------------------------------------------------------------------------------------------
+    void PushBatch(const uint32_t* pIndices, uint32_t count)
+    {
+        if (count == 0)
+        { return; }
+
+        // 事前に連結しておき, 共有スタックへは1回の CAS で積む.
+        for(auto i=0u; i<count - 1; ++i)
+        { m_pItems[pIndices[i]].m_Next.store(pIndices[i + 1], std::memory_order_relaxed); }
+
+        auto& last = m_pItems[pIndices[count - 1]];
+        auto  head = m_FreeHead.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            last.m_Next.store(static_cast<uint32_t>(head & 0xffffffff), std::memory_order_relaxed);
+            auto newHead = MakeHead(static_cast<uint32_t>(head >> 32) + 1, pIndices[0]);
+            if (m_FreeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed))
+            { break; }
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アイテムを構築します.
     //!
-    //! @param[in]      index       取得するアイテムのインデックス.
-    //! @return     アイテムへのポインタを返却します.
+    //! @param[in]      index       アイテムのインデックスです.
+    //! @param[in]      func        ユーザによる初期化処理です.
+    //! @return     構築したアイテムへのポインタを返却します.
     //---------------------------------------------------------------------------------------------
-    Item* GetItem( uint32_t index )
+    template<typename Func>
+    T* Construct(uint32_t index, Func& func)
     {
-        A3D_ASSERT( 0 <= index && index <= m_Capacity + 2 );
-        return reinterpret_cast<Item*>( m_pBuffer + sizeof(Item) * index );
+        auto& item = m_pItems[index];
+        A3D_ASSERT((item.m_Generation.load(std::memory_order_relaxed) & 0x1) == 0);
+
+        // メモリ割り当て.
+        auto val = new (&item.m_Storage) T();
+
+        // 初期化の必要があれば呼び出す.
+        func(index, val);
+
+        item.m_Generation.fetch_add(1, std::memory_order_release);
+        m_Count.fetch_add(1, std::memory_order_relaxed);
+
+        return val;
     }
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      アイテムにメモリを割り当てます.
+    //! @brief      アイテムを未使用にします.
     //!
-    //! @param[in]      index       取得するアイテムのインデックス.
-    //! @return     アイテムへのポインタを返却します.
+    //! @param[in]      pValue      アイテムへのポインタです.
+    //! @return     アイテムのインデックスを返却します.
     //---------------------------------------------------------------------------------------------
-    Item* AssignItem( uint32_t index )
+    uint32_t Retire(T* pValue)
     {
-        A3D_ASSERT( 0 <= index && index <= m_Capacity + 2 );
-        auto buf = (m_pBuffer + sizeof(Item) * index);
-        return new (buf) Item;
+        auto  index = GetIndex(pValue);
+        auto& item  = m_pItems[index];
+
+        // 世代を進めて既存のハンドルを無効化する. 二重解放はここで検出する.
+        auto prev = item.m_Generation.fetch_add(1, std::memory_order_acq_rel);
+        A3D_ASSERT((prev & 0x1) == 1);
+        A3D_UNUSED(prev);
+
+        m_Count.fetch_sub(1, std::memory_order_relaxed);
+        return index;
     }
 
     Pool            (const Pool&) = delete;
     void operator = (const Pool&) = delete;
 };
 
-} // namespace a3d
\ No newline at end of file
+} // namespace a3d
@@ -0,0 +1,562 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dBundle.cpp
+// Desc : Pre-Baked Bundle Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace {
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタを展開するシェーダステージです. Queue の展開順と合わせています.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t g_BindStages[] = {
+    a3d::SHADER_MASK_VERTEX,
+    a3d::SHADER_MASK_DOMAIN,
+    a3d::SHADER_MASK_GEOMETRY,
+    a3d::SHADER_MASK_HULL,
+    a3d::SHADER_MASK_PIXEL,
+    a3d::SHADER_MASK_COMPUTE,
+};
+
+//-------------------------------------------------------------------------------------------------
+//      定数バッファを設定します.
+//-------------------------------------------------------------------------------------------------
+void SetConstantBuffer(ID3D11DeviceContext* pContext, uint32_t stage, uint32_t slot, ID3D11Buffer* pBuffer)
+{
+    switch(stage)
+    {
+    case a3d::SHADER_MASK_VERTEX:   pContext->VSSetConstantBuffers(slot, 1, &pBuffer); break;
+    case a3d::SHADER_MASK_DOMAIN:   pContext->DSSetConstantBuffers(slot, 1, &pBuffer); break;
+    case a3d::SHADER_MASK_GEOMETRY: pContext->GSSetConstantBuffers(slot, 1, &pBuffer); break;
+    case a3d::SHADER_MASK_HULL:     pContext->HSSetConstantBuffers(slot, 1, &pBuffer); break;
+    case a3d::SHADER_MASK_PIXEL:    pContext->PSSetConstantBuffers(slot, 1, &pBuffer); break;
+    case a3d::SHADER_MASK_COMPUTE:  pContext->CSSetConstantBuffers(slot, 1, &pBuffer); break;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      シェーダリソースビューを設定します.
+//-------------------------------------------------------------------------------------------------
+void SetShaderResource(ID3D11DeviceContext* pContext, uint32_t stage, uint32_t slot, ID3D11ShaderResourceView* pSRV)
+{
+    switch(stage)
+    {
+    case a3d::SHADER_MASK_VERTEX:   pContext->VSSetShaderResources(slot, 1, &pSRV); break;
+    case a3d::SHADER_MASK_DOMAIN:   pContext->DSSetShaderResources(slot, 1, &pSRV); break;
+    case a3d::SHADER_MASK_GEOMETRY: pContext->GSSetShaderResources(slot, 1, &pSRV); break;
+    case a3d::SHADER_MASK_HULL:     pContext->HSSetShaderResources(slot, 1, &pSRV); break;
+    case a3d::SHADER_MASK_PIXEL:    pContext->PSSetShaderResources(slot, 1, &pSRV); break;
+    case a3d::SHADER_MASK_COMPUTE:  pContext->CSSetShaderResources(slot, 1, &pSRV); break;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サンプラーを設定します.
+//-------------------------------------------------------------------------------------------------
+void SetSampler(ID3D11DeviceContext* pContext, uint32_t stage, uint32_t slot, ID3D11SamplerState* pSampler)
+{
+    switch(stage)
+    {
+    case a3d::SHADER_MASK_VERTEX:   pContext->VSSetSamplers(slot, 1, &pSampler); break;
+    case a3d::SHADER_MASK_DOMAIN:   pContext->DSSetSamplers(slot, 1, &pSampler); break;
+    case a3d::SHADER_MASK_GEOMETRY: pContext->GSSetSamplers(slot, 1, &pSampler); break;
+    case a3d::SHADER_MASK_HULL:     pContext->HSSetSamplers(slot, 1, &pSampler); break;
+    case a3d::SHADER_MASK_PIXEL:    pContext->PSSetSamplers(slot, 1, &pSampler); break;
+    case a3d::SHADER_MASK_COMPUTE:  pContext->CSSetSamplers(slot, 1, &pSampler); break;
+    }
+}
+
+} // namespace
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Bundle class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+Bundle::Bundle()
+: m_IsCompiled  (false)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+Bundle::~Bundle()
+{ Reset(); }
+
+//-------------------------------------------------------------------------------------------------
+//      コマンドバッファを解析し, ネイティブ呼び出し列に変換します.
+//-------------------------------------------------------------------------------------------------
+bool Bundle::Compile(const CommandBuffer* pBuffer)
+{
+    Reset();
+
+    if (pBuffer == nullptr)
+    { return false; }
+
+    // バンドル内で冗長な設定を取り除くためのキャッシュです.
+    PipelineState*  pBoundPipelineState = nullptr;
+    Buffer*         pBoundIndexBuffer   = nullptr;
+    uint64_t        boundIndexOffset    = 0;
+
+    auto pSegment = pBuffer->GetSegments();
+    auto count    = pBuffer->GetSegmentCount();
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto pCmd = const_cast<uint8_t*>(pSegment[i].pBegin);
+        auto pEnd = pSegment[i].pEnd;
+
+        while(pCmd < pEnd)
+        {
+            auto pBase = reinterpret_cast<ImCmdBase*>(pCmd);
+
+            Op op = {};
+
+            switch(pBase->Type)
+            {
+            case CMD_SUB_BEGIN:
+            case CMD_SUB_END:
+            case CMD_PUSH_MARKER:
+            case CMD_POP_MARKER:
+                {
+                    // ネイティブ呼び出しが無いので取り除く.
+                }
+                break;
+
+            case CMD_SET_BLEND_CONSTANT:
+                {
+                    auto cmd = reinterpret_cast<ImCmdSetBlendConstant*>(pCmd);
+
+                    op.Type = OP_SET_BLEND_CONSTANT;
+                    memcpy(op.Args, cmd->BlendConstant, sizeof(cmd->BlendConstant));
+                    m_Ops.push_back(op);
+
+                    // パイプラインステート設定時に反映されるので, 次の設定は省略できない.
+                    pBoundPipelineState = nullptr;
+                }
+                break;
+
+            case CMD_SET_STENCIL_REFERENCE:
+                {
+                    auto cmd = reinterpret_cast<ImCmdSetStencilReference*>(pCmd);
+
+                    op.Type    = OP_SET_STENCIL_REFERENCE;
+                    op.Args[0] = cmd->StencilReference;
+                    m_Ops.push_back(op);
+
+                    // パイプラインステート設定時に反映されるので, 次の設定は省略できない.
+                    pBoundPipelineState = nullptr;
+                }
+                break;
+
+            case CMD_SET_PIPELINESTATE:
+                {
+                    auto cmd = reinterpret_cast<ImCmdSetPipelineState*>(pCmd);
+
+                    auto pPipelineState = static_cast<PipelineState*>(cmd->pPipelineState);
+                    if (pPipelineState == nullptr)
+                    {
+                        Reset();
+                        return false;
+                    }
+
+                    if (pPipelineState == pBoundPipelineState)
+                    { break; }
+
+                    op.Type    = OP_SET_PIPELINE_STATE;
+                    op.pObject = pPipelineState;
+                    m_Ops.push_back(op);
+
+                    pBoundPipelineState = pPipelineState;
+                }
+                break;
+
+            case CMD_SET_DESCRIPTORSET:
+                {
+                    CompileDescriptorSet(reinterpret_cast<ImCmdSetDescriptorSet*>(pCmd));
+                }
+                break;
+
+            case CMD_SET_VERTEX_BUFFERS:
+                {
+                    auto cmd = reinterpret_cast<ImCmdSetVertexBuffers*>(pCmd);
+                    if (cmd->Count > D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT)
+                    {
+                        Reset();
+                        return false;
+                    }
+
+                    auto ppSrcBuffers = reinterpret_cast<IBuffer**>(ImCmdPayload(cmd));
+                    auto pSrcOffsets  = (cmd->HasOffset)
+                                        ? reinterpret_cast<uint64_t*>(ppSrcBuffers + cmd->Count)
+                                        : nullptr;
+
+                    op.Type    = OP_SET_VERTEX_BUFFERS;
+                    op.Args[0] = cmd->StartSlot;
+                    op.Args[1] = cmd->Count;
+                    op.Args[2] = static_cast<uint32_t>(m_VertexBuffers.size());
+                    m_Ops.push_back(op);
+
+                    for(auto j=0u; j<cmd->Count; ++j)
+                    {
+                        auto pWrapBuffer = static_cast<Buffer*>(ppSrcBuffers[j]);
+                        A3D_ASSERT(pWrapBuffer != nullptr);
+
+                        m_VertexBuffers.push_back(pWrapBuffer->GetD3D11Buffer());
+                        m_Strides      .push_back(pWrapBuffer->GetDesc().Stride);
+                        m_Offsets      .push_back((pSrcOffsets != nullptr) ? static_cast<uint32_t>(pSrcOffsets[j]) : 0);
+                    }
+                }
+                break;
+
+            case CMD_SET_INDEX_BUFFER:
+                {
+                    auto cmd = reinterpret_cast<ImCmdSetIndexBuffer*>(pCmd);
+
+                    auto pWrapBuffer = static_cast<Buffer*>(cmd->pBuffer);
+                    if (pWrapBuffer == nullptr)
+                    {
+                        Reset();
+                        return false;
+                    }
+
+                    if (pWrapBuffer == pBoundIndexBuffer && cmd->Offset == boundIndexOffset)
+                    { break; }
+
+                    op.Type    = OP_SET_INDEX_BUFFER;
+                    op.pObject = pWrapBuffer->GetD3D11Buffer();
+                    op.Args[0] = (pWrapBuffer->GetDesc().Stride == sizeof(uint16_t))
+                                    ? DXGI_FORMAT_R16_UINT
+                                    : DXGI_FORMAT_R32_UINT;
+                    op.Args[1] = static_cast<uint32_t>(cmd->Offset);
+                    m_Ops.push_back(op);
+
+                    pBoundIndexBuffer = pWrapBuffer;
+                    boundIndexOffset  = cmd->Offset;
+                }
+                break;
+
+            case CMD_DRAW_INSTANCED:
+                {
+                    auto cmd = reinterpret_cast<ImCmdDrawInstanced*>(pCmd);
+
+                    op.Type    = OP_DRAW_INSTANCED;
+                    op.Args[0] = cmd->VertexCount;
+                    op.Args[1] = cmd->InstanceCount;
+                    op.Args[2] = cmd->FirstVertex;
+                    op.Args[3] = cmd->FirstInstance;
+                    m_Ops.push_back(op);
+                }
+                break;
+
+            case CMD_DRAW_INDEXED_INSTANCED:
+                {
+                    auto cmd = reinterpret_cast<ImCmdDrawIndexedInstanced*>(pCmd);
+
+                    op.Type    = OP_DRAW_INDEXED_INSTANCED;
+                    op.Args[0] = cmd->IndexCount;
+                    op.Args[1] = cmd->InstanceCount;
+                    op.Args[2] = cmd->FirstIndex;
+                    op.Args[3] = static_cast<uint32_t>(cmd->VertexOffset);
+                    op.Args[4] = cmd->FirstInstance;
+                    m_Ops.push_back(op);
+                }
+                break;
+
+            case CMD_DISPATCH:
+                {
+                    auto cmd = reinterpret_cast<ImCmdDispatch*>(pCmd);
+
+                    op.Type    = OP_DISPATCH;
+                    op.Args[0] = cmd->X;
+                    op.Args[1] = cmd->Y;
+                    op.Args[2] = cmd->Z;
+                    m_Ops.push_back(op);
+                }
+                break;
+
+            case CMD_UPDATE_CONSTANT_BUFFER:
+                {
+                    auto cmd = reinterpret_cast<ImCmdUpdateConstantBuffer*>(pCmd);
+
+                    auto pWrapBuffer = static_cast<Buffer*>(cmd->pBuffer);
+                    if (pWrapBuffer == nullptr)
+                    {
+                        Reset();
+                        return false;
+                    }
+
+                    op.Type    = OP_UPDATE_CONSTANT_BUFFER;
+                    op.pObject = pWrapBuffer->GetD3D11Buffer();
+                    op.pData   = ImCmdPayload(cmd);
+                    op.Args[0] = static_cast<uint32_t>(cmd->Offset);
+                    op.Args[1] = static_cast<uint32_t>(cmd->Size);
+                    op.Args[2] = static_cast<uint32_t>(pWrapBuffer->GetDesc().Size);
+                    m_Ops.push_back(op);
+                }
+                break;
+
+            default:
+                {
+                    // フレームバッファ・ビューポート・バリア・コピー・クエリなどはバンドルでは使用できない.
+                    Reset();
+                    return false;
+                }
+            }
+
+            pCmd += pBase->CmdSize;
+        }
+    }
+
+    m_IsCompiled = true;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      変換結果を破棄します.
+//-------------------------------------------------------------------------------------------------
+void Bundle::Reset()
+{
+    // 再変換に備えて容量は維持する.
+    m_Ops          .clear();
+    m_VertexBuffers.clear();
+    m_Strides      .clear();
+    m_Offsets      .clear();
+    m_IsCompiled = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      変換済みのネイティブ呼び出し列を実行します.
+//-------------------------------------------------------------------------------------------------
+void Bundle::Execute
+(
+    ID3D11DeviceContext*    pDeviceContext,
+    float                   blendFactor[4],
+    uint32_t*               pStencilRef
+) const
+{
+    A3D_ASSERT(m_IsCompiled);
+
+    for(auto& op : m_Ops)
+    {
+        switch(op.Type)
+        {
+        case OP_SET_BLEND_CONSTANT:
+            { memcpy(blendFactor, op.Args, sizeof(float) * 4); }
+            break;
+
+        case OP_SET_STENCIL_REFERENCE:
+            { *pStencilRef = op.Args[0]; }
+            break;
+
+        case OP_SET_PIPELINE_STATE:
+            {
+                auto pPipelineState = static_cast<PipelineState*>(op.pObject);
+                pPipelineState->Bind(pDeviceContext, blendFactor, *pStencilRef);
+            }
+            break;
+
+        case OP_SET_CONSTANT_BUFFER:
+            {
+                SetConstantBuffer(
+                    pDeviceContext,
+                    op.Args[0],
+                    op.Args[1],
+                    static_cast<ID3D11Buffer*>(op.pObject));
+            }
+            break;
+
+        case OP_SET_SHADER_RESOURCE:
+            {
+                SetShaderResource(
+                    pDeviceContext,
+                    op.Args[0],
+                    op.Args[1],
+                    static_cast<ID3D11ShaderResourceView*>(op.pObject));
+            }
+            break;
+
+        case OP_SET_SAMPLER:
+            {
+                SetSampler(
+                    pDeviceContext,
+                    op.Args[0],
+                    op.Args[1],
+                    static_cast<ID3D11SamplerState*>(op.pObject));
+            }
+            break;
+
+        case OP_SET_UNORDERED_ACCESS_VIEW:
+            {
+                auto pUAV = static_cast<ID3D11UnorderedAccessView*>(op.pObject);
+                pDeviceContext->CSSetUnorderedAccessViews(op.Args[1], 1, &pUAV, nullptr);
+            }
+            break;
+
+        case OP_UPDATE_BUFFER_VIEW:
+            {
+                auto pWrapView = static_cast<BufferView*>(op.pObject);
+                pWrapView->UpdateSubsource(pDeviceContext);
+            }
+            break;
+
+        case OP_SET_VERTEX_BUFFERS:
+            {
+                auto index = op.Args[2];
+                pDeviceContext->IASetVertexBuffers(
+                    op.Args[0],
+                    op.Args[1],
+                    &m_VertexBuffers[index],
+                    &m_Strides[index],
+                    &m_Offsets[index]);
+            }
+            break;
+
+        case OP_SET_INDEX_BUFFER:
+            {
+                pDeviceContext->IASetIndexBuffer(
+                    static_cast<ID3D11Buffer*>(op.pObject),
+                    static_cast<DXGI_FORMAT>(op.Args[0]),
+                    op.Args[1]);
+            }
+            break;
+
+        case OP_DRAW_INSTANCED:
+            {
+                pDeviceContext->DrawInstanced(
+                    op.Args[0],
+                    op.Args[1],
+                    op.Args[2],
+                    op.Args[3]);
+            }
+            break;
+
+        case OP_DRAW_INDEXED_INSTANCED:
+            {
+                pDeviceContext->DrawIndexedInstanced(
+                    op.Args[0],
+                    op.Args[1],
+                    op.Args[2],
+                    static_cast<int>(op.Args[3]),
+                    op.Args[4]);
+            }
+            break;
+
+        case OP_DISPATCH:
+            {
+                pDeviceContext->Dispatch(
+                    op.Args[0],
+                    op.Args[1],
+                    op.Args[2]);
+            }
+            break;
+
+        case OP_UPDATE_CONSTANT_BUFFER:
+            {
+                D3D11_BOX box = {};
+                box.left     = op.Args[0];
+                box.right    = op.Args[1];
+                box.top      = 0;
+                box.bottom   = 1;
+                box.front    = 0;
+                box.back     = 1;
+
+                pDeviceContext->UpdateSubresource(
+                    static_cast<ID3D11Buffer*>(op.pObject),
+                    0,
+                    &box,
+                    op.pData,
+                    op.Args[2],
+                    1);
+            }
+            break;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      変換済みかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool Bundle::IsCompiled() const
+{ return m_IsCompiled; }
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタセットの設定をステージ毎の呼び出しに展開します.
+//-------------------------------------------------------------------------------------------------
+void Bundle::CompileDescriptorSet(const ImCmdSetDescriptorSet* pCmd)
+{
+    auto pDescriptors = reinterpret_cast<void* const*>(
+        ImCmdPayload(const_cast<ImCmdSetDescriptorSet*>(pCmd)));
+
+    for(auto i=0u; i<pCmd->pDesc->EntryCount; ++i)
+    {
+        auto& entry = pCmd->pDesc->Entries[i];
+
+        // ネイティブオブジェクトは変換時に一度だけ解決する.
+        Op op = {};
+        switch(entry.Type)
+        {
+        case DESCRIPTOR_TYPE_CBV:
+            {
+                op.Type    = OP_SET_CONSTANT_BUFFER;
+                op.pObject = static_cast<BufferView*>(pDescriptors[i])->GetD3D11Buffer();
+            }
+            break;
+
+        case DESCRIPTOR_TYPE_SRV:
+            {
+                op.Type    = OP_SET_SHADER_RESOURCE;
+                op.pObject = static_cast<TextureView*>(pDescriptors[i])->GetD3D11ShaderResourceView();
+            }
+            break;
+
+        case DESCRIPTOR_TYPE_SMP:
+            {
+                op.Type    = OP_SET_SAMPLER;
+                op.pObject = static_cast<Sampler*>(pDescriptors[i])->GetD3D11SamplerState();
+            }
+            break;
+
+        case DESCRIPTOR_TYPE_UAV:
+            {
+                op.Type    = OP_SET_UNORDERED_ACCESS_VIEW;
+                op.pObject = static_cast<UnorderedAccessView*>(pDescriptors[i])->GetD3D11UnorderedAccessView();
+            }
+            break;
+
+        default:
+            continue;
+        }
+
+        for(auto j=0u; j<sizeof(g_BindStages) / sizeof(g_BindStages[0]); ++j)
+        {
+            auto stage = g_BindStages[j];
+            if ((entry.ShaderMask & stage) == 0)
+            { continue; }
+
+            // アンオーダードアクセスビューはコンピュートシェーダのみ設定する.
+            if (op.Type == OP_SET_UNORDERED_ACCESS_VIEW && stage != SHADER_MASK_COMPUTE)
+            { continue; }
+
+            op.Args[0] = stage;
+            op.Args[1] = entry.ShaderRegister;
+            m_Ops.push_back(op);
+        }
+
+        if (entry.Type == DESCRIPTOR_TYPE_CBV)
+        {
+            Op update = {};
+            update.Type    = OP_UPDATE_BUFFER_VIEW;
+            update.pObject = pDescriptors[i];
+            m_Ops.push_back(update);
+        }
+    }
+}
+
+} // namespace a3d
@@ -0,0 +1,136 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dBundle.h
+// Desc : Pre-Baked Bundle Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+class PipelineState;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Bundle class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class Bundle : public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    Bundle();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~Bundle();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コマンドバッファを解析し, ネイティブ呼び出し列に変換します.
+    //!
+    //! @param[in]      pBuffer     閉じられたバンドルのコマンドバッファです.
+    //! @retval true    変換に成功.
+    //! @retval false   バンドルで使用できないコマンドが含まれているため変換できません.
+    //! @note       定数バッファの更新データはコマンドバッファを直接参照するため,
+    //!             コマンドバッファをリセットするまでの間のみ有効です.
+    //---------------------------------------------------------------------------------------------
+    bool Compile(const CommandBuffer* pBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      変換結果を破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      変換済みのネイティブ呼び出し列を実行します.
+    //!
+    //! @param[in]      pDeviceContext      デバイスコンテキストです.
+    //! @param[in,out]  blendFactor         ブレンド定数です. バンドル内の設定が反映されます.
+    //! @param[in,out]  pStencilRef         ステンシル参照値です. バンドル内の設定が反映されます.
+    //---------------------------------------------------------------------------------------------
+    void Execute(
+        ID3D11DeviceContext*    pDeviceContext,
+        float                   blendFactor[4],
+        uint32_t*               pStencilRef) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      変換済みかどうかチェックします.
+    //!
+    //! @retval true    変換済みです.
+    //! @retval false   未変換です.
+    //---------------------------------------------------------------------------------------------
+    bool IsCompiled() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // OP_TYPE enum
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    enum OP_TYPE
+    {
+        OP_SET_BLEND_CONSTANT,          //!< ブレンド定数の設定です.
+        OP_SET_STENCIL_REFERENCE,       //!< ステンシル参照値の設定です.
+        OP_SET_PIPELINE_STATE,          //!< パイプラインステートの設定です.
+        OP_SET_CONSTANT_BUFFER,         //!< 定数バッファの設定です.
+        OP_SET_SHADER_RESOURCE,         //!< シェーダリソースビューの設定です.
+        OP_SET_SAMPLER,                 //!< サンプラーの設定です.
+        OP_SET_UNORDERED_ACCESS_VIEW,   //!< アンオーダードアクセスビューの設定です.
+        OP_UPDATE_BUFFER_VIEW,          //!< バッファビューの内容の転送です.
+        OP_SET_VERTEX_BUFFERS,          //!< 頂点バッファの設定です.
+        OP_SET_INDEX_BUFFER,            //!< インデックスバッファの設定です.
+        OP_DRAW_INSTANCED,              //!< インスタンス描画です.
+        OP_DRAW_INDEXED_INSTANCED,      //!< インデックス付きインスタンス描画です.
+        OP_DISPATCH,                    //!< ディスパッチです.
+        OP_UPDATE_CONSTANT_BUFFER,      //!< 定数バッファの更新です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Op structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Op
+    {
+        OP_TYPE         Type;       //!< 呼び出しの種類です.
+        uint32_t        Args[5];    //!< 呼び出し引数です.
+        void*           pObject;    //!< 解決済みのネイティブオブジェクトです.
+        const void*     pData;      //!< 付随データです.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::vector<Op, StdAllocator<Op>>                       m_Ops;              //!< ネイティブ呼び出し列です.
+    std::vector<ID3D11Buffer*, StdAllocator<ID3D11Buffer*>> m_VertexBuffers;    //!< 頂点バッファです.
+    std::vector<uint32_t, StdAllocator<uint32_t>>           m_Strides;          //!< 頂点ストライドです.
+    std::vector<uint32_t, StdAllocator<uint32_t>>           m_Offsets;          //!< 頂点オフセットです.
+    bool                                                    m_IsCompiled;       //!< 変換済みかどうか?
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタセットの設定をステージ毎の呼び出しに展開します.
+    //!
+    //! @param[in]      pCmd        ディスクリプタセット設定コマンドです.
+    //---------------------------------------------------------------------------------------------
+    void CompileDescriptorSet(const ImCmdSetDescriptorSet* pCmd);
+
+    Bundle          (const Bundle&) = delete;
+    void operator = (const Bundle&) = delete;
+};
+
+} // namespace a3d
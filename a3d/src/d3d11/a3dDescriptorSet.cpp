@@ -142,12 +142,17 @@ void DescriptorSet::SetSampler(uint32_t index, ISampler* const pSampler)
 //-------------------------------------------------------------------------------------------------
 void DescriptorSet::MakeCommand(ImCmdSetDescriptorSet* pCmd)
 {
-    pCmd->Type = CMD_SET_DESCRIPTORSET;
+    // コマンドは呼び出し側でディスクリプタ数分のペイロードを付けて確保済み.
     pCmd->pDesc = m_pLayoutDesc;
-    for(auto i=0u; i<m_pLayoutDesc->EntryCount; ++i)
-    { pCmd->pDescriptor[i] = m_pDescriptors[i]; }
+    memcpy(ImCmdPayload(pCmd), m_pDescriptors, sizeof(void*) * m_pLayoutDesc->EntryCount);
 }
 
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタ数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t DescriptorSet::GetDescriptorCount() const
+{ return m_pLayoutDesc->EntryCount; }
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
@@ -107,6 +107,13 @@ public:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY MakeCommand(ImCmdSetDescriptorSet* pCmd);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタ数を取得します.
+    //!
+    //! @return     コマンドに格納するディスクリプタ数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetDescriptorCount() const;
+
 private:
     //=============================================================================================
     // private variables.
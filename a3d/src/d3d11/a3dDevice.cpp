@@ -37,6 +37,7 @@ Device::Device()
 , m_pOutput         (nullptr)
 , m_pDevice         (nullptr)
 , m_pDeviceContext  (nullptr)
+, m_pCommandChunkPool(nullptr)
 #if defined(A3D_FOR_WINDOWS10)
 , m_pFactory5       (nullptr)
 , m_pAdapter3       (nullptr)
@@ -132,6 +133,13 @@ bool Device::Init(const DeviceDesc* pDesc)
         { return false; }
     }
 
+    m_pCommandChunkPool = new CommandChunkPool();
+    if (m_pCommandChunkPool == nullptr)
+    { return false; }
+
+    if (!m_pCommandChunkPool->Init(CommandChunkPool::DefaultChunkSize))
+    { return false; }
+
     if (!Queue::Create(
         this,
         COMMANDLIST_TYPE_DIRECT,
@@ -203,6 +211,7 @@ void Device::Term()
     SafeRelease(m_pGraphicsQueue);
     SafeRelease(m_pComputeQueue);
     SafeRelease(m_pCopyQueue);
+    SafeDelete(m_pCommandChunkPool);
     SafeRelease(m_pDeviceContext);
     SafeRelease(m_pDevice);
 
@@ -428,6 +437,12 @@ ID3D11Device* Device::GetD3D11Device() const
 ID3D11DeviceContext* Device::GetD3D11DeviceContext() const
 { return m_pDeviceContext; }
 
+//-------------------------------------------------------------------------------------------------
+//      コマンドチャンクプールを取得します.
+//-------------------------------------------------------------------------------------------------
+CommandChunkPool* Device::GetCommandChunkPool() const
+{ return m_pCommandChunkPool; }
+
 //-------------------------------------------------------------------------------------------------
 //      DXGIファクトリーを取得します.
 //-------------------------------------------------------------------------------------------------
@@ -319,6 +319,13 @@ public:
     //---------------------------------------------------------------------------------------------
     ID3D11DeviceContext* A3D_APIENTRY GetD3D11DeviceContext() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コマンドチャンクプールを取得します.
+    //!
+    //! @return     コマンドリスト間で共有するコマンドチャンクプールを返却します.
+    //---------------------------------------------------------------------------------------------
+    CommandChunkPool* A3D_APIENTRY GetCommandChunkPool() const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      DXGIファクトリー3を取得します.
     //!
@@ -390,6 +397,7 @@ private:
     ID3D11DeviceContext*    m_pDeviceContext;       //!< デバイスコンテキストです.
     D3D_FEATURE_LEVEL       m_FeatureLevel;         //!< 機能レベル.
     uint64_t                m_TimeStampFrequency;   //!< GPUタイムスタンプの更新頻度(Hz単位)です.
+    CommandChunkPool*       m_pCommandChunkPool;    //!< コマンドチャンクプールです.
 #if defined(A3D_FOR_WINDOWS10)
     IDXGIFactory5*          m_pFactory5;            //!< ファクトリ5です.
     IDXGIAdapter4*          m_pAdapter3;            //!< アダプター3です.
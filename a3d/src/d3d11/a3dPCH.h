@@ -16,6 +16,7 @@
 #include <cassert>
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 #if defined(A3D_FOR_WINDOWS10)
 #include <d3d11_4.h>
@@ -49,6 +50,7 @@
 #include "a3dDescriptorSet.h"
 #include "a3dPipelineState.h"
 #include "a3dQueryPool.h"
+#include "a3dBundle.h"
 
 #ifndef A3D_ASSERT
     #if defined(DEBUG) || defined(_DEBUG)
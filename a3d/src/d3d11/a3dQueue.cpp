@@ -29,6 +29,7 @@ Queue::Queue()
 , m_MaxSubmitCount  (0)
 , m_SubmitIndex     (0)
 , m_Frequency       (0)
+, m_ElidedCallCount (0)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -210,986 +211,991 @@ void Queue::ParseCmd()
     auto pDeviceContext = m_pDevice->GetD3D11DeviceContext();
     A3D_ASSERT(pDeviceContext != nullptr);
 
-    bool end = false;
     FrameBuffer*     pActiveFrameBuffer   = nullptr;
     DescriptorSet*   pActiveDescriptorSet = nullptr;
     float            blendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
     uint32_t         stencilRef     = 0;
 
+    // 同じ設定のデバイスコンテキスト呼び出しを省略するためのキャッシュです.
+    PipelineState*   pBoundPipelineState = nullptr;
+    Buffer*          pBoundIndexBuffer   = nullptr;
+    uint64_t         boundIndexOffset    = 0;
+
     for(auto i=0u; i<m_SubmitIndex; ++i)
     {
-        auto pCmd = m_pCommandLists[i]->GetCommandBuffer()->GetBuffer();
+        auto pBuffer  = m_pCommandLists[i]->GetCommandBuffer();
+        auto pSegment = pBuffer->GetSegments();
+        auto count    = pBuffer->GetSegmentCount();
 
-        while(pCmd != m_pCommandLists[i]->GetCommandBuffer()->GetCmdPtr() || !end)
+        // コマンドはチャンク単位のセグメントに分かれて記録されているので, 順に辿る.
+        for(auto j=0u; j<count; ++j)
         {
-            auto type = reinterpret_cast<ImCmdBase*>(pCmd)->Type; 
+            auto pCmd = const_cast<uint8_t*>(pSegment[j].pBegin);
+            auto pEnd = pSegment[j].pEnd;
 
-            // 中間コマンドからネイティブに変換します.
-            switch(type)
+            while(pCmd < pEnd)
             {
-            case CMD_BEGIN:
-                {
-                    auto cmd = reinterpret_cast<ImCmdBegin*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-                    pCmd += sizeof(ImCmdBegin);
-                }
-                break;
+                auto pBase = reinterpret_cast<ImCmdBase*>(pCmd);
+                auto type  = pBase->Type;
 
-            case CMD_SUB_BEGIN:
+                // 中間コマンドからネイティブに変換します.
+                switch(type)
                 {
-                    auto cmd = reinterpret_cast<ImCmdBegin*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-                    /* DO_NOTHING */
-                    pCmd += sizeof(ImCmdBegin);
-                }
-                break;
+                case CMD_BEGIN:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdBegin*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+                    }
+                    break;
 
-            case CMD_BEGIN_FRAME_BUFFER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdBeginFrameBuffer*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                case CMD_SUB_BEGIN:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdBegin*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+                        /* DO_NOTHING */
+                    }
+                    break;
 
-                    pActiveFrameBuffer = static_cast<FrameBuffer*>(cmd->pFrameBuffer);
-                    if (pActiveFrameBuffer != nullptr)
-                    { pActiveFrameBuffer->Bind(pDeviceContext); }
-                    else
+                case CMD_BEGIN_FRAME_BUFFER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdBeginFrameBuffer*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+
+                        pActiveFrameBuffer = static_cast<FrameBuffer*>(cmd->pFrameBuffer);
+                        if (pActiveFrameBuffer != nullptr)
+                        { pActiveFrameBuffer->Bind(pDeviceContext); }
+                        else
+                        {
+                            ID3D11RenderTargetView* pNullRTVs[] = {
+                                nullptr, nullptr, nullptr, nullptr,
+                                nullptr, nullptr, nullptr, nullptr
+                            };
+                            pDeviceContext->OMSetRenderTargets(8, pNullRTVs, nullptr);
+                            pActiveFrameBuffer = nullptr;
+                        }
+                    }
+                    break;
+
+                case CMD_END_FRAME_BUFFER:
                     {
                         ID3D11RenderTargetView* pNullRTVs[] = {
                             nullptr, nullptr, nullptr, nullptr,
                             nullptr, nullptr, nullptr, nullptr
                         };
                         pDeviceContext->OMSetRenderTargets(8, pNullRTVs, nullptr);
-                        pActiveFrameBuffer = nullptr;
                     }
+                    break;
 
-                    pCmd += sizeof(ImCmdBeginFrameBuffer);
-                }
-                break;
-
-            case CMD_END_FRAME_BUFFER:
-                {
-                    ID3D11RenderTargetView* pNullRTVs[] = {
-                        nullptr, nullptr, nullptr, nullptr,
-                        nullptr, nullptr, nullptr, nullptr
-                    };
-                    pDeviceContext->OMSetRenderTargets(8, pNullRTVs, nullptr);
-                    pCmd += sizeof(ImCmdBase);
-                }
-                break;
-
-            case CMD_CLEAR_FRAME_BUFFER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdClearFrameBuffer*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-
-                    if (pActiveFrameBuffer != nullptr)
+                case CMD_CLEAR_FRAME_BUFFER:
                     {
-                        pActiveFrameBuffer->Clear(
-                            pDeviceContext,
-                            cmd->ClearColorCount,
-                            cmd->ClearColors,
-                            ((cmd->HasDepth) ? &cmd->ClearDepthStencil : nullptr));
-                    }
+                        auto cmd = reinterpret_cast<ImCmdClearFrameBuffer*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pCmd += sizeof(ImCmdClearFrameBuffer);
-                }
-                break;
-
-            case CMD_SET_BLEND_CONSTANT:
-                {
-                    auto cmd = reinterpret_cast<ImCmdSetBlendConstant*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        if (pActiveFrameBuffer != nullptr)
+                        {
+                            pActiveFrameBuffer->Clear(
+                                pDeviceContext,
+                                cmd->ClearColorCount,
+                                reinterpret_cast<ClearColorValue*>(ImCmdPayload(cmd)),
+                                ((cmd->HasDepth) ? &cmd->ClearDepthStencil : nullptr));
+                        }
+                    }
+                    break;
 
-                    memcpy( blendFactor, cmd->BlendConstant, sizeof(blendFactor) );
+                case CMD_SET_BLEND_CONSTANT:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdSetBlendConstant*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pCmd += sizeof(ImCmdSetBlendConstant);
-                }
-                break;
+                        memcpy( blendFactor, cmd->BlendConstant, sizeof(blendFactor) );
 
-            case CMD_SET_STENCIL_REFERENCE:
-                {
-                    auto cmd = reinterpret_cast<ImCmdSetStencilReference*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        // パイプラインステート設定時に反映されるので, 次の設定は省略できない.
+                        pBoundPipelineState = nullptr;
+                    }
+                    break;
 
-                    stencilRef = cmd->StencilReference;
+                case CMD_SET_STENCIL_REFERENCE:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdSetStencilReference*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pCmd += sizeof(ImCmdSetStencilReference);
-                }
-                break;
+                        stencilRef = cmd->StencilReference;
 
-            case CMD_SET_VIEWPORTS:
-                {
-                    auto cmd = reinterpret_cast<ImCmdSetViewports*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        // パイプラインステート設定時に反映されるので, 次の設定は省略できない.
+                        pBoundPipelineState = nullptr;
+                    }
+                    break;
 
-                    D3D11_VIEWPORT viewports[16];
-                    for(auto i=0u; i<cmd->Count; ++i)
+                case CMD_SET_VIEWPORTS:
                     {
-                        viewports[i].TopLeftX   = cmd->Viewports[i].X;
-                        viewports[i].TopLeftY   = cmd->Viewports[i].Y;
-                        viewports[i].Width      = cmd->Viewports[i].Width;
-                        viewports[i].Height     = cmd->Viewports[i].Height;
-                        viewports[i].MinDepth   = cmd->Viewports[i].MinDepth;
-                        viewports[i].MaxDepth   = cmd->Viewports[i].MaxDepth;
-                    }
+                        auto cmd = reinterpret_cast<ImCmdSetViewports*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pDeviceContext->RSSetViewports(cmd->Count, viewports);
+                        auto pViewports = reinterpret_cast<Viewport*>(ImCmdPayload(cmd));
 
-                    pCmd += sizeof(ImCmdSetViewports);
-                }
-                break;
+                        D3D11_VIEWPORT viewports[16];
+                        for(auto i=0u; i<cmd->Count; ++i)
+                        {
+                            viewports[i].TopLeftX   = pViewports[i].X;
+                            viewports[i].TopLeftY   = pViewports[i].Y;
+                            viewports[i].Width      = pViewports[i].Width;
+                            viewports[i].Height     = pViewports[i].Height;
+                            viewports[i].MinDepth   = pViewports[i].MinDepth;
+                            viewports[i].MaxDepth   = pViewports[i].MaxDepth;
+                        }
 
-            case CMD_SET_SCISSORS:
-                {
-                    auto cmd = reinterpret_cast<ImCmdSetScissors*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        pDeviceContext->RSSetViewports(cmd->Count, viewports);
+                    }
+                    break;
 
-                    D3D11_RECT rects[16];
-                    for(auto i=0u; i<cmd->Count; ++i)
+                case CMD_SET_SCISSORS:
                     {
-                        rects[i].left   = cmd->Rects[i].Offset.X;
-                        rects[i].right  = cmd->Rects[i].Offset.X + cmd->Rects[i].Extent.Width;
-                        rects[i].top    = cmd->Rects[i].Offset.Y;
-                        rects[i].bottom = cmd->Rects[i].Offset.Y + cmd->Rects[i].Extent.Height;
-                    }
+                        auto cmd = reinterpret_cast<ImCmdSetScissors*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pDeviceContext->RSSetScissorRects(cmd->Count, rects);
+                        auto pRects = reinterpret_cast<Rect*>(ImCmdPayload(cmd));
 
-                    pCmd += sizeof(ImCmdSetScissors);
-                }
-                break;
+                        D3D11_RECT rects[16];
+                        for(auto i=0u; i<cmd->Count; ++i)
+                        {
+                            rects[i].left   = pRects[i].Offset.X;
+                            rects[i].right  = pRects[i].Offset.X + pRects[i].Extent.Width;
+                            rects[i].top    = pRects[i].Offset.Y;
+                            rects[i].bottom = pRects[i].Offset.Y + pRects[i].Extent.Height;
+                        }
 
-            case CMD_SET_PIPELINESTATE:
-                {
-                    auto cmd = reinterpret_cast<ImCmdSetPipelineState*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        pDeviceContext->RSSetScissorRects(cmd->Count, rects);
+                    }
+                    break;
 
-                    auto pPipelineState = static_cast<PipelineState*>(cmd->pPipelineState);
-                    pPipelineState->Bind(pDeviceContext, blendFactor, stencilRef);
+                case CMD_SET_PIPELINESTATE:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdSetPipelineState*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pCmd += sizeof(ImCmdSetPipelineState);
-                }
-                break;
+                        auto pPipelineState = static_cast<PipelineState*>(cmd->pPipelineState);
+                        if (pPipelineState == pBoundPipelineState)
+                        {
+                            m_ElidedCallCount++;
+                            break;
+                        }
 
-            case CMD_SET_DESCRIPTORSET:
-                {
-                    auto cmd = reinterpret_cast<ImCmdSetDescriptorSet*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        pPipelineState->Bind(pDeviceContext, blendFactor, stencilRef);
+                        pBoundPipelineState = pPipelineState;
+                    }
+                    break;
 
-                    for(auto i=0u; i<cmd->pDesc->EntryCount; ++i)
+                case CMD_SET_DESCRIPTORSET:
                     {
-                        auto& entry = cmd->pDesc->Entries[i];
+                        auto cmd = reinterpret_cast<ImCmdSetDescriptorSet*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                        if (entry.ShaderMask & SHADER_MASK_VERTEX)
-                        {
-                            switch(entry.Type)
-                            {
-                            case DESCRIPTOR_TYPE_CBV:
-                                {
-                                    auto pWrapView = static_cast<a3d::BufferView*>(cmd->pDescriptor[i]);
-                                    auto pCBV = pWrapView->GetD3D11Buffer();
-                                    pDeviceContext->VSSetConstantBuffers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pCBV);
-                                }
-                                break;
+                        auto pDescriptors = reinterpret_cast<void**>(ImCmdPayload(cmd));
 
-                            case DESCRIPTOR_TYPE_SRV:
-                                {
-                                    auto pWrapView = static_cast<a3d::TextureView*>(cmd->pDescriptor[i]);
-                                    auto pSRV = pWrapView->GetD3D11ShaderResourceView();
-                                    pDeviceContext->VSSetShaderResources(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSRV);
-                                }
-                                break;
+                        for(auto i=0u; i<cmd->pDesc->EntryCount; ++i)
+                        {
+                            auto& entry = cmd->pDesc->Entries[i];
 
-                            case DESCRIPTOR_TYPE_SMP:
+                            if (entry.ShaderMask & SHADER_MASK_VERTEX)
+                            {
+                                switch(entry.Type)
                                 {
-                                    auto pWrapSmp = static_cast<a3d::Sampler*>(cmd->pDescriptor[i]);
-                                    auto pSmp = pWrapSmp->GetD3D11SamplerState();
-                                    pDeviceContext->VSSetSamplers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSmp);
+                                case DESCRIPTOR_TYPE_CBV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::BufferView*>(pDescriptors[i]);
+                                        auto pCBV = pWrapView->GetD3D11Buffer();
+                                        pDeviceContext->VSSetConstantBuffers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pCBV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SRV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::TextureView*>(pDescriptors[i]);
+                                        auto pSRV = pWrapView->GetD3D11ShaderResourceView();
+                                        pDeviceContext->VSSetShaderResources(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSRV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SMP:
+                                    {
+                                        auto pWrapSmp = static_cast<a3d::Sampler*>(pDescriptors[i]);
+                                        auto pSmp = pWrapSmp->GetD3D11SamplerState();
+                                        pDeviceContext->VSSetSamplers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSmp);
+                                    }
+                                    break;
                                 }
-                                break;
                             }
-                        }
-                        
-                        if (entry.ShaderMask & SHADER_MASK_DOMAIN)
-                        {
-                            switch(entry.Type)
+                            
+                            if (entry.ShaderMask & SHADER_MASK_DOMAIN)
                             {
-                            case DESCRIPTOR_TYPE_CBV:
+                                switch(entry.Type)
                                 {
-                                    auto pWrapView = static_cast<a3d::BufferView*>(cmd->pDescriptor[i]);
-                                    auto pCBV = pWrapView->GetD3D11Buffer();
-                                    pDeviceContext->DSSetConstantBuffers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pCBV);
+                                case DESCRIPTOR_TYPE_CBV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::BufferView*>(pDescriptors[i]);
+                                        auto pCBV = pWrapView->GetD3D11Buffer();
+                                        pDeviceContext->DSSetConstantBuffers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pCBV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SRV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::TextureView*>(pDescriptors[i]);
+                                        auto pSRV = pWrapView->GetD3D11ShaderResourceView();
+                                        pDeviceContext->DSSetShaderResources(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSRV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SMP:
+                                    {
+                                        auto pWrapSmp = static_cast<a3d::Sampler*>(pDescriptors[i]);
+                                        auto pSmp = pWrapSmp->GetD3D11SamplerState();
+                                        pDeviceContext->DSSetSamplers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSmp);
+                                    }
+                                    break;
                                 }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SRV:
-                                {
-                                    auto pWrapView = static_cast<a3d::TextureView*>(cmd->pDescriptor[i]);
-                                    auto pSRV = pWrapView->GetD3D11ShaderResourceView();
-                                    pDeviceContext->DSSetShaderResources(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSRV);
-                                }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SMP:
-                                {
-                                    auto pWrapSmp = static_cast<a3d::Sampler*>(cmd->pDescriptor[i]);
-                                    auto pSmp = pWrapSmp->GetD3D11SamplerState();
-                                    pDeviceContext->DSSetSamplers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSmp);
-                                }
-                                break;
                             }
-                        }
 
-                        if (entry.ShaderMask & SHADER_MASK_GEOMETRY)
-                        {
-                            switch(entry.Type)
+                            if (entry.ShaderMask & SHADER_MASK_GEOMETRY)
                             {
-                            case DESCRIPTOR_TYPE_CBV:
+                                switch(entry.Type)
                                 {
-                                    auto pWrapView = static_cast<a3d::BufferView*>(cmd->pDescriptor[i]);
-                                    auto pCBV = pWrapView->GetD3D11Buffer();
-                                    pDeviceContext->GSSetConstantBuffers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pCBV);
+                                case DESCRIPTOR_TYPE_CBV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::BufferView*>(pDescriptors[i]);
+                                        auto pCBV = pWrapView->GetD3D11Buffer();
+                                        pDeviceContext->GSSetConstantBuffers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pCBV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SRV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::TextureView*>(pDescriptors[i]);
+                                        auto pSRV = pWrapView->GetD3D11ShaderResourceView();
+                                        pDeviceContext->GSSetShaderResources(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSRV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SMP:
+                                    {
+                                        auto pWrapSmp = static_cast<a3d::Sampler*>(pDescriptors[i]);
+                                        auto pSmp = pWrapSmp->GetD3D11SamplerState();
+                                        pDeviceContext->GSSetSamplers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSmp);
+                                    }
+                                    break;
                                 }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SRV:
-                                {
-                                    auto pWrapView = static_cast<a3d::TextureView*>(cmd->pDescriptor[i]);
-                                    auto pSRV = pWrapView->GetD3D11ShaderResourceView();
-                                    pDeviceContext->GSSetShaderResources(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSRV);
-                                }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SMP:
-                                {
-                                    auto pWrapSmp = static_cast<a3d::Sampler*>(cmd->pDescriptor[i]);
-                                    auto pSmp = pWrapSmp->GetD3D11SamplerState();
-                                    pDeviceContext->GSSetSamplers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSmp);
-                                }
-                                break;
                             }
-                        }
 
-                        if (entry.ShaderMask & SHADER_MASK_HULL)
-                        {
-                            switch(entry.Type)
+                            if (entry.ShaderMask & SHADER_MASK_HULL)
                             {
-                            case DESCRIPTOR_TYPE_CBV:
+                                switch(entry.Type)
                                 {
-                                    auto pWrapView = static_cast<a3d::BufferView*>(cmd->pDescriptor[i]);
-                                    auto pCBV = pWrapView->GetD3D11Buffer();
-                                    pDeviceContext->HSSetConstantBuffers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pCBV);
+                                case DESCRIPTOR_TYPE_CBV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::BufferView*>(pDescriptors[i]);
+                                        auto pCBV = pWrapView->GetD3D11Buffer();
+                                        pDeviceContext->HSSetConstantBuffers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pCBV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SRV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::TextureView*>(pDescriptors[i]);
+                                        auto pSRV = pWrapView->GetD3D11ShaderResourceView();
+                                        pDeviceContext->HSSetShaderResources(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSRV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SMP:
+                                    {
+                                        auto pWrapSmp = static_cast<a3d::Sampler*>(pDescriptors[i]);
+                                        auto pSmp = pWrapSmp->GetD3D11SamplerState();
+                                        pDeviceContext->HSSetSamplers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSmp);
+                                    }
+                                    break;
                                 }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SRV:
-                                {
-                                    auto pWrapView = static_cast<a3d::TextureView*>(cmd->pDescriptor[i]);
-                                    auto pSRV = pWrapView->GetD3D11ShaderResourceView();
-                                    pDeviceContext->HSSetShaderResources(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSRV);
-                                }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SMP:
-                                {
-                                    auto pWrapSmp = static_cast<a3d::Sampler*>(cmd->pDescriptor[i]);
-                                    auto pSmp = pWrapSmp->GetD3D11SamplerState();
-                                    pDeviceContext->HSSetSamplers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSmp);
-                                }
-                                break;
                             }
-                        }
 
-                        if (entry.ShaderMask & SHADER_MASK_PIXEL)
-                        {
-                            switch(entry.Type)
+                            if (entry.ShaderMask & SHADER_MASK_PIXEL)
                             {
-                            case DESCRIPTOR_TYPE_CBV:
-                                {
-                                    auto pWrapView = static_cast<a3d::BufferView*>(cmd->pDescriptor[i]);
-                                    auto pCBV = pWrapView->GetD3D11Buffer();
-                                    pDeviceContext->PSSetConstantBuffers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pCBV);
-                                }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SRV:
+                                switch(entry.Type)
                                 {
-                                    auto pWrapView = static_cast<a3d::TextureView*>(cmd->pDescriptor[i]);
-                                    auto pSRV = pWrapView->GetD3D11ShaderResourceView();
-                                    pDeviceContext->PSSetShaderResources(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSRV);
+                                case DESCRIPTOR_TYPE_CBV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::BufferView*>(pDescriptors[i]);
+                                        auto pCBV = pWrapView->GetD3D11Buffer();
+                                        pDeviceContext->PSSetConstantBuffers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pCBV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SRV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::TextureView*>(pDescriptors[i]);
+                                        auto pSRV = pWrapView->GetD3D11ShaderResourceView();
+                                        pDeviceContext->PSSetShaderResources(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSRV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SMP:
+                                    {
+                                        auto pWrapSmp = static_cast<a3d::Sampler*>(pDescriptors[i]);
+                                        auto pSmp = pWrapSmp->GetD3D11SamplerState();
+                                        pDeviceContext->PSSetSamplers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSmp);
+                                    }
+                                    break;
                                 }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SMP:
-                                {
-                                    auto pWrapSmp = static_cast<a3d::Sampler*>(cmd->pDescriptor[i]);
-                                    auto pSmp = pWrapSmp->GetD3D11SamplerState();
-                                    pDeviceContext->PSSetSamplers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSmp);
-                                }
-                                break;
                             }
-                        }
 
-                        if (entry.ShaderMask & SHADER_MASK_COMPUTE)
-                        {
-                            switch(entry.Type)
+                            if (entry.ShaderMask & SHADER_MASK_COMPUTE)
                             {
-                            case DESCRIPTOR_TYPE_CBV:
-                                {
-                                    auto pWrapView = static_cast<a3d::BufferView*>(cmd->pDescriptor[i]);
-                                    auto pCBV = pWrapView->GetD3D11Buffer();
-                                    pDeviceContext->CSSetConstantBuffers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pCBV);
-                                }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SRV:
+                                switch(entry.Type)
                                 {
-                                    auto pWrapView = static_cast<a3d::TextureView*>(cmd->pDescriptor[i]);
-                                    auto pSRV = pWrapView->GetD3D11ShaderResourceView();
-                                    pDeviceContext->CSSetShaderResources(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSRV);
+                                case DESCRIPTOR_TYPE_CBV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::BufferView*>(pDescriptors[i]);
+                                        auto pCBV = pWrapView->GetD3D11Buffer();
+                                        pDeviceContext->CSSetConstantBuffers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pCBV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SRV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::TextureView*>(pDescriptors[i]);
+                                        auto pSRV = pWrapView->GetD3D11ShaderResourceView();
+                                        pDeviceContext->CSSetShaderResources(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSRV);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_SMP:
+                                    {
+                                        auto pWrapSmp = static_cast<a3d::Sampler*>(pDescriptors[i]);
+                                        auto pSmp = pWrapSmp->GetD3D11SamplerState();
+                                        pDeviceContext->CSSetSamplers(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pSmp);
+                                    }
+                                    break;
+
+                                case DESCRIPTOR_TYPE_UAV:
+                                    {
+                                        auto pWrapView = static_cast<a3d::UnorderedAccessView*>(pDescriptors[i]);
+                                        auto pUAV = pWrapView->GetD3D11UnorderedAccessView();
+                                        pDeviceContext->CSSetUnorderedAccessViews(
+                                            entry.ShaderRegister,
+                                            1,
+                                            &pUAV,
+                                            nullptr);
+                                    }
+                                    break;
                                 }
-                                break;
-
-                            case DESCRIPTOR_TYPE_SMP:
-                                {
-                                    auto pWrapSmp = static_cast<a3d::Sampler*>(cmd->pDescriptor[i]);
-                                    auto pSmp = pWrapSmp->GetD3D11SamplerState();
-                                    pDeviceContext->CSSetSamplers(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pSmp);
-                                }
-                                break;
-
-                            case DESCRIPTOR_TYPE_UAV:
-                                {
-                                    auto pWrapView = static_cast<a3d::UnorderedAccessView*>(cmd->pDescriptor[i]);
-                                    auto pUAV = pWrapView->GetD3D11UnorderedAccessView();
-                                    pDeviceContext->CSGetUnorderedAccessViews(
-                                        entry.ShaderRegister,
-                                        1,
-                                        &pUAV);
-                                }
-                                break;
                             }
-                        }
 
 
-                        if (entry.Type == DESCRIPTOR_TYPE_CBV)
-                        {
-                            auto pWrapView = static_cast<a3d::BufferView*>(cmd->pDescriptor[i]);
-                            pWrapView->UpdateSubsource(pDeviceContext);
+                            if (entry.Type == DESCRIPTOR_TYPE_CBV)
+                            {
+                                auto pWrapView = static_cast<a3d::BufferView*>(pDescriptors[i]);
+                                pWrapView->UpdateSubsource(pDeviceContext);
+                            }
                         }
                     }
+                    break;
 
-                    pCmd += sizeof(ImCmdSetDescriptorSet);
-                }
-                break;
-
-            case CMD_SET_VERTEX_BUFFERS:
-                {
-                    auto cmd = reinterpret_cast<ImCmdSetVertexBuffers*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-
-                    ID3D11Buffer* pBuffers[32];
-                    uint32_t strides[32];
-                    uint32_t offsets[32];
-
-                    for(auto i=0u; i<cmd->Count; ++i)
+                case CMD_SET_VERTEX_BUFFERS:
                     {
-                        auto pWrapBuffer = static_cast<Buffer*>(cmd->pBuffers[i]);
-                        A3D_ASSERT(pWrapBuffer != nullptr);
-
-                        pBuffers[i] = pWrapBuffer->GetD3D11Buffer();
-                        strides [i] = pWrapBuffer->GetDesc().Stride;
-                        offsets [i] = static_cast<uint32_t>(cmd->Offsets[i]);
-                    }
-
-                    pDeviceContext->IASetVertexBuffers(
-                        cmd->StartSlot,
-                        cmd->Count,
-                        pBuffers,
-                        strides,
-                        offsets);
-
-                    pCmd += sizeof(ImCmdSetVertexBuffers);
-                }
-                break;
+                        auto cmd = reinterpret_cast<ImCmdSetVertexBuffers*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-            case CMD_SET_INDEX_BUFFER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdSetIndexBuffer*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        auto ppSrcBuffers = reinterpret_cast<IBuffer**>(ImCmdPayload(cmd));
+                        auto pSrcOffsets  = (cmd->HasOffset)
+                                            ? reinterpret_cast<uint64_t*>(ppSrcBuffers + cmd->Count)
+                                            : nullptr;
 
-                    auto pWrapBuffer = static_cast<Buffer*>(cmd->pBuffer);
-                    auto format = pWrapBuffer->GetDesc().Stride == sizeof(uint16_t)
-                                    ? DXGI_FORMAT_R16_UINT
-                                    : DXGI_FORMAT_R32_UINT;
+                        ID3D11Buffer* pBuffers[32];
+                        uint32_t strides[32];
+                        uint32_t offsets[32];
 
-                    pDeviceContext->IASetIndexBuffer(
-                        pWrapBuffer->GetD3D11Buffer(),
-                        format,
-                        static_cast<uint32_t>(cmd->Offset));
+                        for(auto i=0u; i<cmd->Count; ++i)
+                        {
+                            auto pWrapBuffer = static_cast<Buffer*>(ppSrcBuffers[i]);
+                            A3D_ASSERT(pWrapBuffer != nullptr);
 
-                    pCmd += sizeof(ImCmdSetIndexBuffer);
-                }
-                break;
+                            pBuffers[i] = pWrapBuffer->GetD3D11Buffer();
+                            strides [i] = pWrapBuffer->GetDesc().Stride;
+                            offsets [i] = (pSrcOffsets != nullptr) ? static_cast<uint32_t>(pSrcOffsets[i]) : 0;
+                        }
 
-            case CMD_TEXTURE_BARRIER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdTextureBarrier*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        pDeviceContext->IASetVertexBuffers(
+                            cmd->StartSlot,
+                            cmd->Count,
+                            pBuffers,
+                            strides,
+                            offsets);
+                    }
+                    break;
 
-                    auto pTexture = static_cast<Texture*>(cmd->pResource);
+                case CMD_SET_INDEX_BUFFER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdSetIndexBuffer*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pDeviceContext->Flush();
+                        auto pWrapBuffer = static_cast<Buffer*>(cmd->pBuffer);
+                        if (pWrapBuffer == pBoundIndexBuffer && cmd->Offset == boundIndexOffset)
+                        {
+                            m_ElidedCallCount++;
+                            break;
+                        }
 
-                    pCmd += sizeof(ImCmdTextureBarrier);
-                }
-                break;
+                        pBoundIndexBuffer = pWrapBuffer;
+                        boundIndexOffset  = cmd->Offset;
 
-            case CMD_BUFFER_BARRIER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdBufferBarrier*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        auto format = pWrapBuffer->GetDesc().Stride == sizeof(uint16_t)
+                                        ? DXGI_FORMAT_R16_UINT
+                                        : DXGI_FORMAT_R32_UINT;
 
-                    auto pBuffer = reinterpret_cast<Buffer*>(cmd->pResource);
+                        pDeviceContext->IASetIndexBuffer(
+                            pWrapBuffer->GetD3D11Buffer(),
+                            format,
+                            static_cast<uint32_t>(cmd->Offset));
+                    }
+                    break;
 
-                    pDeviceContext->Flush();
+                case CMD_TEXTURE_BARRIER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdTextureBarrier*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pCmd += sizeof(ImCmdBufferBarrier);
-                }
-                break;
+                        auto pTexture = static_cast<Texture*>(cmd->pResource);
 
-            case CMD_DRAW_INSTANCED:
-                {
-                    auto cmd = reinterpret_cast<ImCmdDrawInstanced*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        pDeviceContext->Flush();
+                    }
+                    break;
 
-                    pDeviceContext->DrawInstanced(
-                        cmd->VertexCount,
-                        cmd->InstanceCount,
-                        cmd->FirstVertex,
-                        cmd->FirstInstance);
+                case CMD_BUFFER_BARRIER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdBufferBarrier*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pCmd += sizeof(ImCmdDrawIndexedInstanced);
-                }
-                break;
+                        auto pBuffer = reinterpret_cast<Buffer*>(cmd->pResource);
 
-            case CMD_DRAW_INDEXED_INSTANCED:
-                {
-                    auto cmd = reinterpret_cast<ImCmdDrawIndexedInstanced*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        pDeviceContext->Flush();
+                    }
+                    break;
 
-                    pDeviceContext->DrawIndexedInstanced(
-                        cmd->IndexCount,
-                        cmd->InstanceCount,
-                        cmd->FirstIndex,
-                        cmd->VertexOffset,
-                        cmd->FirstInstance);
+                case CMD_DRAW_INSTANCED:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdDrawInstanced*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+
+                        pDeviceContext->DrawInstanced(
+                            cmd->VertexCount,
+                            cmd->InstanceCount,
+                            cmd->FirstVertex,
+                            cmd->FirstInstance);
+                    }
+                    break;
 
-                    pCmd += sizeof(ImCmdDrawIndexedInstanced);
-                }
-                break;
+                case CMD_DRAW_INDEXED_INSTANCED:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdDrawIndexedInstanced*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+
+                        pDeviceContext->DrawIndexedInstanced(
+                            cmd->IndexCount,
+                            cmd->InstanceCount,
+                            cmd->FirstIndex,
+                            cmd->VertexOffset,
+                            cmd->FirstInstance);
+                    }
+                    break;
 
-            case CMD_DISPATCH:
-                {
-                    auto cmd = reinterpret_cast<ImCmdDispatch*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                case CMD_DISPATCH:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdDispatch*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pDeviceContext->Dispatch(
-                        cmd->X,
-                        cmd->Y,
-                        cmd->Z);
+                        pDeviceContext->Dispatch(
+                            cmd->X,
+                            cmd->Y,
+                            cmd->Z);
+                    }
+                    break;
 
-                    pCmd += sizeof(ImCmdDispatch);
-                }
-                break;
 
+                case CMD_DISPATCH_MESH:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdDispatch*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-            case CMD_DISPATCH_MESH:
-                {
-                    auto cmd = reinterpret_cast<ImCmdDispatch*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        /* 対応するコマンドはありません. */
+                        A3D_UNUSED(cmd);
+                    }
+                    break;
 
-                    /* 対応するコマンドはありません. */
-                    A3D_UNUSED(cmd);
+                case CMD_EXECUTE_INDIRECT:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdExecuteIndirect*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pCmd += sizeof(ImCmdDispatch);
-                }
-                break;
+                        auto pWrapCommandSet = static_cast<CommandSet*>(cmd->pCommandSet);
+                        A3D_ASSERT(pWrapCommandSet != nullptr);
 
-            case CMD_EXECUTE_INDIRECT:
-                {
-                    auto cmd = reinterpret_cast<ImCmdExecuteIndirect*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        auto desc = pWrapCommandSet->GetDesc();
 
-                    auto pWrapCommandSet = static_cast<CommandSet*>(cmd->pCommandSet);
-                    A3D_ASSERT(pWrapCommandSet != nullptr);
+                        auto pWrapArgumentBuffer = static_cast<Buffer*>(cmd->pArgumentBuffer);
+                        A3D_ASSERT(pWrapArgumentBuffer != nullptr);
 
-                    auto desc = pWrapCommandSet->GetDesc();
+                        auto pNativeArgumentBuffer = pWrapArgumentBuffer->GetD3D11Buffer();
+                        A3D_ASSERT(pNativeArgumentBuffer != nullptr);
 
-                    auto pWrapArgumentBuffer = static_cast<Buffer*>(cmd->pArgumentBuffer);
-                    A3D_ASSERT(pWrapArgumentBuffer != nullptr);
+                        uint32_t* pCounters = nullptr;
+                        if (cmd->pCounterBuffer != nullptr)
+                        { pCounters = static_cast<uint32_t*>(cmd->pCounterBuffer->Map()); }
 
-                    auto pNativeArgumentBuffer = pWrapArgumentBuffer->GetD3D11Buffer();
-                    A3D_ASSERT(pNativeArgumentBuffer != nullptr);
-
-                    uint32_t* pCounters = nullptr;
-                    if (cmd->pCounterBuffer != nullptr)
-                    { pCounters = static_cast<uint32_t*>(cmd->pCounterBuffer->Map()); }
+                        auto offset = static_cast<uint32_t>(cmd->ArgumentBufferOffset);
+                        for(auto i=0u; i<desc.ArgumentCount; ++i)
+                        {
+                            auto count = cmd->MaxCommandCount;
+                            if (pCounters != nullptr)
+                            { count = (pCounters[i] < cmd->MaxCommandCount ) ? pCounters[i] : cmd->MaxCommandCount; }
 
-                    auto offset = static_cast<uint32_t>(cmd->ArgumentBufferOffset);
-                    for(auto i=0u; i<desc.ArgumentCount; ++i)
-                    {
-                        auto count = cmd->MaxCommandCount;
-                        if (pCounters != nullptr)
-                        { count = (pCounters[i] < cmd->MaxCommandCount ) ? pCounters[i] : cmd->MaxCommandCount; }
+                            switch(desc.pArguments[i])
+                            {
+                            case INDIRECT_ARGUMENT_TYPE_DRAW:
+                                { pDeviceContext->DrawInstancedIndirect(pNativeArgumentBuffer, offset); }
+                                break;
 
-                        switch(desc.pArguments[i])
-                        {
-                        case INDIRECT_ARGUMENT_TYPE_DRAW:
-                            { pDeviceContext->DrawInstancedIndirect(pNativeArgumentBuffer, offset); }
-                            break;
+                            case INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED:
+                                { pDeviceContext->DrawIndexedInstancedIndirect(pNativeArgumentBuffer, offset); }
+                                break;
 
-                        case INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED:
-                            { pDeviceContext->DrawIndexedInstancedIndirect(pNativeArgumentBuffer, offset); }
-                            break;
+                            case INDIRECT_ARGUMENT_TYPE_DISPATCH:
+                                { pDeviceContext->DispatchIndirect(pNativeArgumentBuffer, offset); }
+                                break;
+                            }
 
-                        case INDIRECT_ARGUMENT_TYPE_DISPATCH:
-                            { pDeviceContext->DispatchIndirect(pNativeArgumentBuffer, offset); }
-                            break;
+                            offset += desc.ByteStride;
                         }
-
-                        offset += desc.ByteStride;
                     }
+                    break;
 
-                    pCmd += sizeof(ImCmdExecuteIndirect);
-                }
-                break;
-
-            case CMD_BEGIN_QUERY:
-                {
-                    auto cmd = reinterpret_cast<ImCmdBeginQuery*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                case CMD_BEGIN_QUERY:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdBeginQuery*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    auto pQuery = static_cast<QueryPool*>(cmd->pQuery);
-                    auto pD3D11Query = pQuery->GetD3D11Query(cmd->Index);
+                        auto pQuery = static_cast<QueryPool*>(cmd->pQuery);
+                        auto pD3D11Query = pQuery->GetD3D11Query(cmd->Index);
 
-                    pDeviceContext->Begin(pD3D11Query);
-                    pCmd += sizeof(ImCmdBeginQuery);
-                }
-                break;
-
-            case CMD_END_QUERY:
-                {
-                    auto cmd = reinterpret_cast<ImCmdEndQuery*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        pDeviceContext->Begin(pD3D11Query);
+                    }
+                    break;
 
-                    auto pQuery = static_cast<QueryPool*>(cmd->pQuery);
-                    auto pD3D11Query = pQuery->GetD3D11Query(cmd->Index);
+                case CMD_END_QUERY:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdEndQuery*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pDeviceContext->End(pD3D11Query);
+                        auto pQuery = static_cast<QueryPool*>(cmd->pQuery);
+                        auto pD3D11Query = pQuery->GetD3D11Query(cmd->Index);
 
-                    pCmd += sizeof(ImCmdEndQuery);
-                }
-                break;
+                        pDeviceContext->End(pD3D11Query);
+                    }
+                    break;
 
-            case CMD_RESOLVE_QUERY:
-                {
-                    auto cmd = reinterpret_cast<ImCmdResolveQuery*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                case CMD_RESOLVE_QUERY:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdResolveQuery*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    auto pWrapQuery = static_cast<QueryPool*>(cmd->pQuery);
-                    A3D_ASSERT(pWrapQuery != nullptr);
-                    auto queryType = pWrapQuery->GetDesc().Type;
+                        auto pWrapQuery = static_cast<QueryPool*>(cmd->pQuery);
+                        A3D_ASSERT(pWrapQuery != nullptr);
+                        auto queryType = pWrapQuery->GetDesc().Type;
 
-                    auto pWrapBuffer = static_cast<Buffer*>(cmd->pDstBuffer);
-                    A3D_ASSERT(pWrapBuffer != nullptr);
+                        auto pWrapBuffer = static_cast<Buffer*>(cmd->pDstBuffer);
+                        A3D_ASSERT(pWrapBuffer != nullptr);
 
-                    auto pDstPtr = static_cast<uint8_t*>(pWrapBuffer->Map()) + cmd->DstOffset;
+                        auto pDstPtr = static_cast<uint8_t*>(pWrapBuffer->Map()) + cmd->DstOffset;
 
-                    for(auto i=cmd->StartIndex; i<cmd->QueryCount; ++i)
-                    {
-                        switch(queryType)
+                        for(auto i=cmd->StartIndex; i<cmd->QueryCount; ++i)
                         {
-                        case QUERY_TYPE_OCCLUSION:
+                            switch(queryType)
                             {
-                                UINT64 data = 0;
-                                while( pDeviceContext->GetData(pWrapQuery->GetD3D11Query(i), &data, sizeof(data), 0) != S_OK);
-                                memcpy(pDstPtr, &data, sizeof(data));
-                                pDstPtr += sizeof(data);
-                            }
-                            break;
+                            case QUERY_TYPE_OCCLUSION:
+                                {
+                                    UINT64 data = 0;
+                                    while( pDeviceContext->GetData(pWrapQuery->GetD3D11Query(i), &data, sizeof(data), 0) != S_OK);
+                                    memcpy(pDstPtr, &data, sizeof(data));
+                                    pDstPtr += sizeof(data);
+                                }
+                                break;
 
-                        case QUERY_TYPE_TIMESTAMP:
-                            {
-                                UINT64 data = 0;
-                                while( pDeviceContext->GetData(pWrapQuery->GetD3D11Query(i), &data, sizeof(data), 0) != S_OK);
-                                memcpy(pDstPtr, &data, sizeof(data));
-                                pDstPtr += sizeof(data);
-                            }
-                            break;
+                            case QUERY_TYPE_TIMESTAMP:
+                                {
+                                    UINT64 data = 0;
+                                    while( pDeviceContext->GetData(pWrapQuery->GetD3D11Query(i), &data, sizeof(data), 0) != S_OK);
+                                    memcpy(pDstPtr, &data, sizeof(data));
+                                    pDstPtr += sizeof(data);
+                                }
+                                break;
 
-                        case QUERY_TYPE_PIPELINE_STATISTICS:
-                            {
-                                D3D11_QUERY_DATA_PIPELINE_STATISTICS data = {};
-                                while( pDeviceContext->GetData(pWrapQuery->GetD3D11Query(i), &data, sizeof(data), 0) != S_OK);
-
-                                PipelineStatistics convert = {};
-                                convert.IAVertices              = data.IAVertices;
-                                convert.IAPrimitives            = data.IAPrimitives;
-                                convert.VSInvocations           = data.VSInvocations;
-                                convert.GSInvocations           = data.GSInvocations;
-                                convert.GSPrimitives            = data.GSPrimitives;
-                                convert.RasterizerInvocations   = data.CInvocations;
-                                convert.RenderedPrimitives      = data.CPrimitives;
-                                convert.PSInvocations           = data.PSInvocations;
-                                convert.HSInvocations           = data.HSInvocations;
-                                convert.DSInvocations           = data.DSInvocations;
-                                convert.CSInvocations           = data.CSInvocations;
-
-                                memcpy(pDstPtr, &convert, sizeof(convert));
-                                pDstPtr += sizeof(convert);
+                            case QUERY_TYPE_PIPELINE_STATISTICS:
+                                {
+                                    D3D11_QUERY_DATA_PIPELINE_STATISTICS data = {};
+                                    while( pDeviceContext->GetData(pWrapQuery->GetD3D11Query(i), &data, sizeof(data), 0) != S_OK);
+
+                                    PipelineStatistics convert = {};
+                                    convert.IAVertices              = data.IAVertices;
+                                    convert.IAPrimitives            = data.IAPrimitives;
+                                    convert.VSInvocations           = data.VSInvocations;
+                                    convert.GSInvocations           = data.GSInvocations;
+                                    convert.GSPrimitives            = data.GSPrimitives;
+                                    convert.RasterizerInvocations   = data.CInvocations;
+                                    convert.RenderedPrimitives      = data.CPrimitives;
+                                    convert.PSInvocations           = data.PSInvocations;
+                                    convert.HSInvocations           = data.HSInvocations;
+                                    convert.DSInvocations           = data.DSInvocations;
+                                    convert.CSInvocations           = data.CSInvocations;
+
+                                    memcpy(pDstPtr, &convert, sizeof(convert));
+                                    pDstPtr += sizeof(convert);
+                                }
+                                break;
                             }
-                            break;
                         }
-                    }
-
-                    pWrapBuffer->Unmap();
 
-                    pCmd += sizeof(ImCmdResolveQuery);
-                }
-                break;
-
-            case CMD_RESET_QUERY:
-                {
-                    /* DO_NOTHING */
-                    pCmd += sizeof(ImCmdResetQuery);
-                }
-                break;
-        
-            case CMD_COPY_TEXTURE:
-                {
-                    auto cmd = reinterpret_cast<ImCmdCopyTexture*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        pWrapBuffer->Unmap();
+                    }
+                    break;
 
-                    auto pDstTexture = static_cast<Texture*>(cmd->pDstTexture);
-                    auto pSrcTexture = static_cast<Texture*>(cmd->pSrcTexture);
-                    A3D_ASSERT(pDstTexture != nullptr);
-                    A3D_ASSERT(pSrcTexture != nullptr);
+                case CMD_RESET_QUERY:
+                    {
+                        /* DO_NOTHING */
+                    }
+                    break;
+            
+                case CMD_COPY_TEXTURE:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdCopyTexture*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pDeviceContext->CopyResource(
-                        pDstTexture->GetD3D11Resource(),
-                        pSrcTexture->GetD3D11Resource());
+                        auto pDstTexture = static_cast<Texture*>(cmd->pDstTexture);
+                        auto pSrcTexture = static_cast<Texture*>(cmd->pSrcTexture);
+                        A3D_ASSERT(pDstTexture != nullptr);
+                        A3D_ASSERT(pSrcTexture != nullptr);
 
-                    pCmd += sizeof(ImCmdCopyTexture);
-                }
-                break;
+                        pDeviceContext->CopyResource(
+                            pDstTexture->GetD3D11Resource(),
+                            pSrcTexture->GetD3D11Resource());
+                    }
+                    break;
 
-            case CMD_COPY_BUFFER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdCopyBuffer*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                case CMD_COPY_BUFFER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdCopyBuffer*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    auto pDstBuffer = static_cast<Buffer*>(cmd->pDstBuffer);
-                    auto pSrcBuffer = static_cast<Buffer*>(cmd->pSrcBuffer);
-                    A3D_ASSERT(pDstBuffer != nullptr);
-                    A3D_ASSERT(pSrcBuffer != nullptr);
+                        auto pDstBuffer = static_cast<Buffer*>(cmd->pDstBuffer);
+                        auto pSrcBuffer = static_cast<Buffer*>(cmd->pSrcBuffer);
+                        A3D_ASSERT(pDstBuffer != nullptr);
+                        A3D_ASSERT(pSrcBuffer != nullptr);
 
-                    pDeviceContext->CopyResource(
-                        pDstBuffer->GetD3D11Buffer(),
-                        pSrcBuffer->GetD3D11Buffer());
+                        pDeviceContext->CopyResource(
+                            pDstBuffer->GetD3D11Buffer(),
+                            pSrcBuffer->GetD3D11Buffer());
+                    }
+                    break;
 
-                    pCmd += sizeof(ImCmdCopyBuffer);
-                }
-                break;
+                case CMD_COPY_TEXTURE_REGION:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdCopyTextureRegion*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+
+                        auto pDstTexture = static_cast<Texture*>(cmd->pDstResource);
+                        auto pSrcTexture = static_cast<Texture*>(cmd->pSrcResource);
+                        A3D_ASSERT(pDstTexture != nullptr);
+                        A3D_ASSERT(pSrcTexture != nullptr);
+
+                        D3D11_BOX box = {};
+                        box.left    = cmd->SrcOffset.X;
+                        box.right   = cmd->SrcOffset.X + cmd->SrcExtent.Width;
+                        box.top     = cmd->SrcOffset.Y;
+                        box.bottom  = cmd->SrcOffset.Y + cmd->SrcExtent.Height;
+                        box.front   = cmd->SrcOffset.Z;
+                        box.back    = cmd->SrcOffset.Z + cmd->SrcExtent.Depth;
+
+                        pDeviceContext->CopySubresourceRegion(
+                            pDstTexture->GetD3D11Resource(),
+                            cmd->DstSubresource,
+                            cmd->DstOffset.X,
+                            cmd->DstOffset.Y,
+                            cmd->DstOffset.Z,
+                            pSrcTexture->GetD3D11Resource(),
+                            cmd->SrcSubresource,
+                            &box);
+                    }
+                    break;
 
-            case CMD_COPY_TEXTURE_REGION:
-                {
-                    auto cmd = reinterpret_cast<ImCmdCopyTextureRegion*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-
-                    auto pDstTexture = static_cast<Texture*>(cmd->pDstResource);
-                    auto pSrcTexture = static_cast<Texture*>(cmd->pSrcResource);
-                    A3D_ASSERT(pDstTexture != nullptr);
-                    A3D_ASSERT(pSrcTexture != nullptr);
-
-                    D3D11_BOX box = {};
-                    box.left    = cmd->SrcOffset.X;
-                    box.right   = cmd->SrcOffset.X + cmd->SrcExtent.Width;
-                    box.top     = cmd->SrcOffset.Y;
-                    box.bottom  = cmd->SrcOffset.Y + cmd->SrcExtent.Height;
-                    box.front   = cmd->SrcOffset.Z;
-                    box.back    = cmd->SrcOffset.Z + cmd->SrcExtent.Depth;
-
-                    pDeviceContext->CopySubresourceRegion(
-                        pDstTexture->GetD3D11Resource(),
-                        cmd->DstSubresource,
-                        cmd->DstOffset.X,
-                        cmd->DstOffset.Y,
-                        cmd->DstOffset.Z,
-                        pSrcTexture->GetD3D11Resource(),
-                        cmd->SrcSubresource,
-                        &box);
-
-                    pCmd += sizeof(ImCmdCopyTextureRegion);
-                }
-                break;
+                case CMD_COPY_BUFFER_REGION:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdCopyBufferRegion*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-            case CMD_COPY_BUFFER_REGION:
-                {
-                    auto cmd = reinterpret_cast<ImCmdCopyBufferRegion*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        auto pDstBuffer = static_cast<Buffer*>(cmd->pDstBuffer);
+                        auto pSrcBuffer = static_cast<Buffer*>(cmd->pSrcBuffer);
+                        A3D_ASSERT(pDstBuffer != nullptr);
+                        A3D_ASSERT(pSrcBuffer != nullptr);
 
-                    auto pDstBuffer = static_cast<Buffer*>(cmd->pDstBuffer);
-                    auto pSrcBuffer = static_cast<Buffer*>(cmd->pSrcBuffer);
-                    A3D_ASSERT(pDstBuffer != nullptr);
-                    A3D_ASSERT(pSrcBuffer != nullptr);
+                        D3D11_MAPPED_SUBRESOURCE dstMap = {};
+                        D3D11_MAPPED_SUBRESOURCE srcMap = {};
 
-                    D3D11_MAPPED_SUBRESOURCE dstMap = {};
-                    D3D11_MAPPED_SUBRESOURCE srcMap = {};
+                        pDeviceContext->Map(pSrcBuffer->GetD3D11Buffer(), 0, D3D11_MAP_READ, 0, &srcMap);
+                        pDeviceContext->Map(pDstBuffer->GetD3D11Buffer(), 0, D3D11_MAP_WRITE, 0, &dstMap);
 
-                    pDeviceContext->Map(pSrcBuffer->GetD3D11Buffer(), 0, D3D11_MAP_READ, 0, &srcMap);
-                    pDeviceContext->Map(pDstBuffer->GetD3D11Buffer(), 0, D3D11_MAP_WRITE, 0, &dstMap);
+                        auto pSrcPtr = static_cast<uint8_t*>(srcMap.pData) + cmd->SrcOffset;
+                        auto pDstPtr = static_cast<uint8_t*>(dstMap.pData) + cmd->DstOffset;
+                        memcpy(pDstPtr, pSrcPtr, static_cast<size_t>(cmd->ByteCount));
 
-                    auto pSrcPtr = static_cast<uint8_t*>(srcMap.pData) + cmd->SrcOffset;
-                    auto pDstPtr = static_cast<uint8_t*>(dstMap.pData) + cmd->DstOffset;
-                    memcpy(pDstPtr, pSrcPtr, static_cast<size_t>(cmd->ByteCount));
+                        pDeviceContext->Unmap(pSrcBuffer->GetD3D11Buffer(), 0);
+                        pDeviceContext->Unmap(pDstBuffer->GetD3D11Buffer(), 0);
+                    }
+                    break;
 
-                    pDeviceContext->Unmap(pSrcBuffer->GetD3D11Buffer(), 0);
-                    pDeviceContext->Unmap(pDstBuffer->GetD3D11Buffer(), 0);
+                case CMD_COPY_BUFFER_TO_TEXTURE:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdCopyBufferToTexture*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+
+                        auto pDstTexture = static_cast<Texture*>(cmd->pDstTexture);
+                        auto pSrcBuffer  = static_cast<Buffer*>(cmd->pSrcBuffer);
+                        A3D_ASSERT(pDstTexture != nullptr);
+                        A3D_ASSERT(pSrcBuffer  != nullptr);
+
+                        auto dstDesc = pDstTexture->GetDesc();
+
+                        auto subResourceLayout = pDstTexture->GetSubresourceLayout(cmd->DstSubresource);
+                        auto pSrcPtr = static_cast<uint8_t*>(pSrcBuffer->Map()) + cmd->SrcOffset;
+
+                        D3D11_BOX dstBox = {};
+                        dstBox.left     = cmd->DstOffset.X;
+                        dstBox.right    = dstDesc.Width;
+                        dstBox.top      = cmd->DstOffset.Y;
+                        dstBox.bottom   = dstDesc.Height;
+                        dstBox.front    = cmd->DstOffset.Z;
+                        dstBox.back     = dstDesc.DepthOrArraySize;
+
+                        pDeviceContext->UpdateSubresource(
+                            pDstTexture->GetD3D11Resource(),
+                            cmd->DstSubresource,
+                            &dstBox,
+                            pSrcPtr,
+                            static_cast<uint32_t>(subResourceLayout.RowPitch),
+                            static_cast<uint32_t>(subResourceLayout.SlicePitch));
+                    }
+                    break;
 
-                    pCmd += sizeof(ImCmdCopyBufferRegion);
-                }
-                break;
+                case CMD_COPY_TEXTURE_TO_BUFFER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdCopyTextureToBuffer*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+
+                        auto pDstBuffer  = static_cast<Buffer*>(cmd->pDstBuffer);
+                        auto pSrcTexture = static_cast<Texture*>(cmd->pSrcTexture);
+                        A3D_ASSERT(pDstBuffer  != nullptr);
+                        A3D_ASSERT(pSrcTexture != nullptr);
+
+                        D3D11_MAPPED_SUBRESOURCE srcMap = {};
+
+                        pDeviceContext->Map(
+                            pSrcTexture->GetD3D11Resource(),
+                            cmd->SrcSubresource,
+                            D3D11_MAP_READ,
+                            0,
+                            &srcMap);
+
+                        D3D11_BOX dstBox = {};
+                        dstBox.left     = static_cast<uint32_t>(cmd->DstOffset);
+                        dstBox.right    = static_cast<uint32_t>(pDstBuffer->GetDesc().Size);
+                        dstBox.top      = 0;
+                        dstBox.bottom   = 1;
+                        dstBox.front    = 0;
+                        dstBox.back     = 1;
+
+                        pDeviceContext->UpdateSubresource(
+                            pDstBuffer->GetD3D11Buffer(),
+                            0,
+                            &dstBox,
+                            srcMap.pData,
+                            srcMap.RowPitch,
+                            srcMap.DepthPitch);
+
+                        pDeviceContext->Unmap(pSrcTexture->GetD3D11Resource(), cmd->SrcSubresource);
+                    }
+                    break;
 
-            case CMD_COPY_BUFFER_TO_TEXTURE:
-                {
-                    auto cmd = reinterpret_cast<ImCmdCopyBufferToTexture*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-
-                    auto pDstTexture = static_cast<Texture*>(cmd->pDstTexture);
-                    auto pSrcBuffer  = static_cast<Buffer*>(cmd->pSrcBuffer);
-                    A3D_ASSERT(pDstTexture != nullptr);
-                    A3D_ASSERT(pSrcBuffer  != nullptr);
-
-                    auto dstDesc = pDstTexture->GetDesc();
-
-                    auto subResourceLayout = pDstTexture->GetSubresourceLayout(cmd->DstSubresource);
-                    auto pSrcPtr = static_cast<uint8_t*>(pSrcBuffer->Map()) + cmd->SrcOffset;
-
-                    D3D11_BOX dstBox = {};
-                    dstBox.left     = cmd->DstOffset.X;
-                    dstBox.right    = dstDesc.Width;
-                    dstBox.top      = cmd->DstOffset.Y;
-                    dstBox.bottom   = dstDesc.Height;
-                    dstBox.front    = cmd->DstOffset.Z;
-                    dstBox.back     = dstDesc.DepthOrArraySize;
-
-                    pDeviceContext->UpdateSubresource(
-                        pDstTexture->GetD3D11Resource(),
-                        cmd->DstSubresource,
-                        &dstBox,
-                        pSrcPtr,
-                        static_cast<uint32_t>(subResourceLayout.RowPitch),
-                        static_cast<uint32_t>(subResourceLayout.SlicePitch));
-
-                    pCmd += sizeof(ImCmdCopyBufferToTexture);
-                }
-                break;
+                case CMD_RESOLVE_SUBRESOURCE:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdResolveSubresource*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+
+                        auto pDstTexture = static_cast<Texture*>(cmd->pDstResource);
+                        auto pSrcTexture = static_cast<Texture*>(cmd->pSrcResource);
+                        A3D_ASSERT(pDstTexture != nullptr);
+                        A3D_ASSERT(pSrcTexture != nullptr);
+
+                        pDeviceContext->ResolveSubresource(
+                            pDstTexture->GetD3D11Resource(),
+                            cmd->DstSubresource,
+                            pSrcTexture->GetD3D11Resource(),
+                            cmd->SrcSubresource,
+                            ToNativeFormat(pDstTexture->GetDesc().Format));
+                    }
+                    break;
 
-            case CMD_COPY_TEXTURE_TO_BUFFER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdCopyTextureToBuffer*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-
-                    auto pDstBuffer  = static_cast<Buffer*>(cmd->pDstBuffer);
-                    auto pSrcTexture = static_cast<Texture*>(cmd->pSrcTexture);
-                    A3D_ASSERT(pDstBuffer  != nullptr);
-                    A3D_ASSERT(pSrcTexture != nullptr);
-
-                    D3D11_MAPPED_SUBRESOURCE srcMap = {};
-
-                    pDeviceContext->Map(
-                        pSrcTexture->GetD3D11Resource(),
-                        cmd->SrcSubresource,
-                        D3D11_MAP_READ,
-                        0,
-                        &srcMap);
-
-                    D3D11_BOX dstBox = {};
-                    dstBox.left     = static_cast<uint32_t>(cmd->DstOffset);
-                    dstBox.right    = static_cast<uint32_t>(pDstBuffer->GetDesc().Size);
-                    dstBox.top      = 0;
-                    dstBox.bottom   = 1;
-                    dstBox.front    = 0;
-                    dstBox.back     = 1;
-
-                    pDeviceContext->UpdateSubresource(
-                        pDstBuffer->GetD3D11Buffer(),
-                        0,
-                        &dstBox,
-                        srcMap.pData,
-                        srcMap.RowPitch,
-                        srcMap.DepthPitch);
-
-                    pDeviceContext->Unmap(pSrcTexture->GetD3D11Resource(), cmd->SrcSubresource);
-
-                    pCmd += sizeof(ImCmdCopyTextureToBuffer);
-                }
-                break;
+                case CMD_EXECUTE_BUNDLE:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdExecuteBundle*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-            case CMD_RESOLVE_SUBRESOURCE:
-                {
-                    auto cmd = reinterpret_cast<ImCmdResolveSubresource*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-
-                    auto pDstTexture = static_cast<Texture*>(cmd->pDstResource);
-                    auto pSrcTexture = static_cast<Texture*>(cmd->pSrcResource);
-                    A3D_ASSERT(pDstTexture != nullptr);
-                    A3D_ASSERT(pSrcTexture != nullptr);
-
-                    pDeviceContext->ResolveSubresource(
-                        pDstTexture->GetD3D11Resource(),
-                        cmd->DstSubresource,
-                        pSrcTexture->GetD3D11Resource(),
-                        cmd->SrcSubresource,
-                        ToNativeFormat(pDstTexture->GetDesc().Format));
-
-                    pCmd += sizeof(ImCmdResolveSubresource);
-                }
-                break;
+                        auto pWrapBundle = static_cast<CommandList*>(cmd->pBundle);
+                        pWrapBundle->GetBundle()->Execute(pDeviceContext, blendFactor, &stencilRef);
 
-            case CMD_PUSH_MARKER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdPushMarker*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                        // バンドル内で変更されたステートは追跡できないので全て無効化する.
+                        pBoundPipelineState = nullptr;
+                        pBoundIndexBuffer   = nullptr;
+                    }
+                    break;
 
-                    // ID3D11DeviceContext2じゃないと実行できない.
-                    #if 0
-                        //PIXBeginEvent(pDeviceContext, 0, cmd->Tag);
-                    #endif
+                case CMD_PUSH_MARKER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdPushMarker*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    pCmd += sizeof(ImCmdPushMarker);
-                }
-                break;
+                        // ID3D11DeviceContext2じゃないと実行できない.
+                        #if 0
+                            //PIXBeginEvent(pDeviceContext, 0, reinterpret_cast<const char*>(ImCmdPayload(cmd)));
+                        #endif
+                    }
+                    break;
 
-            case CMD_POP_MARKER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdPopMarker*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
+                case CMD_POP_MARKER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdPopMarker*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
 
-                    // ID3D11DeviceContext2じゃないと実行できない.
-                    #if 0
-                        //PIXEndEvent(pDeviceContext);
-                    #endif
+                        // ID3D11DeviceContext2じゃないと実行できない.
+                        #if 0
+                            //PIXEndEvent(pDeviceContext);
+                        #endif
+                    }
+                    break;
 
-                    pCmd += sizeof(ImCmdPopMarker);
-                }
-                break;
+                case CMD_UPDATE_CONSTANT_BUFFER:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdUpdateConstantBuffer*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+
+                        auto pBuffer = static_cast<Buffer*>(cmd->pBuffer);
+
+                        D3D11_BOX box = {};
+                        box.left     = static_cast<uint32_t>(cmd->Offset);
+                        box.right    = static_cast<uint32_t>(cmd->Size);
+                        box.top      = 0;
+                        box.bottom   = 1;
+                        box.front    = 0;
+                        box.back     = 1;
+
+                        pDeviceContext->UpdateSubresource(
+                            pBuffer->GetD3D11Buffer(),
+                            0,
+                            &box,
+                            ImCmdPayload(cmd),
+                            UINT(pBuffer->GetDesc().Size),
+                            1);
+                    }
+                    break;
 
-            case CMD_UPDATE_CONSTANT_BUFFER:
-                {
-                    auto cmd = reinterpret_cast<ImCmdUpdateConstantBuffer*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-
-                    pCmd += sizeof(ImCmdUpdateConstantBuffer);
-
-                    auto pBuffer = static_cast<Buffer*>(cmd->pBuffer);
-
-                    D3D11_BOX box = {};
-                    box.left     = static_cast<uint32_t>(cmd->Offset);
-                    box.right    = static_cast<uint32_t>(cmd->Size);
-                    box.top      = 0;
-                    box.bottom   = 1;
-                    box.front    = 0;
-                    box.back     = 1;
-
-                    pDeviceContext->UpdateSubresource(
-                        pBuffer->GetD3D11Buffer(),
-                        0,
-                        &box,
-                        pCmd,
-                        UINT(pBuffer->GetDesc().Size),
-                        1);
-                }
-                break;
+                case CMD_SUB_END:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdEnd*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+                        /* DO_NOTHING */
+                    }
+                    break;
 
-            case CMD_SUB_END:
-                {
-                    auto cmd = reinterpret_cast<ImCmdEnd*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-                    /* DO_NOTHING */
-                    pCmd += sizeof(ImCmdEnd);
+                case CMD_END:
+                    {
+                        auto cmd = reinterpret_cast<ImCmdEnd*>(pCmd);
+                        A3D_ASSERT(cmd != nullptr);
+                        pDeviceContext->Flush();
+                    }
+                    break;
                 }
-                break;
 
-            case CMD_END:
-                {
-                    auto cmd = reinterpret_cast<ImCmdEnd*>(pCmd);
-                    A3D_ASSERT(cmd != nullptr);
-                    end = true;
-                    pCmd += sizeof(ImCmdEnd);
-                    pDeviceContext->Flush();
-                }
-                break;
+                // 可変長コマンドなので, 記録されたサイズで次のコマンドに進める.
+                pCmd += pBase->CmdSize;
             }
         }
     }
 }
 
+//-------------------------------------------------------------------------------------------------
+//      省略したデバイスコンテキスト呼び出し数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint64_t Queue::GetElidedCallCount() const
+{ return m_ElidedCallCount; }
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
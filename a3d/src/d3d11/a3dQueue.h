@@ -94,6 +94,13 @@ public:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Present( ISwapChain* pSwapChain ) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      冗長なため省略したデバイスコンテキスト呼び出し数を取得します.
+    //!
+    //! @return     生成してから省略したデバイスコンテキスト呼び出し数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint64_t A3D_APIENTRY GetElidedCallCount() const;
+
 private:
     //=============================================================================================
     // private variables.
@@ -106,6 +113,7 @@ private:
     CommandList**               m_pCommandLists;    //!< コマンドリストです.
     ID3D11Query*                m_pQuery;           //!< クエリです.
     uint64_t                    m_Frequency;        //!< GPU周期です.
+    uint64_t                    m_ElidedCallCount;  //!< 省略したデバイスコンテキスト呼び出し数です.
 
     //=============================================================================================
     // private methods.
@@ -44,10 +44,12 @@ void ToNativeDescriptorRange( const a3d::DescriptorEntry& entry, D3D12_DESCRIPTO
     switch(entry.Type)
     {
     case a3d::DESCRIPTOR_TYPE_CBV:
+    case a3d::DESCRIPTOR_TYPE_CBV_DYNAMIC:
         result.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
         break;
 
     case a3d::DESCRIPTOR_TYPE_UAV:
+    case a3d::DESCRIPTOR_TYPE_UAV_DYNAMIC:
         result.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
         break;
 
@@ -7,6 +7,138 @@
 
 namespace a3d {
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CommandChunkPool class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+CommandChunkPool::CommandChunkPool()
+: m_pFreeList   (nullptr)
+, m_ChunkSize   (0)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+CommandChunkPool::~CommandChunkPool()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool CommandChunkPool::Init(size_t chunkSize)
+{
+    if (chunkSize == 0)
+    { return false; }
+
+    Term();
+
+    m_ChunkSize = ImCmdAlign(chunkSize);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void CommandChunkPool::Term()
+{
+    std::lock_guard<std::mutex> locker(m_Mutex);
+
+    auto pChunk = m_pFreeList;
+    while(pChunk != nullptr)
+    {
+        auto pNext = pChunk->pNext;
+        a3d_free(pChunk);
+        pChunk = pNext;
+    }
+
+    m_pFreeList = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      チャンクを取得します.
+//-------------------------------------------------------------------------------------------------
+CommandChunk* CommandChunkPool::Acquire(size_t size)
+{
+    if (size > m_ChunkSize)
+    { return AllocChunk(ImCmdAlign(size)); }
+
+    CommandChunk* pChunk = nullptr;
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        pChunk = m_pFreeList;
+        if (pChunk != nullptr)
+        { m_pFreeList = pChunk->pNext; }
+    }
+
+    if (pChunk == nullptr)
+    { return AllocChunk(m_ChunkSize); }
+
+    pChunk->pNext = nullptr;
+    return pChunk;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      チャンクのリストをプールに返却します.
+//-------------------------------------------------------------------------------------------------
+void CommandChunkPool::Release(CommandChunk* pHead)
+{
+    // ロックの外でリストを組み替えておき，返却時のロックは一回で済ませる.
+    CommandChunk* pFirst = nullptr;
+    CommandChunk* pLast  = nullptr;
+
+    auto pChunk = pHead;
+    while(pChunk != nullptr)
+    {
+        auto pNext = pChunk->pNext;
+
+        if (pChunk->Capacity != m_ChunkSize)
+        {
+            a3d_free(pChunk);
+        }
+        else
+        {
+            pChunk->pNext = pFirst;
+            pFirst = pChunk;
+            if (pLast == nullptr)
+            { pLast = pChunk; }
+        }
+
+        pChunk = pNext;
+    }
+
+    if (pFirst == nullptr)
+    { return; }
+
+    std::lock_guard<std::mutex> locker(m_Mutex);
+    pLast->pNext = m_pFreeList;
+    m_pFreeList  = pFirst;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      チャンクサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+size_t CommandChunkPool::GetChunkSize() const
+{ return m_ChunkSize; }
+
+//-------------------------------------------------------------------------------------------------
+//      チャンクのメモリを確保します.
+//-------------------------------------------------------------------------------------------------
+CommandChunk* CommandChunkPool::AllocChunk(size_t capacity)
+{
+    auto pChunk = static_cast<CommandChunk*>(
+        a3d_alloc(ImCmdAlign(sizeof(CommandChunk)) + capacity, ImCmdAlignment));
+    if (pChunk == nullptr)
+    { return nullptr; }
+
+    pChunk->pNext    = nullptr;
+    pChunk->Capacity = capacity;
+    return pChunk;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // CommandBuffer class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -15,10 +147,14 @@ namespace a3d {
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
 CommandBuffer::CommandBuffer()
-: m_pBuffer (nullptr)
-, m_pCmd    (nullptr)
-, m_Size    (0)
-, m_Enable  (true)
+: m_pPool           (nullptr)
+, m_pHead           (nullptr)
+, m_pTail           (nullptr)
+, m_pSegmentBegin   (nullptr)
+, m_pCmd            (nullptr)
+, m_pChunkEnd       (nullptr)
+, m_CmdSize         (0)
+, m_Enable          (false)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -30,16 +166,14 @@ CommandBuffer::~CommandBuffer()
 //-------------------------------------------------------------------------------------------------
 //      初期化処理を行います.
 //-------------------------------------------------------------------------------------------------
-bool CommandBuffer::Init(size_t size)
+bool CommandBuffer::Init(CommandChunkPool* pPool)
 {
-    Term();
-
-    m_pBuffer = static_cast<uint8_t*>(a3d_alloc( size, 4 ));
-    if (m_pBuffer == nullptr)
+    if (pPool == nullptr)
     { return false; }
 
-    m_Size  = size;
-    m_pCmd   = m_pBuffer;
+    Term();
+
+    m_pPool  = pPool;
     m_Enable = true;
 
     return true;
@@ -50,57 +184,88 @@ bool CommandBuffer::Init(size_t size)
 //-------------------------------------------------------------------------------------------------
 void CommandBuffer::Term()
 {
-    if (m_pBuffer != nullptr)
-    {
-        a3d_free(m_pBuffer);
-        m_pBuffer = nullptr;
-    }
+    Reset();
 
-    m_pCmd   = nullptr;
-    m_Size   = 0;
+    m_Segments.clear();
+    m_Segments.shrink_to_fit();
+
+    m_pPool  = nullptr;
     m_Enable = false;
 }
 
 //-------------------------------------------------------------------------------------------------
-//      コマンドポインタをコマンドバッファの先頭に戻します.
+//      記録済みのコマンドを破棄し，チャンクをプールに返却します.
 //-------------------------------------------------------------------------------------------------
 void CommandBuffer::Reset()
 {
-    m_pCmd = m_pBuffer;
+    if (m_pPool != nullptr)
+    { m_pPool->Release(m_pHead); }
+
+    m_pHead         = nullptr;
+    m_pTail         = nullptr;
+    m_pSegmentBegin = nullptr;
+    m_pCmd          = nullptr;
+    m_pChunkEnd     = nullptr;
+    m_CmdSize       = 0;
+
+    // 容量は維持したまま空にする.
+    m_Segments.clear();
 
-    if (m_pBuffer != nullptr)
-    { m_Enable = true; }
+    m_Enable = (m_pPool != nullptr);
 }
 
 //-------------------------------------------------------------------------------------------------
 //      コマンドバッファを閉じます.
 //-------------------------------------------------------------------------------------------------
 void CommandBuffer::Close()
-{ m_Enable = false; }
+{
+    CloseSegment();
+    m_Enable = false;
+}
 
 //-------------------------------------------------------------------------------------------------
 //      コマンドを追加します.
 //-------------------------------------------------------------------------------------------------
 void CommandBuffer::Push(const void* pData, size_t size)
 {
-    if (!m_Enable)
+    auto pCmd = Alloc(size);
+    if (pCmd == nullptr)
     { return; }
 
-    auto usedSize = GetCmdSize();
-    if (usedSize + size >= m_Size)
+    memcpy(pCmd, pData, size);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      コマンド領域を確保します.
+//-------------------------------------------------------------------------------------------------
+void* CommandBuffer::Alloc(size_t size)
+{
+    if (!m_Enable)
+    { return nullptr; }
+
+    A3D_ASSERT((size % ImCmdAlignment) == 0);
+
+    if (m_pCmd == nullptr || size > static_cast<size_t>(m_pChunkEnd - m_pCmd))
     {
-        auto resize = static_cast<size_t>(m_Size * 1.5);
-        if (resize >= usedSize + size)
-        { resize = static_cast<size_t>((usedSize + size) * 1.5); }
-
-        m_pBuffer = static_cast<uint8_t*>(a3d_realloc(m_pBuffer, resize, 4));
-        m_Size    = resize;
-        m_pCmd    = m_pBuffer;
-        m_pCmd    += usedSize;
+        if (!NextChunk(size))
+        { return nullptr; }
     }
 
-    memcpy(m_pCmd, pData, size);
-    m_pCmd += size;
+    auto pCmd = m_pCmd;
+    m_pCmd    += size;
+    m_CmdSize += size;
+    return pCmd;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      直前に追加したコマンドを取り消します.
+//-------------------------------------------------------------------------------------------------
+void CommandBuffer::Rewind(size_t size)
+{
+    // 直前のコマンドは必ず記録中のセグメント内にある.
+    A3D_ASSERT(size <= static_cast<size_t>(m_pCmd - m_pSegmentBegin));
+    m_pCmd    -= size;
+    m_CmdSize -= size;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -111,46 +276,90 @@ void CommandBuffer::Append(const CommandBuffer* pBuffer)
     if (!m_Enable)
     { return; }
 
-    auto usedSize = GetCmdSize();
-    auto bufSize  = pBuffer->GetCmdSize();
-    if (usedSize + bufSize >= m_Size)
-    {
-        auto resize = static_cast<size_t>(m_Size * 1.5);
-        if (resize >= usedSize + bufSize)
-        { resize = static_cast<size_t>((usedSize + bufSize) * 1.5); }
-
-        m_pBuffer = static_cast<uint8_t*>(a3d_realloc(m_pBuffer, resize, 4));
-        m_Size    = resize;
-        m_pCmd    = m_pBuffer;
-        m_pCmd    += usedSize;
-    }
+    A3D_ASSERT(pBuffer != nullptr);
+    A3D_ASSERT(!pBuffer->m_Enable);
 
-    memcpy(m_pCmd, pBuffer->GetBuffer(), bufSize);
-    m_pCmd += bufSize;
+    // 追加元のセグメントを参照として繋ぎ，以降のコマンドは新しいセグメントとして記録する.
+    CloseSegment();
+    m_Segments.insert(m_Segments.end(), pBuffer->m_Segments.begin(), pBuffer->m_Segments.end());
+    m_CmdSize += pBuffer->m_CmdSize;
 }
 
 //-------------------------------------------------------------------------------------------------
-//      コマンドバッファへのポインタを取得します.
+//      記録中のセグメントを確定し, 現在の挿入位置を取得します.
 //-------------------------------------------------------------------------------------------------
-uint8_t* CommandBuffer::GetBuffer() const
-{ return m_pBuffer; }
+uint32_t CommandBuffer::Mark()
+{
+    CloseSegment();
+    return GetSegmentCount();
+}
 
 //-------------------------------------------------------------------------------------------------
-//      コマンドポインタを取得します.
+//      指定位置にコマンドバッファを挿入します.
 //-------------------------------------------------------------------------------------------------
-uint8_t* CommandBuffer::GetCmdPtr() const
-{ return m_pCmd; }
+void CommandBuffer::Insert(uint32_t index, const CommandBuffer* pBuffer)
+{
+    A3D_ASSERT(pBuffer != nullptr);
+    A3D_ASSERT(!pBuffer->m_Enable);
+    A3D_ASSERT(index <= m_Segments.size());
+
+    m_Segments.insert(m_Segments.begin() + index, pBuffer->m_Segments.begin(), pBuffer->m_Segments.end());
+    m_CmdSize += pBuffer->m_CmdSize;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      セグメントの配列を取得します.
+//-------------------------------------------------------------------------------------------------
+const CommandBuffer::Segment* CommandBuffer::GetSegments() const
+{ return m_Segments.data(); }
 
 //-------------------------------------------------------------------------------------------------
-//      コマンドバッファサイズを取得します.
+//      セグメント数を取得します.
 //-------------------------------------------------------------------------------------------------
-size_t CommandBuffer::GetBufferSize() const
-{ return m_Size; }
+uint32_t CommandBuffer::GetSegmentCount() const
+{ return static_cast<uint32_t>(m_Segments.size()); }
 
 //-------------------------------------------------------------------------------------------------
 //      コマンドサイズを取得します.
 //-------------------------------------------------------------------------------------------------
 size_t CommandBuffer::GetCmdSize() const
-{ return static_cast<size_t>(m_pCmd - m_pBuffer); }
+{ return m_CmdSize; }
+
+//-------------------------------------------------------------------------------------------------
+//      プールから次のチャンクを取得します.
+//-------------------------------------------------------------------------------------------------
+bool CommandBuffer::NextChunk(size_t size)
+{
+    auto pChunk = m_pPool->Acquire(size);
+    if (pChunk == nullptr)
+    { return false; }
+
+    CloseSegment();
+
+    if (m_pTail != nullptr)
+    { m_pTail->pNext = pChunk; }
+    else
+    { m_pHead = pChunk; }
+    m_pTail = pChunk;
+
+    m_pCmd          = pChunk->GetData();
+    m_pSegmentBegin = m_pCmd;
+    m_pChunkEnd     = m_pCmd + pChunk->Capacity;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      記録中のセグメントを確定します.
+//-------------------------------------------------------------------------------------------------
+void CommandBuffer::CloseSegment()
+{
+    if (m_pCmd != m_pSegmentBegin)
+    {
+        Segment segment = { m_pSegmentBegin, m_pCmd };
+        m_Segments.push_back(segment);
+    }
+
+    m_pSegmentBegin = m_pCmd;
+}
 
 } // namespace a3d
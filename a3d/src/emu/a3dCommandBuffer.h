@@ -8,6 +8,117 @@
 
 namespace a3d {
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CommandChunk structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CommandChunk
+{
+    CommandChunk*   pNext;      //!< 次のチャンクです.
+    size_t          Capacity;   //!< データ領域のサイズです.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      データ領域の先頭ポインタを取得します.
+    //!
+    //! @return     ヘッダ直後のデータ領域の先頭ポインタを返却します.
+    //---------------------------------------------------------------------------------------------
+    uint8_t* GetData()
+    { return reinterpret_cast<uint8_t*>(this) + ImCmdAlign(sizeof(CommandChunk)); }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// CommandChunkPool class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class CommandChunkPool : public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const size_t DefaultChunkSize = 64 * 1024;   //!< 既定のチャンクサイズです.
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    CommandChunkPool();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~CommandChunkPool();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      chunkSize   チャンクのデータ領域のサイズです.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(size_t chunkSize);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //!
+    //! @note       プールに返却済みのチャンクのみが解放されます.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      チャンクを取得します.
+    //!
+    //! @param[in]      size        必要なデータ領域のサイズです.
+    //! @return     チャンクを返却します. 確保に失敗した場合は nullptr を返却します.
+    //! @note       チャンクサイズを超える要求の場合は専用のチャンクを確保します.
+    //---------------------------------------------------------------------------------------------
+    CommandChunk* Acquire(size_t size);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      チャンクのリストをプールに返却します.
+    //!
+    //! @param[in]      pHead       返却するチャンクリストの先頭です.
+    //! @note       専用に確保されたチャンクはプールに戻さず解放します.
+    //---------------------------------------------------------------------------------------------
+    void Release(CommandChunk* pHead);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      チャンクサイズを取得します.
+    //!
+    //! @return     チャンクのデータ領域のサイズを返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetChunkSize() const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::mutex      m_Mutex;        //!< ミューテックスです.
+    CommandChunk*   m_pFreeList;    //!< 未使用チャンクのリストです.
+    size_t          m_ChunkSize;    //!< チャンクサイズです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      チャンクのメモリを確保します.
+    //!
+    //! @param[in]      capacity    データ領域のサイズです.
+    //! @return     確保したチャンクを返却します. 確保に失敗した場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    static CommandChunk* AllocChunk(size_t capacity);
+
+    CommandChunkPool(const CommandChunkPool&) = delete;
+    void operator = (const CommandChunkPool&) = delete;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // CommandBuffer class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -22,7 +133,15 @@ public:
     //=============================================================================================
     // public variables.
     //=============================================================================================
-    /* NOTHING */
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Segment structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Segment
+    {
+        const uint8_t*  pBegin;     //!< 先頭コマンドへのポインタです.
+        const uint8_t*  pEnd;       //!< 末尾コマンドの直後へのポインタです.
+    };
 
     //=============================================================================================
     // public methods.
@@ -41,11 +160,11 @@ public:
     //---------------------------------------------------------------------------------------------
     //! @brief      初期化処理を行います.
     //!
-    //! @param[in]      size        バッファの初期化サイズです.
+    //! @param[in]      pPool       チャンクを取得するプールです.
     //! @retval true    初期化に成功.
     //! @retval false   初期化に失敗.
     //---------------------------------------------------------------------------------------------
-    bool Init(size_t size);
+    bool Init(CommandChunkPool* pPool);
 
     //---------------------------------------------------------------------------------------------
     //! @brief      終了処理を行います.
@@ -53,7 +172,7 @@ public:
     void Term();
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      コマンドポイントを先頭に戻します.
+    //! @brief      記録済みのコマンドを破棄し，チャンクをプールに返却します.
     //---------------------------------------------------------------------------------------------
     void Reset();
 
@@ -67,46 +186,72 @@ public:
     //!
     //! @param[in]      pData       コマンドデータです.
     //! @param[in]      size        コマンドサイズです.
-    //! @note       コマンドバッファの容量が足らない場合はメモリ再確保が実行されます.
-    //!             メモリの再確保に失敗した場合はコマンドが追加されません.
+    //! @note       チャンクの容量が足らない場合はプールから次のチャンクを取得します.
+    //!             チャンクの取得に失敗した場合はコマンドが追加されません.
     //---------------------------------------------------------------------------------------------
     void Push(const void* pData, size_t size);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コマンド領域を確保し，コマンドポインタを進めます.
+    //!
+    //! @param[in]      size        確保するサイズです. ImCmdAlignment の倍数である必要があります.
+    //! @return     確保した領域の先頭ポインタを返却します. 確保に失敗した場合は nullptr を返却します.
+    //! @note       コマンドはチャンクをまたいで配置されません.
+    //!             返却したポインタは Reset() または Term() を呼び出すまで有効です.
+    //---------------------------------------------------------------------------------------------
+    void* Alloc(size_t size);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      直前に追加したコマンドを取り消し，コマンドポインタを戻します.
+    //!
+    //! @param[in]      size        取り消すサイズです.
+    //---------------------------------------------------------------------------------------------
+    void Rewind(size_t size);
+
     //---------------------------------------------------------------------------------------------
     //! @brief      コマンドバッファを追加します.
     //!
-    //! @param[in]      pBuffer     追加するコマンドバッファです.
-    //! @note       コマンドバッファの容量が足らない場合はメモリ再確保が実行されます.
-    //!             メモリの再確保に失敗した場合はコマンドが追加されません.
+    //! @param[in]      pBuffer     追加するコマンドバッファです. 閉じられている必要があります.
+    //! @note       コマンドはコピーされず，追加元のセグメントを参照します.
+    //!             このコマンドバッファを実行し終えるまで，追加元を再記録してはいけません.
     //---------------------------------------------------------------------------------------------
     void Append(const CommandBuffer* pBuffer);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      コマンドバッファの先頭ポインタを取得します.
+    //! @brief      記録中のセグメントを確定し, 現在の挿入位置を取得します.
     //!
-    //! @return     コマンドバッファの先頭ポインタを返却します.
+    //! @return     Insert() に渡す挿入位置を返却します.
     //---------------------------------------------------------------------------------------------
-    uint8_t* GetBuffer() const;
+    uint32_t Mark();
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      コマンドポインタを取得します.
+    //! @brief      指定位置にコマンドバッファを挿入します.
     //!
-    //! @return     コマンドポインタを返却します.
+    //! @param[in]      index       Mark() で取得した挿入位置です.
+    //! @param[in]      pBuffer     挿入するコマンドバッファです. 閉じられている必要があります.
+    //! @note       Append() と同様にコマンドはコピーされず, 挿入元のセグメントを参照します.
     //---------------------------------------------------------------------------------------------
-    uint8_t* GetCmdPtr() const;
+    void Insert(uint32_t index, const CommandBuffer* pBuffer);
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      コマンドバッファ全体のサイズを取得します.
+    //! @brief      セグメントの配列を取得します.
     //!
-    //! @return     コマンドバッファ全体のサイズを返却します.
-    //! @note       コマンド未使用領域のサイズも含まれます.
+    //! @return     記録順に並んだセグメントの配列を返却します.
+    //! @note       Close() を呼び出した後に有効になります.
     //---------------------------------------------------------------------------------------------
-    size_t GetBufferSize() const;
+    const Segment* GetSegments() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      セグメント数を取得します.
+    //!
+    //! @return     セグメント数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetSegmentCount() const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      コマンドサイズを取得します.
     //!
-    //! @return     コマンドバッファ先頭からコマンドポインタまでのサイズを返却します.
+    //! @return     記録済みのコマンドの合計サイズを返却します.
     //---------------------------------------------------------------------------------------------
     size_t GetCmdSize() const;
 
@@ -114,14 +259,34 @@ private:
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    uint8_t*    m_pBuffer;  //!< コマンドバッファです.
-    uint8_t*    m_pCmd;     //!< コマンドポインタです.
-    size_t      m_Size;     //!< コマンドバッファサイズです.
-    bool        m_Enable;   //!< 記録可能かどうか?
+    CommandChunkPool*                               m_pPool;            //!< チャンクプールです.
+    CommandChunk*                                   m_pHead;            //!< 先頭チャンクです.
+    CommandChunk*                                   m_pTail;            //!< 末尾チャンクです.
+    uint8_t*                                        m_pSegmentBegin;    //!< 記録中のセグメントの先頭です.
+    uint8_t*                                        m_pCmd;             //!< コマンドポインタです.
+    uint8_t*                                        m_pChunkEnd;        //!< 末尾チャンクの終端です.
+    std::vector<Segment, StdAllocator<Segment>>     m_Segments;         //!< セグメントです.
+    size_t                                          m_CmdSize;          //!< コマンドサイズです.
+    bool                                            m_Enable;           //!< 記録可能かどうか?
 
     //=============================================================================================
     // private methods.
     //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      プールから次のチャンクを取得します.
+    //!
+    //! @param[in]      size        追加するサイズです.
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool NextChunk(size_t size);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      記録中のセグメントを確定します.
+    //---------------------------------------------------------------------------------------------
+    void CloseSegment();
+
     CommandBuffer   (const CommandBuffer&) = delete;
     void operator = (const CommandBuffer&) = delete;
 };
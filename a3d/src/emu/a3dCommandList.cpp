@@ -15,17 +15,30 @@ namespace a3d {
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
 CommandList::CommandList()
-: m_RefCount(1)
-, m_pDevice (nullptr)
-, m_Type    (COMMANDLIST_TYPE_DIRECT)
-, m_Buffer  ()
-{ /* DO_NOTHING */ }
+: m_RefCount    (1)
+, m_pDevice     (nullptr)
+, m_Type        (COMMANDLIST_TYPE_DIRECT)
+, m_Buffer      ()
+, m_ElidedCount (0)
+, m_pBundle     (nullptr)
+, m_ContextCount(0)
+, m_IsContext   (false)
+{ ResetStateCache(); }
 
 //-------------------------------------------------------------------------------------------------
 //      デストラクタです.
 //-------------------------------------------------------------------------------------------------
 CommandList::~CommandList()
-{ SafeRelease(m_pDevice); }
+{
+    for(size_t i=0; i<m_Contexts.size(); ++i)
+    { SafeRelease(m_Contexts[i]); }
+    m_Contexts.clear();
+
+    // チャンクはデバイスのプールに返却するので, デバイスより先に解放する.
+    SafeDelete(m_pBundle);
+    m_Buffer.Term();
+    SafeRelease(m_pDevice);
+}
 
 //-------------------------------------------------------------------------------------------------
 //      参照カウントを増やします.
@@ -64,12 +77,21 @@ void CommandList::GetDevice(IDevice** ppDevice)
 //-------------------------------------------------------------------------------------------------
 void CommandList::Begin()
 {
+    // 変換結果はコマンドバッファを参照しているので, 先に破棄する.
+    if (m_pBundle != nullptr)
+    { m_pBundle->Reset(); }
+
+    // 前回連結したコンテキストのチャンクもここでプールに返却する.
+    for(size_t i=0; i<m_Contexts.size(); ++i)
+    { m_Contexts[i]->m_Buffer.Reset(); }
+    m_ParallelBatches.clear();
+    m_ContextCount = 0;
+
     m_Buffer.Reset();
+    ResetStateCache();
+    m_ElidedCount = 0;
 
-    ImCmdBegin cmd = {};
-    cmd.Type = (m_Type == COMMANDLIST_TYPE_DIRECT) ? CMD_BEGIN : CMD_SUB_BEGIN;
-    
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    AllocCmd<ImCmdBegin>((m_Type == COMMANDLIST_TYPE_DIRECT) ? CMD_BEGIN : CMD_SUB_BEGIN);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -77,11 +99,14 @@ void CommandList::Begin()
 //-------------------------------------------------------------------------------------------------
 void CommandList::BeginFrameBuffer(IFrameBuffer* pBuffer)
 {
-    ImCmdBeginFrameBuffer cmd = {};
-    cmd.Type         = CMD_BEGIN_FRAME_BUFFER;
-    cmd.pFrameBuffer = pBuffer;
+    auto cmd = AllocCmd<ImCmdBeginFrameBuffer>(CMD_BEGIN_FRAME_BUFFER);
+    if (cmd == nullptr)
+    { return; }
+
+    cmd->pFrameBuffer = pBuffer;
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    // レンダーターゲット設定時にランタイムが競合するビューを解除するため, 同じディスクリプタセットでも再設定が必要.
+    m_pLastStateCmd[CMD_SET_DESCRIPTORSET] = nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -89,9 +114,10 @@ void CommandList::BeginFrameBuffer(IFrameBuffer* pBuffer)
 //-------------------------------------------------------------------------------------------------
 void CommandList::EndFrameBuffer()
 {
-    ImCmdBase cmd = {};
-    cmd.Type = CMD_END_FRAME_BUFFER;
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    AllocCmd<ImCmdBase>(CMD_END_FRAME_BUFFER);
+
+    // フレームバッファ内で解除されたビューを戻すため, ディスクリプタセットを再設定させる.
+    m_pLastStateCmd[CMD_SET_DESCRIPTORSET] = nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -104,17 +130,18 @@ void CommandList::ClearFrameBuffer
     const ClearDepthStencilValue*   pClearDepthStencil
 )
 {
-    ImCmdClearFrameBuffer cmd = {};
-    cmd.Type            = CMD_CLEAR_FRAME_BUFFER;
-    cmd.ClearColorCount = clearColorCount;
-    memcpy(cmd.ClearColors, pClearColors, clearColorCount * sizeof(ClearColorValue));
-    if (pClearDepthStencil != nullptr)
-    {
-        cmd.HasDepth            = true;
-        cmd.ClearDepthStencil   = *pClearDepthStencil;
-    }
+    auto cmd = AllocCmd<ImCmdClearFrameBuffer>(
+        CMD_CLEAR_FRAME_BUFFER,
+        sizeof(ClearColorValue) * clearColorCount);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->ClearColorCount = clearColorCount;
+    cmd->HasDepth        = (pClearDepthStencil != nullptr);
+    if (clearColorCount > 0)
+    { memcpy(ImCmdPayload(cmd), pClearColors, sizeof(ClearColorValue) * clearColorCount); }
+    if (pClearDepthStencil != nullptr)
+    { cmd->ClearDepthStencil = *pClearDepthStencil; }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -122,11 +149,15 @@ void CommandList::ClearFrameBuffer
 //-------------------------------------------------------------------------------------------------
 void CommandList::SetBlendConstant(const float blendConstant[4])
 {
-    ImCmdSetBlendConstant cmd = {};
-    cmd.Type = CMD_SET_BLEND_CONSTANT;
-    memcpy( cmd.BlendConstant, blendConstant, sizeof(cmd.BlendConstant) );
+    auto cmd = AllocCmd<ImCmdSetBlendConstant>(CMD_SET_BLEND_CONSTANT);
+    if (cmd == nullptr)
+    { return; }
+
+    memcpy( cmd->BlendConstant, blendConstant, sizeof(cmd->BlendConstant) );
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    // ブレンド定数はパイプラインステート設定時に反映されるため, 次の設定は省略できない.
+    if (!DiscardIfRedundant(cmd))
+    { m_pLastStateCmd[CMD_SET_PIPELINESTATE] = nullptr; }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -134,11 +165,15 @@ void CommandList::SetBlendConstant(const float blendConstant[4])
 //-------------------------------------------------------------------------------------------------
 void CommandList::SetStencilReference(uint32_t stencilRef)
 {
-    ImCmdSetStencilReference cmd = {};
-    cmd.Type = CMD_SET_STENCIL_REFERENCE;
-    cmd.StencilReference = stencilRef;
+    auto cmd = AllocCmd<ImCmdSetStencilReference>(CMD_SET_STENCIL_REFERENCE);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->StencilReference = stencilRef;
+
+    // ステンシル参照値はパイプラインステート設定時に反映されるため, 次の設定は省略できない.
+    if (!DiscardIfRedundant(cmd))
+    { m_pLastStateCmd[CMD_SET_PIPELINESTATE] = nullptr; }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -146,12 +181,14 @@ void CommandList::SetStencilReference(uint32_t stencilRef)
 //-------------------------------------------------------------------------------------------------
 void CommandList::SetViewports(uint32_t count, Viewport* pViewports)
 {
-    ImCmdSetViewports cmd = {};
-    cmd.Type  = CMD_SET_VIEWPORTS;
-    cmd.Count = count;
-    memcpy(cmd.Viewports, pViewports, sizeof(Viewport) * count);
+    auto cmd = AllocCmd<ImCmdSetViewports>(CMD_SET_VIEWPORTS, sizeof(Viewport) * count);
+    if (cmd == nullptr)
+    { return; }
+
+    cmd->Count = count;
+    memcpy(ImCmdPayload(cmd), pViewports, sizeof(Viewport) * count);
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    DiscardIfRedundant(cmd);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -159,12 +196,14 @@ void CommandList::SetViewports(uint32_t count, Viewport* pViewports)
 //-------------------------------------------------------------------------------------------------
 void CommandList::SetScissors(uint32_t count, Rect* pScissors)
 {
-    ImCmdSetScissors cmd = {};
-    cmd.Type  = CMD_SET_SCISSORS;
-    cmd.Count = count;
-    memcpy(cmd.Rects, pScissors, sizeof(Rect) * count);
+    auto cmd = AllocCmd<ImCmdSetScissors>(CMD_SET_SCISSORS, sizeof(Rect) * count);
+    if (cmd == nullptr)
+    { return; }
+
+    cmd->Count = count;
+    memcpy(ImCmdPayload(cmd), pScissors, sizeof(Rect) * count);
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    DiscardIfRedundant(cmd);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -172,11 +211,13 @@ void CommandList::SetScissors(uint32_t count, Rect* pScissors)
 //-------------------------------------------------------------------------------------------------
 void CommandList::SetPipelineState(IPipelineState* pPipelineState)
 {
-    ImCmdSetPipelineState cmd = {};
-    cmd.Type            = CMD_SET_PIPELINESTATE;
-    cmd.pPipelineState  = pPipelineState;
+    auto cmd = AllocCmd<ImCmdSetPipelineState>(CMD_SET_PIPELINESTATE);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pPipelineState  = pPipelineState;
+
+    DiscardIfRedundant(cmd);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -185,10 +226,17 @@ void CommandList::SetPipelineState(IPipelineState* pPipelineState)
 void CommandList::SetDescriptorSet(IDescriptorSet* pDescriptorSet)
 {
     auto pWrapDescriptorSet = static_cast<DescriptorSet*>(pDescriptorSet);
-    ImCmdSetDescriptorSet cmd = {};
-    pWrapDescriptorSet->MakeCommand(&cmd);
+    A3D_ASSERT(pWrapDescriptorSet != nullptr);
+
+    auto cmd = AllocCmd<ImCmdSetDescriptorSet>(
+        CMD_SET_DESCRIPTORSET,
+        sizeof(void*) * pWrapDescriptorSet->GetDescriptorCount());
+    if (cmd == nullptr)
+    { return; }
+
+    pWrapDescriptorSet->MakeCommand(cmd);
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    DiscardIfRedundant(cmd);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -202,16 +250,25 @@ void CommandList::SetVertexBuffers
     uint64_t*   pOffsets
 )
 {
-    ImCmdSetVertexBuffers cmd = {};
-    cmd.Type        = CMD_SET_VERTEX_BUFFERS;
-    cmd.StartSlot   = startSlot;
-    cmd.Count       = count;
-    memcpy(cmd.pBuffers, ppResources, sizeof(IBuffer) * count);
-    cmd.HasOffset   = (pOffsets != nullptr);
-    if (pOffsets != nullptr)
-    { memcpy(cmd.Offsets, pOffsets, sizeof(uint64_t) * count); }
+    auto hasOffset   = (pOffsets != nullptr);
+    auto payloadSize = sizeof(IBuffer*) * count;
+    if (hasOffset)
+    { payloadSize += sizeof(uint64_t) * count; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    auto cmd = AllocCmd<ImCmdSetVertexBuffers>(CMD_SET_VERTEX_BUFFERS, payloadSize);
+    if (cmd == nullptr)
+    { return; }
+
+    cmd->StartSlot  = startSlot;
+    cmd->Count      = count;
+    cmd->HasOffset  = hasOffset;
+
+    auto pPayload = ImCmdPayload(cmd);
+    memcpy(pPayload, ppResources, sizeof(IBuffer*) * count);
+    if (hasOffset)
+    { memcpy(pPayload + sizeof(IBuffer*) * count, pOffsets, sizeof(uint64_t) * count); }
+
+    DiscardIfRedundant(cmd);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -219,12 +276,14 @@ void CommandList::SetVertexBuffers
 //-------------------------------------------------------------------------------------------------
 void CommandList::SetIndexBuffer(IBuffer* pResource, uint64_t offset)
 {
-    ImCmdSetIndexBuffer cmd = {};
-    cmd.Type    = CMD_SET_INDEX_BUFFER;
-    cmd.pBuffer = pResource;
-    cmd.Offset  = offset;
+    auto cmd = AllocCmd<ImCmdSetIndexBuffer>(CMD_SET_INDEX_BUFFER);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pBuffer = pResource;
+    cmd->Offset  = offset;
+
+    DiscardIfRedundant(cmd);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -237,13 +296,13 @@ void CommandList::TextureBarrier
     RESOURCE_STATE  nextState
 )
 {
-    ImCmdTextureBarrier cmd = {};
-    cmd.Type        = CMD_TEXTURE_BARRIER;
-    cmd.pResource   = pResource;
-    cmd.PrevState   = prevState;
-    cmd.NextState   = nextState;
+    auto cmd = AllocCmd<ImCmdTextureBarrier>(CMD_TEXTURE_BARRIER);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pResource   = pResource;
+    cmd->PrevState   = prevState;
+    cmd->NextState   = nextState;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -256,13 +315,13 @@ void CommandList::BufferBarrier
     RESOURCE_STATE  nextState
 )
 {
-    ImCmdBufferBarrier cmd = {};
-    cmd.Type        = CMD_BUFFER_BARRIER;
-    cmd.pResource   = pResource;
-    cmd.PrevState   = prevState;
-    cmd.NextState   = nextState;
+    auto cmd = AllocCmd<ImCmdBufferBarrier>(CMD_BUFFER_BARRIER);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pResource   = pResource;
+    cmd->PrevState   = prevState;
+    cmd->NextState   = nextState;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -276,14 +335,14 @@ void CommandList::DrawInstanced
     uint32_t    firstInstance
 )
 {
-    ImCmdDrawInstanced cmd = {};
-    cmd.Type            = CMD_DRAW_INSTANCED;
-    cmd.VertexCount     = vertexCount;
-    cmd.InstanceCount   = instanceCount;
-    cmd.FirstVertex     = firstVertex;
-    cmd.FirstInstance   = firstInstance;
+    auto cmd = AllocCmd<ImCmdDrawInstanced>(CMD_DRAW_INSTANCED);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->VertexCount     = vertexCount;
+    cmd->InstanceCount   = instanceCount;
+    cmd->FirstVertex     = firstVertex;
+    cmd->FirstInstance   = firstInstance;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -297,15 +356,15 @@ void CommandList::DrawIndexedInstanced
     int         vertexOffset,
     uint32_t    firstInstance)
 {
-    ImCmdDrawIndexedInstanced cmd = {};
-    cmd.Type            = CMD_DRAW_INDEXED_INSTANCED;
-    cmd.IndexCount      = indexCount;
-    cmd.InstanceCount   = instanceCount;
-    cmd.FirstIndex      = firstIndex;
-    cmd.VertexOffset    = vertexOffset;
-    cmd.FirstInstance   = firstInstance;
+    auto cmd = AllocCmd<ImCmdDrawIndexedInstanced>(CMD_DRAW_INDEXED_INSTANCED);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->IndexCount      = indexCount;
+    cmd->InstanceCount   = instanceCount;
+    cmd->FirstIndex      = firstIndex;
+    cmd->VertexOffset    = vertexOffset;
+    cmd->FirstInstance   = firstInstance;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -313,13 +372,16 @@ void CommandList::DrawIndexedInstanced
 //-------------------------------------------------------------------------------------------------
 void CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z)
 {
-    ImCmdDispatch cmd = {};
-    cmd.Type    = CMD_DISPATCH;
-    cmd.X       = x;
-    cmd.Y       = y;
-    cmd.Z       = z;
+    auto cmd = AllocCmd<ImCmdDispatch>(CMD_DISPATCH);
+    if (cmd == nullptr)
+    { return; }
+
+    cmd->X       = x;
+    cmd->Y       = y;
+    cmd->Z       = z;
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    // UAVとして書き込んだリソースはランタイムにより他のビューが解除されうるので, ディスクリプタセットを再設定させる.
+    m_pLastStateCmd[CMD_SET_DESCRIPTORSET] = nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -327,13 +389,13 @@ void CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z)
 //-------------------------------------------------------------------------------------------------
 void CommandList::DispatchMesh(uint32_t x, uint32_t y, uint32_t z)
 {
-    ImCmdDispatch cmd = {};
-    cmd.Type = CMD_DISPATCH_MESH;
-    cmd.X = x;
-    cmd.Y = y;
-    cmd.Z = z;
+    auto cmd = AllocCmd<ImCmdDispatch>(CMD_DISPATCH_MESH);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->X = x;
+    cmd->Y = y;
+    cmd->Z = z;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -349,16 +411,19 @@ void CommandList::ExecuteIndirect
     uint64_t        counterBufferOffset
 )
 {
-    ImCmdExecuteIndirect cmd = {};
-    cmd.Type                    = CMD_EXECUTE_INDIRECT;
-    cmd.pCommandSet             = pCommandSet;
-    cmd.MaxCommandCount         = maxCommandCount;
-    cmd.pArgumentBuffer         = pArgumentBuffer;
-    cmd.ArgumentBufferOffset    = argumentBufferOffset;
-    cmd.pCounterBuffer          = pCounterBuffer;
-    cmd.CounterBufferOffset     = counterBufferOffset;
+    auto cmd = AllocCmd<ImCmdExecuteIndirect>(CMD_EXECUTE_INDIRECT);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pCommandSet             = pCommandSet;
+    cmd->MaxCommandCount         = maxCommandCount;
+    cmd->pArgumentBuffer         = pArgumentBuffer;
+    cmd->ArgumentBufferOffset    = argumentBufferOffset;
+    cmd->pCounterBuffer          = pCounterBuffer;
+    cmd->CounterBufferOffset     = counterBufferOffset;
+
+    // ディスパッチを含みうるので Dispatch() と同様にディスクリプタセットを再設定させる.
+    m_pLastStateCmd[CMD_SET_DESCRIPTORSET] = nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -366,12 +431,12 @@ void CommandList::ExecuteIndirect
 //-------------------------------------------------------------------------------------------------
 void CommandList::BeginQuery(IQueryPool* pQuery, uint32_t index)
 {
-    ImCmdBeginQuery cmd = {};
-    cmd.Type    = CMD_BEGIN_QUERY;
-    cmd.pQuery  = pQuery;
-    cmd.Index   = index;
+    auto cmd = AllocCmd<ImCmdBeginQuery>(CMD_BEGIN_QUERY);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pQuery  = pQuery;
+    cmd->Index   = index;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -379,12 +444,12 @@ void CommandList::BeginQuery(IQueryPool* pQuery, uint32_t index)
 //-------------------------------------------------------------------------------------------------
 void CommandList::EndQuery(IQueryPool* pQuery, uint32_t index)
 {
-    ImCmdEndQuery cmd = {};
-    cmd.Type    = CMD_END_QUERY;
-    cmd.pQuery  = pQuery;
-    cmd.Index   = index;
+    auto cmd = AllocCmd<ImCmdEndQuery>(CMD_END_QUERY);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pQuery  = pQuery;
+    cmd->Index   = index;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -399,15 +464,15 @@ void CommandList::ResolveQuery
     uint64_t    dstOffset
 )
 {
-    ImCmdResolveQuery cmd = {};
-    cmd.Type        = CMD_RESOLVE_QUERY;
-    cmd.pQuery      = pQuery;
-    cmd.StartIndex  = startIndex;
-    cmd.QueryCount  = queryCount;
-    cmd.pDstBuffer  = pDstBuffer;
-    cmd.DstOffset   = dstOffset;
+    auto cmd = AllocCmd<ImCmdResolveQuery>(CMD_RESOLVE_QUERY);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pQuery      = pQuery;
+    cmd->StartIndex  = startIndex;
+    cmd->QueryCount  = queryCount;
+    cmd->pDstBuffer  = pDstBuffer;
+    cmd->DstOffset   = dstOffset;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -415,11 +480,11 @@ void CommandList::ResolveQuery
 //-------------------------------------------------------------------------------------------------
 void CommandList::ResetQuery(IQueryPool* pQuery)
 {
-    ImCmdResetQuery cmd = {};
-    cmd.Type    = CMD_RESET_QUERY;
-    cmd.pQuery  = pQuery;
+    auto cmd = AllocCmd<ImCmdResetQuery>(CMD_RESET_QUERY);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pQuery  = pQuery;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -431,12 +496,12 @@ void CommandList::CopyTexture
     ITexture*       pSrcResource
 )
 {
-    ImCmdCopyTexture cmd = {};
-    cmd.Type        = CMD_COPY_TEXTURE;
-    cmd.pDstTexture = pDstResource;
-    cmd.pSrcTexture = pSrcResource;
+    auto cmd = AllocCmd<ImCmdCopyTexture>(CMD_COPY_TEXTURE);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pDstTexture = pDstResource;
+    cmd->pSrcTexture = pSrcResource;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -444,12 +509,12 @@ void CommandList::CopyTexture
 //-------------------------------------------------------------------------------------------------
 void CommandList::CopyBuffer(IBuffer* pDstResource, IBuffer* pSrcResource)
 {
-    ImCmdCopyBuffer cmd = {};
-    cmd.Type       = CMD_COPY_BUFFER;
-    cmd.pDstBuffer = pDstResource;
-    cmd.pSrcBuffer = pSrcResource;
+    auto cmd = AllocCmd<ImCmdCopyBuffer>(CMD_COPY_BUFFER);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pDstBuffer = pDstResource;
+    cmd->pSrcBuffer = pSrcResource;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -466,17 +531,17 @@ void CommandList::CopyTextureRegion
     Extent3D        srcExtent
 )
 {
-    ImCmdCopyTextureRegion cmd = {};
-    cmd.Type            = CMD_COPY_TEXTURE_REGION;
-    cmd.pDstResource    = pDstResource;
-    cmd.DstSubresource  = dstSubresource;
-    cmd.DstOffset       = dstOffset;
-    cmd.pSrcResource    = pSrcResource;
-    cmd.SrcSubresource  = srcSubresource;
-    cmd.SrcOffset       = srcOffset;
-    cmd.SrcExtent       = srcExtent;
+    auto cmd = AllocCmd<ImCmdCopyTextureRegion>(CMD_COPY_TEXTURE_REGION);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pDstResource    = pDstResource;
+    cmd->DstSubresource  = dstSubresource;
+    cmd->DstOffset       = dstOffset;
+    cmd->pSrcResource    = pSrcResource;
+    cmd->SrcSubresource  = srcSubresource;
+    cmd->SrcOffset       = srcOffset;
+    cmd->SrcExtent       = srcExtent;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -491,15 +556,15 @@ void CommandList::CopyBufferRegion
     uint64_t    byteCount
 )
 {
-    ImCmdCopyBufferRegion cmd = {};
-    cmd.Type        = CMD_COPY_BUFFER_REGION;
-    cmd.pDstBuffer  = pDstBuffer;
-    cmd.DstOffset   = dstOffset;
-    cmd.pSrcBuffer  = pSrcBuffer;
-    cmd.SrcOffset   = srcOffset;
-    cmd.ByteCount   = byteCount;
+    auto cmd = AllocCmd<ImCmdCopyBufferRegion>(CMD_COPY_BUFFER_REGION);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pDstBuffer  = pDstBuffer;
+    cmd->DstOffset   = dstOffset;
+    cmd->pSrcBuffer  = pSrcBuffer;
+    cmd->SrcOffset   = srcOffset;
+    cmd->ByteCount   = byteCount;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -514,15 +579,15 @@ void CommandList::CopyBufferToTexture
     uint64_t        srcOffset
 )
 {
-    ImCmdCopyBufferToTexture cmd = {};
-    cmd.Type            = CMD_COPY_BUFFER_TO_TEXTURE;
-    cmd.pDstTexture     = pDstTexture;
-    cmd.DstSubresource  = dstSubresource;
-    cmd.DstOffset       = dstOffset;
-    cmd.pSrcBuffer      = pSrcBuffer;
-    cmd.SrcOffset       = srcOffset;
+    auto cmd = AllocCmd<ImCmdCopyBufferToTexture>(CMD_COPY_BUFFER_TO_TEXTURE);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pDstTexture     = pDstTexture;
+    cmd->DstSubresource  = dstSubresource;
+    cmd->DstOffset       = dstOffset;
+    cmd->pSrcBuffer      = pSrcBuffer;
+    cmd->SrcOffset       = srcOffset;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -538,16 +603,16 @@ void CommandList::CopyTextureToBuffer
     Extent3D        srcExtent
 )
 {
-    ImCmdCopyTextureToBuffer cmd = {};
-    cmd.Type            = CMD_COPY_TEXTURE_TO_BUFFER;
-    cmd.pDstBuffer      = pDstBuffer;
-    cmd.DstOffset       = dstOffset;
-    cmd.pSrcTexture     = pSrcTexture;
-    cmd.SrcSubresource  = srcSubresource;
-    cmd.SrcOffset       = srcOffset;
-    cmd.SrcExtent       = srcExtent;
+    auto cmd = AllocCmd<ImCmdCopyTextureToBuffer>(CMD_COPY_TEXTURE_TO_BUFFER);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pDstBuffer      = pDstBuffer;
+    cmd->DstOffset       = dstOffset;
+    cmd->pSrcTexture     = pSrcTexture;
+    cmd->SrcSubresource  = srcSubresource;
+    cmd->SrcOffset       = srcOffset;
+    cmd->SrcExtent       = srcExtent;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -561,14 +626,14 @@ void CommandList::ResolveSubresource
     uint32_t        srcSubresource
 )
 {
-    ImCmdResolveSubresource cmd = {};
-    cmd.Type            = CMD_RESOLVE_SUBRESOURCE;
-    cmd.pDstResource    = pDstResource;
-    cmd.DstSubresource  = dstSubresource;
-    cmd.pSrcResource    = pSrcResource;
-    cmd.SrcSubresource  = srcSubresource;
+    auto cmd = AllocCmd<ImCmdResolveSubresource>(CMD_RESOLVE_SUBRESOURCE);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->pDstResource    = pDstResource;
+    cmd->DstSubresource  = dstSubresource;
+    cmd->pSrcResource    = pSrcResource;
+    cmd->SrcSubresource  = srcSubresource;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -579,7 +644,64 @@ void CommandList::ExecuteBundle(ICommandList* pCommandList)
     auto pWrapCommandList = reinterpret_cast<CommandList*>(pCommandList);
     A3D_ASSERT(pWrapCommandList != nullptr);
 
-    m_Buffer.Append(pWrapCommandList->GetCommandBuffer());
+    // 変換済みのバンドルは参照のみ記録し, キューが直接再生する.
+    if (pWrapCommandList->GetBundle() != nullptr)
+    {
+        auto cmd = AllocCmd<ImCmdExecuteBundle>(CMD_EXECUTE_BUNDLE);
+        if (cmd != nullptr)
+        { cmd->pBundle = pWrapCommandList; }
+    }
+    else
+    {
+        m_Buffer.Append(pWrapCommandList->GetCommandBuffer());
+    }
+
+    // バンドル内で変更されたステートは追跡できないので全て無効化する.
+    ResetStateCache();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      並列記録用のコンテキストを開きます.
+//-------------------------------------------------------------------------------------------------
+bool CommandList::OpenParallelContexts(uint32_t count, ICommandList** ppContexts)
+{
+    if (count == 0 || ppContexts == nullptr || m_IsContext)
+    { return false; }
+
+    // 不足分のみ生成し, 生成済みのコンテキストは次回以降の記録でも再利用する.
+    while(m_Contexts.size() < m_ContextCount + count)
+    {
+        auto pContext = new CommandList();
+        if (pContext == nullptr)
+        { return false; }
+
+        if (!pContext->Init(m_pDevice, COMMANDLIST_TYPE_BUNDLE, true))
+        {
+            SafeRelease(pContext);
+            return false;
+        }
+
+        m_Contexts.push_back(pContext);
+    }
+
+    ParallelBatch batch = {};
+    batch.SegmentIndex = m_Buffer.Mark();
+    batch.FirstContext = m_ContextCount;
+    batch.ContextCount = count;
+    m_ParallelBatches.push_back(batch);
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto pContext = m_Contexts[m_ContextCount + i];
+        pContext->Begin();
+        ppContexts[i] = pContext;
+    }
+
+    m_ContextCount += count;
+
+    // コンテキスト内で変更されるステートは追跡できないので全て無効化する.
+    ResetStateCache();
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -587,11 +709,14 @@ void CommandList::ExecuteBundle(ICommandList* pCommandList)
 //-------------------------------------------------------------------------------------------------
 void CommandList::PushMarker(const char* tag)
 {
-    ImCmdPushMarker cmd = {};
-    cmd.Type = CMD_PUSH_MARKER;
-    strcpy_s( cmd.Tag, tag );
+    auto length = static_cast<uint32_t>(strlen(tag));
+
+    auto cmd = AllocCmd<ImCmdPushMarker>(CMD_PUSH_MARKER, length + 1);
+    if (cmd == nullptr)
+    { return; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    cmd->Length = length;
+    memcpy(ImCmdPayload(cmd), tag, length + 1);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -599,10 +724,7 @@ void CommandList::PushMarker(const char* tag)
 //-------------------------------------------------------------------------------------------------
 void CommandList::PopMarker()
 {
-    ImCmdPopMarker cmd = {};
-    cmd.Type = CMD_POP_MARKER;
-
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    AllocCmd<ImCmdPopMarker>(CMD_POP_MARKER);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -610,14 +732,14 @@ void CommandList::PopMarker()
 //-------------------------------------------------------------------------------------------------
 bool CommandList::UpdateConstantBuffer(IBuffer* pBuffer, size_t offset, size_t size, const void* pData)
 {
-    ImCmdUpdateConstantBuffer cmd = {};
-    cmd.Type    = CMD_UPDATE_CONSTANT_BUFFER;
-    cmd.pBuffer = pBuffer;
-    cmd.Offset  = offset;
-    cmd.Size    = size;
+    auto cmd = AllocCmd<ImCmdUpdateConstantBuffer>(CMD_UPDATE_CONSTANT_BUFFER, size);
+    if (cmd == nullptr)
+    { return false; }
 
-    m_Buffer.Push(&cmd, sizeof(cmd));
-    m_Buffer.Push(pData, size);
+    cmd->pBuffer = pBuffer;
+    cmd->Offset  = offset;
+    cmd->Size    = size;
+    memcpy(ImCmdPayload(cmd), pData, size);
     return true;
 }
 
@@ -626,11 +748,26 @@ bool CommandList::UpdateConstantBuffer(IBuffer* pBuffer, size_t offset, size_t s
 //-------------------------------------------------------------------------------------------------
 void CommandList::End()
 {
-    ImCmdEnd cmd = {};
-    cmd.Type = (m_Type == COMMANDLIST_TYPE_DIRECT) ? CMD_END : CMD_SUB_END;
-
-    m_Buffer.Push(&cmd, sizeof(cmd));
+    AllocCmd<ImCmdEnd>((m_Type == COMMANDLIST_TYPE_DIRECT) ? CMD_END : CMD_SUB_END);
     m_Buffer.Close();
+
+    // 並列記録したコンテキストを開いた位置へインデックス順に連結する.
+    // 後ろから挿入すれば手前の挿入位置はずれないので, 逆順に処理する.
+    for(auto i=m_ParallelBatches.size(); i>0; --i)
+    {
+        auto& batch = m_ParallelBatches[i - 1];
+        for(auto j=batch.ContextCount; j>0; --j)
+        {
+            auto pContext = m_Contexts[batch.FirstContext + j - 1];
+            pContext->End();
+            m_Buffer.Insert(batch.SegmentIndex, &pContext->m_Buffer);
+        }
+    }
+
+    // バンドルは一度だけネイティブ呼び出し列に変換しておく.
+    // 変換できない場合はコマンドバッファを参照する従来の方法で実行する.
+    if (m_pBundle != nullptr)
+    { m_pBundle->Compile(&m_Buffer); }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -639,6 +776,80 @@ void CommandList::End()
 const CommandBuffer* CommandList::GetCommandBuffer() const
 { return &m_Buffer; }
 
+//-------------------------------------------------------------------------------------------------
+//      省略したコマンド数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t CommandList::GetElidedCommandCount() const
+{ return m_ElidedCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      変換済みのバンドルを取得します.
+//-------------------------------------------------------------------------------------------------
+const Bundle* CommandList::GetBundle() const
+{
+    if (m_pBundle == nullptr || !m_pBundle->IsCompiled())
+    { return nullptr; }
+
+    return m_pBundle;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      直前に記録したステート設定コマンドと同じであれば破棄します.
+//-------------------------------------------------------------------------------------------------
+bool CommandList::DiscardIfRedundant(ImCmdBase* pCmd)
+{
+    // コマンドはゼロ初期化されているのでパディングを含めて比較できる.
+    // チャンクは再配置されないので, 記録済みコマンドへのポインタは Reset() まで有効.
+    auto& pLast = m_pLastStateCmd[pCmd->Type];
+    if (pLast != nullptr)
+    {
+        if (pLast->CmdSize == pCmd->CmdSize && memcmp(pLast, pCmd, pCmd->CmdSize) == 0)
+        {
+            m_Buffer.Rewind(pCmd->CmdSize);
+            m_ElidedCount++;
+            return true;
+        }
+    }
+
+    pLast = pCmd;
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ステートのキャッシュをリセットします.
+//-------------------------------------------------------------------------------------------------
+void CommandList::ResetStateCache()
+{
+    for(auto i=0u; i<CmdTypeCount; ++i)
+    { m_pLastStateCmd[i] = nullptr; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool CommandList::Init(IDevice* pDevice, COMMANDLIST_TYPE type, bool isContext)
+{
+    m_pDevice = pDevice;
+    m_pDevice->AddRef();
+    m_Type      = type;
+    m_IsContext = isContext;
+
+    // チャンクはデバイスが保持するプールから取得するため, BufferSize はサイズ検証のみに用いる.
+    auto pChunkPool = static_cast<Device*>(pDevice)->GetCommandChunkPool();
+    if (!m_Buffer.Init(pChunkPool))
+    { return false; }
+
+    // 並列記録用のコンテキストは親に連結されるだけなので変換しない.
+    if (type == COMMANDLIST_TYPE_BUNDLE && !isContext)
+    {
+        m_pBundle = new Bundle();
+        if (m_pBundle == nullptr)
+        { return false; }
+    }
+
+    return true;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
@@ -659,11 +870,7 @@ bool CommandList::Create
     if ( instance == nullptr )
     { return false; }
 
-    instance->m_pDevice = pDevice;
-    instance->m_pDevice->AddRef();
-    instance->m_Type = pDesc->Type;
-    
-    if (!instance->m_Buffer.Init(pDesc->BufferSize))
+    if (!instance->Init(pDevice, pDesc->Type, false))
     {
         SafeRelease(instance);
         return false;
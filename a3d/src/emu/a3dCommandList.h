@@ -8,6 +8,8 @@
 
 namespace a3d {
 
+class Bundle;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // CommandList class 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -388,6 +390,18 @@ public:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY ExecuteBundle(ICommandList* pCommandList) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      並列記録用のコンテキストを開きます.
+    //!
+    //! @param[in]      count           開くコンテキスト数です.
+    //! @param[out]     ppContexts      コンテキストの格納先です.
+    //! @retval true    コンテキストを開くのに成功.
+    //! @retval false   コンテキストを開くのに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY OpenParallelContexts(
+        uint32_t        count,
+        ICommandList**  ppContexts) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      デバッグマーカーをプッシュします.
     //!
@@ -428,14 +442,49 @@ public:
     //---------------------------------------------------------------------------------------------
     const CommandBuffer* A3D_APIENTRY GetCommandBuffer() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      冗長なため記録を省略したコマンド数を取得します.
+    //!
+    //! @return     Begin() 呼び出し以降に省略したコマンド数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetElidedCommandCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      変換済みのバンドルを取得します.
+    //!
+    //! @return     End() 時にネイティブ呼び出し列へ変換できた場合はバンドルを返却します.
+    //!             バンドル以外のコマンドリスト, または変換できなかった場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    const Bundle* A3D_APIENTRY GetBundle() const;
+
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // ParallelBatch structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct ParallelBatch
+    {
+        uint32_t    SegmentIndex;   //!< 連結先のセグメント位置です.
+        uint32_t    FirstContext;   //!< 先頭コンテキストの番号です.
+        uint32_t    ContextCount;   //!< コンテキスト数です.
+    };
+
+    template<typename T>
+    using TrackedArray = std::vector<T, StdAllocator<T>>;
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
-    std::atomic<uint32_t>   m_RefCount;     //!< 参照カウントです.
-    IDevice*                m_pDevice;      //!< デバイスです.
-    COMMANDLIST_TYPE        m_Type;         //!< コマンドリストタイプです.
-    CommandBuffer           m_Buffer;       //!< コマンドバッファです.
+    std::atomic<uint32_t>           m_RefCount;                     //!< 参照カウントです.
+    IDevice*                        m_pDevice;                      //!< デバイスです.
+    COMMANDLIST_TYPE                m_Type;                         //!< コマンドリストタイプです.
+    CommandBuffer                   m_Buffer;                       //!< コマンドバッファです.
+    ImCmdBase*                      m_pLastStateCmd[CmdTypeCount];  //!< 直前に記録したステート設定コマンドです.
+    uint32_t                        m_ElidedCount;                  //!< 省略したコマンド数です.
+    Bundle*                         m_pBundle;                      //!< 変換済みのバンドルです.
+    TrackedArray<CommandList*>      m_Contexts;                     //!< 並列記録用のコンテキストです.
+    TrackedArray<ParallelBatch>     m_ParallelBatches;              //!< 開いたコンテキストの連結情報です.
+    uint32_t                        m_ContextCount;                 //!< 使用中のコンテキスト数です.
+    bool                            m_IsContext;                    //!< 並列記録用のコンテキストかどうか?
 
     //=============================================================================================
     // private methods.
@@ -451,6 +500,57 @@ private:
     //---------------------------------------------------------------------------------------------
     ~CommandList();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDevice         デバイスです.
+    //! @param[in]      type            コマンドリストタイプです.
+    //! @param[in]      isContext       並列記録用のコンテキストかどうか?
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(IDevice* pDevice, COMMANDLIST_TYPE type, bool isContext);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コマンドバッファ上に直接コマンドを確保します.
+    //!
+    //! @param[in]      type            コマンドタイプです.
+    //! @param[in]      payloadSize     コマンドに続くペイロードのサイズです.
+    //! @return     確保したコマンドを返却します. 確保に失敗した場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    template<typename T>
+    T* AllocCmd(CMD_TYPE type, size_t payloadSize = 0)
+    {
+        auto size = ImCmdAlign(sizeof(T));
+        if (payloadSize > 0)
+        { size += ImCmdAlign(payloadSize); }
+
+        auto cmd = static_cast<T*>(m_Buffer.Alloc(size));
+        if (cmd == nullptr)
+        { return nullptr; }
+
+        // 冗長なコマンドをバイト比較で検出できるようにパディングも含めてゼロクリアしておく.
+        memset(cmd, 0, size);
+
+        cmd->Type    = type;
+        cmd->CmdSize = static_cast<uint32_t>(size);
+        return cmd;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      直前に記録した同じ種類のステート設定コマンドと同一であれば破棄します.
+    //!
+    //! @param[in]      pCmd        直前に確保したコマンドです.
+    //! @retval true    冗長なため破棄しました.
+    //! @retval false   記録しました.
+    //---------------------------------------------------------------------------------------------
+    bool DiscardIfRedundant(ImCmdBase* pCmd);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ステートのキャッシュをリセットします.
+    //---------------------------------------------------------------------------------------------
+    void ResetStateCache();
+
     CommandList     (const CommandList&) = delete;
     void operator = (const CommandList&) = delete;
 };
@@ -53,12 +53,19 @@ enum CMD_TYPE
     CMD_END,                            //!< ICommandList::End() For COMMANDLIST_TYPE_DIRECT
 };
 
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const size_t   ImCmdAlignment = 8;               //!< コマンドのアライメントです. ポインタと64bit値を直接読めるようにします.
+static const uint32_t CmdTypeCount   = CMD_END + 1;     //!< コマンドタイプ数です.
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // ImCmdBase    structure
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 struct ImCmdBase 
 {
     CMD_TYPE    Type;
+    uint32_t    CmdSize;    //!< ペイロードを含めたコマンドサイズです. 次のコマンドはここから辿ります.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -82,8 +89,8 @@ struct ImCmdClearFrameBuffer : ImCmdBase
 {
     uint32_t                ClearColorCount;
     bool                    HasDepth;
-    ClearColorValue         ClearColors[8];
     ClearDepthStencilValue  ClearDepthStencil;
+    // ここから ClearColorValue が ClearColorCount 分はいる.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -108,7 +115,7 @@ struct ImCmdSetStencilReference : ImCmdBase
 struct ImCmdSetViewports : ImCmdBase
 {
     uint32_t    Count;
-    Viewport    Viewports[16];
+    // ここから Viewport が Count 分はいる.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -117,7 +124,7 @@ struct ImCmdSetViewports : ImCmdBase
 struct ImCmdSetScissors : ImCmdBase
 {
     uint32_t    Count;
-    Rect        Rects[16];
+    // ここから Rect が Count 分はいる.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -134,7 +141,7 @@ struct ImCmdSetPipelineState : ImCmdBase
 struct ImCmdSetDescriptorSet : ImCmdBase
 {
     DescriptorSetLayoutDesc*    pDesc;
-    void*                       pDescriptor[64];
+    // ここからディスクリプタのポインタが pDesc->EntryCount 分はいる.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -144,9 +151,8 @@ struct ImCmdSetVertexBuffers : ImCmdBase
 {
     uint32_t    StartSlot;
     uint32_t    Count;
-    IBuffer*    pBuffers[32];
     bool        HasOffset;
-    uint64_t    Offsets[32];
+    // ここから IBuffer* が Count 分はいり, HasOffset が true の場合は続けて uint64_t が Count 分はいる.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -342,12 +348,21 @@ struct ImCmdResolveSubresource : ImCmdBase
     uint32_t        SrcSubresource;
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ImCmdExecuteBundle structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct ImCmdExecuteBundle : ImCmdBase
+{
+    ICommandList*   pBundle;    // 変換済みのバンドルです. 実行時に直接再生します.
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // ImCmdPushMarker stcuture
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 struct ImCmdPushMarker : ImCmdBase
 {
-    char        Tag[256];
+    uint32_t    Length;
+    // ここから終端文字を含めたタグ文字列が Length + 1 分はいる.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -373,4 +388,23 @@ struct ImCmdUpdateConstantBuffer: ImCmdBase
 struct ImCmdEnd : ImCmdBase
 { /* NOTHING */ };
 
+//-------------------------------------------------------------------------------------------------
+//! @brief      コマンドサイズをアライメントに切り上げます.
+//!
+//! @param[in]      size        サイズです.
+//! @return     切り上げたサイズを返却します.
+//-------------------------------------------------------------------------------------------------
+inline size_t ImCmdAlign(size_t size)
+{ return (size + ImCmdAlignment - 1) & ~(ImCmdAlignment - 1); }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      コマンドに続くペイロードの先頭を取得します.
+//!
+//! @param[in]      pCmd        コマンドです.
+//! @return     ペイロードの先頭ポインタを返却します.
+//-------------------------------------------------------------------------------------------------
+template<typename T>
+inline uint8_t* ImCmdPayload(T* pCmd)
+{ return reinterpret_cast<uint8_t*>(pCmd) + ImCmdAlign(sizeof(T)); }
+
 } // namespace a3d
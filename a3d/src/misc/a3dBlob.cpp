@@ -36,9 +36,11 @@ bool Blob::Init(size_t size)
 
     // メモリ確保.
     m_pBuffer = a3d_alloc(size, DefaultAlignment);
+    if (m_pBuffer == nullptr)
+    { return false; }
 
-    // nullptrじゃなければ成功.
-    return m_pBuffer != nullptr;
+    m_Size = size;
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -51,6 +53,8 @@ void Blob::Term()
         a3d_free(m_pBuffer);
         m_pBuffer = nullptr;
     }
+
+    m_Size = 0;
 }
 
 //-------------------------------------------------------------------------------------------------
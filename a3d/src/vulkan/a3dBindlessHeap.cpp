@@ -0,0 +1,449 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dBindlessHeap.cpp
+// Desc : Bindless Descriptor Heap.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+const VkDescriptorType kHeapDescriptorTypes[a3d::BindlessHeap::HEAP_TYPE_COUNT] = {
+    VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    VK_DESCRIPTOR_TYPE_SAMPLER,
+};
+
+} // namespace /* anonymous */
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BindlessHeap class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+BindlessHeap::BindlessHeap()
+: m_pDevice             (nullptr)
+, m_DescriptorSetLayout (null_handle)
+, m_PipelineLayout      (null_handle)
+, m_DescriptorPool      (null_handle)
+, m_DescriptorSet       (null_handle)
+{
+    for(auto i=0; i<HEAP_TYPE_COUNT; ++i)
+    {
+        m_Lists[i].pFreeIndices = nullptr;
+        m_Lists[i].FreeCount    = 0;
+        m_Lists[i].Capacity     = 0;
+        m_Lists[i].pRetired     = nullptr;
+        m_Lists[i].RetiredHead  = 0;
+        m_Lists[i].RetiredCount = 0;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+BindlessHeap::~BindlessHeap()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool BindlessHeap::Init(Device* pDevice, uint32_t resourceCount, uint32_t samplerCount)
+{
+#if defined(VK_EXT_descriptor_indexing)
+    if (pDevice == nullptr || resourceCount == 0 || samplerCount == 0)
+    { return false; }
+
+    m_pDevice = pDevice;
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT( pNativeDevice != null_handle );
+
+    uint32_t counts[HEAP_TYPE_COUNT] = {
+        resourceCount,
+        resourceCount,
+        samplerCount
+    };
+
+    // 空き番号リストを初期化. 小さい番号から払い出されるように逆順に積んでおく.
+    for(auto i=0; i<HEAP_TYPE_COUNT; ++i)
+    {
+        m_Lists[i].pFreeIndices = new uint32_t [counts[i]];
+        if (m_Lists[i].pFreeIndices == nullptr)
+        { return false; }
+
+        for(auto j=0u; j<counts[i]; ++j)
+        { m_Lists[i].pFreeIndices[j] = counts[i] - 1 - j; }
+
+        m_Lists[i].FreeCount = counts[i];
+        m_Lists[i].Capacity  = counts[i];
+
+        // 全ての番号が同時に回収待ちになっても溢れないよう最大数分確保する.
+        m_Lists[i].pRetired = new RetireEntry [counts[i]];
+        if (m_Lists[i].pRetired == nullptr)
+        { return false; }
+
+        m_Lists[i].RetiredHead  = 0;
+        m_Lists[i].RetiredCount = 0;
+    }
+
+    // ディスクリプタセットレイアウトを生成.
+    {
+        VkDescriptorSetLayoutBinding bindings    [HEAP_TYPE_COUNT];
+        VkDescriptorBindingFlagsEXT  bindingFlags[HEAP_TYPE_COUNT];
+        for(auto i=0; i<HEAP_TYPE_COUNT; ++i)
+        {
+            bindings[i].binding             = i;
+            bindings[i].descriptorType      = kHeapDescriptorTypes[i];
+            bindings[i].descriptorCount     = counts[i];
+            bindings[i].stageFlags          = VK_SHADER_STAGE_ALL;
+            bindings[i].pImmutableSamplers  = nullptr;
+
+            // 未登録の番号はシェーダから参照されない限り不正とならないようにしておく.
+            bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT
+                            | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT
+                            | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+        }
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT flagsInfo = {};
+        flagsInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        flagsInfo.pNext         = nullptr;
+        flagsInfo.bindingCount  = HEAP_TYPE_COUNT;
+        flagsInfo.pBindingFlags = bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo info = {};
+        info.sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        info.pNext          = &flagsInfo;
+        info.flags          = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        info.bindingCount   = HEAP_TYPE_COUNT;
+        info.pBindings      = bindings;
+
+        auto ret = vkCreateDescriptorSetLayout( pNativeDevice, &info, nullptr, &m_DescriptorSetLayout );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    // ヒープのみを含むパイプラインレイアウトを生成.
+    {
+        VkPipelineLayoutCreateInfo info = {};
+        info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        info.pNext                  = nullptr;
+        info.flags                  = 0;
+        info.setLayoutCount         = 1;
+        info.pSetLayouts            = &m_DescriptorSetLayout;
+        info.pushConstantRangeCount = 0;
+        info.pPushConstantRanges    = nullptr;
+
+        auto ret = vkCreatePipelineLayout( pNativeDevice, &info, nullptr, &m_PipelineLayout );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    // ディスクリプタプールを生成.
+    {
+        VkDescriptorPoolSize poolSize[HEAP_TYPE_COUNT];
+        for(auto i=0; i<HEAP_TYPE_COUNT; ++i)
+        {
+            poolSize[i].type            = kHeapDescriptorTypes[i];
+            poolSize[i].descriptorCount = counts[i];
+        }
+
+        VkDescriptorPoolCreateInfo info = {};
+        info.sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        info.pNext          = nullptr;
+        info.flags          = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        info.maxSets        = 1;
+        info.poolSizeCount  = HEAP_TYPE_COUNT;
+        info.pPoolSizes     = poolSize;
+
+        auto ret = vkCreateDescriptorPool( pNativeDevice, &info, nullptr, &m_DescriptorPool );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    // ディスクリプタセットを確保.
+    {
+        VkDescriptorSetAllocateInfo info = {};
+        info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        info.pNext              = nullptr;
+        info.descriptorPool     = m_DescriptorPool;
+        info.descriptorSetCount = 1;
+        info.pSetLayouts        = &m_DescriptorSetLayout;
+
+        auto ret = vkAllocateDescriptorSets( pNativeDevice, &info, &m_DescriptorSet );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    return true;
+#else
+    A3D_UNUSED(pDevice);
+    A3D_UNUSED(resourceCount);
+    A3D_UNUSED(samplerCount);
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void BindlessHeap::Term()
+{
+    if (m_pDevice != nullptr)
+    {
+        auto pNativeDevice = m_pDevice->GetVulkanDevice();
+        A3D_ASSERT( pNativeDevice != null_handle );
+
+        // ディスクリプタセットはプールと一緒に破棄される.
+        if ( m_DescriptorPool != null_handle )
+        {
+            vkDestroyDescriptorPool( pNativeDevice, m_DescriptorPool, nullptr );
+            m_DescriptorPool = null_handle;
+            m_DescriptorSet  = null_handle;
+        }
+
+        if ( m_PipelineLayout != null_handle )
+        {
+            vkDestroyPipelineLayout( pNativeDevice, m_PipelineLayout, nullptr );
+            m_PipelineLayout = null_handle;
+        }
+
+        if ( m_DescriptorSetLayout != null_handle )
+        {
+            vkDestroyDescriptorSetLayout( pNativeDevice, m_DescriptorSetLayout, nullptr );
+            m_DescriptorSetLayout = null_handle;
+        }
+    }
+
+    for(auto i=0; i<HEAP_TYPE_COUNT; ++i)
+    {
+        if (m_Lists[i].pFreeIndices != nullptr)
+        {
+            delete [] m_Lists[i].pFreeIndices;
+            m_Lists[i].pFreeIndices = nullptr;
+        }
+
+        if (m_Lists[i].pRetired != nullptr)
+        {
+            delete [] m_Lists[i].pRetired;
+            m_Lists[i].pRetired = nullptr;
+        }
+
+        m_Lists[i].FreeCount    = 0;
+        m_Lists[i].Capacity     = 0;
+        m_Lists[i].RetiredHead  = 0;
+        m_Lists[i].RetiredCount = 0;
+    }
+
+    m_pDevice = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      イメージビューを登録します.
+//-------------------------------------------------------------------------------------------------
+uint32_t BindlessHeap::AllocTexture(VkImageView imageView, VkImageLayout imageLayout)
+{
+    auto index = Alloc(HEAP_TYPE_TEXTURE);
+    if (index == UINT32_MAX)
+    { return index; }
+
+    VkDescriptorImageInfo info = {};
+    info.sampler     = null_handle;
+    info.imageView   = imageView;
+    info.imageLayout = imageLayout;
+
+    Write(HEAP_TYPE_TEXTURE, index, &info, nullptr);
+    return index;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ストレージバッファを登録します.
+//-------------------------------------------------------------------------------------------------
+uint32_t BindlessHeap::AllocBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    auto index = Alloc(HEAP_TYPE_BUFFER);
+    if (index == UINT32_MAX)
+    { return index; }
+
+    VkDescriptorBufferInfo info = {};
+    info.buffer = buffer;
+    info.offset = offset;
+    info.range  = range;
+
+    Write(HEAP_TYPE_BUFFER, index, nullptr, &info);
+    return index;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サンプラーを登録します.
+//-------------------------------------------------------------------------------------------------
+uint32_t BindlessHeap::AllocSampler(VkSampler sampler)
+{
+    auto index = Alloc(HEAP_TYPE_SAMPLER);
+    if (index == UINT32_MAX)
+    { return index; }
+
+    VkDescriptorImageInfo info = {};
+    info.sampler     = sampler;
+    info.imageView   = null_handle;
+    info.imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    Write(HEAP_TYPE_SAMPLER, index, &info, nullptr);
+    return index;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      登録を解除します.
+//-------------------------------------------------------------------------------------------------
+void BindlessHeap::Free(HEAP_TYPE type, uint32_t index)
+{
+    auto& list = m_Lists[type];
+    if (index >= list.Capacity)
+    { return; }
+
+    // 実行済みのコマンドがまだ参照している可能性があるので, 直ちには再利用せず
+    // 全てのキューでそれまでのサブミットが完了してから空き番号に戻す.
+    // ディスクリプタは PARTIALLY_BOUND なので書き戻さずに番号だけ返却する.
+    uint64_t retireValues[Device::QueueCount];
+    GetQueueValues(retireValues, false);
+
+    std::lock_guard<std::mutex> locker(list.Mutex);
+    A3D_ASSERT(list.FreeCount + list.RetiredCount < list.Capacity);
+
+    auto tail = (list.RetiredHead + list.RetiredCount) % list.Capacity;
+    list.pRetired[tail].Index = index;
+    for(auto i=0u; i<Device::QueueCount; ++i)
+    { list.pRetired[tail].RetireValue[i] = retireValues[i]; }
+    list.RetiredCount++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタセットレイアウトを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDescriptorSetLayout BindlessHeap::GetVulkanDescriptorSetLayout() const
+{ return m_DescriptorSetLayout; }
+
+//-------------------------------------------------------------------------------------------------
+//      パイプラインレイアウトを取得します.
+//-------------------------------------------------------------------------------------------------
+VkPipelineLayout BindlessHeap::GetVulkanPipelineLayout() const
+{ return m_PipelineLayout; }
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタセットを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDescriptorSet BindlessHeap::GetVulkanDescriptorSet() const
+{ return m_DescriptorSet; }
+
+//-------------------------------------------------------------------------------------------------
+//      空き番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t BindlessHeap::Alloc(HEAP_TYPE type)
+{
+    auto& list = m_Lists[type];
+
+    std::lock_guard<std::mutex> locker(list.Mutex);
+    Reclaim(list);
+
+    if (list.FreeCount == 0)
+    { return UINT32_MAX; }
+
+    list.FreeCount--;
+    return list.pFreeIndices[list.FreeCount];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      GPUでの参照が終わった番号を空き番号に戻します.
+//-------------------------------------------------------------------------------------------------
+void BindlessHeap::Reclaim(IndexList& list)
+{
+    if (list.RetiredCount == 0)
+    { return; }
+
+    uint64_t completedValues[Device::QueueCount];
+    GetQueueValues(completedValues, true);
+
+    // サブミットは順番に完了するので, 先頭から完了済みのものだけ戻せばよい.
+    while (list.RetiredCount > 0)
+    {
+        auto& entry = list.pRetired[list.RetiredHead];
+
+        auto completed = true;
+        for(auto i=0u; i<Device::QueueCount; ++i)
+        {
+            if (entry.RetireValue[i] > completedValues[i])
+            { completed = false; }
+        }
+
+        if (!completed)
+        { break; }
+
+        list.pFreeIndices[list.FreeCount] = entry.Index;
+        list.FreeCount++;
+
+        list.RetiredHead = (list.RetiredHead + 1) % list.Capacity;
+        list.RetiredCount--;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      各キューのサブミットの通し番号を取得します.
+//-------------------------------------------------------------------------------------------------
+void BindlessHeap::GetQueueValues(uint64_t* pValues, bool completed)
+{
+    for(auto i=0u; i<Device::QueueCount; ++i)
+    {
+        auto pQueue = m_pDevice->GetQueue(i);
+        if (pQueue == nullptr)
+        {
+            pValues[i] = (completed) ? UINT64_MAX : 0;
+            continue;
+        }
+
+        if (completed)
+        {
+            // フレームを提出しない使い方でも回収できるように, 追跡用のフェンスを確認する.
+            pQueue->PollCompleted();
+            pValues[i] = pQueue->GetCompletedValue();
+        }
+        else
+        { pValues[i] = pQueue->GetSubmitValue(); }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタを書き込みます.
+//-------------------------------------------------------------------------------------------------
+void BindlessHeap::Write
+(
+    HEAP_TYPE                       type,
+    uint32_t                        index,
+    const VkDescriptorImageInfo*    pImageInfo,
+    const VkDescriptorBufferInfo*   pBufferInfo
+)
+{
+    VkWriteDescriptorSet write = {};
+    write.sType             = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.pNext             = nullptr;
+    write.dstSet            = m_DescriptorSet;
+    write.dstBinding        = uint32_t(type);
+    write.dstArrayElement   = index;
+    write.descriptorCount   = 1;
+    write.descriptorType    = kHeapDescriptorTypes[type];
+    write.pImageInfo        = pImageInfo;
+    write.pBufferInfo       = pBufferInfo;
+    write.pTexelBufferView  = nullptr;
+
+    // UPDATE_AFTER_BIND なので記録済みのコマンドバッファに影響せず更新できるが,
+    // 書き込み先のディスクリプタセットは外部同期が必要.
+    std::lock_guard<std::mutex> locker(m_WriteMutex);
+    vkUpdateDescriptorSets( m_pDevice->GetVulkanDevice(), 1, &write, 0, nullptr );
+}
+
+} // namespace a3d
@@ -0,0 +1,215 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dBindlessHeap.h
+// Desc : Bindless Descriptor Heap.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+class Device;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BindlessHeap class
+//! @brief      デバイスが所有するバインドレスディスクリプタヒープです.
+//! @note       binding = 0 にサンプルイメージ, binding = 1 にストレージバッファ,
+//!             binding = 2 にサンプラーの配列を持つディスクリプタセットを1つだけ保持します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class BindlessHeap : public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // HEAP_TYPE enum
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    enum HEAP_TYPE
+    {
+        HEAP_TYPE_TEXTURE = 0,      //!< サンプルイメージです.
+        HEAP_TYPE_BUFFER,           //!< ストレージバッファです.
+        HEAP_TYPE_SAMPLER,          //!< サンプラーです.
+        HEAP_TYPE_COUNT,
+    };
+
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    BindlessHeap();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~BindlessHeap();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDevice         デバイスです.
+    //! @param[in]      resourceCount   サンプルイメージ・ストレージバッファの最大数です.
+    //! @param[in]      samplerCount    サンプラーの最大数です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       循環参照となるため, デバイスの参照カウントは増やしません.
+    //---------------------------------------------------------------------------------------------
+    bool Init(Device* pDevice, uint32_t resourceCount, uint32_t samplerCount);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イメージビューを登録します.
+    //!
+    //! @param[in]      imageView       イメージビューです.
+    //! @param[in]      imageLayout     イメージレイアウトです.
+    //! @return     ヒープ上の番号を返却します. 空きが無い場合は UINT32_MAX を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t AllocTexture(VkImageView imageView, VkImageLayout imageLayout);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ストレージバッファを登録します.
+    //!
+    //! @param[in]      buffer          バッファです.
+    //! @param[in]      offset          オフセットです.
+    //! @param[in]      range           サイズです.
+    //! @return     ヒープ上の番号を返却します. 空きが無い場合は UINT32_MAX を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t AllocBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サンプラーを登録します.
+    //!
+    //! @param[in]      sampler         サンプラーです.
+    //! @return     ヒープ上の番号を返却します. 空きが無い場合は UINT32_MAX を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t AllocSampler(VkSampler sampler);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      登録を解除します.
+    //!
+    //! @param[in]      type            ヒープタイプです.
+    //! @param[in]      index           ヒープ上の番号です.
+    //! @note       番号はグラフィックスキューで実行済みのサブミットがGPUで完了するまで再利用されません.
+    //---------------------------------------------------------------------------------------------
+    void Free(HEAP_TYPE type, uint32_t index);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタセットレイアウトを取得します.
+    //!
+    //! @return     ディスクリプタセットレイアウトを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkDescriptorSetLayout GetVulkanDescriptorSetLayout() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヒープのみを含むパイプラインレイアウトを取得します.
+    //!
+    //! @return     パイプラインレイアウトを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkPipelineLayout GetVulkanPipelineLayout() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタセットを取得します.
+    //!
+    //! @return     ディスクリプタセットを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkDescriptorSet GetVulkanDescriptorSet() const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // RetireEntry structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct RetireEntry
+    {
+        uint32_t    Index;                              //!< ヒープ上の番号です.
+        uint64_t    RetireValue[Device::QueueCount];    //!< 再利用可能になる各キューのサブミットの通し番号です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // IndexList structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct IndexList
+    {
+        std::mutex      Mutex;          //!< ミューテックスです.
+        uint32_t*       pFreeIndices;   //!< 空き番号のスタックです.
+        uint32_t        FreeCount;      //!< 空き番号数です.
+        uint32_t        Capacity;       //!< 最大数です.
+        RetireEntry*    pRetired;       //!< 回収待ちの番号のリングです.
+        uint32_t        RetiredHead;    //!< 回収待ちの先頭位置です.
+        uint32_t        RetiredCount;   //!< 回収待ちの番号数です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    Device*                 m_pDevice;                      //!< デバイスです.
+    VkDescriptorSetLayout   m_DescriptorSetLayout;          //!< ディスクリプタセットレイアウトです.
+    VkPipelineLayout        m_PipelineLayout;               //!< パイプラインレイアウトです.
+    VkDescriptorPool        m_DescriptorPool;               //!< ディスクリプタプールです.
+    VkDescriptorSet         m_DescriptorSet;                //!< ディスクリプタセットです.
+    IndexList               m_Lists[HEAP_TYPE_COUNT];       //!< 空き番号リストです.
+    std::mutex              m_WriteMutex;                   //!< ディスクリプタ書き込み用ミューテックスです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      空き番号を取得します.
+    //!
+    //! @param[in]      type            ヒープタイプです.
+    //! @return     空き番号を返却します. 空きが無い場合は UINT32_MAX を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Alloc(HEAP_TYPE type);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      GPUでの参照が終わった番号を空き番号に戻します.
+    //!
+    //! @param[in]      list            空き番号リストです. ロック済みである必要があります.
+    //---------------------------------------------------------------------------------------------
+    void Reclaim(IndexList& list);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      各キューのサブミットの通し番号を取得します.
+    //!
+    //! @param[out]     pValues         通し番号の格納先です. Device::QueueCount 個必要です.
+    //! @param[in]      completed       true であれば完了済みの通し番号を, false であれば実行した通し番号を取得します.
+    //---------------------------------------------------------------------------------------------
+    void GetQueueValues(uint64_t* pValues, bool completed);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタを書き込みます.
+    //!
+    //! @param[in]      type            ヒープタイプです.
+    //! @param[in]      index           ヒープ上の番号です.
+    //! @param[in]      pImageInfo      イメージ情報です.
+    //! @param[in]      pBufferInfo     バッファ情報です.
+    //---------------------------------------------------------------------------------------------
+    void Write(
+        HEAP_TYPE                       type,
+        uint32_t                        index,
+        const VkDescriptorImageInfo*    pImageInfo,
+        const VkDescriptorBufferInfo*   pBufferInfo);
+
+    BindlessHeap(const BindlessHeap&) = delete;
+    void operator = (const BindlessHeap&) = delete;
+};
+
+} // namespace a3d
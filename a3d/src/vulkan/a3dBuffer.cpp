@@ -58,6 +58,7 @@ Buffer::Buffer()
 , m_pDevice     (nullptr)
 , m_Buffer      (null_handle)
 , m_Allocation  (null_handle)
+, m_TrackedState(RESOURCE_STATE_UNKNOWN)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -83,6 +84,7 @@ bool Buffer::Init(IDevice* pDevice, const BufferDesc* pDesc)
     auto deviceMemoryProps = m_pDevice->GetVulkanPhysicalDeviceMemoryProperties(0);
 
     memcpy(&m_Desc, pDesc, sizeof(m_Desc));
+    m_TrackedState = pDesc->InitState;
 
     // obt@𐶐܂.
     {
@@ -209,6 +211,24 @@ VkBuffer Buffer::GetVulkanBuffer() const
 RESOURCE_KIND Buffer::GetKind() const
 { return RESOURCE_KIND_BUFFER; }
 
+//-------------------------------------------------------------------------------------------------
+//      \[XXe[gǐՂ邩ǂ`FbN܂.
+//-------------------------------------------------------------------------------------------------
+bool Buffer::IsTracked() const
+{ return (m_Desc.Usage & RESOURCE_USAGE_STATE_TRACKING) != 0; }
+
+//-------------------------------------------------------------------------------------------------
+//      ǐՒ̃\[XXe[g擾܂.
+//-------------------------------------------------------------------------------------------------
+RESOURCE_STATE Buffer::GetTrackedState() const
+{ return m_TrackedState; }
+
+//-------------------------------------------------------------------------------------------------
+//      ǐՒ̃\[XXe[gݒ肵܂.
+//-------------------------------------------------------------------------------------------------
+void Buffer::SetTrackedState(RESOURCE_STATE state)
+{ m_TrackedState = state; }
+
 //-------------------------------------------------------------------------------------------------
 //      s܂.
 //-------------------------------------------------------------------------------------------------
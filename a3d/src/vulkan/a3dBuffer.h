@@ -99,6 +99,28 @@ public:
     //---------------------------------------------------------------------------------------------
     RESOURCE_KIND A3D_APIENTRY GetKind() const override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      \[XXe[gǐՂ邩ǂ`FbN܂.
+    //!
+    //! @retval true    ǐՂ܂.
+    //! @retval false   ǐՂ܂.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY IsTracked() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ǐՒ̃\[XXe[g擾܂.
+    //!
+    //! @return     \[XXe[gԋp܂.
+    //---------------------------------------------------------------------------------------------
+    RESOURCE_STATE A3D_APIENTRY GetTrackedState() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ǐՒ̃\[XXe[gݒ肵܂.
+    //!
+    //! @param[in]      state       \[XXe[gł.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY SetTrackedState(RESOURCE_STATE state);
+
 private:
     //=============================================================================================
     // private variables.
@@ -108,6 +130,7 @@ private:
     BufferDesc              m_Desc;                 //!< \ݒł.
     VkBuffer                m_Buffer;               //!< obt@ł.
     VmaAllocation           m_Allocation;           //!< AP[gł.
+    RESOURCE_STATE          m_TrackedState;         //!< ǐՒ̃\[XXe[gł.
 
     //=============================================================================================
     // private methods.
@@ -18,6 +18,7 @@ BufferView::BufferView()
 : m_RefCount(1)
 , m_pDevice (nullptr)
 , m_pBuffer (nullptr)
+, m_DescriptorIndex(UINT32_MAX)
 { memset(&m_Desc, 0, sizeof(m_Desc)); }
 
 //-------------------------------------------------------------------------------------------------
@@ -45,6 +46,11 @@ bool BufferView::Init(IDevice* pDevice, IBuffer* pBuffer, const BufferViewDesc*
 
     memcpy(&m_Desc, pDesc, sizeof(m_Desc));
 
+    // バインドレスディスクリプタヒープにはストレージバッファとして登録.
+    auto pHeap = m_pDevice->GetBindlessHeap();
+    if (pHeap != nullptr && (m_pBuffer->GetDesc().Usage & RESOURCE_USAGE_UNORDERED_ACCESS_VIEW))
+    { m_DescriptorIndex = pHeap->AllocBuffer(m_pBuffer->GetVulkanBuffer(), m_Desc.Offset, m_Desc.Range); }
+
     return true;
 }
 
@@ -53,6 +59,12 @@ bool BufferView::Init(IDevice* pDevice, IBuffer* pBuffer, const BufferViewDesc*
 //-------------------------------------------------------------------------------------------------
 void BufferView::Term()
 {
+    if (m_DescriptorIndex != UINT32_MAX)
+    {
+        m_pDevice->GetBindlessHeap()->Free(BindlessHeap::HEAP_TYPE_BUFFER, m_DescriptorIndex);
+        m_DescriptorIndex = UINT32_MAX;
+    }
+
     SafeRelease(m_pBuffer);
     SafeRelease(m_pDevice);
 }
@@ -112,6 +124,12 @@ VkBuffer BufferView::GetVulkanBuffer() const
 IBuffer* BufferView::GetResource() const
 { return m_pBuffer; }
 
+//-------------------------------------------------------------------------------------------------
+//      バインドレスディスクリプタヒープ上の番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t BufferView::GetDescriptorIndex() const
+{ return m_DescriptorIndex; }
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
@@ -89,6 +89,13 @@ public:
     //---------------------------------------------------------------------------------------------
     IBuffer* A3D_APIENTRY GetResource() const override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バインドレスディスクリプタヒープ上の番号を取得します.
+    //!
+    //! @return     ヒープ上の番号を返却します. 登録されていない場合は UINT32_MAX を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetDescriptorIndex() const override;
+
 private:
     //=============================================================================================
     // private variables.
@@ -97,6 +104,7 @@ private:
     Device*                 m_pDevice;      //!< デバイスです.
     Buffer*                 m_pBuffer;      //!< バッファです.
     BufferViewDesc          m_Desc;         //!< 構成設定です.
+    uint32_t                m_DescriptorIndex;  //!< バインドレスディスクリプタヒープ上の番号です.
 
     //=============================================================================================
     // private methods.
@@ -10,6 +10,56 @@
 #include "a3dVulkanFunc.h"
 
 
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+//      読み取り専用の状態かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsReadOnlyState(a3d::RESOURCE_STATE state)
+{
+    switch(state)
+    {
+    case a3d::RESOURCE_STATE_GENERAL:
+    case a3d::RESOURCE_STATE_COLOR_WRITE:
+    case a3d::RESOURCE_STATE_UNORDERED_ACCESS:
+    case a3d::RESOURCE_STATE_DEPTH_WRITE:
+    case a3d::RESOURCE_STATE_STREAM_OUT:
+    case a3d::RESOURCE_STATE_COPY_DST:
+    case a3d::RESOURCE_STATE_RESOLVE_DST:
+        return false;
+
+    default:
+        return true;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブリソース範囲が等しいかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsSameRange(const VkImageSubresourceRange& lhs, const VkImageSubresourceRange& rhs)
+{
+    return lhs.aspectMask     == rhs.aspectMask
+        && lhs.baseMipLevel   == rhs.baseMipLevel
+        && lhs.levelCount     == rhs.levelCount
+        && lhs.baseArrayLayer == rhs.baseArrayLayer
+        && lhs.layerCount     == rhs.layerCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      サブリソース範囲が重なっているかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsOverlapRange(const VkImageSubresourceRange& lhs, const VkImageSubresourceRange& rhs)
+{
+    return (lhs.aspectMask & rhs.aspectMask) != 0
+        && lhs.baseMipLevel   < rhs.baseMipLevel   + rhs.levelCount
+        && rhs.baseMipLevel   < lhs.baseMipLevel   + lhs.levelCount
+        && lhs.baseArrayLayer < rhs.baseArrayLayer + rhs.layerCount
+        && rhs.baseArrayLayer < lhs.baseArrayLayer + lhs.layerCount;
+}
+
+} // namespace /* anonymous */
+
+
 namespace a3d {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -20,12 +70,22 @@ namespace a3d {
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
 CommandList::CommandList()
-: m_RefCount        (1)
-, m_pDevice         (nullptr)
-, m_CommandPool     (null_handle)
-, m_CommandBuffer   (null_handle)
-, m_pFrameBuffer    (nullptr)
-{ /* DO_NOTHING */ }
+: m_RefCount                    (1)
+, m_pDevice                     (nullptr)
+, m_CommandPool                 (null_handle)
+, m_CommandBuffer               (null_handle)
+, m_pFrameBuffer                (nullptr)
+, m_Type                        (COMMANDLIST_TYPE_DIRECT)
+, m_SupportedStages             (0)
+, m_PendingTextureBarrierCount  (0)
+, m_PendingBufferBarrierCount   (0)
+, m_FixupCommandBuffer          (null_handle)
+, m_pDescriptorArena            (nullptr)
+, m_TransientSetCount           (0)
+{
+    m_IsHeapBound[0] = false;
+    m_IsHeapBound[1] = false;
+}
 
 //-------------------------------------------------------------------------------------------------
 //      デストラクタです.
@@ -44,9 +104,29 @@ bool CommandList::Init(IDevice* pDevice, COMMANDLIST_TYPE listType)
     m_pDevice = static_cast<Device*>(pDevice);
     m_pDevice->AddRef();
 
+    m_Type = listType;
+
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT( pNativeDevice != null_handle );
 
+    // キューで使用できないステージをバリアに含めないようにする.
+    if (listType == COMMANDLIST_TYPE_COMPUTE)
+    {
+        m_SupportedStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                          | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT
+                          | VK_PIPELINE_STAGE_TRANSFER_BIT
+                          | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    else if (listType == COMMANDLIST_TYPE_COPY)
+    {
+        m_SupportedStages = VK_PIPELINE_STAGE_TRANSFER_BIT
+                          | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    else
+    {
+        m_SupportedStages = m_pDevice->GetGraphicsPipelineStages();
+    }
+
     {
         uint32_t queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 
@@ -104,6 +184,21 @@ bool CommandList::Init(IDevice* pDevice, COMMANDLIST_TYPE listType)
         auto ret = vkAllocateCommandBuffers( pNativeDevice, &info, &m_CommandBuffer );
         if ( ret != VK_SUCCESS )
         { return false; }
+
+        // 追跡対象リソースの補正バリア用.
+        ret = vkAllocateCommandBuffers( pNativeDevice, &info, &m_FixupCommandBuffer );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    // 一時ディスクリプタセット用アリーナ.
+    {
+        m_pDescriptorArena = new DescriptorArena();
+        if (m_pDescriptorArena == nullptr)
+        { return false; }
+
+        if (!m_pDescriptorArena->Init(m_pDevice->GetDescriptorAllocator()))
+        { return false; }
     }
 
     return true;
@@ -120,6 +215,22 @@ void CommandList::Term()
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT(pNativeDevice != null_handle);
 
+    ClearTrackedState();
+
+    for(size_t i=0; i<m_TransientSets.size(); ++i)
+    { SafeRelease(m_TransientSets[i]); }
+
+    m_TransientSets.clear();
+    m_TransientSetCount = 0;
+
+    SafeDelete(m_pDescriptorArena);
+
+    if (m_FixupCommandBuffer != null_handle)
+    {
+        vkFreeCommandBuffers(pNativeDevice, m_CommandPool, 1, &m_FixupCommandBuffer);
+        m_FixupCommandBuffer = null_handle;
+    }
+
     if (m_CommandBuffer != null_handle)
     {
         vkFreeCommandBuffers(pNativeDevice, m_CommandPool, 1, &m_CommandBuffer);
@@ -195,6 +306,15 @@ void CommandList::Begin()
 
     m_pFrameBuffer = nullptr;
 
+    m_PendingTextureBarrierCount = 0;
+    m_PendingBufferBarrierCount  = 0;
+
+    ClearTrackedState();
+
+    // コマンドバッファを再記録できる時点で前回の実行は完了しているので, 一時ディスクリプタセットを再利用する.
+    m_pDescriptorArena->Reset();
+    m_TransientSetCount = 0;
+
     VkViewport dummyViewport = {};
     dummyViewport.width    = 1;
     dummyViewport.height   = 1;
@@ -209,6 +329,10 @@ void CommandList::Begin()
     vkCmdSetBlendConstants( m_CommandBuffer, blendConstant );
 
     vkCmdSetStencilReference( m_CommandBuffer, VK_STENCIL_FRONT_AND_BACK, 0 );
+
+    // バインドレスヒープはバインドレスのレイアウトを最初に設定する時に設定する.
+    m_IsHeapBound[0] = false;
+    m_IsHeapBound[1] = false;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -226,6 +350,9 @@ void CommandList::BeginFrameBuffer(IFrameBuffer* pBuffer)
     if (m_pFrameBuffer == pWrapFrameBuffer)
     { return; }
 
+    // レンダーパス内ではバリアを発行できないので，開始前に出しておく.
+    FlushBarrier();
+
     pWrapFrameBuffer->Bind( this );
     m_pFrameBuffer = pWrapFrameBuffer;
 }
@@ -255,6 +382,8 @@ void CommandList::ClearFrameBuffer
     if (m_pFrameBuffer == nullptr)
     { return; }
 
+    FlushBarrier();
+
     m_pFrameBuffer->Clear(this, clearColorCount, pClearColors, pClearDepthStencil);
 }
 
@@ -352,6 +481,72 @@ void CommandList::SetDescriptorSet(IDescriptorSet* pDescriptorSet)
     pWrapDescriptorSet->Issue( this );
 }
 
+//-------------------------------------------------------------------------------------------------
+//      動的オフセットを指定してディスクリプタセットを設定します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::SetDescriptorSet
+(
+    IDescriptorSet* pDescriptorSet,
+    uint32_t        offsetCount,
+    const uint32_t* pOffsets
+)
+{
+    if (pDescriptorSet == nullptr)
+    { return; }
+
+    auto pWrapDescriptorSet = static_cast<DescriptorSet*>(pDescriptorSet);
+    A3D_ASSERT( pWrapDescriptorSet != nullptr );
+
+    pWrapDescriptorSet->Issue( this, offsetCount, pOffsets );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      一時ディスクリプタセットを割り当てます.
+//-------------------------------------------------------------------------------------------------
+bool CommandList::AllocateTransientDescriptorSet
+(
+    IDescriptorSetLayout*   pLayout,
+    IDescriptorSet**        ppDescriptorSet
+)
+{
+    if (pLayout == nullptr || ppDescriptorSet == nullptr)
+    { return false; }
+
+    auto pWrapLayout = static_cast<DescriptorSetLayout*>(pLayout);
+    A3D_ASSERT(pWrapLayout != nullptr);
+
+    // プッシュディスクリプタで発行する場合はセット自体が不要.
+    VkDescriptorSet set = null_handle;
+    if (!m_pDevice->IsSupportExtension(Device::EXT_KHR_PUSH_DESCRIPTOR))
+    {
+        if (!m_pDescriptorArena->Allocate(
+            pWrapLayout->GetVulkanDescriptorSetLayout(),
+            pWrapLayout->GetVulkanPoolSizes(),
+            pWrapLayout->GetVulkanPoolSizeCount(),
+            &set))
+        { return false; }
+    }
+
+    // オブジェクトは使い回し, 足りない場合のみ生成する.
+    if (m_TransientSetCount == m_TransientSets.size())
+    {
+        DescriptorSet* pSet = nullptr;
+        if (!DescriptorSet::CreateTransient(m_pDevice, &pSet))
+        { return false; }
+
+        m_TransientSets.push_back(pSet);
+    }
+
+    auto pSet = m_TransientSets[m_TransientSetCount];
+    if (!pSet->ResetTransient(pWrapLayout, set))
+    { return false; }
+
+    m_TransientSetCount++;
+
+    *ppDescriptorSet = pSet;
+    return true;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      頂点バッファを設定します.
 //-------------------------------------------------------------------------------------------------
@@ -419,15 +614,16 @@ void CommandList::TextureBarrier
     if (pResource == nullptr)
     { return; }
 
+    // 読み取り同士であれば同期の必要はない.
+    if (prevState == nextState && IsReadOnlyState(nextState))
+    { return; }
+
     auto pWrapResource = static_cast<Texture*>(pResource);
     A3D_ASSERT( pWrapResource != nullptr );
 
     auto pNativeImage = pWrapResource->GetVulkanImage();
     A3D_ASSERT( pNativeImage != null_handle );
 
-    auto oldLayout = ToNativeImageLayout( prevState );
-    auto newLayout = ToNativeImageLayout( nextState );
-
     VkImageSubresourceRange range = {};
     range.aspectMask     = pWrapResource->GetVulkanImageAspectFlags();
     range.baseArrayLayer = 0;
@@ -435,72 +631,7 @@ void CommandList::TextureBarrier
     range.layerCount     = pWrapResource->GetDesc().DepthOrArraySize;
     range.levelCount     = pWrapResource->GetDesc().MipLevels;
 
-    VkPipelineStageFlags srcStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-    VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-
-    if ( prevState == RESOURCE_STATE_PRESENT && nextState == RESOURCE_STATE_COLOR_WRITE )
-    {
-        VkImageMemoryBarrier barrier;
-        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.pNext                           = nullptr;
-        barrier.srcAccessMask                   = VK_ACCESS_MEMORY_READ_BIT;
-        barrier.dstAccessMask                   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        barrier.oldLayout                       = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        barrier.newLayout                       = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-        barrier.subresourceRange                = range;
-        barrier.image                           = pNativeImage;
-
-        vkCmdPipelineBarrier(
-            m_CommandBuffer,
-            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-            0,
-            0,
-            nullptr,
-            0,
-            nullptr,
-            1,
-            &barrier);
-    }
-    else if ( prevState == RESOURCE_STATE_COLOR_WRITE && nextState == RESOURCE_STATE_PRESENT )
-    {
-        VkImageMemoryBarrier barrier;
-        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.pNext                           = nullptr;
-        barrier.srcAccessMask                   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        barrier.dstAccessMask                   = VK_ACCESS_MEMORY_READ_BIT;
-        barrier.oldLayout                       = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        barrier.newLayout                       = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-        barrier.subresourceRange                = range;
-        barrier.image                           = pNativeImage;
-
-        vkCmdPipelineBarrier(
-            m_CommandBuffer,
-            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-            0,
-            0,
-            nullptr,
-            0,
-            nullptr,
-            1,
-            &barrier);
-    }
-    else
-    {
-        SetImageLayout(
-            m_CommandBuffer,
-            pNativeImage,
-            srcStageMask,
-            dstStageMask,
-            oldLayout,
-            newLayout,
-            range );
-    }
+    PushTextureBarrier(pNativeImage, range, prevState, nextState);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -516,35 +647,291 @@ void CommandList::BufferBarrier
     if (pResource == nullptr)
     { return; }
 
+    // 読み取り同士であれば同期の必要はない.
+    if (prevState == nextState && IsReadOnlyState(nextState))
+    { return; }
+
     auto pWrapResource = static_cast<Buffer*>(pResource);
     A3D_ASSERT( pWrapResource != nullptr );
 
     auto pNativeBuffer = pWrapResource->GetVulkanBuffer();
     A3D_ASSERT( pNativeBuffer != null_handle );
 
-    auto srcAccess = ToNativeAccessFlags( prevState );
-    auto dstAccess = ToNativeAccessFlags( nextState );
+    PushBufferBarrier(pNativeBuffer, pWrapResource->GetDesc().Size, prevState, nextState);
+}
 
-    VkBufferMemoryBarrier barrier = {};
-    barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-    barrier.pNext               = nullptr;
-    barrier.srcAccessMask       = srcAccess;
-    barrier.dstAccessMask       = dstAccess;
-    barrier.srcQueueFamilyIndex = 0;
-    barrier.dstQueueFamilyIndex = 0;
-    barrier.buffer              = pNativeBuffer;
-    barrier.offset              = 0;
-    barrier.size                = pWrapResource->GetDesc().Size;
+//-------------------------------------------------------------------------------------------------
+//      追跡対象テクスチャのサブリソースを指定状態に遷移させます.
+//-------------------------------------------------------------------------------------------------
+void CommandList::TransitionTexture
+(
+    ITexture*       pResource,
+    uint32_t        mipSlice,
+    uint32_t        mipLevels,
+    uint32_t        firstArraySlice,
+    uint32_t        arraySize,
+    RESOURCE_STATE  nextState
+)
+{
+    if (pResource == nullptr)
+    { return; }
 
-    vkCmdPipelineBarrier(
-        m_CommandBuffer,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        0,
-        0, nullptr,
-        1, &barrier,
-        0, nullptr
-    );
+    // バンドルは単独でキューに投入されないため，最初の遷移を補うことができない.
+    A3D_ASSERT( m_FixupCommandBuffer != null_handle );
+    A3D_ASSERT( nextState != RESOURCE_STATE_UNKNOWN );
+
+    auto pWrapResource = static_cast<Texture*>(pResource);
+    A3D_ASSERT( pWrapResource != nullptr );
+    A3D_ASSERT( pWrapResource->IsTracked() );
+
+    if (!pWrapResource->IsTracked())
+    { return; }
+
+    auto totalMipLevels = pWrapResource->GetDesc().MipLevels;
+    auto totalCount     = pWrapResource->GetTrackedSubresourceCount();
+    auto totalArraySize = totalCount / totalMipLevels;
+
+    if (mipSlice >= totalMipLevels || firstArraySlice >= totalArraySize)
+    { return; }
+
+    if (mipLevels > totalMipLevels - mipSlice)
+    { mipLevels = totalMipLevels - mipSlice; }
+
+    if (arraySize > totalArraySize - firstArraySlice)
+    { arraySize = totalArraySize - firstArraySlice; }
+
+    // コマンドリスト内のステートテーブルを検索します.
+    auto offset = UINT32_MAX;
+    for(size_t i=0; i<m_TrackedTextures.size(); ++i)
+    {
+        if (m_TrackedTextures[i].pTexture == pWrapResource)
+        {
+            offset = m_TrackedTextures[i].Offset;
+            break;
+        }
+    }
+
+    if (offset == UINT32_MAX)
+    {
+        offset = uint32_t(m_TrackedStates.size());
+
+        TrackedTexture entry = {};
+        entry.pTexture = pWrapResource;
+        entry.Offset   = offset;
+        m_TrackedTextures.push_back(entry);
+        pWrapResource->AddRef();
+
+        TrackedState state = {};
+        state.FirstState = RESOURCE_STATE_UNKNOWN;
+        state.LastState  = RESOURCE_STATE_UNKNOWN;
+        m_TrackedStates.resize(offset + totalCount, state);
+    }
+
+    auto pNativeImage = pWrapResource->GetVulkanImage();
+    A3D_ASSERT( pNativeImage != null_handle );
+
+    VkImageSubresourceRange range = {};
+    range.aspectMask = pWrapResource->GetVulkanImageAspectFlags();
+    range.layerCount = 1;
+
+    for(auto layer=firstArraySlice; layer<firstArraySlice + arraySize; ++layer)
+    {
+        range.baseArrayLayer = layer;
+
+        auto runMip   = 0u;
+        auto runCount = 0u;
+        auto runState = RESOURCE_STATE_UNKNOWN;
+
+        for(auto mip=mipSlice; mip<mipSlice + mipLevels; ++mip)
+        {
+            auto& state     = m_TrackedStates[offset + layer * totalMipLevels + mip];
+            auto  prevState = state.LastState;
+
+            // コマンドリスト内で最初の使用であれば，遷移はキュー投入時に補う.
+            auto needBarrier = (state.FirstState != RESOURCE_STATE_UNKNOWN)
+                            && (prevState != nextState || !IsReadOnlyState(nextState));
+
+            if (state.FirstState == RESOURCE_STATE_UNKNOWN)
+            { state.FirstState = nextState; }
+            state.LastState = nextState;
+
+            // 同じ状態から遷移する連続したミップレベルは1つのバリアにまとめる.
+            if (runCount > 0 && (!needBarrier || prevState != runState))
+            {
+                range.baseMipLevel = runMip;
+                range.levelCount   = runCount;
+                PushTextureBarrier(pNativeImage, range, runState, nextState);
+                runCount = 0;
+            }
+
+            if (needBarrier)
+            {
+                if (runCount == 0)
+                {
+                    runMip   = mip;
+                    runState = prevState;
+                }
+                runCount++;
+            }
+        }
+
+        if (runCount > 0)
+        {
+            range.baseMipLevel = runMip;
+            range.levelCount   = runCount;
+            PushTextureBarrier(pNativeImage, range, runState, nextState);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      追跡対象バッファを指定状態に遷移させます.
+//-------------------------------------------------------------------------------------------------
+void CommandList::TransitionBuffer(IBuffer* pResource, RESOURCE_STATE nextState)
+{
+    if (pResource == nullptr)
+    { return; }
+
+    // バンドルは単独でキューに投入されないため，最初の遷移を補うことができない.
+    A3D_ASSERT( m_FixupCommandBuffer != null_handle );
+    A3D_ASSERT( nextState != RESOURCE_STATE_UNKNOWN );
+
+    auto pWrapResource = static_cast<Buffer*>(pResource);
+    A3D_ASSERT( pWrapResource != nullptr );
+    A3D_ASSERT( pWrapResource->IsTracked() );
+
+    if (!pWrapResource->IsTracked())
+    { return; }
+
+    for(size_t i=0; i<m_TrackedBuffers.size(); ++i)
+    {
+        if (m_TrackedBuffers[i].pBuffer != pWrapResource)
+        { continue; }
+
+        auto& state = m_TrackedBuffers[i].State;
+
+        if (state.LastState != nextState || !IsReadOnlyState(nextState))
+        {
+            PushBufferBarrier(
+                pWrapResource->GetVulkanBuffer(),
+                pWrapResource->GetDesc().Size,
+                state.LastState,
+                nextState);
+        }
+
+        state.LastState = nextState;
+        return;
+    }
+
+    // コマンドリスト内で最初の使用であれば，遷移はキュー投入時に補う.
+    TrackedBuffer entry = {};
+    entry.pBuffer          = pWrapResource;
+    entry.State.FirstState = nextState;
+    entry.State.LastState  = nextState;
+    m_TrackedBuffers.push_back(entry);
+    pWrapResource->AddRef();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャバリアを保留リストに追加します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::PushTextureBarrier
+(
+    VkImage                         image,
+    const VkImageSubresourceRange&  range,
+    RESOURCE_STATE                  prevState,
+    RESOURCE_STATE                  nextState
+)
+{
+    // レンダーパス内ではバリアを発行できない. EndFrameBuffer() してから遷移させること.
+    A3D_ASSERT(m_pFrameBuffer == nullptr);
+
+    for(auto i=0u; i<m_PendingTextureBarrierCount; ++i)
+    {
+        auto& pending = m_PendingTextureBarrier[i];
+        if (pending.Image != image)
+        { continue; }
+
+        if (IsSameRange(pending.Range, range) && pending.NextState == prevState)
+        {
+            // 間で使用されていないので A->B->C は A->C にまとめる.
+            pending.NextState = nextState;
+
+            // A->B->A で読み取り状態に戻るだけなら何もしなくてよい.
+            if (pending.PrevState == pending.NextState && IsReadOnlyState(pending.NextState))
+            {
+                m_PendingTextureBarrierCount--;
+                m_PendingTextureBarrier[i] = m_PendingTextureBarrier[m_PendingTextureBarrierCount];
+            }
+            return;
+        }
+
+        // 同一バリア内で同じサブリソースを二度遷移させないよう，重なる場合は先に発行する.
+        if (IsOverlapRange(pending.Range, range))
+        {
+            FlushBarrier();
+            break;
+        }
+    }
+
+    if (m_PendingTextureBarrierCount >= MaxPendingBarrierCount)
+    { FlushBarrier(); }
+
+    auto& barrier = m_PendingTextureBarrier[m_PendingTextureBarrierCount];
+    barrier.Image       = image;
+    barrier.Range       = range;
+    barrier.PrevState   = prevState;
+    barrier.NextState   = nextState;
+    m_PendingTextureBarrierCount++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッファバリアを保留リストに追加します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::PushBufferBarrier
+(
+    VkBuffer        buffer,
+    VkDeviceSize    size,
+    RESOURCE_STATE  prevState,
+    RESOURCE_STATE  nextState
+)
+{
+    // レンダーパス内ではバリアを発行できない. EndFrameBuffer() してから遷移させること.
+    A3D_ASSERT(m_pFrameBuffer == nullptr);
+
+    for(auto i=0u; i<m_PendingBufferBarrierCount; ++i)
+    {
+        auto& pending = m_PendingBufferBarrier[i];
+        if (pending.Buffer != buffer)
+        { continue; }
+
+        if (pending.NextState != prevState)
+        {
+            FlushBarrier();
+            break;
+        }
+
+        // 間で使用されていないので A->B->C は A->C にまとめる.
+        pending.NextState = nextState;
+
+        // A->B->A で読み取り状態に戻るだけなら何もしなくてよい.
+        if (pending.PrevState == pending.NextState && IsReadOnlyState(pending.NextState))
+        {
+            m_PendingBufferBarrierCount--;
+            m_PendingBufferBarrier[i] = m_PendingBufferBarrier[m_PendingBufferBarrierCount];
+        }
+        return;
+    }
+
+    if (m_PendingBufferBarrierCount >= MaxPendingBarrierCount)
+    { FlushBarrier(); }
+
+    auto& barrier = m_PendingBufferBarrier[m_PendingBufferBarrierCount];
+    barrier.Buffer      = buffer;
+    barrier.Size        = size;
+    barrier.PrevState   = prevState;
+    barrier.NextState   = nextState;
+    m_PendingBufferBarrierCount++;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -561,6 +948,8 @@ void CommandList::DrawInstanced
     if (vertexCount == 0 || instanceCount == 0)
     { return; }
 
+    FlushBarrier();
+
     vkCmdDraw(
         m_CommandBuffer,
         vertexCount,
@@ -584,6 +973,8 @@ void CommandList::DrawIndexedInstanced
     if (indexCount == 0 || instanceCount == 0)
     { return; }
 
+    FlushBarrier();
+
     vkCmdDrawIndexed(
         m_CommandBuffer,
         indexCount,
@@ -601,6 +992,8 @@ void CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z)
     if (x == 0 && y == 0 && z == 0)
     { return; }
 
+    FlushBarrier();
+
     vkCmdDispatch( m_CommandBuffer, x, y, z );
 }
 
@@ -626,6 +1019,8 @@ void CommandList::DispatchMesh(uint32_t x, uint32_t y, uint32_t z)
     if (vkCmdDrawMeshTasks == nullptr)
     { return; }
 
+    FlushBarrier();
+
     vkCmdDrawMeshTasks( m_CommandBuffer, x, 0 );
 }
 
@@ -660,6 +1055,8 @@ void CommandList::ExecuteIndirect
     if (pCounterBuffer != nullptr)
     { pCounters = static_cast<uint32_t*>(pCounterBuffer->Map()); }
 
+    FlushBarrier();
+
     auto offset = argumentBufferOffset;
     for(auto i=0u; i<desc.ArgumentCount; ++i)
     {
@@ -757,7 +1154,10 @@ void CommandList::ResolveQuery
     auto pNativeBuffer = pWrapBuffer->GetVulkanBuffer();
     A3D_ASSERT(pNativeBuffer != null_handle);
 
-    VkQueryResultFlags flags = 0; // TODO : 実装チェック.
+    // 他のAPIと同様に 64bit 値で書き込み，結果が揃うまでGPU側で待機させる.
+    VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT;
+
+    FlushBarrier();
 
     vkCmdCopyQueryPoolResults(
         m_CommandBuffer,
@@ -766,7 +1166,7 @@ void CommandList::ResolveQuery
         queryCount,
         pNativeBuffer,
         dstOffset,
-        pDstBuffer->GetDesc().Size,
+        pWrapQueryPool->GetResultSize(),
         flags );
 }
 
@@ -882,6 +1282,8 @@ void CommandList::CopyTextureRegion
     region.extent.height = srcExtent.Height;
     region.extent.depth  = srcExtent.Depth;
 
+    FlushBarrier();
+
     vkCmdCopyImage( m_CommandBuffer, pNativeSrc, srcLayout, pNativeDst, dstLayout, 1, &region );
 }
 
@@ -910,6 +1312,8 @@ void CommandList::CopyBufferRegion
     region.srcOffset = srcOffset;
     region.size      = byteCount;
 
+    FlushBarrier();
+
     vkCmdCopyBuffer( 
         m_CommandBuffer, 
         pWrapSrc->GetVulkanBuffer(),
@@ -961,6 +1365,8 @@ void CommandList::CopyBufferToTexture
         region.imageSubresource.baseArrayLayer,
         planeSlice);
 
+    FlushBarrier();
+
     vkCmdCopyBufferToImage(
         m_CommandBuffer,
         pWrapSrc->GetVulkanBuffer(),
@@ -1014,6 +1420,8 @@ void CommandList::CopyTextureToBuffer
         region.imageSubresource.baseArrayLayer,
         planeSlice);
 
+    FlushBarrier();
+
     vkCmdCopyImageToBuffer(
         m_CommandBuffer,
         pWrapSrc->GetVulkanImage(),
@@ -1087,6 +1495,8 @@ void CommandList::ResolveSubresource
     region.extent.height = pWrapDst->GetDesc().Height;
     region.extent.depth  = pWrapDst->GetDesc().DepthOrArraySize;
 
+    FlushBarrier();
+
     vkCmdResolveImage( m_CommandBuffer, pNativeSrc, srcLayout, pNativeDst, dstLayout, 1, &region );
 }
 
@@ -1104,6 +1514,8 @@ void CommandList::ExecuteBundle(ICommandList* pCommandList)
     auto pNativeBundle = pWrapCommandList->GetVulkanCommandBuffer();
     A3D_ASSERT(pNativeBundle != null_handle);
 
+    FlushBarrier();
+
     vkCmdExecuteCommands(m_CommandBuffer, 1, &pNativeBundle);
 }
 
@@ -1147,6 +1559,8 @@ bool CommandList::UpdateConstantBuffer(IBuffer* pBuffer, size_t offset, size_t s
     if (pWrapBuffer == nullptr || size == 0 || pData == nullptr)
     { return false; }
 
+    FlushBarrier();
+
     vkCmdUpdateBuffer(m_CommandBuffer, pWrapBuffer->GetVulkanBuffer(), offset, size, pData);
     return true;
 }
@@ -1162,6 +1576,9 @@ void CommandList::End()
         m_pFrameBuffer = nullptr;
     }
 
+    // 表示用の遷移などが残っていれば出し切る.
+    FlushBarrier();
+
     vkEndCommandBuffer( m_CommandBuffer );
 }
 
@@ -1179,6 +1596,20 @@ void CommandList::Flush()
     auto pNativeQueue = pWrapQueue->GetVulkanQueue();
     A3D_ASSERT(pNativeQueue != null_handle);
 
+    // 追跡対象リソースの補正バリアがあれば先に実行する.
+    VkCommandBuffer commandBuffers[2] = {};
+    uint32_t        commandBufferCount = 0;
+
+    auto fixupCommandBuffer = ResolveTrackedState();
+    if (fixupCommandBuffer != null_handle)
+    {
+        commandBuffers[commandBufferCount] = fixupCommandBuffer;
+        commandBufferCount++;
+    }
+
+    commandBuffers[commandBufferCount] = m_CommandBuffer;
+    commandBufferCount++;
+
     VkPipelineStageFlags waitDstStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
     VkSubmitInfo info = {};
     info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -1186,8 +1617,8 @@ void CommandList::Flush()
     info.waitSemaphoreCount     = 0;
     info.pWaitSemaphores        = nullptr;
     info.pWaitDstStageMask      = &waitDstStageMask;
-    info.commandBufferCount     = 1;
-    info.pCommandBuffers        = &m_CommandBuffer;
+    info.commandBufferCount     = commandBufferCount;
+    info.pCommandBuffers        = commandBuffers;
     info.signalSemaphoreCount   = 0;
     info.pSignalSemaphores      = nullptr;
 
@@ -1197,6 +1628,256 @@ void CommandList::Flush()
     SafeRelease(pQueue);
 }
 
+//-------------------------------------------------------------------------------------------------
+//      保留中のリソースバリアを1回のパイプラインバリアとして発行します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::FlushBarrier()
+{ FlushBarrier(m_CommandBuffer); }
+
+//-------------------------------------------------------------------------------------------------
+//      保留中のリソースバリアを指定コマンドバッファに発行します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::FlushBarrier(VkCommandBuffer commandBuffer)
+{
+    if (m_PendingTextureBarrierCount == 0 && m_PendingBufferBarrierCount == 0)
+    { return; }
+
+    // 保留中のバリアは BeginFrameBuffer() で発行済みのはずなので, レンダーパス内には残っていない.
+    A3D_ASSERT(commandBuffer != m_CommandBuffer || m_pFrameBuffer == nullptr);
+
+    VkImageMemoryBarrier    imageBarriers [MaxPendingBarrierCount];
+    VkBufferMemoryBarrier   bufferBarriers[MaxPendingBarrierCount];
+
+    VkPipelineStageFlags srcStageMask = 0;
+    VkPipelineStageFlags dstStageMask = 0;
+
+    for(auto i=0u; i<m_PendingTextureBarrierCount; ++i)
+    {
+        const auto& pending = m_PendingTextureBarrier[i];
+
+        auto srcStage = ToNativePipelineStageFlags(pending.PrevState) & m_SupportedStages;
+        auto dstStage = ToNativePipelineStageFlags(pending.NextState) & m_SupportedStages;
+
+        auto& barrier = imageBarriers[i];
+        barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.pNext               = nullptr;
+        barrier.srcAccessMask       = (srcStage != 0) ? ToNativeAccessFlags(pending.PrevState) : 0;
+        barrier.dstAccessMask       = (dstStage != 0) ? ToNativeAccessFlags(pending.NextState) : 0;
+        barrier.oldLayout           = ToNativeImageLayout(pending.PrevState);
+        barrier.newLayout           = ToNativeImageLayout(pending.NextState);
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image               = pending.Image;
+        barrier.subresourceRange    = pending.Range;
+
+        srcStageMask |= srcStage;
+        dstStageMask |= dstStage;
+    }
+
+    for(auto i=0u; i<m_PendingBufferBarrierCount; ++i)
+    {
+        const auto& pending = m_PendingBufferBarrier[i];
+
+        auto srcStage = ToNativePipelineStageFlags(pending.PrevState) & m_SupportedStages;
+        auto dstStage = ToNativePipelineStageFlags(pending.NextState) & m_SupportedStages;
+
+        auto& barrier = bufferBarriers[i];
+        barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.pNext               = nullptr;
+        barrier.srcAccessMask       = (srcStage != 0) ? ToNativeAccessFlags(pending.PrevState) : 0;
+        barrier.dstAccessMask       = (dstStage != 0) ? ToNativeAccessFlags(pending.NextState) : 0;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer              = pending.Buffer;
+        barrier.offset              = 0;
+        barrier.size                = pending.Size;
+
+        srcStageMask |= srcStage;
+        dstStageMask |= dstStage;
+    }
+
+    // 待つべき処理が無い場合や，後続で使われない場合.
+    if (srcStageMask == 0)
+    { srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT; }
+    if (dstStageMask == 0)
+    { dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT; }
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        srcStageMask,
+        dstStageMask,
+        0,
+        0, nullptr,
+        m_PendingBufferBarrierCount,  bufferBarriers,
+        m_PendingTextureBarrierCount, imageBarriers);
+
+    m_PendingTextureBarrierCount = 0;
+    m_PendingBufferBarrierCount  = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタセットを設定する前に，バインドレスヒープを必要に応じて設定します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::PrepareDescriptorSet(VkPipelineBindPoint bindPoint, uint32_t setIndex)
+{
+    // コピーキューはディスクリプタを使わず, コンピュートキューはグラフィックスのバインドポイントを持たない.
+    A3D_ASSERT(m_Type != COMMANDLIST_TYPE_COPY);
+    A3D_ASSERT(m_Type != COMMANDLIST_TYPE_COMPUTE || bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE);
+
+    auto index = (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE) ? 1 : 0;
+
+    // バインドレスでないレイアウトは set = 0 を使うので, ヒープは上書きされる.
+    if (setIndex == 0)
+    {
+        m_IsHeapBound[index] = false;
+        return;
+    }
+
+    if (m_IsHeapBound[index])
+    { return; }
+
+    auto pHeap = m_pDevice->GetBindlessHeap();
+    A3D_ASSERT(pHeap != nullptr);
+
+    // 後から set = 0 を設定すると set = 1 が無効になるため, ユーザーのセットより先に設定する.
+    auto heapSet = pHeap->GetVulkanDescriptorSet();
+    vkCmdBindDescriptorSets(
+        m_CommandBuffer,
+        bindPoint,
+        pHeap->GetVulkanPipelineLayout(),
+        0,
+        1,
+        &heapSet,
+        0,
+        nullptr);
+
+    m_IsHeapBound[index] = true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      追跡対象リソースの状態を解決し，補正用コマンドバッファを記録します.
+//-------------------------------------------------------------------------------------------------
+VkCommandBuffer CommandList::ResolveTrackedState()
+{
+    if (m_TrackedTextures.empty() && m_TrackedBuffers.empty())
+    { return null_handle; }
+
+    // End() で全て発行済みのはず.
+    A3D_ASSERT( m_PendingTextureBarrierCount == 0 );
+    A3D_ASSERT( m_PendingBufferBarrierCount  == 0 );
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.pNext            = nullptr;
+    beginInfo.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = nullptr;
+
+    auto result = vkBeginCommandBuffer(m_FixupCommandBuffer, &beginInfo);
+    A3D_ASSERT( result == VK_SUCCESS );
+    A3D_UNUSED( result );
+
+    auto barrierCount = 0u;
+
+    for(size_t i=0; i<m_TrackedTextures.size(); ++i)
+    {
+        auto pTexture  = m_TrackedTextures[i].pTexture;
+        auto offset    = m_TrackedTextures[i].Offset;
+        auto image     = pTexture->GetVulkanImage();
+        auto mipLevels = pTexture->GetDesc().MipLevels;
+        auto count     = pTexture->GetTrackedSubresourceCount();
+
+        for(auto j=0u; j<count; ++j)
+        {
+            const auto& state = m_TrackedStates[offset + j];
+            if (state.FirstState == RESOURCE_STATE_UNKNOWN)
+            { continue; }
+
+            // リソースの状態をコマンドリスト終了時の状態に更新する.
+            auto currentState = pTexture->GetTrackedState(j);
+            pTexture->SetTrackedState(j, state.LastState);
+
+            if (currentState == state.FirstState && IsReadOnlyState(currentState))
+            { continue; }
+
+            auto mip   = j % mipLevels;
+            auto layer = j / mipLevels;
+
+            // 直前のバリアと連続するミップレベルであれば範囲を広げる.
+            if (m_PendingTextureBarrierCount > 0)
+            {
+                auto& prev = m_PendingTextureBarrier[m_PendingTextureBarrierCount - 1];
+                if (prev.Image                 == image
+                 && prev.Range.baseArrayLayer  == layer
+                 && prev.Range.baseMipLevel + prev.Range.levelCount == mip
+                 && prev.PrevState             == currentState
+                 && prev.NextState             == state.FirstState)
+                {
+                    prev.Range.levelCount++;
+                    continue;
+                }
+            }
+
+            if (m_PendingTextureBarrierCount >= MaxPendingBarrierCount)
+            { FlushBarrier(m_FixupCommandBuffer); }
+
+            auto& barrier = m_PendingTextureBarrier[m_PendingTextureBarrierCount];
+            barrier.Image                   = image;
+            barrier.Range.aspectMask        = pTexture->GetVulkanImageAspectFlags();
+            barrier.Range.baseMipLevel      = mip;
+            barrier.Range.levelCount        = 1;
+            barrier.Range.baseArrayLayer    = layer;
+            barrier.Range.layerCount        = 1;
+            barrier.PrevState               = currentState;
+            barrier.NextState               = state.FirstState;
+            m_PendingTextureBarrierCount++;
+            barrierCount++;
+        }
+    }
+
+    for(size_t i=0; i<m_TrackedBuffers.size(); ++i)
+    {
+        auto pBuffer      = m_TrackedBuffers[i].pBuffer;
+        auto state        = m_TrackedBuffers[i].State;
+        auto currentState = pBuffer->GetTrackedState();
+        pBuffer->SetTrackedState(state.LastState);
+
+        if (currentState == state.FirstState && IsReadOnlyState(currentState))
+        { continue; }
+
+        if (m_PendingBufferBarrierCount >= MaxPendingBarrierCount)
+        { FlushBarrier(m_FixupCommandBuffer); }
+
+        auto& barrier = m_PendingBufferBarrier[m_PendingBufferBarrierCount];
+        barrier.Buffer      = pBuffer->GetVulkanBuffer();
+        barrier.Size        = pBuffer->GetDesc().Size;
+        barrier.PrevState   = currentState;
+        barrier.NextState   = state.FirstState;
+        m_PendingBufferBarrierCount++;
+        barrierCount++;
+    }
+
+    FlushBarrier(m_FixupCommandBuffer);
+    vkEndCommandBuffer(m_FixupCommandBuffer);
+
+    return (barrierCount > 0) ? m_FixupCommandBuffer : null_handle;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      追跡中のリソースを解放します.
+//-------------------------------------------------------------------------------------------------
+void CommandList::ClearTrackedState()
+{
+    for(size_t i=0; i<m_TrackedTextures.size(); ++i)
+    { m_TrackedTextures[i].pTexture->Release(); }
+
+    for(size_t i=0; i<m_TrackedBuffers.size(); ++i)
+    { m_TrackedBuffers[i].pBuffer->Release(); }
+
+    m_TrackedTextures.clear();
+    m_TrackedBuffers .clear();
+    m_TrackedStates  .clear();
+}
+
 //-------------------------------------------------------------------------------------------------
 //      コマンドプールを取得します.
 //-------------------------------------------------------------------------------------------------
@@ -12,6 +12,10 @@ namespace a3d {
 // Forward Declarations.
 //-------------------------------------------------------------------------------------------------
 class FrameBuffer;
+class Texture;
+class Buffer;
+class DescriptorSet;
+class DescriptorArena;
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -28,7 +32,7 @@ public:
     //=============================================================================================
     // public variables.
     //=============================================================================================
-    /* NOTHING */
+    static const uint32_t   MaxPendingBarrierCount = 64;    //!< 保留できる最大バリア数です.
 
     //=============================================================================================
     // public methods.
@@ -145,6 +149,30 @@ public:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY SetDescriptorSet(IDescriptorSet* pDescriptorSet) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      動的オフセットを指定してディスクリプタセットを設定します.
+    //!
+    //! @param[in]      pDescriptorSet      ディスクリプタセットです.
+    //! @param[in]      offsetCount         動的オフセット数です.
+    //! @param[in]      pOffsets            動的オフセットです.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY SetDescriptorSet(
+        IDescriptorSet* pDescriptorSet,
+        uint32_t        offsetCount,
+        const uint32_t* pOffsets) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      一時ディスクリプタセットを割り当てます.
+    //!
+    //! @param[in]      pLayout             ディスクリプタセットレイアウトです.
+    //! @param[out]     ppDescriptorSet     ディスクリプタセットの格納先です.
+    //! @retval true    割り当てに成功.
+    //! @retval false   割り当てに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY AllocateTransientDescriptorSet(
+        IDescriptorSetLayout*   pLayout,
+        IDescriptorSet**        ppDescriptorSet) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      頂点バッファを設定します.
     //!
@@ -175,6 +203,7 @@ public:
     //! @param[in]      pResource       リソースです.
     //! @param[in]      prevState       変更前の状態です.
     //! @param[in]      nextState       変更後の状態です.
+    //! @note       バリアはすぐには発行されず，次にリソースを使用するコマンドの直前にまとめて発行されます.
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY TextureBarrier(
         ITexture*       pResource,
@@ -187,12 +216,41 @@ public:
     //! @param[in]      pResource       リソースです.
     //! @param[in]      prevState       変更前の状態です.
     //! @param[in]      nextState       変更後の状態です.
+    //! @note       バリアはすぐには発行されず，次にリソースを使用するコマンドの直前にまとめて発行されます.
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY BufferBarrier(
         IBuffer*        pResource,
         RESOURCE_STATE  prevState,
         RESOURCE_STATE  nextState) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡対象テクスチャのサブリソースを指定状態に遷移させます.
+    //!
+    //! @param[in]      pResource           テクスチャです.
+    //! @param[in]      mipSlice            最初のミップレベルです.
+    //! @param[in]      mipLevels           ミップレベル数です.
+    //! @param[in]      firstArraySlice     最初の配列番号です.
+    //! @param[in]      arraySize           配列数です.
+    //! @param[in]      nextState           変更後の状態です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY TransitionTexture(
+        ITexture*       pResource,
+        uint32_t        mipSlice,
+        uint32_t        mipLevels,
+        uint32_t        firstArraySlice,
+        uint32_t        arraySize,
+        RESOURCE_STATE  nextState) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡対象バッファを指定状態に遷移させます.
+    //!
+    //! @param[in]      pResource       バッファです.
+    //! @param[in]      nextState       変更後の状態です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY TransitionBuffer(
+        IBuffer*        pResource,
+        RESOURCE_STATE  nextState) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      インスタンス描画します.
     //!
@@ -442,6 +500,30 @@ public:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Flush();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      保留中のリソースバリアを1回のパイプラインバリアとして発行します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY FlushBarrier();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタセットを設定する前に，set = 0 のバインドレスヒープを必要に応じて設定します.
+    //!
+    //! @param[in]      bindPoint       パイプラインバインドポイントです.
+    //! @param[in]      setIndex        ディスクリプタセットを設定するセット番号です.
+    //! @note       バインドレスでないレイアウトは set = 0 にディスクリプタセットを設定するため，
+    //!             ヒープを上書きします. その後にバインドレスのレイアウトを使う場合はヒープを設定し直します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PrepareDescriptorSet(VkPipelineBindPoint bindPoint, uint32_t setIndex);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡対象リソースの状態を解決し，補正用コマンドバッファを記録します.
+    //!
+    //! @return     補正用のバリアが必要な場合はコマンドバッファを，不要な場合は null_handle を返却します.
+    //! @note       キューへの投入時に呼び出され，追跡対象リソースの状態をコマンドリスト終了時の状態に更新します.
+    //!             返却したコマンドバッファは本体のコマンドバッファの直前に実行する必要があります.
+    //---------------------------------------------------------------------------------------------
+    VkCommandBuffer A3D_APIENTRY ResolveTrackedState();
+
     //---------------------------------------------------------------------------------------------
     //! @brief      コマンドプールを取得します.
     //!
@@ -457,6 +539,58 @@ public:
     VkCommandBuffer A3D_APIENTRY GetVulkanCommandBuffer() const;
 
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // PendingTextureBarrier structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct PendingTextureBarrier
+    {
+        VkImage                 Image;          //!< イメージです.
+        VkImageSubresourceRange Range;          //!< サブリソース範囲です.
+        RESOURCE_STATE          PrevState;      //!< 変更前の状態です.
+        RESOURCE_STATE          NextState;      //!< 変更後の状態です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // PendingBufferBarrier structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct PendingBufferBarrier
+    {
+        VkBuffer                Buffer;         //!< バッファです.
+        VkDeviceSize            Size;           //!< サイズです.
+        RESOURCE_STATE          PrevState;      //!< 変更前の状態です.
+        RESOURCE_STATE          NextState;      //!< 変更後の状態です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // TrackedState structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct TrackedState
+    {
+        RESOURCE_STATE          FirstState;     //!< コマンドリスト内で最初に要求された状態です.
+        RESOURCE_STATE          LastState;      //!< コマンドリスト内で最後に遷移した状態です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // TrackedTexture structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct TrackedTexture
+    {
+        Texture*                pTexture;       //!< テクスチャです.
+        uint32_t                Offset;         //!< ステートテーブルの先頭位置です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // TrackedBuffer structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct TrackedBuffer
+    {
+        Buffer*                 pBuffer;        //!< バッファです.
+        TrackedState            State;          //!< ステートです.
+    };
+
+    template<typename T>
+    using TrackedArray = std::vector<T, StdAllocator<T>>;
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
@@ -465,6 +599,20 @@ private:
     VkCommandPool               m_CommandPool;          //!< コマンドプールです.
     VkCommandBuffer             m_CommandBuffer;        //!< コマンドバッファです.
     FrameBuffer*                m_pFrameBuffer;         //!< バインドされているフレームバッファです.
+    COMMANDLIST_TYPE            m_Type;                 //!< コマンドリストタイプです.
+    VkPipelineStageFlags        m_SupportedStages;      //!< キューがサポートするパイプラインステージです.
+    PendingTextureBarrier       m_PendingTextureBarrier[MaxPendingBarrierCount];   //!< 保留中のテクスチャバリアです.
+    PendingBufferBarrier        m_PendingBufferBarrier [MaxPendingBarrierCount];   //!< 保留中のバッファバリアです.
+    uint32_t                    m_PendingTextureBarrierCount;                       //!< 保留中のテクスチャバリア数です.
+    uint32_t                    m_PendingBufferBarrierCount;                        //!< 保留中のバッファバリア数です.
+    VkCommandBuffer             m_FixupCommandBuffer;                               //!< 追跡対象リソースの補正用コマンドバッファです.
+    TrackedArray<TrackedTexture> m_TrackedTextures;                                 //!< 追跡中のテクスチャです.
+    TrackedArray<TrackedBuffer>  m_TrackedBuffers;                                  //!< 追跡中のバッファです.
+    TrackedArray<TrackedState>   m_TrackedStates;                                   //!< テクスチャのサブリソースごとのステートです.
+    DescriptorArena*            m_pDescriptorArena;                                 //!< 一時ディスクリプタセットのアリーナです.
+    TrackedArray<DescriptorSet*> m_TransientSets;                                   //!< 一時ディスクリプタセットです.
+    uint32_t                    m_TransientSetCount;                                //!< 使用中の一時ディスクリプタセット数です.
+    bool                        m_IsHeapBound[2];                                   //!< set = 0 にバインドレスヒープが設定されているかどうか(グラフィックス, コンピュート)です.
 
     //=============================================================================================
     // private methods.
@@ -496,6 +644,46 @@ private:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Term();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャバリアを保留リストに追加します.
+    //!
+    //! @param[in]      image       イメージです.
+    //! @param[in]      range       サブリソース範囲です.
+    //! @param[in]      prevState   変更前の状態です.
+    //! @param[in]      nextState   変更後の状態です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PushTextureBarrier(
+        VkImage                         image,
+        const VkImageSubresourceRange&  range,
+        RESOURCE_STATE                  prevState,
+        RESOURCE_STATE                  nextState);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファバリアを保留リストに追加します.
+    //!
+    //! @param[in]      buffer      バッファです.
+    //! @param[in]      size        サイズです.
+    //! @param[in]      prevState   変更前の状態です.
+    //! @param[in]      nextState   変更後の状態です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PushBufferBarrier(
+        VkBuffer        buffer,
+        VkDeviceSize    size,
+        RESOURCE_STATE  prevState,
+        RESOURCE_STATE  nextState);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      保留中のリソースバリアを指定コマンドバッファに発行します.
+    //!
+    //! @param[in]      commandBuffer   発行先のコマンドバッファです.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY FlushBarrier(VkCommandBuffer commandBuffer);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡中のリソースを解放します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY ClearTrackedState();
+
     CommandList     (const CommandList&) = delete;
     void operator = (const CommandList&) = delete;
 };
@@ -0,0 +1,415 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dDescriptorAllocator.cpp
+// Desc : Paged Descriptor Pool Allocator.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values.
+//-------------------------------------------------------------------------------------------------
+static const uint32_t kTransientSetCount = 256;     // 一時ページ1つあたりのセット数です.
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタセットを確保します.
+//-------------------------------------------------------------------------------------------------
+bool AllocateFromPage
+(
+    VkDevice                device,
+    VkDescriptorPool        page,
+    VkDescriptorSetLayout   layout,
+    VkDescriptorSet*        pSet
+)
+{
+    VkDescriptorSetAllocateInfo info = {};
+    info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    info.pNext              = nullptr;
+    info.descriptorPool     = page;
+    info.descriptorSetCount = 1;
+    info.pSetLayouts        = &layout;
+
+    // VK_ERROR_OUT_OF_POOL_MEMORY, VK_ERROR_FRAGMENTED_POOL の他,
+    // VK_KHR_maintenance1 未対応のドライバーは別のエラーを返すことがあるため失敗は全て容量不足として扱う.
+    return vkAllocateDescriptorSets(device, &info, pSet) == VK_SUCCESS;
+}
+
+} // namespace /* anonymous */
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DescriptorAllocator class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+DescriptorAllocator::DescriptorAllocator()
+: m_pDevice(nullptr)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+DescriptorAllocator::~DescriptorAllocator()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorAllocator::Init(Device* pDevice)
+{
+    if (pDevice == nullptr)
+    { return false; }
+
+    m_pDevice = pDevice;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void DescriptorAllocator::Term()
+{
+    if (m_pDevice == nullptr)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT( pNativeDevice != null_handle );
+
+    for(auto& itr : m_PersistentBuckets)
+    {
+        auto& pages = itr.second.Pages;
+        for(size_t i=0; i<pages.size(); ++i)
+        { vkDestroyDescriptorPool( pNativeDevice, pages[i], nullptr ); }
+    }
+
+    for(size_t i=0; i<m_TransientPages.size(); ++i)
+    { vkDestroyDescriptorPool( pNativeDevice, m_TransientPages[i], nullptr ); }
+
+    m_PersistentBuckets .clear();
+    m_TransientPages    .clear();
+    m_FreeTransientPages.clear();
+
+    m_pDevice = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      永続ディスクリプタセットを確保します.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorAllocator::Allocate
+(
+    VkDescriptorSetLayout       layout,
+    const VkDescriptorPoolSize* pSizes,
+    uint32_t                    sizeCount,
+    uint32_t                    setCount,
+    VkDescriptorSet*            pSet,
+    VkDescriptorPool*           pPool
+)
+{
+    if (pSet == nullptr || pPool == nullptr)
+    { return false; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT( pNativeDevice != null_handle );
+
+    auto& bucket = GetBucket(pSizes, sizeCount);
+    std::lock_guard<std::mutex> locker(bucket.Mutex);
+
+    // 空きがある可能性のあるページだけを, 最後に確保できたページから試す.
+    // 確保できなかったページは解放されるまで候補から外すので, 全ページを走査することは無い.
+    while (!bucket.Candidates.empty())
+    {
+        auto page = bucket.Candidates.back();
+        if (AllocateFromPage(pNativeDevice, page, layout, pSet))
+        {
+            *pPool = page;
+            return true;
+        }
+
+        bucket.Candidates.pop_back();
+    }
+
+    // 空きが無ければページを追加する.
+    VkDescriptorPool page = null_handle;
+    if (!CreatePage(pSizes, sizeCount, setCount, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, &page))
+    { return false; }
+
+    bucket.Pages     .push_back(page);
+    bucket.Candidates.push_back(page);
+
+    if (!AllocateFromPage(pNativeDevice, page, layout, pSet))
+    { return false; }
+
+    *pPool = page;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      永続ディスクリプタセットを解放します.
+//-------------------------------------------------------------------------------------------------
+void DescriptorAllocator::Free
+(
+    const VkDescriptorPoolSize* pSizes,
+    uint32_t                    sizeCount,
+    VkDescriptorPool            pool,
+    uint32_t                    count,
+    const VkDescriptorSet*      pSets
+)
+{
+    if (pool == null_handle || count == 0 || pSets == nullptr)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT( pNativeDevice != null_handle );
+
+    // プールは外部同期が必要.
+    auto& bucket = GetBucket(pSizes, sizeCount);
+    std::lock_guard<std::mutex> locker(bucket.Mutex);
+    vkFreeDescriptorSets( pNativeDevice, pool, count, pSets );
+
+    // 空きができたので候補に戻す.
+    if (bucket.Candidates.empty() || bucket.Candidates.back() != pool)
+    { bucket.Candidates.push_back(pool); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      一時ディスクリプタセット用のページを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDescriptorPool DescriptorAllocator::AcquireTransientPage
+(
+    const VkDescriptorPoolSize* pSizes,
+    uint32_t                    sizeCount,
+    uint32_t                    setCount,
+    bool*                       pCreated
+)
+{
+    std::lock_guard<std::mutex> locker(m_TransientMutex);
+
+    if (!m_FreeTransientPages.empty())
+    {
+        auto page = m_FreeTransientPages.back();
+        m_FreeTransientPages.pop_back();
+
+        if (pCreated != nullptr)
+        { *pCreated = false; }
+
+        return page;
+    }
+
+    VkDescriptorPool page = null_handle;
+    if (!CreatePage(pSizes, sizeCount, setCount, 0, &page))
+    { return null_handle; }
+
+    m_TransientPages.push_back(page);
+
+    if (pCreated != nullptr)
+    { *pCreated = true; }
+
+    return page;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      一時ディスクリプタセット用のページを返却します.
+//-------------------------------------------------------------------------------------------------
+void DescriptorAllocator::ReleaseTransientPages(uint32_t count, const VkDescriptorPool* pPages)
+{
+    if (count == 0 || pPages == nullptr)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT( pNativeDevice != null_handle );
+
+    // ページは呼び出し元が占有しているのでロック外でリセットできる.
+    for(auto i=0u; i<count; ++i)
+    { vkResetDescriptorPool( pNativeDevice, pPages[i], 0 ); }
+
+    std::lock_guard<std::mutex> locker(m_TransientMutex);
+    for(auto i=0u; i<count; ++i)
+    { m_FreeTransientPages.push_back(pPages[i]); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタ数の構成に対応する永続ページのバケットを取得します.
+//-------------------------------------------------------------------------------------------------
+DescriptorAllocator::PageBucket& DescriptorAllocator::GetBucket
+(
+    const VkDescriptorPoolSize* pSizes,
+    uint32_t                    sizeCount
+)
+{
+    // バインディングの並び順に依らないようにタイプ順に並べる.
+    PageKey key;
+    memset(&key, 0, sizeof(key));
+    for(auto i=0u; i<sizeCount && key.Count<MaxPoolSizeCount; ++i)
+    {
+        if (pSizes[i].descriptorCount == 0)
+        { continue; }
+
+        auto j = key.Count;
+        while (j > 0 && key.Sizes[j - 1].type > pSizes[i].type)
+        {
+            key.Sizes[j] = key.Sizes[j - 1];
+            j--;
+        }
+
+        key.Sizes[j] = pSizes[i];
+        key.Count++;
+    }
+
+    // std::unordered_map の要素は再ハッシュでも移動しないので, ロック外で参照してよい.
+    std::lock_guard<std::mutex> locker(m_PersistentMutex);
+    return m_PersistentBuckets[key];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ページを生成します.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorAllocator::CreatePage
+(
+    const VkDescriptorPoolSize* pSizes,
+    uint32_t                    sizeCount,
+    uint32_t                    setCount,
+    VkDescriptorPoolCreateFlags flags,
+    VkDescriptorPool*           pPage
+)
+{
+    // 1セットあたりのディスクリプタ数をページ内のセット数分確保する.
+    VkDescriptorPoolSize sizes[MaxPoolSizeCount];
+    auto count = 0u;
+    for(auto i=0u; i<sizeCount && count<MaxPoolSizeCount; ++i)
+    {
+        if (pSizes[i].descriptorCount == 0)
+        { continue; }
+
+        sizes[count].type            = pSizes[i].type;
+        sizes[count].descriptorCount = pSizes[i].descriptorCount * setCount;
+        count++;
+    }
+
+    // ディスクリプタを持たないレイアウトでも確保できるようにしておく.
+    if (count == 0)
+    {
+        sizes[0].type            = VK_DESCRIPTOR_TYPE_SAMPLER;
+        sizes[0].descriptorCount = 1;
+        count = 1;
+    }
+
+    VkDescriptorPoolCreateInfo info = {};
+    info.sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    info.pNext          = nullptr;
+    info.flags          = flags;
+    info.maxSets        = setCount;
+    info.poolSizeCount  = count;
+    info.pPoolSizes     = sizes;
+
+    auto ret = vkCreateDescriptorPool( m_pDevice->GetVulkanDevice(), &info, nullptr, pPage );
+    return ret == VK_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デバイスを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDevice DescriptorAllocator::GetVulkanDevice() const
+{ return m_pDevice->GetVulkanDevice(); }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DescriptorArena class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+DescriptorArena::DescriptorArena()
+: m_pAllocator(nullptr)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+DescriptorArena::~DescriptorArena()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorArena::Init(DescriptorAllocator* pAllocator)
+{
+    if (pAllocator == nullptr)
+    { return false; }
+
+    m_pAllocator = pAllocator;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void DescriptorArena::Term()
+{
+    if (m_pAllocator == nullptr)
+    { return; }
+
+    Reset();
+    m_pAllocator = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      一時ディスクリプタセットを確保します.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorArena::Allocate
+(
+    VkDescriptorSetLayout       layout,
+    const VkDescriptorPoolSize* pSizes,
+    uint32_t                    sizeCount,
+    VkDescriptorSet*            pSet
+)
+{
+    if (pSet == nullptr)
+    { return false; }
+
+    auto pNativeDevice = m_pAllocator->GetVulkanDevice();
+    A3D_ASSERT( pNativeDevice != null_handle );
+
+    // 現在のページから線形に確保する.
+    if (!m_Pages.empty())
+    {
+        if (AllocateFromPage(pNativeDevice, m_Pages.back(), layout, pSet))
+        { return true; }
+    }
+
+    // 再利用したページは他のレイアウト向けの構成で足りない場合があるので,
+    // 新規に生成したページで失敗するまでページを追加する.
+    for(;;)
+    {
+        auto created = false;
+        auto page = m_pAllocator->AcquireTransientPage(pSizes, sizeCount, kTransientSetCount, &created);
+        if (page == null_handle)
+        { return false; }
+
+        m_Pages.push_back(page);
+
+        if (AllocateFromPage(pNativeDevice, page, layout, pSet))
+        { return true; }
+
+        if (created)
+        { return false; }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      確保した全てのセットを解放し, ページをアロケータに返却します.
+//-------------------------------------------------------------------------------------------------
+void DescriptorArena::Reset()
+{
+    if (m_Pages.empty())
+    { return; }
+
+    m_pAllocator->ReleaseTransientPages(uint32_t(m_Pages.size()), m_Pages.data());
+    m_Pages.clear();
+}
+
+} // namespace a3d
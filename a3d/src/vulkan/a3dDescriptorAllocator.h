@@ -0,0 +1,316 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dDescriptorAllocator.h
+// Desc : Paged Descriptor Pool Allocator.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+class Device;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DescriptorAllocator class
+//! @brief      デバイスが所有するディスクリプタプールのページアロケータです.
+//! @note       ページはディスクリプタセットレイアウトが実際に使用するディスクリプタ数から決定し,
+//!             確保に失敗した場合はページを追加して拡張します.
+//!             永続ページはディスクリプタ数の構成ごとにまとめ, 空きがある可能性のあるページだけを試します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class DescriptorAllocator : public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const uint32_t MaxPoolSizeCount = 16;    //!< ページを構成するディスクリプタタイプの最大数です.
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    DescriptorAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~DescriptorAllocator();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDevice         デバイスです.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       循環参照となるため, デバイスの参照カウントは増やしません.
+    //---------------------------------------------------------------------------------------------
+    bool Init(Device* pDevice);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      永続ディスクリプタセットを確保します.
+    //!
+    //! @param[in]      layout          ディスクリプタセットレイアウトです.
+    //! @param[in]      pSizes          1セットあたりのディスクリプタ数です.
+    //! @param[in]      sizeCount       ディスクリプタ数の要素数です.
+    //! @param[in]      setCount        ページを追加する場合に1ページに収めるセット数です.
+    //! @param[out]     pSet            ディスクリプタセットの格納先です.
+    //! @param[out]     pPool           確保元のディスクリプタプールの格納先です.
+    //! @retval true    確保に成功.
+    //! @retval false   確保に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Allocate(
+        VkDescriptorSetLayout       layout,
+        const VkDescriptorPoolSize* pSizes,
+        uint32_t                    sizeCount,
+        uint32_t                    setCount,
+        VkDescriptorSet*            pSet,
+        VkDescriptorPool*           pPool);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      永続ディスクリプタセットを解放します.
+    //!
+    //! @param[in]      pSizes          確保時に指定した1セットあたりのディスクリプタ数です.
+    //! @param[in]      sizeCount       ディスクリプタ数の要素数です.
+    //! @param[in]      pool            確保元のディスクリプタプールです.
+    //! @param[in]      count           ディスクリプタセット数です.
+    //! @param[in]      pSets           ディスクリプタセットです.
+    //---------------------------------------------------------------------------------------------
+    void Free(
+        const VkDescriptorPoolSize* pSizes,
+        uint32_t                    sizeCount,
+        VkDescriptorPool            pool,
+        uint32_t                    count,
+        const VkDescriptorSet*      pSets);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      一時ディスクリプタセット用のページを取得します.
+    //!
+    //! @param[in]      pSizes          1セットあたりのディスクリプタ数です.
+    //! @param[in]      sizeCount       ディスクリプタ数の要素数です.
+    //! @param[in]      setCount        ページを生成する場合に1ページに収めるセット数です.
+    //! @param[out]     pCreated        新規に生成したページかどうかの格納先です.
+    //! @return     ページを返却します. 失敗した場合は null_handle を返却します.
+    //! @note       リセット済みのページがあれば再利用します.
+    //---------------------------------------------------------------------------------------------
+    VkDescriptorPool AcquireTransientPage(
+        const VkDescriptorPoolSize* pSizes,
+        uint32_t                    sizeCount,
+        uint32_t                    setCount,
+        bool*                       pCreated);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      一時ディスクリプタセット用のページを返却します.
+    //!
+    //! @param[in]      count           ページ数です.
+    //! @param[in]      pPages          ページです.
+    //! @note       ページは vkResetDescriptorPool() で一括リセットされ, 確保済みのセットは全て無効になります.
+    //---------------------------------------------------------------------------------------------
+    void ReleaseTransientPages(uint32_t count, const VkDescriptorPool* pPages);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスを取得します.
+    //!
+    //! @return     デバイスを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkDevice GetVulkanDevice() const;
+
+private:
+    using PageList = std::vector<VkDescriptorPool, StdAllocator<VkDescriptorPool>>;
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // PageKey structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct PageKey
+    {
+        uint32_t                Count;                      //!< ディスクリプタタイプ数です.
+        VkDescriptorPoolSize    Sizes[MaxPoolSizeCount];    //!< タイプ順に並べた1セットあたりのディスクリプタ数です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // PageKeyHash structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct PageKeyHash
+    {
+        size_t operator()(const PageKey& key) const
+        {
+            // FNV-1a.
+            auto pBytes = reinterpret_cast<const uint8_t*>(&key);
+            auto hash   = uint64_t(14695981039346656037ull);
+            for(auto i=0u; i<sizeof(PageKey); ++i)
+            {
+                hash ^= pBytes[i];
+                hash *= uint64_t(1099511628211ull);
+            }
+            return size_t(hash);
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // PageKeyEqual structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct PageKeyEqual
+    {
+        bool operator()(const PageKey& lhs, const PageKey& rhs) const
+        { return memcmp(&lhs, &rhs, sizeof(PageKey)) == 0; }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // PageBucket structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct PageBucket
+    {
+        std::mutex  Mutex;          //!< ミューテックスです.
+        PageList    Pages;          //!< 生成した全てのページです.
+        PageList    Candidates;     //!< 空きがある可能性のあるページです. 末尾が最後に確保に成功したページです.
+    };
+
+    using BucketMap = std::unordered_map<
+        PageKey,
+        PageBucket,
+        PageKeyHash,
+        PageKeyEqual,
+        StdAllocator<std::pair<const PageKey, PageBucket>>>;
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    Device*     m_pDevice;              //!< デバイスです.
+    std::mutex  m_PersistentMutex;      //!< 永続ページのバケット用ミューテックスです.
+    BucketMap   m_PersistentBuckets;    //!< ディスクリプタ数の構成ごとの永続ページです.
+    std::mutex  m_TransientMutex;       //!< 一時ページ用ミューテックスです.
+    PageList    m_TransientPages;       //!< 生成した全ての一時ページです.
+    PageList    m_FreeTransientPages;   //!< リセット済みの一時ページです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタ数の構成に対応する永続ページのバケットを取得します.
+    //!
+    //! @param[in]      pSizes          1セットあたりのディスクリプタ数です.
+    //! @param[in]      sizeCount       ディスクリプタ数の要素数です.
+    //! @return     バケットを返却します. 存在しない場合は追加します.
+    //---------------------------------------------------------------------------------------------
+    PageBucket& GetBucket(const VkDescriptorPoolSize* pSizes, uint32_t sizeCount);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ページを生成します.
+    //!
+    //! @param[in]      pSizes          1セットあたりのディスクリプタ数です.
+    //! @param[in]      sizeCount       ディスクリプタ数の要素数です.
+    //! @param[in]      setCount        1ページに収めるセット数です.
+    //! @param[in]      flags           生成フラグです.
+    //! @param[out]     pPage           ページの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool CreatePage(
+        const VkDescriptorPoolSize* pSizes,
+        uint32_t                    sizeCount,
+        uint32_t                    setCount,
+        VkDescriptorPoolCreateFlags flags,
+        VkDescriptorPool*           pPage);
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    void operator = (const DescriptorAllocator&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DescriptorArena class
+//! @brief      一時ディスクリプタセットを線形に確保するアリーナです.
+//! @note       スレッドセーフではありません. 確保したセットは Reset() で一括して無効になります.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class DescriptorArena : public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    DescriptorArena();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~DescriptorArena();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pAllocator      ページの取得元です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Init(DescriptorAllocator* pAllocator);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      一時ディスクリプタセットを確保します.
+    //!
+    //! @param[in]      layout          ディスクリプタセットレイアウトです.
+    //! @param[in]      pSizes          1セットあたりのディスクリプタ数です.
+    //! @param[in]      sizeCount       ディスクリプタ数の要素数です.
+    //! @param[out]     pSet            ディスクリプタセットの格納先です.
+    //! @retval true    確保に成功.
+    //! @retval false   確保に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Allocate(
+        VkDescriptorSetLayout       layout,
+        const VkDescriptorPoolSize* pSizes,
+        uint32_t                    sizeCount,
+        VkDescriptorSet*            pSet);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      確保した全てのセットを解放し, ページをアロケータに返却します.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    using PageList = std::vector<VkDescriptorPool, StdAllocator<VkDescriptorPool>>;
+
+    DescriptorAllocator*    m_pAllocator;   //!< ページの取得元です.
+    PageList                m_Pages;        //!< 使用中のページです.
+
+    DescriptorArena(const DescriptorArena&) = delete;
+    void operator = (const DescriptorArena&) = delete;
+};
+
+} // namespace a3d
@@ -24,8 +24,12 @@ DescriptorSet::DescriptorSet()
 , m_pDevice         (nullptr)
 , m_pLayout         (nullptr)
 , m_DescriptorSet   (null_handle)
+, m_DescriptorPool  (null_handle)
 , m_pWrites         (nullptr)
 , m_pInfos          (nullptr)
+, m_HasStorageImage (false)
+, m_IsTransient     (false)
+, m_EntryCapacity   (0)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -58,69 +62,11 @@ bool DescriptorSet::Init
     // ディスクリプタセットを生成します.
     if (!m_pDevice->IsSupportExtension(Device::EXT_KHR_PUSH_DESCRIPTOR))
     {
-        auto pNativeDescriptorPool   = pLayout->GetVulkanDescriptorPool();
-        auto pNativeDescriptorLayout = pLayout->GetVulkanDescriptorSetLayout();
-
-        VkDescriptorSetAllocateInfo info = {};
-        info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        info.pNext              = nullptr;
-        info.descriptorPool     = pNativeDescriptorPool;
-        info.descriptorSetCount = 1;
-        info.pSetLayouts        = &pNativeDescriptorLayout;
-
-        auto ret = vkAllocateDescriptorSets( pNativeDevice, &info, &m_DescriptorSet );
-        if (ret != VK_SUCCESS)
+        if (!pLayout->AllocateVulkanDescriptorSet(&m_DescriptorSet, &m_DescriptorPool))
         { return false; }
     }
 
-    if (pLayout->GetDesc().EntryCount > 0)
-    {
-        const auto& desc = pLayout->GetDesc();
-        auto count       = desc.EntryCount;
-
-        m_pWrites = new VkWriteDescriptorSet [count];
-        if (m_pWrites == nullptr)
-        { return false; }
-
-        memset( m_pWrites, 0, sizeof(VkWriteDescriptorSet) * count );
-
-        m_pInfos = new DescriptorInfo [count];
-        if (m_pInfos == nullptr)
-        { return false; }
-
-        memset( m_pInfos, 0, sizeof(DescriptorInfo) * count );
-
-        auto bufferIndex = 0;
-        auto imageIndex  = 0;
-        for(auto i=0u; i<count; ++i)
-        {
-            m_pWrites[i].sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            m_pWrites[i].pNext              = nullptr;
-            m_pWrites[i].dstSet             = m_DescriptorSet;
-            m_pWrites[i].dstBinding         = desc.Entries[i].BindLocation;
-            m_pWrites[i].dstArrayElement    = 0;
-            m_pWrites[i].descriptorCount    = 1;
-            m_pWrites[i].descriptorType     = ToNativeDescriptorType(desc.Entries[i].Type);
-            m_pWrites[i].pImageInfo         = nullptr;
-            m_pWrites[i].pBufferInfo        = nullptr;
-            m_pWrites[i].pTexelBufferView   = nullptr;
-
-            if (desc.Entries[i].Type == DESCRIPTOR_TYPE_CBV ||
-                desc.Entries[i].Type == DESCRIPTOR_TYPE_UAV)
-            {
-                m_pWrites[i].pBufferInfo = &m_pInfos[bufferIndex].Buffer;
-                bufferIndex++;
-            }
-            else if (desc.Entries[i].Type == DESCRIPTOR_TYPE_SRV ||
-                     desc.Entries[i].Type == DESCRIPTOR_TYPE_SMP)
-            {
-                m_pWrites[i].pImageInfo = &m_pInfos[imageIndex].Image;
-                imageIndex++;
-            }
-        }
-    }
-
-    return true;
+    return SetupWrites(pLayout);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -134,9 +80,6 @@ void DescriptorSet::Term()
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT(pNativeDevice != null_handle);
 
-    auto pNativeDescriptorPool = m_pLayout->GetVulkanDescriptorPool();
-    A3D_ASSERT(pNativeDescriptorPool != null_handle);
-
     if (m_pWrites != nullptr)
     {
         delete[] m_pWrites;
@@ -149,13 +92,23 @@ void DescriptorSet::Term()
         m_pInfos = nullptr;
     }
 
-    if (m_DescriptorSet != null_handle)
+    m_EntryCapacity = 0;
+
+    // 一時ディスクリプタセットはアリーナのページごとリセットされるため返却しない.
+    if (m_DescriptorSet != null_handle && !m_IsTransient)
     {
-        vkFreeDescriptorSets(pNativeDevice, pNativeDescriptorPool, 1, &m_DescriptorSet);
-        m_DescriptorSet = null_handle;
+        // セットはレイアウト側で再利用されるため, プールには返却しない.
+        m_pLayout->ReleaseVulkanDescriptorSet(m_DescriptorSet, m_DescriptorPool);
     }
 
-    SafeRelease(m_pLayout);
+    m_DescriptorSet  = null_handle;
+    m_DescriptorPool = null_handle;
+
+    if (m_IsTransient)
+    { m_pLayout = nullptr; }
+    else
+    { SafeRelease(m_pLayout); }
+
     SafeRelease(m_pDevice);
 }
 
@@ -253,6 +206,9 @@ void DescriptorSet::SetView(uint32_t index, IUnorderedAccessView* const pResourc
         m_pInfos[index].Image.imageLayout   = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         m_pInfos[index].Image.imageView     = pWrapView->GetVulkanImageView();
         m_pInfos[index].StorageBuffer       = false;
+
+        // テンプレートはレイアウトのディスクリプタタイプで書き込むため使用できなくなる.
+        m_HasStorageImage = true;
     }
 }
 
@@ -277,12 +233,26 @@ void DescriptorSet::Update()
     if (m_pDevice->IsSupportExtension(Device::EXT_KHR_PUSH_DESCRIPTOR))
     { return; }
 
+    #if defined(VK_KHR_descriptor_update_template)
+    if (IsTemplateUpdate())
+    {
+        a3d_vkUpdateDescriptorSetWithTemplate(
+            m_pDevice->GetVulkanDevice(),
+            m_DescriptorSet,
+            m_pLayout->GetVulkanDescriptorUpdateTemplate(),
+            m_pInfos);
+        return;
+    }
+    #endif
+
     const auto& desc = m_pLayout->GetDesc();
     auto count = desc.EntryCount;
 
     for(auto i=0u; i<count; ++i)
     {
-        if (desc.Entries[i].Type == DESCRIPTOR_TYPE_CBV)
+        if (desc.Entries[i].Type == DESCRIPTOR_TYPE_CBV         ||
+            desc.Entries[i].Type == DESCRIPTOR_TYPE_CBV_DYNAMIC ||
+            desc.Entries[i].Type == DESCRIPTOR_TYPE_UAV_DYNAMIC)
         {
             m_pWrites[i].pBufferInfo = &m_pInfos[i].Buffer;
             m_pWrites[i].pImageInfo  = nullptr;
@@ -319,13 +289,77 @@ void DescriptorSet::Update()
 //      描画コマンドを生成します.
 //-------------------------------------------------------------------------------------------------
 void DescriptorSet::Issue(ICommandList* pCommandList)
+{ Issue(pCommandList, 0, nullptr); }
+
+//-------------------------------------------------------------------------------------------------
+//      動的オフセットを指定して描画コマンドを生成します.
+//-------------------------------------------------------------------------------------------------
+void DescriptorSet::Issue
+(
+    ICommandList*   pCommandList,
+    uint32_t        offsetCount,
+    const uint32_t* pOffsets
+)
 {
+    auto pWrapCommandList = static_cast<CommandList*>(pCommandList);
+    A3D_ASSERT(pWrapCommandList != nullptr);
+
+    auto pNativeCommandBuffer = pWrapCommandList->GetVulkanCommandBuffer();
+    A3D_ASSERT(pNativeCommandBuffer != null_handle);
+
+    // バインドレスのレイアウトであれば, set = 0 にヒープが設定されている必要がある.
+    pWrapCommandList->PrepareDescriptorSet(
+        m_pLayout->GetVulkanPipelineBindPoint(),
+        m_pLayout->GetVulkanSetIndex());
+
+#if defined(VK_KHR_PUSH_DESCRIPTOR_SPEC_VERSION) && defined(VK_KHR_descriptor_update_template)
+    if (m_pDevice->IsSupportExtension(Device::EXT_KHR_PUSH_DESCRIPTOR) && IsTemplateUpdate())
+    {
+        const void* pData = m_pInfos;
+
+        // 動的オフセットはコピーしたディスクリプタ情報に加算する.
+        DescriptorInfo dynamicInfos[64];
+        if (m_pLayout->GetDynamicOffsetCount() > 0)
+        {
+            const auto& desc = m_pLayout->GetDesc();
+            memcpy(dynamicInfos, m_pInfos, sizeof(DescriptorInfo) * desc.EntryCount);
+
+            auto dynamicIndex = 0u;
+            for(auto i=0u; i<desc.EntryCount; ++i)
+            {
+                if (desc.Entries[i].Type != DESCRIPTOR_TYPE_CBV_DYNAMIC &&
+                    desc.Entries[i].Type != DESCRIPTOR_TYPE_UAV_DYNAMIC)
+                { continue; }
+
+                if (dynamicIndex < offsetCount)
+                { dynamicInfos[i].Buffer.offset += pOffsets[dynamicIndex]; }
+                dynamicIndex++;
+            }
+
+            pData = dynamicInfos;
+        }
+
+        a3d_vkCmdPushDescriptorSetWithTemplate(
+            pNativeCommandBuffer,
+            m_pLayout->GetVulkanDescriptorUpdateTemplate(),
+            m_pLayout->GetVulkanPipelineLayout(),
+            m_pLayout->GetVulkanSetIndex(),
+            pData);
+
+        return;
+    }
+#endif
+
 #if defined(VK_KHR_PUSH_DESCRIPTOR_SPEC_VERSION)
     if (m_pDevice->IsSupportExtension(Device::EXT_KHR_PUSH_DESCRIPTOR))
     {
         auto desc  = m_pLayout->GetDesc();
         auto count = desc.EntryCount;
 
+        // 動的オフセットを加算したバッファ情報です.
+        VkDescriptorBufferInfo dynamicInfos[64];
+        auto dynamicIndex = 0u;
+
         for(auto i=0u; i<count; ++i)
         {
             if (desc.Entries[i].Type == DESCRIPTOR_TYPE_CBV)
@@ -333,6 +367,17 @@ void DescriptorSet::Issue(ICommandList* pCommandList)
                 m_pWrites[i].pBufferInfo = &m_pInfos[i].Buffer;
                 m_pWrites[i].pImageInfo  = nullptr;
             }
+            else if (desc.Entries[i].Type == DESCRIPTOR_TYPE_CBV_DYNAMIC ||
+                     desc.Entries[i].Type == DESCRIPTOR_TYPE_UAV_DYNAMIC)
+            {
+                dynamicInfos[i] = m_pInfos[i].Buffer;
+                if (dynamicIndex < offsetCount)
+                { dynamicInfos[i].offset += pOffsets[dynamicIndex]; }
+                dynamicIndex++;
+
+                m_pWrites[i].pBufferInfo = &dynamicInfos[i];
+                m_pWrites[i].pImageInfo  = nullptr;
+            }
             else if (desc.Entries[i].Type == DESCRIPTOR_TYPE_SRV ||
                      desc.Entries[i].Type == DESCRIPTOR_TYPE_SMP)
             {
@@ -356,57 +401,137 @@ void DescriptorSet::Issue(ICommandList* pCommandList)
             }
         }
 
-        auto pWrapCommandList = static_cast<CommandList*>(pCommandList);
-        A3D_ASSERT(pWrapCommandList != nullptr);
-
-        auto pNativeCommandBuffer = pWrapCommandList->GetVulkanCommandBuffer();
-        A3D_ASSERT(pNativeCommandBuffer != null_handle);
-
         vkCmdPushDescriptorSet(
             pNativeCommandBuffer,
             m_pLayout->GetVulkanPipelineBindPoint(),
             m_pLayout->GetVulkanPipelineLayout(),
-            0,                                      // 0番目を更新.
+            m_pLayout->GetVulkanSetIndex(),
             count,
             m_pWrites);
-    }
-    else
-    {
-        auto pWrapCommandList = static_cast<CommandList*>(pCommandList);
-        A3D_ASSERT(pWrapCommandList != nullptr);
-
-        auto pNativeCommandBuffer = pWrapCommandList->GetVulkanCommandBuffer();
-        A3D_ASSERT(pNativeCommandBuffer != null_handle);
 
-        vkCmdBindDescriptorSets(
-            pNativeCommandBuffer,
-            m_pLayout->GetVulkanPipelineBindPoint(),
-            m_pLayout->GetVulkanPipelineLayout(),
-            0,
-            1,
-            &m_DescriptorSet,
-            0,
-            nullptr);
+        return;
     }
-#else
-    auto pWrapCommandList = static_cast<CommandList*>(pCommandList);
-    A3D_ASSERT(pWrapCommandList != nullptr);
+#endif
 
-    auto pNativeCommandBuffer = pWrapCommandList->GetVulkanCommandBuffer();
-    A3D_ASSERT(pNativeCommandBuffer != null_handle);
+    // エントリー順で受け取ったオフセットをバインド番号順に並べ替える.
+    uint32_t dynamicOffsets[64];
+    auto dynamicOffsetCount = m_pLayout->GetDynamicOffsetCount();
+    for(auto i=0u; i<dynamicOffsetCount; ++i)
+    {
+        auto order = m_pLayout->GetDynamicOffsetOrder(i);
+        dynamicOffsets[i] = (order < offsetCount) ? pOffsets[order] : 0;
+    }
 
     vkCmdBindDescriptorSets(
         pNativeCommandBuffer,
         m_pLayout->GetVulkanPipelineBindPoint(),
         m_pLayout->GetVulkanPipelineLayout(),
-        0,
+        m_pLayout->GetVulkanSetIndex(),
         1,
         &m_DescriptorSet,
-        0,
-        nullptr);
-#endif
+        dynamicOffsetCount,
+        (dynamicOffsetCount > 0) ? dynamicOffsets : nullptr);
 }
 
+//-------------------------------------------------------------------------------------------------
+//      一時ディスクリプタセットとして再設定します.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorSet::ResetTransient(DescriptorSetLayout* pLayout, VkDescriptorSet set)
+{
+    A3D_ASSERT(m_IsTransient);
+
+    if (pLayout == nullptr)
+    { return false; }
+
+    m_pLayout         = pLayout;
+    m_DescriptorSet   = set;
+    m_HasStorageImage = false;
+
+    return SetupWrites(pLayout);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      書き込みディスクリプタを設定します.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorSet::SetupWrites(DescriptorSetLayout* pLayout)
+{
+    if (pLayout->GetDesc().EntryCount > 0)
+    {
+        const auto& desc = pLayout->GetDesc();
+        auto count       = desc.EntryCount;
+
+        // 一時ディスクリプタセットとして再利用する場合は, 足りないときだけ確保し直す.
+        if (count > m_EntryCapacity)
+        {
+            if (m_pWrites != nullptr)
+            {
+                delete[] m_pWrites;
+                m_pWrites = nullptr;
+            }
+
+            if (m_pInfos != nullptr)
+            {
+                delete[] m_pInfos;
+                m_pInfos = nullptr;
+            }
+
+            m_EntryCapacity = 0;
+
+            m_pWrites = new VkWriteDescriptorSet [count];
+            if (m_pWrites == nullptr)
+            { return false; }
+
+            m_pInfos = new DescriptorInfo [count];
+            if (m_pInfos == nullptr)
+            { return false; }
+
+            m_EntryCapacity = count;
+        }
+
+        memset( m_pWrites, 0, sizeof(VkWriteDescriptorSet) * count );
+        memset( m_pInfos, 0, sizeof(DescriptorInfo) * count );
+
+        auto bufferIndex = 0;
+        auto imageIndex  = 0;
+        for(auto i=0u; i<count; ++i)
+        {
+            m_pWrites[i].sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            m_pWrites[i].pNext              = nullptr;
+            m_pWrites[i].dstSet             = m_DescriptorSet;
+            m_pWrites[i].dstBinding         = desc.Entries[i].BindLocation;
+            m_pWrites[i].dstArrayElement    = 0;
+            m_pWrites[i].descriptorCount    = 1;
+            m_pWrites[i].descriptorType     = pLayout->GetVulkanDescriptorType(i);
+            m_pWrites[i].pImageInfo         = nullptr;
+            m_pWrites[i].pBufferInfo        = nullptr;
+            m_pWrites[i].pTexelBufferView   = nullptr;
+
+            if (desc.Entries[i].Type == DESCRIPTOR_TYPE_CBV         ||
+                desc.Entries[i].Type == DESCRIPTOR_TYPE_UAV         ||
+                desc.Entries[i].Type == DESCRIPTOR_TYPE_CBV_DYNAMIC ||
+                desc.Entries[i].Type == DESCRIPTOR_TYPE_UAV_DYNAMIC)
+            {
+                m_pWrites[i].pBufferInfo = &m_pInfos[bufferIndex].Buffer;
+                bufferIndex++;
+            }
+            else if (desc.Entries[i].Type == DESCRIPTOR_TYPE_SRV ||
+                     desc.Entries[i].Type == DESCRIPTOR_TYPE_SMP)
+            {
+                m_pWrites[i].pImageInfo = &m_pInfos[imageIndex].Image;
+                imageIndex++;
+            }
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタ更新テンプレートを使用するかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorSet::IsTemplateUpdate() const
+{ return m_pLayout->GetVulkanDescriptorUpdateTemplate() != null_handle && !m_HasStorageImage; }
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
@@ -436,4 +561,30 @@ bool DescriptorSet::Create
     return true;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      一時ディスクリプタセット用のオブジェクトを生成します.
+//-------------------------------------------------------------------------------------------------
+bool DescriptorSet::CreateTransient
+(
+    IDevice*            pDevice,
+    DescriptorSet**     ppDescriptorSet
+)
+{
+    if (pDevice         == nullptr
+     || ppDescriptorSet == nullptr)
+    { return false; }
+
+    auto instance = new DescriptorSet;
+    if (instance == nullptr)
+    { return false; }
+
+    // レイアウトとセットは割り当て毎に ResetTransient() で設定する.
+    instance->m_pDevice = static_cast<Device*>(pDevice);
+    instance->m_pDevice->AddRef();
+    instance->m_IsTransient = true;
+
+    *ppDescriptorSet = instance;
+    return true;
+}
+
 } // namespace a3d
@@ -42,6 +42,28 @@ public:
         DescriptorSetLayout*            pLayout,
         IDescriptorSet**                ppDescriptorSet);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      一時ディスクリプタセット用のオブジェクトを生成します.
+    //!
+    //! @param[in]      pDevice             デバイスです.
+    //! @param[out]     ppDescriptorSet     ディスクリプタセットの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY CreateTransient(
+        IDevice*                        pDevice,
+        DescriptorSet**                 ppDescriptorSet);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      一時ディスクリプタセットとして再設定します.
+    //!
+    //! @param[in]      pLayout     ディスクリプタセットレイアウトです. 参照カウントは増やしません.
+    //! @param[in]      set         アリーナから確保したディスクリプタセットです.
+    //! @retval true    再設定に成功.
+    //! @retval false   再設定に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY ResetTransient(DescriptorSetLayout* pLayout, VkDescriptorSet set);
+
     //---------------------------------------------------------------------------------------------
     //! @brief      参照カウントを増やします.
     //---------------------------------------------------------------------------------------------
@@ -109,21 +131,19 @@ public:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Issue(ICommandList* pCommandList);
 
-private:
-    ///////////////////////////////////////////////////////////////////////////////////////////////
-    // DescriptorInfo union
-    ///////////////////////////////////////////////////////////////////////////////////////////////
-    struct DescriptorInfo
-    {
-        union
-        {
-            VkDescriptorImageInfo   Image;          //!< イメージ情報です.
-            VkDescriptorBufferInfo  Buffer;         //!< バッファ情報です.
-            VkBufferView            BufferView;     //!< バッファビューです.
-        };
-        bool StorageBuffer;
-    };
+    //---------------------------------------------------------------------------------------------
+    //! @brief      動的オフセットを指定して描画コマンドを発行します.
+    //!
+    //! @param[in]      pCommandList    コマンドリストです.
+    //! @param[in]      offsetCount     動的オフセット数です.
+    //! @param[in]      pOffsets        エントリー順の動的オフセットです.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Issue(
+        ICommandList*   pCommandList,
+        uint32_t        offsetCount,
+        const uint32_t* pOffsets);
 
+private:
     //=============================================================================================
     // private variables.
     //=============================================================================================
@@ -131,8 +151,12 @@ private:
     Device*                         m_pDevice;              //!< デバイスです.
     DescriptorSetLayout*            m_pLayout;              //!< ディスクリプタセットレイアウトです.
     VkDescriptorSet                 m_DescriptorSet;        //!< ディスクリプタセットです.
+    VkDescriptorPool                m_DescriptorPool;       //!< 確保元のディスクリプタプールです.
     VkWriteDescriptorSet*           m_pWrites;              //!< 書き込みディスクリプタです.
     DescriptorInfo*                 m_pInfos;               //!< ディスクリプタ情報です.
+    bool                            m_HasStorageImage;      //!< ストレージイメージが設定されているかどうか?
+    bool                            m_IsTransient;          //!< 一時ディスクリプタセットかどうか?
+    uint32_t                        m_EntryCapacity;        //!< 書き込みディスクリプタの確保済み要素数です.
 
     //---------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
@@ -161,6 +185,23 @@ private:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Term();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      書き込みディスクリプタを設定します.
+    //!
+    //! @param[in]      pLayout         ディスクリプタセットレイアウトです.
+    //! @retval true    設定に成功.
+    //! @retval false   設定に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY SetupWrites(DescriptorSetLayout* pLayout);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタ更新テンプレートを使用するかどうかチェックします.
+    //!
+    //! @retval true    テンプレートを使用します.
+    //! @retval false   テンプレートを使用しません.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY IsTemplateUpdate() const;
+
     DescriptorSet   (const DescriptorSet&) = delete;
     void operator = (const DescriptorSet&) = delete;
 };
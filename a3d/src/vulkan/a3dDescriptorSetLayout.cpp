@@ -4,6 +4,11 @@
 // Copyright(c) Project Asura. All right reserved.
 //-------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include "a3dVulkanFunc.h"
+
 
 namespace /* anonymous */ {
 
@@ -51,10 +56,13 @@ DescriptorSetLayout::DescriptorSetLayout()
 , m_pDevice             (nullptr)
 , m_DescriptorSetLayout (null_handle)
 , m_PipelineLayout      (null_handle)
-, m_DescriptorPool      (null_handle)
 , m_ImageCount          (0)
 , m_BufferCount         (0)
 , m_SamplerCount        (0)
+, m_DynamicOffsetCount  (0)
+, m_UpdateTemplate      (null_handle)
+, m_SetIndex            (0)
+, m_PoolSizeCount       (0)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -112,24 +120,70 @@ bool DescriptorSetLayout::Init(IDevice* pDevice, const DescriptorSetLayoutDesc*
         for(auto i=0u; i<pDesc->EntryCount; ++i)
         {
             bindings[i].binding             = pDesc->Entries[i].BindLocation;
-            bindings[i].descriptorType      = ToNativeDescriptorType(pDesc->Entries[i].Type);
+            bindings[i].descriptorType      = GetVulkanDescriptorType(i);
             bindings[i].stageFlags          = ToNativeShaderFlags(pDesc->Entries[i].ShaderMask);
             bindings[i].descriptorCount     = 1;
             bindings[i].pImmutableSamplers  = nullptr;
 
-            if (bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
-                bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER )
+            if (bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER         ||
+                bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER         ||
+                bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC )
             { bufferCount++; }
             else if (bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE)
             { imageCount++; }
             else if (bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER)
             { samplerCount++; }
+
+            // プールのページを実際に使用するディスクリプタ数から決めるため, タイプ毎に集計しておく.
+            auto hit = false;
+            for(auto j=0u; j<m_PoolSizeCount; ++j)
+            {
+                if (m_PoolSizes[j].type == bindings[i].descriptorType)
+                {
+                    m_PoolSizes[j].descriptorCount += bindings[i].descriptorCount;
+                    hit = true;
+                    break;
+                }
+            }
+
+            if (!hit)
+            {
+                A3D_ASSERT(m_PoolSizeCount < 8);
+                m_PoolSizes[m_PoolSizeCount].type            = bindings[i].descriptorType;
+                m_PoolSizes[m_PoolSizeCount].descriptorCount = bindings[i].descriptorCount;
+                m_PoolSizeCount++;
+            }
         }
 
         m_BufferCount  = bufferCount;
         m_ImageCount   = imageCount;
         m_SamplerCount = samplerCount;
 
+        // vkCmdBindDescriptorSets() の動的オフセットはバインド番号順に並べる必要があるため，
+        // エントリー順で受け取ったオフセットとの対応をここで求めておく.
+        uint32_t bindLocations[64];
+        m_DynamicOffsetCount = 0;
+        for(auto i=0u; i<pDesc->EntryCount; ++i)
+        {
+            if (pDesc->Entries[i].Type != DESCRIPTOR_TYPE_CBV_DYNAMIC &&
+                pDesc->Entries[i].Type != DESCRIPTOR_TYPE_UAV_DYNAMIC)
+            { continue; }
+
+            // 挿入ソートでバインド番号順の位置に入れる.
+            auto bindLocation = pDesc->Entries[i].BindLocation;
+            auto j = m_DynamicOffsetCount;
+            while (j > 0 && bindLocations[j - 1] > bindLocation)
+            {
+                bindLocations       [j] = bindLocations       [j - 1];
+                m_DynamicOffsetOrder[j] = m_DynamicOffsetOrder[j - 1];
+                j--;
+            }
+            bindLocations       [j] = bindLocation;
+            m_DynamicOffsetOrder[j] = m_DynamicOffsetCount;
+            m_DynamicOffsetCount++;
+        }
+
         VkDescriptorSetLayoutCreateFlags flags = 0;
         #if defined(VK_KHR_push_descriptor)
         if (m_pDevice->IsSupportExtension(Device::EXT_KHR_PUSH_DESCRIPTOR))
@@ -149,12 +203,31 @@ bool DescriptorSetLayout::Init(IDevice* pDevice, const DescriptorSetLayoutDesc*
     }
 
     {
+        // バインドレスヒープはバインドレスのレイアウト間で互換性を保つため set = 0 に置く.
+        // バインドレスでないレイアウトは set = 0 を使うため, ヒープはコマンドリスト側で必要に応じて設定し直す.
+        VkDescriptorSetLayout setLayouts[2] = {};
+        auto setLayoutCount = 0u;
+
+        if (pDesc->Flags & DESCRIPTOR_SET_LAYOUT_FLAG_BINDLESS)
+        {
+            auto pHeap = m_pDevice->GetBindlessHeap();
+            if (pHeap == nullptr)
+            { return false; }
+
+            setLayouts[setLayoutCount] = pHeap->GetVulkanDescriptorSetLayout();
+            setLayoutCount++;
+        }
+
+        m_SetIndex = setLayoutCount;
+        setLayouts[setLayoutCount] = m_DescriptorSetLayout;
+        setLayoutCount++;
+
         VkPipelineLayoutCreateInfo info = {};
         info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         info.pNext                  = nullptr;
         info.flags                  = 0;
-        info.setLayoutCount         = 1;
-        info.pSetLayouts            = &m_DescriptorSetLayout;
+        info.setLayoutCount         = setLayoutCount;
+        info.pSetLayouts            = setLayouts;
         info.pushConstantRangeCount = 0;
         info.pPushConstantRanges    = nullptr;
 
@@ -163,8 +236,43 @@ bool DescriptorSetLayout::Init(IDevice* pDevice, const DescriptorSetLayoutDesc*
         { return false; }
     }
 
-    if (!m_pDevice->CreateVulkanDescriptorPool(pDesc->MaxSetCount, &m_DescriptorPool))
-    { return false; }
+    // 書き込み情報をエントリー毎に組み立てなくて済むように，更新テンプレートを作成しておく.
+    #if defined(VK_KHR_descriptor_update_template)
+    if (m_pDevice->IsSupportExtension(Device::EXT_KHR_DESCRIPTOR_UPDATE_TEMPLATE) && pDesc->EntryCount > 0)
+    {
+        VkDescriptorUpdateTemplateEntryKHR entries[64];
+        for(auto i=0u; i<pDesc->EntryCount; ++i)
+        {
+            entries[i].dstBinding       = pDesc->Entries[i].BindLocation;
+            entries[i].dstArrayElement  = 0;
+            entries[i].descriptorCount  = 1;
+            entries[i].descriptorType   = GetVulkanDescriptorType(i);
+            entries[i].offset           = sizeof(DescriptorInfo) * i;
+            entries[i].stride           = sizeof(DescriptorInfo);
+        }
+
+        VkDescriptorUpdateTemplateCreateInfoKHR info = {};
+        info.sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR;
+        info.pNext                      = nullptr;
+        info.flags                      = 0;
+        info.descriptorUpdateEntryCount = pDesc->EntryCount;
+        info.pDescriptorUpdateEntries   = entries;
+        info.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+        info.descriptorSetLayout        = m_DescriptorSetLayout;
+        info.pipelineBindPoint          = m_BindPoint;
+        info.pipelineLayout             = m_PipelineLayout;
+        info.set                        = m_SetIndex;
+
+        #if defined(VK_KHR_push_descriptor)
+        if (m_pDevice->IsSupportExtension(Device::EXT_KHR_PUSH_DESCRIPTOR))
+        { info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR; }
+        #endif
+
+        auto ret = a3d_vkCreateDescriptorUpdateTemplate( pNativeDevice, &info, nullptr, &m_UpdateTemplate );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+    #endif
 
     return true;
 }
@@ -180,6 +288,14 @@ void DescriptorSetLayout::Term()
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT( pNativeDevice != null_handle );
 
+    #if defined(VK_KHR_descriptor_update_template)
+    if ( m_UpdateTemplate != null_handle )
+    {
+        a3d_vkDestroyDescriptorUpdateTemplate(pNativeDevice, m_UpdateTemplate, nullptr);
+        m_UpdateTemplate = null_handle;
+    }
+    #endif
+
     if ( m_DescriptorSetLayout != null_handle )
     {
         vkDestroyDescriptorSetLayout(pNativeDevice, m_DescriptorSetLayout, nullptr);
@@ -192,15 +308,27 @@ void DescriptorSetLayout::Term()
         m_PipelineLayout = null_handle;
     }
 
-    if ( m_DescriptorPool != null_handle )
+    // 再利用のために保持していたセットをプールに返却する.
     {
-        vkDestroyDescriptorPool(pNativeDevice, m_DescriptorPool, nullptr);
-        m_DescriptorPool = null_handle;
+        auto pAllocator = m_pDevice->GetDescriptorAllocator();
+        for(size_t i=0; i<m_CachedSets.size(); ++i)
+        {
+            pAllocator->Free(
+                m_PoolSizes,
+                m_PoolSizeCount,
+                m_CachedSets[i].Pool,
+                1,
+                &m_CachedSets[i].Set);
+        }
+
+        m_CachedSets.clear();
     }
 
-    m_BufferCount  = 0;
-    m_ImageCount   = 0;
-    m_SamplerCount = 0;
+    m_BufferCount        = 0;
+    m_ImageCount         = 0;
+    m_SamplerCount       = 0;
+    m_DynamicOffsetCount = 0;
+    m_PoolSizeCount      = 0;
     SafeRelease(m_pDevice);
 }
 
@@ -261,10 +389,60 @@ VkPipelineBindPoint DescriptorSetLayout::GetVulkanPipelineBindPoint() const
 { return m_BindPoint; }
 
 //-------------------------------------------------------------------------------------------------
-//      ディスクリプタプールを取得します.
+//      ディスクリプタセットを確保します.
 //-------------------------------------------------------------------------------------------------
-VkDescriptorPool DescriptorSetLayout::GetVulkanDescriptorPool() const
-{ return m_DescriptorPool; }
+bool DescriptorSetLayout::AllocateVulkanDescriptorSet(VkDescriptorSet* pSet, VkDescriptorPool* pPool)
+{
+    if (pSet == nullptr || pPool == nullptr)
+    { return false; }
+
+    {
+        std::lock_guard<std::mutex> locker(m_CacheMutex);
+        if (!m_CachedSets.empty())
+        {
+            *pSet  = m_CachedSets.back().Set;
+            *pPool = m_CachedSets.back().Pool;
+            m_CachedSets.pop_back();
+            return true;
+        }
+    }
+
+    return m_pDevice->GetDescriptorAllocator()->Allocate(
+        m_DescriptorSetLayout,
+        m_PoolSizes,
+        m_PoolSizeCount,
+        Max(1u, m_Desc.MaxSetCount),
+        pSet,
+        pPool);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタセットを解放します.
+//-------------------------------------------------------------------------------------------------
+void DescriptorSetLayout::ReleaseVulkanDescriptorSet(VkDescriptorSet set, VkDescriptorPool pool)
+{
+    if (set == null_handle)
+    { return; }
+
+    CachedSet item;
+    item.Set  = set;
+    item.Pool = pool;
+
+    std::lock_guard<std::mutex> locker(m_CacheMutex);
+    m_CachedSets.push_back(item);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1セットあたりのディスクリプタ数を取得します.
+//-------------------------------------------------------------------------------------------------
+const VkDescriptorPoolSize* DescriptorSetLayout::GetVulkanPoolSizes() const
+{ return m_PoolSizes; }
+
+//-------------------------------------------------------------------------------------------------
+//      1セットあたりのディスクリプタ数の要素数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t DescriptorSetLayout::GetVulkanPoolSizeCount() const
+{ return m_PoolSizeCount; }
 
 //-------------------------------------------------------------------------------------------------
 //      ディスクリプタセットレイアウトを取得します.
@@ -290,6 +468,54 @@ uint32_t DescriptorSetLayout::GetImageCount() const
 uint32_t DescriptorSetLayout::GetSamplerCount() const
 { return m_SamplerCount; }
 
+//-------------------------------------------------------------------------------------------------
+//      エントリーのディスクリプタタイプを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDescriptorType DescriptorSetLayout::GetVulkanDescriptorType(uint32_t index) const
+{
+    A3D_ASSERT(index < m_Desc.EntryCount);
+    auto type = ToNativeDescriptorType(m_Desc.Entries[index].Type);
+
+    // プッシュディスクリプタでは動的ディスクリプタを使用できないため，
+    // 通常のディスクリプタとして扱い，オフセットは書き込み時に加算する.
+    if (m_pDevice->IsSupportExtension(Device::EXT_KHR_PUSH_DESCRIPTOR))
+    {
+        if (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+        { type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; }
+        else if (type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC)
+        { type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER; }
+    }
+
+    return type;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      動的オフセット数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t DescriptorSetLayout::GetDynamicOffsetCount() const
+{ return m_DynamicOffsetCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      バインド番号順の動的オフセットに対応するエントリー順の番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t DescriptorSetLayout::GetDynamicOffsetOrder(uint32_t index) const
+{
+    A3D_ASSERT(index < m_DynamicOffsetCount);
+    return m_DynamicOffsetOrder[index];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ディスクリプタ更新テンプレートを取得します.
+//-------------------------------------------------------------------------------------------------
+VkDescriptorUpdateTemplateKHR DescriptorSetLayout::GetVulkanDescriptorUpdateTemplate() const
+{ return m_UpdateTemplate; }
+
+//-------------------------------------------------------------------------------------------------
+//      パイプラインレイアウト上のセット番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t DescriptorSetLayout::GetVulkanSetIndex() const
+{ return m_SetIndex; }
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
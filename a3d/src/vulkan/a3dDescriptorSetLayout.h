@@ -8,6 +8,22 @@
 
 namespace a3d {
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DescriptorInfo structure
+//! @brief      ディスクリプタ情報です.
+//! @note       ディスクリプタ更新テンプレートはエントリー番号 * sizeof(DescriptorInfo) の位置を参照します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct DescriptorInfo
+{
+    union
+    {
+        VkDescriptorImageInfo   Image;          //!< イメージ情報です.
+        VkDescriptorBufferInfo  Buffer;         //!< バッファ情報です.
+        VkBufferView            BufferView;     //!< バッファビューです.
+    };
+    bool StorageBuffer;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // DescriptorSetLayout class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -97,11 +113,38 @@ public:
     VkPipelineBindPoint A3D_APIENTRY GetVulkanPipelineBindPoint() const;
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      ディスクリプタプールを取得します.
+    //! @brief      ディスクリプタセットを確保します.
     //!
-    //! @return     ディスクリプタプールを返却します.
+    //! @param[out]     pSet        ディスクリプタセットの格納先です.
+    //! @param[out]     pPool       確保元のディスクリプタプールの格納先です.
+    //! @retval true    確保に成功.
+    //! @retval false   確保に失敗.
+    //! @note       解放済みのセットがあれば再利用します.
     //---------------------------------------------------------------------------------------------
-    VkDescriptorPool A3D_APIENTRY GetVulkanDescriptorPool() const;
+    bool A3D_APIENTRY AllocateVulkanDescriptorSet(VkDescriptorSet* pSet, VkDescriptorPool* pPool);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタセットを解放します.
+    //!
+    //! @param[in]      set         ディスクリプタセットです.
+    //! @param[in]      pool        確保元のディスクリプタプールです.
+    //! @note       セットはレイアウトの破棄まで再利用のために保持されます.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY ReleaseVulkanDescriptorSet(VkDescriptorSet set, VkDescriptorPool pool);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      1セットあたりのディスクリプタ数を取得します.
+    //!
+    //! @return     ディスクリプタタイプ毎のディスクリプタ数を返却します.
+    //---------------------------------------------------------------------------------------------
+    const VkDescriptorPoolSize* A3D_APIENTRY GetVulkanPoolSizes() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      1セットあたりのディスクリプタ数の要素数を取得します.
+    //!
+    //! @return     ディスクリプタ数の要素数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetVulkanPoolSizeCount() const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      ディスクリプタセットレイアウトを取得します.
@@ -131,7 +174,55 @@ public:
     //---------------------------------------------------------------------------------------------
     uint32_t A3D_APIENTRY GetSamplerCount() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      エントリーのディスクリプタタイプを取得します.
+    //!
+    //! @param[in]      index       エントリー番号です.
+    //! @return     ネイティブ形式のディスクリプタタイプを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkDescriptorType A3D_APIENTRY GetVulkanDescriptorType(uint32_t index) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      動的オフセット数を取得します.
+    //!
+    //! @return     動的オフセット数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetDynamicOffsetCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バインド番号順の動的オフセットに対応するエントリー順の番号を取得します.
+    //!
+    //! @param[in]      index       バインド番号順の動的オフセット番号です.
+    //! @return     エントリー順の動的オフセット番号を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetDynamicOffsetOrder(uint32_t index) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタ更新テンプレートを取得します.
+    //!
+    //! @return     ディスクリプタ更新テンプレートを返却します. 未サポートの場合は null_handle を返却します.
+    //! @note       プッシュディスクリプタ使用時はプッシュディスクリプタ用のテンプレートとなります.
+    //---------------------------------------------------------------------------------------------
+    VkDescriptorUpdateTemplateKHR A3D_APIENTRY GetVulkanDescriptorUpdateTemplate() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインレイアウト上のセット番号を取得します.
+    //!
+    //! @return     セット番号を返却します.
+    //! @note       DESCRIPTOR_SET_LAYOUT_FLAG_BINDLESS 指定時は set = 0 がバインドレスヒープとなるため 1 を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetVulkanSetIndex() const;
+
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // CachedSet structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct CachedSet
+    {
+        VkDescriptorSet     Set;        //!< ディスクリプタセットです.
+        VkDescriptorPool    Pool;       //!< 確保元のディスクリプタプールです.
+    };
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
@@ -141,10 +232,17 @@ private:
     VkDescriptorSetLayout   m_DescriptorSetLayout;  //!< ディスクリプタセットレイアウトです.
     VkPipelineLayout        m_PipelineLayout;       //!< パイプラインレイアウトです.
     VkPipelineBindPoint     m_BindPoint;            //!< パイプラインバインドポイントです.
-    VkDescriptorPool        m_DescriptorPool;       //!< ディスクリプタプールです.
     uint32_t                m_ImageCount;           //!< イメージ数です.
     uint32_t                m_BufferCount;          //!< バッファ数です.
     uint32_t                m_SamplerCount;         //!< サンプラー数です.
+    uint32_t                m_DynamicOffsetCount;   //!< 動的オフセット数です.
+    uint32_t                m_DynamicOffsetOrder[64];   //!< バインド番号順の動的オフセットに対応するエントリー順の番号です.
+    VkDescriptorUpdateTemplateKHR   m_UpdateTemplate;   //!< ディスクリプタ更新テンプレートです.
+    uint32_t                m_SetIndex;             //!< パイプラインレイアウト上のセット番号です.
+    VkDescriptorPoolSize    m_PoolSizes[8];         //!< 1セットあたりのディスクリプタ数です.
+    uint32_t                m_PoolSizeCount;        //!< 1セットあたりのディスクリプタ数の要素数です.
+    std::mutex              m_CacheMutex;           //!< 再利用セット用ミューテックスです.
+    std::vector<CachedSet, StdAllocator<CachedSet>> m_CachedSets;   //!< 再利用するディスクリプタセットです.
 
     //=============================================================================================
     // private methods.
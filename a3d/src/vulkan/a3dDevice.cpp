@@ -283,7 +283,8 @@ void CheckDeviceExtension
         VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
         VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
         VK_NV_MESH_SHADER_EXTENSION_NAME,
-        VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME
+        VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
+        VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME
     };
 
     result.reserve(count);
@@ -312,6 +313,35 @@ void CheckDeviceExtension
     a3d_free(temp);
 }
 
+//-------------------------------------------------------------------------------------------------
+//      パイプラインキャッシュデータが物理デバイスと互換性があるかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsCompatiblePipelineCache
+(
+    const void*                         pData,
+    size_t                              size,
+    const VkPhysicalDeviceProperties&   props
+)
+{
+    // VK_PIPELINE_CACHE_HEADER_VERSION_ONE のヘッダレイアウト.
+    // headerSize, headerVersion, vendorID, deviceID, pipelineCacheUUID の順に格納されている.
+    const size_t HeaderSize = sizeof(uint32_t) * 4 + VK_UUID_SIZE;
+
+    if (pData == nullptr || size < HeaderSize)
+    { return false; }
+
+    uint32_t header[4] = {};
+    memcpy(header, pData, sizeof(header));
+
+    auto pUUID = static_cast<const uint8_t*>(pData) + sizeof(header);
+
+    return header[0] >= HeaderSize
+        && header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && header[2] == props.vendorID
+        && header[3] == props.deviceID
+        && memcmp(pUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
 } // namespace /* anonymous */
 
 //-------------------------------------------------------------------------------------------------
@@ -329,6 +359,10 @@ PFN_vkGetPhysicalDevicePresentRectanglesKHR  vkGetPhysicalDevicePresentRectangle
 PFN_vkAcquireNextImage2KHR                   vkAcquireNextImage2                     = nullptr;
 #endif
 
+#if defined(VK_EXT_headless_surface)
+PFN_vkCreateHeadlessSurfaceEXT       vkCreateHeadlessSurface    = nullptr;
+#endif
+
 #if defined(VK_EXT_debug_marker)
 PFN_vkDebugMarkerSetObjectTagEXT     vkDebugMarkerSetObjectTag  = nullptr;
 PFN_vkDebugMarkerSetObjectNameEXT    vkDebugMarkerSetObjectName = nullptr;
@@ -341,6 +375,16 @@ PFN_vkCmdDebugMarkerInsertEXT        vkCmdDebugMarkerInsert     = nullptr;
 PFN_vkCmdPushDescriptorSetKHR        vkCmdPushDescriptorSet     = nullptr;
 #endif
 
+#if defined(VK_KHR_descriptor_update_template)
+PFN_vkCreateDescriptorUpdateTemplateKHR     a3d_vkCreateDescriptorUpdateTemplate    = nullptr;
+PFN_vkDestroyDescriptorUpdateTemplateKHR    a3d_vkDestroyDescriptorUpdateTemplate   = nullptr;
+PFN_vkUpdateDescriptorSetWithTemplateKHR    a3d_vkUpdateDescriptorSetWithTemplate   = nullptr;
+#endif
+
+#if defined(VK_KHR_push_descriptor) && defined(VK_KHR_descriptor_update_template)
+PFN_vkCmdPushDescriptorSetWithTemplateKHR   a3d_vkCmdPushDescriptorSetWithTemplate  = nullptr;
+#endif
+
 #if defined(VK_EXT_hdr_metadata)
 PFN_vkSetHdrMetadataEXT              vkSetHdrMetadata           = nullptr;
 #endif
@@ -351,6 +395,12 @@ PFN_vkCmdDrawMeshTasksIndirectNV         vkCmdDrawMeshTasksIndirect         = nu
 PFN_vkCmdDrawMeshTasksIndirectCountNV    vkCmdDrawMeshTasksIndirectCount    = nullptr;
 #endif
 
+#if defined(VK_KHR_timeline_semaphore)
+PFN_vkGetSemaphoreCounterValueKHR    a3d_vkGetSemaphoreCounterValue  = nullptr;
+PFN_vkWaitSemaphoresKHR              a3d_vkWaitSemaphores            = nullptr;
+PFN_vkSignalSemaphoreKHR             a3d_vkSignalSemaphore           = nullptr;
+#endif
+
 
 namespace a3d {
 
@@ -370,6 +420,13 @@ Device::Device()
 , m_pGraphicsQueue      (nullptr)
 , m_pComputeQueue       (nullptr)
 , m_pCopyQueue          (nullptr)
+, m_GraphicsStages      (0)
+, m_PipelineCache       (null_handle)
+, m_pPipelineCompiler   (nullptr)
+, m_pBindlessHeap       (nullptr)
+, m_pDescriptorAllocator(nullptr)
+, m_pRenderPassCache    (nullptr)
+, m_IsSupportHeadlessSurface(false)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -409,14 +466,17 @@ bool Device::Init(const DeviceDesc* pDesc)
         VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME,
         VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME,
         VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME,
-        VK_EXT_DEBUG_REPORT_EXTENSION_NAME,
+    #if defined(VK_EXT_headless_surface)
+        VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME,
+    #endif
+        VK_EXT_DEBUG_REPORT_EXTENSION_NAME,     // デバッグ無効時に除外するため, 必ず末尾に置くこと.
     };
 
     const char* layerNames[] = {
         "VK_LAYER_KHRONOS_validation",
     };
 
-    uint32_t instanceExtensionCount = 7;
+    auto instanceExtensionCount = uint32_t(sizeof(instanceExtension) / sizeof(instanceExtension[0]));
     uint32_t layerCount = 0;
 
     if (pDesc->EnableDebug)
@@ -447,6 +507,19 @@ bool Device::Init(const DeviceDesc* pDesc)
             extensions
         );
 
+        // ヘッドレスサーフェイスが使えるかどうか.
+        m_IsSupportHeadlessSurface = false;
+    #if defined(VK_EXT_headless_surface)
+        for(size_t i=0; i<extensions.size(); ++i)
+        {
+            if (strcmp(extensions[i], VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME) == 0)
+            {
+                m_IsSupportHeadlessSurface = true;
+                break;
+            }
+        }
+    #endif
+
         VkApplicationInfo appInfo = {};
         appInfo.sType               = VK_STRUCTURE_TYPE_APPLICATION_INFO;
         appInfo.pNext               = nullptr;
@@ -503,6 +576,14 @@ bool Device::Init(const DeviceDesc* pDesc)
     }
     #endif
 
+    #if defined(VK_EXT_headless_surface)
+    if (m_IsSupportHeadlessSurface)
+    {
+        vkCreateHeadlessSurface = GET_INSTANCE_PROC(m_Instance, vkCreateHeadlessSurfaceEXT);
+        m_IsSupportHeadlessSurface = (vkCreateHeadlessSurface != nullptr);
+    }
+    #endif
+
     if (pDesc->EnableDebug)
     {
         vkCreateDebugReportCallback  = GET_INSTANCE_PROC(m_Instance, vkCreateDebugReportCallbackEXT);
@@ -755,19 +836,92 @@ bool Device::Init(const DeviceDesc* pDesc)
 
                 if (strcmp(deviceExtensions[i], VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME) == 0)
                 { m_IsSupportExt[EXT_KHR_RAY_TRACING] = true; }
+
+                if (strcmp(deviceExtensions[i], VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0)
+                { m_IsSupportExt[EXT_KHR_TIMELINE_SEMAPHORE] = true; }
             }
         }
 
+        void* pFeatures = nullptr;
+
+        // 拡張機能が公開されていればタイムラインセマフォ機能はサポートされている.
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures = {};
+        timelineFeatures.sType              = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+        timelineFeatures.pNext              = nullptr;
+        timelineFeatures.timelineSemaphore  = VK_TRUE;
+
+        if (m_IsSupportExt[EXT_KHR_TIMELINE_SEMAPHORE])
+        {
+            timelineFeatures.pNext = pFeatures;
+            pFeatures = &timelineFeatures;
+        }
+
+        // バインドレスヒープで使用する機能は拡張機能が公開されていれば必ずサポートされているものに限定する.
+        #if defined(VK_EXT_descriptor_indexing)
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+        indexingFeatures.sType                                          = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        indexingFeatures.pNext                                          = nullptr;
+        indexingFeatures.shaderSampledImageArrayNonUniformIndexing      = VK_TRUE;
+        indexingFeatures.shaderStorageBufferArrayNonUniformIndexing     = VK_TRUE;
+        indexingFeatures.descriptorBindingSampledImageUpdateAfterBind   = VK_TRUE;
+        indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind  = VK_TRUE;
+        indexingFeatures.descriptorBindingUpdateUnusedWhilePending      = VK_TRUE;
+        indexingFeatures.descriptorBindingPartiallyBound                = VK_TRUE;
+        indexingFeatures.runtimeDescriptorArray                         = VK_TRUE;
+
+        if (pDesc->EnableBindless && m_IsSupportExt[EXT_DESCRIPTOR_INDEXING])
+        {
+            indexingFeatures.pNext = pFeatures;
+            pFeatures = &indexingFeatures;
+        }
+        #endif
+
+        #if defined(VK_NV_mesh_shader)
+        VkPhysicalDeviceMeshShaderFeaturesNV meshFeatures = {};
+        meshFeatures.sType      = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_NV;
+        meshFeatures.pNext      = nullptr;
+        meshFeatures.taskShader = VK_TRUE;
+        meshFeatures.meshShader = VK_TRUE;
+
+        if (m_IsSupportExt[EXT_NV_MESH_SHADER])
+        {
+            meshFeatures.pNext = pFeatures;
+            pFeatures = &meshFeatures;
+        }
+        #endif
+
+        // ジオメトリ・テッセレーションシェーダはサポートしていれば有効化する.
+        VkPhysicalDeviceFeatures supportedFeatures = {};
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
+        VkPhysicalDeviceFeatures enabledFeatures = {};
+        enabledFeatures.geometryShader     = supportedFeatures.geometryShader;
+        enabledFeatures.tessellationShader = supportedFeatures.tessellationShader;
+
+        // 有効化していない機能のステージはバリアに含められないので除外しておく.
+        m_GraphicsStages = ~0u;
+        if (enabledFeatures.geometryShader == VK_FALSE)
+        { m_GraphicsStages &= ~VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT; }
+        if (enabledFeatures.tessellationShader == VK_FALSE)
+        {
+            m_GraphicsStages &= ~(VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT
+                                | VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT);
+        }
+        #if defined(VK_NV_mesh_shader)
+        if (!m_IsSupportExt[EXT_NV_MESH_SHADER])
+        { m_GraphicsStages &= ~(VK_PIPELINE_STAGE_TASK_SHADER_BIT_NV | VK_PIPELINE_STAGE_MESH_SHADER_BIT_NV); }
+        #endif
+
         VkDeviceCreateInfo deviceInfo = {};
         deviceInfo.sType                    = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        deviceInfo.pNext                    = nullptr;
+        deviceInfo.pNext                    = pFeatures;
         deviceInfo.queueCreateInfoCount     = propCount;
         deviceInfo.pQueueCreateInfos        = pQueueInfos;
         deviceInfo.enabledLayerCount        = layerCount;
         deviceInfo.ppEnabledLayerNames      = (layerCount == 0) ? nullptr : layerNames;
         deviceInfo.enabledExtensionCount    = uint32_t(deviceExtensions.size());
         deviceInfo.ppEnabledExtensionNames  = deviceExtensions.data();
-        deviceInfo.pEnabledFeatures         = nullptr;
+        deviceInfo.pEnabledFeatures         = &enabledFeatures;
 
         auto ret = vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &m_Device);
 
@@ -794,6 +948,80 @@ bool Device::Init(const DeviceDesc* pDesc)
         if (ret != VK_SUCCESS)
         { return false; }
 
+        // パイプラインキャッシュ生成.
+        {
+            const void* pInitialData    = nullptr;
+            size_t      initialDataSize = 0;
+
+            // ドライバーやデバイスが異なるデータは読み込まない.
+            if (pDesc->pPipelineCache != nullptr)
+            {
+                auto pData = pDesc->pPipelineCache->GetBufferPointer();
+                auto size  = size_t(pDesc->pPipelineCache->GetBufferSize());
+
+                if (IsCompatiblePipelineCache(pData, size, m_pPhysicalDeviceInfos[0].DeviceProperty))
+                {
+                    pInitialData    = pData;
+                    initialDataSize = size;
+                }
+            }
+
+            VkPipelineCacheCreateInfo info = {};
+            info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            info.pNext           = nullptr;
+            info.flags           = 0;
+            info.initialDataSize = initialDataSize;
+            info.pInitialData    = pInitialData;
+
+            ret = vkCreatePipelineCache(m_Device, &info, nullptr, &m_PipelineCache);
+            if (ret != VK_SUCCESS)
+            { return false; }
+
+            // 呼び出し側の所有物なので保持しない.
+            m_Desc.pPipelineCache = nullptr;
+        }
+
+        // 非同期パイプラインコンパイラ生成.
+        {
+            m_pPipelineCompiler = new PipelineCompiler();
+            if (m_pPipelineCompiler == nullptr)
+            { return false; }
+
+            if (!m_pPipelineCompiler->Init(0))
+            { return false; }
+        }
+
+        // ディスクリプタアロケータ生成.
+        {
+            m_pDescriptorAllocator = new DescriptorAllocator();
+            if (m_pDescriptorAllocator == nullptr)
+            { return false; }
+
+            if (!m_pDescriptorAllocator->Init(this))
+            { return false; }
+        }
+
+        // レンダーパスキャッシュ生成.
+        {
+            m_pRenderPassCache = new RenderPassCache();
+            if (m_pRenderPassCache == nullptr)
+            { return false; }
+
+            if (!m_pRenderPassCache->Init(this))
+            { return false; }
+        }
+
+        // バインドレスディスクリプタヒープ生成.
+        if (pDesc->EnableBindless && m_IsSupportExt[EXT_DESCRIPTOR_INDEXING])
+        {
+            m_pBindlessHeap = new BindlessHeap();
+            if (m_pBindlessHeap == nullptr)
+            { return false; }
+
+            if (!m_pBindlessHeap->Init(this, Max(1u, pDesc->MaxShaderResourceCount), Max(1u, pDesc->MaxSamplerCount)))
+            { return false; }
+        }
+
         #if defined(VK_EXT_debug_marker)
         {
             if (m_IsSupportExt[EXT_DEBUG_MARKER])
@@ -816,6 +1044,26 @@ bool Device::Init(const DeviceDesc* pDesc)
         }
         #endif
 
+        #if defined(VK_KHR_descriptor_update_template)
+        {
+            if (m_IsSupportExt[EXT_KHR_DESCRIPTOR_UPDATE_TEMPLATE])
+            {
+                a3d_vkCreateDescriptorUpdateTemplate    = GET_DEVICE_PROC(m_Device, vkCreateDescriptorUpdateTemplateKHR);
+                a3d_vkDestroyDescriptorUpdateTemplate   = GET_DEVICE_PROC(m_Device, vkDestroyDescriptorUpdateTemplateKHR);
+                a3d_vkUpdateDescriptorSetWithTemplate   = GET_DEVICE_PROC(m_Device, vkUpdateDescriptorSetWithTemplateKHR);
+            }
+        }
+        #endif
+
+        #if defined(VK_KHR_push_descriptor) && defined(VK_KHR_descriptor_update_template)
+        {
+            if (m_IsSupportExt[EXT_KHR_PUSH_DESCRIPTOR] && m_IsSupportExt[EXT_KHR_DESCRIPTOR_UPDATE_TEMPLATE])
+            {
+                a3d_vkCmdPushDescriptorSetWithTemplate  = GET_DEVICE_PROC(m_Device, vkCmdPushDescriptorSetWithTemplateKHR);
+            }
+        }
+        #endif
+
         #if defined(VK_EXT_hdr_metadata)
         {
             if (m_IsSupportExt[EXT_HDR_METADATA])
@@ -836,6 +1084,17 @@ bool Device::Init(const DeviceDesc* pDesc)
         }
         #endif
 
+        #if defined(VK_KHR_timeline_semaphore)
+        {
+            if (m_IsSupportExt[EXT_KHR_TIMELINE_SEMAPHORE])
+            {
+                a3d_vkGetSemaphoreCounterValue = GET_DEVICE_PROC(m_Device, vkGetSemaphoreCounterValueKHR);
+                a3d_vkWaitSemaphores           = GET_DEVICE_PROC(m_Device, vkWaitSemaphoresKHR);
+                a3d_vkSignalSemaphore          = GET_DEVICE_PROC(m_Device, vkSignalSemaphoreKHR);
+            }
+        }
+        #endif
+
         if (!Queue::Create(
             this, 
             graphicsIndex,
@@ -889,6 +1148,17 @@ bool Device::Init(const DeviceDesc* pDesc)
 //-------------------------------------------------------------------------------------------------
 void Device::Term()
 {
+    // ワーカースレッドを停止.
+    SafeDelete(m_pPipelineCompiler);
+
+    SafeDelete(m_pBindlessHeap);
+
+    // ディスクリプタセットはレイアウト破棄時に返却済み.
+    SafeDelete(m_pDescriptorAllocator);
+
+    // フレームバッファとパイプラインステートは全て破棄済み.
+    SafeDelete(m_pRenderPassCache);
+
     SafeRelease(m_pGraphicsQueue);
     SafeRelease(m_pComputeQueue);
     SafeRelease(m_pCopyQueue);
@@ -899,6 +1169,12 @@ void Device::Term()
         m_Allocator = null_handle;
     }
 
+    if (m_PipelineCache != null_handle)
+    {
+        vkDestroyPipelineCache(m_Device, m_PipelineCache, nullptr);
+        m_PipelineCache = null_handle;
+    }
+
     if (m_Device != null_handle)
     {
         vkDeviceWaitIdle(m_Device);
@@ -1109,6 +1385,82 @@ bool Device::CreateComputePipeline(const ComputePipelineStateDesc* pDesc, IPipel
 bool Device::CreateGeometryPipeline(const GeometryPipelineStateDesc* pDesc, IPipelineState** ppPipelineState)
 { return PipelineState::CreateAsGeometry(this, pDesc, ppPipelineState); }
 
+//-------------------------------------------------------------------------------------------------
+//      パイプラインを非同期で生成します.
+//-------------------------------------------------------------------------------------------------
+template<typename DescType>
+bool Device::CreatePipelinesAsync
+(
+    uint32_t            count,
+    const DescType*     pDescs,
+    bool (A3D_APIENTRY *pCreate)(IDevice*, const DescType*, PipelineState**),
+    IPipelineState**    ppPipelineStates
+)
+{
+    if (pDescs == nullptr || ppPipelineStates == nullptr || count == 0)
+    { return false; }
+
+    // IPipelineState** を PipelineState** として書き込むことはできないので，ローカルの配列で受け取る.
+    dynamic_array<PipelineState*> states;
+    states.resize(count, nullptr);
+
+    // 生成情報の構築までは呼び出しスレッドで行い，パイプラインの生成のみワーカースレッドで行う.
+    for(auto i=0u; i<count; ++i)
+    {
+        if (!pCreate(this, &pDescs[i], &states[i]))
+        {
+            for(auto j=0u; j<i; ++j)
+            { SafeRelease(states[j]); }
+            return false;
+        }
+    }
+
+    if (!m_pPipelineCompiler->Push(states.data(), count))
+    {
+        for(auto i=0u; i<count; ++i)
+        { SafeRelease(states[i]); }
+        return false;
+    }
+
+    for(auto i=0u; i<count; ++i)
+    { ppPipelineStates[i] = static_cast<IPipelineState*>(states[i]); }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      グラフィックスパイプラインを非同期で生成します.
+//-------------------------------------------------------------------------------------------------
+bool Device::CreateGraphicsPipelinesAsync
+(
+    uint32_t                            count,
+    const GraphicsPipelineStateDesc*    pDescs,
+    IPipelineState**                    ppPipelineStates
+)
+{ return CreatePipelinesAsync(count, pDescs, &PipelineState::CreateAsGraphicsAsync, ppPipelineStates); }
+
+//-------------------------------------------------------------------------------------------------
+//      コンピュートパイプラインを非同期で生成します.
+//-------------------------------------------------------------------------------------------------
+bool Device::CreateComputePipelinesAsync
+(
+    uint32_t                            count,
+    const ComputePipelineStateDesc*     pDescs,
+    IPipelineState**                    ppPipelineStates
+)
+{ return CreatePipelinesAsync(count, pDescs, &PipelineState::CreateAsComputeAsync, ppPipelineStates); }
+
+//-------------------------------------------------------------------------------------------------
+//      ジオメトリパイプラインを非同期で生成します.
+//-------------------------------------------------------------------------------------------------
+bool Device::CreateGeometryPipelinesAsync
+(
+    uint32_t                            count,
+    const GeometryPipelineStateDesc*    pDescs,
+    IPipelineState**                    ppPipelineStates
+)
+{ return CreatePipelinesAsync(count, pDescs, &PipelineState::CreateAsGeometryAsync, ppPipelineStates); }
+
 //-------------------------------------------------------------------------------------------------
 //      ディスクリプタセットレイアウトを生成します.
 //-------------------------------------------------------------------------------------------------
@@ -1143,7 +1495,98 @@ bool Device::CreateFence(IFence** ppFence)
 //      アイドル状態になるまで待機します.
 //-------------------------------------------------------------------------------------------------
 void Device::WaitIdle()
-{ vkDeviceWaitIdle(m_Device); }
+{
+    uint64_t values[QueueCount] = {};
+    for(auto i=0u; i<QueueCount; ++i)
+    {
+        auto pQueue = GetQueue(i);
+        if (pQueue != nullptr)
+        { values[i] = pQueue->GetSubmitValue(); }
+    }
+
+    if (vkDeviceWaitIdle(m_Device) != VK_SUCCESS)
+    { return; }
+
+    for(auto i=0u; i<QueueCount; ++i)
+    {
+        auto pQueue = GetQueue(i);
+        if (pQueue != nullptr)
+        { pQueue->NotifyCompleted(values[i]); }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パイプラインキャッシュをシリアライズします.
+//-------------------------------------------------------------------------------------------------
+bool Device::GetPipelineCacheBlob(IBlob** ppBlob)
+{
+    if (ppBlob == nullptr || m_PipelineCache == null_handle)
+    { return false; }
+
+    // マージ中のデータが混ざらないようにロックする.
+    std::unique_lock<std::shared_mutex> locker(m_PipelineCacheMutex);
+
+    size_t size = 0;
+    auto ret = vkGetPipelineCacheData(m_Device, m_PipelineCache, &size, nullptr);
+    if (ret != VK_SUCCESS || size == 0)
+    { return false; }
+
+    IBlob* pBlob = nullptr;
+    if (!Blob::Create(size, &pBlob))
+    { return false; }
+
+    ret = vkGetPipelineCacheData(m_Device, m_PipelineCache, &size, pBlob->GetBufferPointer());
+    if (ret != VK_SUCCESS)
+    {
+        SafeRelease(pBlob);
+        return false;
+    }
+
+    *ppBlob = pBlob;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アップロードリングを生成します.
+//-------------------------------------------------------------------------------------------------
+bool Device::CreateUploadRing(const UploadRingDesc* pDesc, IUploadRing** ppUploadRing)
+{ return UploadRing::Create(this, pDesc, ppUploadRing); }
+
+//-------------------------------------------------------------------------------------------------
+//      ヘッドレススワップチェインを生成します.
+//-------------------------------------------------------------------------------------------------
+bool Device::CreateHeadlessSwapChain
+(
+    const SwapChainDesc*    pDesc,
+    IFrameCallback*         pCallback,
+    ISwapChain**            ppSwapChain
+)
+{
+    // フレームを受け取る必要が無ければ, 拡張機能によるサーフェイスで済ませる.
+    if (pCallback == nullptr && m_IsSupportHeadlessSurface)
+    {
+        if (SwapChain::CreateHeadless(this, pDesc, ppSwapChain))
+        { return true; }
+    }
+
+    return HeadlessSwapChain::Create(this, pDesc, pCallback, ppSwapChain);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      読み戻しサービスを生成します.
+//-------------------------------------------------------------------------------------------------
+bool Device::CreateReadbackService
+(
+    const ReadbackServiceDesc*  pDesc,
+    IReadbackService**          ppReadbackService
+)
+{ return ReadbackService::Create(this, pDesc, ppReadbackService); }
+
+//-------------------------------------------------------------------------------------------------
+//      GPUプロファイラーを生成します.
+//-------------------------------------------------------------------------------------------------
+bool Device::CreateGpuProfiler(const GpuProfilerDesc* pDesc, IGpuProfiler** ppProfiler)
+{ return GpuProfiler::Create(this, pDesc, ppProfiler); }
 
 //-------------------------------------------------------------------------------------------------
 //      インスタンスを取得します.
@@ -1191,67 +1634,115 @@ VkPhysicalDeviceProperties Device::GetVulkanPhysicalDeviceProperties(uint32_t in
 }
 
 //-------------------------------------------------------------------------------------------------
-//      ディスクリプタプールを生成します.
+//      拡張機能がサポートされているかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-bool Device::CreateVulkanDescriptorPool(uint32_t maxSet, VkDescriptorPool* pPool)
-{
-    VkDescriptorPoolSize poolSize[10] = {};
-    poolSize[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSize[0].descriptorCount = Max(1u, m_Desc.MaxShaderResourceCount);
-
-    poolSize[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-    poolSize[1].descriptorCount = Max(1u, m_Desc.MaxShaderResourceCount);
-
-    poolSize[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-    poolSize[2].descriptorCount = Max(1u, m_Desc.MaxShaderResourceCount);
-
-    poolSize[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSize[3].descriptorCount = Max(1u, m_Desc.MaxShaderResourceCount);
+bool Device::IsSupportExtension(EXTENSION value) const
+{ return m_IsSupportExt[value]; }
 
-    poolSize[4].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-    poolSize[4].descriptorCount = Max(1u, m_Desc.MaxShaderResourceCount);
+//-------------------------------------------------------------------------------------------------
+//      グラフィックスキューで使用できるパイプラインステージを取得します.
+//-------------------------------------------------------------------------------------------------
+VkPipelineStageFlags Device::GetGraphicsPipelineStages() const
+{ return m_GraphicsStages; }
 
-    poolSize[5].type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-    poolSize[5].descriptorCount = Max(1u, m_Desc.MaxShaderResourceCount);
+//-------------------------------------------------------------------------------------------------
+//      ヘッドレスサーフェイスをサポートしているかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool Device::IsSupportHeadlessSurface() const
+{ return m_IsSupportHeadlessSurface; }
 
-    poolSize[6].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-    poolSize[6].descriptorCount = Max(1u, m_Desc.MaxShaderResourceCount);
+//-------------------------------------------------------------------------------------------------
+//      アロケータを取得します.
+//-------------------------------------------------------------------------------------------------
+VmaAllocator Device::GetAllocator() const
+{ return m_Allocator; }
 
-    poolSize[7].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    poolSize[7].descriptorCount = Max(1u, m_Desc.MaxShaderResourceCount);
+//-------------------------------------------------------------------------------------------------
+//      パイプラインキャッシュを取得します.
+//-------------------------------------------------------------------------------------------------
+VkPipelineCache Device::GetVulkanPipelineCache() const
+{ return m_PipelineCache; }
 
-    poolSize[8].type = VK_DESCRIPTOR_TYPE_SAMPLER;
-    poolSize[8].descriptorCount = Max(1u, m_Desc.MaxSamplerCount);
+//-------------------------------------------------------------------------------------------------
+//      パイプラインキャッシュ用ミューテックスを取得します.
+//-------------------------------------------------------------------------------------------------
+std::shared_mutex& Device::GetPipelineCacheMutex()
+{ return m_PipelineCacheMutex; }
 
-    poolSize[9].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSize[9].descriptorCount = Max(1u, m_Desc.MaxSamplerCount);
+//-------------------------------------------------------------------------------------------------
+//      非同期生成したパイプラインステートの生成完了を待機します.
+//-------------------------------------------------------------------------------------------------
+bool Device::WaitPipelineCompile(const PipelineState* pState, uint32_t timeoutMsec)
+{
+    if (m_pPipelineCompiler == nullptr)
+    { return false; }
 
-    VkDescriptorPoolCreateInfo info = {};
-    info.sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    info.pNext          = nullptr;
-    info.flags          = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    info.maxSets        = Max(1u, maxSet);
-    info.poolSizeCount  = 10;
-    info.pPoolSizes     = poolSize;
+    return m_pPipelineCompiler->Wait(pState, timeoutMsec);
+}
 
-    auto ret = vkCreateDescriptorPool(m_Device, &info, nullptr, pPool);
-    if (ret != VK_SUCCESS)
-    { return false; }
+//-------------------------------------------------------------------------------------------------
+//      バインドレスディスクリプタヒープを取得します.
+//-------------------------------------------------------------------------------------------------
+BindlessHeap* Device::GetBindlessHeap() const
+{ return m_pBindlessHeap; }
 
-    return true;
+//-------------------------------------------------------------------------------------------------
+//      キューを取得します.
+//-------------------------------------------------------------------------------------------------
+Queue* Device::GetQueue(uint32_t index) const
+{
+    Queue* pQueues[QueueCount] = { m_pGraphicsQueue, m_pComputeQueue, m_pCopyQueue };
+    return (index < QueueCount) ? pQueues[index] : nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------
-//      拡張機能がサポートされているかどうかチェックします.
+//      ディスクリプタアロケータを取得します.
 //-------------------------------------------------------------------------------------------------
-bool Device::IsSupportExtension(EXTENSION value) const
-{ return m_IsSupportExt[value]; }
+DescriptorAllocator* Device::GetDescriptorAllocator() const
+{ return m_pDescriptorAllocator; }
 
 //-------------------------------------------------------------------------------------------------
-//      アロケータを取得します.
+//      レンダーパスキャッシュを取得します.
 //-------------------------------------------------------------------------------------------------
-VmaAllocator Device::GetAllocator() const
-{ return m_Allocator; }
+RenderPassCache* Device::GetRenderPassCache() const
+{ return m_pRenderPassCache; }
+
+//-------------------------------------------------------------------------------------------------
+//      パイプラインキャッシュデータをデバイスのパイプラインキャッシュにマージします.
+//-------------------------------------------------------------------------------------------------
+bool Device::MergeVulkanPipelineCache(IBlob* pBlob)
+{
+    if (pBlob == nullptr || m_PipelineCache == null_handle)
+    { return false; }
+
+    auto pData = pBlob->GetBufferPointer();
+    auto size  = size_t(pBlob->GetBufferSize());
+
+    if (!IsCompatiblePipelineCache(pData, size, m_pPhysicalDeviceInfos[0].DeviceProperty))
+    { return false; }
+
+    VkPipelineCacheCreateInfo info = {};
+    info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    info.pNext           = nullptr;
+    info.flags           = 0;
+    info.initialDataSize = size;
+    info.pInitialData    = pData;
+
+    VkPipelineCache srcCache = null_handle;
+    auto ret = vkCreatePipelineCache(m_Device, &info, nullptr, &srcCache);
+    if (ret != VK_SUCCESS)
+    { return false; }
+
+    // マージ先は外部同期が必要. パイプライン生成とも排他にする.
+    {
+        std::unique_lock<std::shared_mutex> locker(m_PipelineCacheMutex);
+        ret = vkMergePipelineCaches(m_Device, m_PipelineCache, 1, &srcCache);
+    }
+
+    vkDestroyPipelineCache(m_Device, srcCache, nullptr);
+
+    return ret == VK_SUCCESS;
+}
 
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
@@ -12,6 +12,11 @@ namespace a3d {
 // Forward Declarations.
 //-------------------------------------------------------------------------------------------------
 class Queue;
+class PipelineState;
+class PipelineCompiler;
+class BindlessHeap;
+class DescriptorAllocator;
+class RenderPassCache;
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -43,13 +48,14 @@ public:
         EXT_KHR_PIPELINE_LIBRARY,               // VK_KHR_pipeline_library          (for VK_KHR_ray_tracing).
         EXT_KHR_RAY_TRACING,                    // VK_KHR_ray_tracing
         EXT_NV_MESH_SHADER,                     // VK_NV_mesh_shader
+        EXT_KHR_TIMELINE_SEMAPHORE,             // VK_KHR_timeline_semaphore
         EXT_COUNT,
     };
 
     //=============================================================================================
     // public variables.
     //=============================================================================================
-    /* NOTHING */
+    static const uint32_t       QueueCount = 3;     //!< キュー数です(グラフィックス, コンピュート, コピー).
 
     //=============================================================================================
     // public methods.
@@ -264,6 +270,48 @@ public:
         const GeometryPipelineStateDesc*    pDesc,
         IPipelineState**                    ppPipelineState) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      グラフィックスパイプラインを非同期で生成します.
+    //!
+    //! @param[in]      count               生成数です.
+    //! @param[in]      pDescs              構成設定の配列です.
+    //! @param[out]     ppPipelineStates    パイプラインステートの格納先配列です.
+    //! @retval true    生成要求に成功.
+    //! @retval false   生成要求に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY CreateGraphicsPipelinesAsync(
+        uint32_t                            count,
+        const GraphicsPipelineStateDesc*    pDescs,
+        IPipelineState**                    ppPipelineStates) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンピュートパイプラインを非同期で生成します.
+    //!
+    //! @param[in]      count               生成数です.
+    //! @param[in]      pDescs              構成設定の配列です.
+    //! @param[out]     ppPipelineStates    パイプラインステートの格納先配列です.
+    //! @retval true    生成要求に成功.
+    //! @retval false   生成要求に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY CreateComputePipelinesAsync(
+        uint32_t                            count,
+        const ComputePipelineStateDesc*     pDescs,
+        IPipelineState**                    ppPipelineStates) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ジオメトリパイプラインを非同期で生成します.
+    //!
+    //! @param[in]      count               生成数です.
+    //! @param[in]      pDescs              構成設定の配列です.
+    //! @param[out]     ppPipelineStates    パイプラインステートの格納先配列です.
+    //! @retval true    生成要求に成功.
+    //! @retval false   生成要求に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY CreateGeometryPipelinesAsync(
+        uint32_t                            count,
+        const GeometryPipelineStateDesc*    pDescs,
+        IPipelineState**                    ppPipelineStates) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      ディスクリプタセットレイアウトを生成します.
     //!
@@ -326,6 +374,65 @@ public:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY WaitIdle() override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインキャッシュをシリアライズします.
+    //!
+    //! @param[out]     ppBlob          パイプラインキャッシュデータの格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY GetPipelineCacheBlob(IBlob** ppBlob) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アップロードリングを生成します.
+    //!
+    //! @param[in]      pDesc           構成設定です.
+    //! @param[out]     ppUploadRing    アップロードリングの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY CreateUploadRing(
+        const UploadRingDesc*   pDesc,
+        IUploadRing**           ppUploadRing) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヘッドレススワップチェインを生成します.
+    //!
+    //! @param[in]      pDesc           構成設定です.
+    //! @param[in]      pCallback       フレームを受け取るコールバックです.
+    //! @param[out]     ppSwapChain     スワップチェインの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY CreateHeadlessSwapChain(
+        const SwapChainDesc*    pDesc,
+        IFrameCallback*         pCallback,
+        ISwapChain**            ppSwapChain) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      読み戻しサービスを生成します.
+    //!
+    //! @param[in]      pDesc               構成設定です.
+    //! @param[out]     ppReadbackService   読み戻しサービスの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY CreateReadbackService(
+        const ReadbackServiceDesc*  pDesc,
+        IReadbackService**          ppReadbackService) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      GPUプロファイラーを生成します.
+    //!
+    //! @param[in]      pDesc           構成設定です.
+    //! @param[out]     ppProfiler      GPUプロファイラーの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY CreateGpuProfiler(
+        const GpuProfilerDesc*  pDesc,
+        IGpuProfiler**          ppProfiler) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      インスタンスを取得します.
     //!
@@ -372,23 +479,28 @@ public:
     VkPhysicalDeviceProperties A3D_APIENTRY GetVulkanPhysicalDeviceProperties(uint32_t index) const;
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      ディスクリプタプールを生成します.
+    //! @brief      拡張機能をサポートしているかどうか?
+    //!
+    //! @param[in]      value       拡張機能.
+    //! @retval true    サポート.
+    //! @retval false   非サポート.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY IsSupportExtension(EXTENSION value) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      グラフィックスキューで使用できるパイプラインステージを取得します.
     //!
-    //! @param[in]      maxSet      最大ディスクリプタセット生成数です.
-    //! @param[out]     pPool       ディスクリプタプールの格納先です.
-    //! @retval true    生成に成功.
-    //! @retval false   生成に失敗.
+    //! @return     有効化した機能に対応するパイプラインステージを返却します.
     //---------------------------------------------------------------------------------------------
-    bool A3D_APIENTRY CreateVulkanDescriptorPool(uint32_t maxSet, VkDescriptorPool* pPool);
+    VkPipelineStageFlags A3D_APIENTRY GetGraphicsPipelineStages() const;
 
     //---------------------------------------------------------------------------------------------
-    //! @brief      拡張機能をサポートしているかどうか?
+    //! @brief      VK_EXT_headless_surface をサポートしているかどうか?
     //!
-    //! @param[in]      value       拡張機能.
     //! @retval true    サポート.
     //! @retval false   非サポート.
     //---------------------------------------------------------------------------------------------
-    bool A3D_APIENTRY IsSupportExtension(EXTENSION value) const;
+    bool A3D_APIENTRY IsSupportHeadlessSurface() const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      アロケータを取得します.
@@ -397,6 +509,69 @@ public:
     //---------------------------------------------------------------------------------------------
     VmaAllocator GetAllocator() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインキャッシュを取得します.
+    //!
+    //! @return     パイプラインキャッシュを返却します.
+    //---------------------------------------------------------------------------------------------
+    VkPipelineCache A3D_APIENTRY GetVulkanPipelineCache() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインキャッシュデータをデバイスのパイプラインキャッシュにマージします.
+    //!
+    //! @param[in]      pBlob           マージするパイプラインキャッシュデータです.
+    //! @retval true    マージに成功.
+    //! @retval false   マージに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY MergeVulkanPipelineCache(IBlob* pBlob);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインキャッシュ用ミューテックスを取得します.
+    //!
+    //! @return     パイプラインキャッシュ用ミューテックスを返却します.
+    //! @note       vkCreate*Pipelines() 呼び出し中は共有ロックを保持してください.
+    //---------------------------------------------------------------------------------------------
+    std::shared_mutex& A3D_APIENTRY GetPipelineCacheMutex();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      非同期生成したパイプラインステートの生成完了を待機します.
+    //!
+    //! @param[in]      pState          待機するパイプラインステートです.
+    //! @param[in]      timeoutMsec     タイムアウト時間(ミリ秒)です.
+    //! @retval true    生成処理が完了しました.
+    //! @retval false   タイムアウトしました.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY WaitPipelineCompile(const PipelineState* pState, uint32_t timeoutMsec);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バインドレスディスクリプタヒープを取得します.
+    //!
+    //! @return     バインドレスディスクリプタヒープを返却します. 無効な場合は nullptr を返却します.
+    //---------------------------------------------------------------------------------------------
+    BindlessHeap* A3D_APIENTRY GetBindlessHeap() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キューを取得します.
+    //!
+    //! @param[in]      index       キュー番号です(0:グラフィックス, 1:コンピュート, 2:コピー).
+    //! @return     キューを返却します. 参照カウントは増やしません.
+    //---------------------------------------------------------------------------------------------
+    Queue* A3D_APIENTRY GetQueue(uint32_t index) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ディスクリプタアロケータを取得します.
+    //!
+    //! @return     ディスクリプタアロケータを返却します.
+    //---------------------------------------------------------------------------------------------
+    DescriptorAllocator* A3D_APIENTRY GetDescriptorAllocator() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レンダーパスキャッシュを取得します.
+    //!
+    //! @return     レンダーパスキャッシュを返却します.
+    //---------------------------------------------------------------------------------------------
+    RenderPassCache* A3D_APIENTRY GetRenderPassCache() const;
+
 private:
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // PhysicalDeviceInfo structure
@@ -424,7 +599,15 @@ private:
     Queue*                      m_pCopyQueue;                   //!< コピーキューです.
     uint64_t                    m_TimeStampFrequency;           //!< GPUタイムスタンプの更新頻度(Hz単位)です.
     bool                        m_IsSupportExt[EXT_COUNT];      //!< 拡張機能.
+    VkPipelineStageFlags        m_GraphicsStages;               //!< グラフィックスキューで使用できるパイプラインステージです.
     VmaAllocator                m_Allocator;                    //!< アロケータ.
+    VkPipelineCache             m_PipelineCache;                //!< パイプラインキャッシュです.
+    std::shared_mutex           m_PipelineCacheMutex;           //!< パイプラインキャッシュ用ミューテックスです(生成時は共有, マージ時は排他).
+    PipelineCompiler*           m_pPipelineCompiler;            //!< 非同期パイプラインコンパイラです.
+    BindlessHeap*               m_pBindlessHeap;                //!< バインドレスディスクリプタヒープです.
+    DescriptorAllocator*        m_pDescriptorAllocator;         //!< ディスクリプタアロケータです.
+    RenderPassCache*            m_pRenderPassCache;             //!< レンダーパスキャッシュです.
+    bool                        m_IsSupportHeadlessSurface;     //!< ヘッドレスサーフェイスをサポートするかどうか?
 
     //=============================================================================================
     // private methods.
@@ -454,6 +637,24 @@ private:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Term();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインを非同期で生成します.
+    //!
+    //! @param[in]      count               生成数です.
+    //! @param[in]      pDescs              構成設定です.
+    //! @param[in]      pCreate             非同期生成用のパイプラインステートの生成関数です.
+    //! @param[out]     ppPipelineStates    パイプラインステートの格納先です.
+    //! @retval true    生成要求の登録に成功.
+    //! @retval false   生成要求の登録に失敗.
+    //! @note       失敗した場合は生成途中のパイプラインステートを全て解放し, 格納先には書き込みません.
+    //---------------------------------------------------------------------------------------------
+    template<typename DescType>
+    bool A3D_APIENTRY CreatePipelinesAsync(
+        uint32_t            count,
+        const DescType*     pDescs,
+        bool (A3D_APIENTRY *pCreate)(IDevice*, const DescType*, PipelineState**),
+        IPipelineState**    ppPipelineStates);
+
     Device          (const Device&) = delete;
     void operator = (const Device&) = delete;
 };
@@ -4,6 +4,11 @@
 // Copyright(c) Project Asura. All right reserved.
 //-------------------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include "a3dVulkanFunc.h"
+
 
 namespace a3d {
 
@@ -18,6 +23,7 @@ Fence::Fence()
 : m_RefCount(1)
 , m_pDevice (nullptr)
 , m_Fence   (null_handle)
+, m_Timeline(null_handle)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -49,6 +55,26 @@ bool Fence::Init(IDevice* pDevice)
     if ( ret != VK_SUCCESS )
     { return false; }
 
+    #if defined(VK_KHR_timeline_semaphore)
+    if (m_pDevice->IsSupportExtension(Device::EXT_KHR_TIMELINE_SEMAPHORE))
+    {
+        VkSemaphoreTypeCreateInfoKHR typeInfo = {};
+        typeInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        typeInfo.pNext          = nullptr;
+        typeInfo.semaphoreType  = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        typeInfo.initialValue   = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+        semaphoreInfo.flags = 0;
+
+        ret = vkCreateSemaphore(pNativeDevice, &semaphoreInfo, nullptr, &m_Timeline);
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+    #endif
+
     return true;
 }
 
@@ -66,6 +92,12 @@ void Fence::Term()
     vkDestroyFence( pNativeDevice, m_Fence, nullptr );
     m_Fence = VK_NULL_HANDLE;
 
+    if (m_Timeline != null_handle)
+    {
+        vkDestroySemaphore( pNativeDevice, m_Timeline, nullptr );
+        m_Timeline = null_handle;
+    }
+
     SafeRelease(m_pDevice);
 }
 
@@ -131,12 +163,98 @@ bool Fence::Wait(uint32_t timeoutMsec)
     return ( ret == VK_SUCCESS );
 }
 
+//-------------------------------------------------------------------------------------------------
+//      CPU側からタイムライン値をシグナルします.
+//-------------------------------------------------------------------------------------------------
+bool Fence::Signal(uint64_t value)
+{
+    if (m_Timeline == null_handle)
+    { return false; }
+
+#if defined(VK_KHR_timeline_semaphore)
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != VK_NULL_HANDLE);
+
+    VkSemaphoreSignalInfoKHR info = {};
+    info.sType      = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+    info.pNext      = nullptr;
+    info.semaphore  = m_Timeline;
+    info.value      = value;
+
+    return a3d_vkSignalSemaphore(pNativeDevice, &info) == VK_SUCCESS;
+#else
+    A3D_UNUSED(value);
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      完了済みのタイムライン値を取得します.
+//-------------------------------------------------------------------------------------------------
+uint64_t Fence::GetCompletedValue() const
+{
+    if (m_Timeline == null_handle)
+    { return 0; }
+
+    uint64_t value = 0;
+
+#if defined(VK_KHR_timeline_semaphore)
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != VK_NULL_HANDLE);
+
+    auto ret = a3d_vkGetSemaphoreCounterValue(pNativeDevice, m_Timeline, &value);
+    A3D_ASSERT(ret == VK_SUCCESS);
+    A3D_UNUSED(ret);
+#endif
+
+    return value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      タイムライン値が指定値に達するまで待機します.
+//-------------------------------------------------------------------------------------------------
+bool Fence::Wait(uint64_t value, uint32_t timeoutMsec)
+{
+    if (m_Timeline == null_handle)
+    { return false; }
+
+#if defined(VK_KHR_timeline_semaphore)
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != VK_NULL_HANDLE);
+
+    const uint64_t MilliSecToNanoSec = 1000 * 1000;
+
+    VkSemaphoreWaitInfoKHR info = {};
+    info.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    info.pNext          = nullptr;
+    info.flags          = 0;
+    info.semaphoreCount = 1;
+    info.pSemaphores    = &m_Timeline;
+    info.pValues        = &value;
+
+    // UINT32_MAX は無限待機として扱う.
+    auto timeout = (timeoutMsec == UINT32_MAX) ? UINT64_MAX : timeoutMsec * MilliSecToNanoSec;
+
+    return a3d_vkWaitSemaphores(pNativeDevice, &info, timeout) == VK_SUCCESS;
+#else
+    A3D_UNUSED(value);
+    A3D_UNUSED(timeoutMsec);
+    return false;
+#endif
+}
+
 //-------------------------------------------------------------------------------------------------
 //      フェンスを取得します.
 //-------------------------------------------------------------------------------------------------
 VkFence Fence::GetVulkanFence() const
 { return m_Fence; }
 
+//-------------------------------------------------------------------------------------------------
+//      タイムラインセマフォを取得します.
+//-------------------------------------------------------------------------------------------------
+VkSemaphore Fence::GetVulkanTimelineSemaphore() const
+{ return m_Timeline; }
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
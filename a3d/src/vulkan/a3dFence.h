@@ -79,6 +79,32 @@ public:
     //---------------------------------------------------------------------------------------------
     bool A3D_APIENTRY Wait(uint32_t timeoutMsec) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      CPU側からタイムライン値をシグナルします.
+    //!
+    //! @param[in]      value       設定する値です.
+    //! @retval true    シグナルに成功.
+    //! @retval false   シグナルに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Signal(uint64_t value) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了済みのタイムライン値を取得します.
+    //!
+    //! @return     完了済みのタイムライン値を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint64_t A3D_APIENTRY GetCompletedValue() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      タイムライン値が指定値に達するまで待機します.
+    //!
+    //! @param[in]      value           待機する値です.
+    //! @param[in]      timeoutMsec     タイムアウト時間です(ミリ秒単位).
+    //! @retval true    処理完了です.
+    //! @retval false   処理未完了です.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Wait(uint64_t value, uint32_t timeoutMsec) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      フェンスを取得します.
     //!
@@ -86,6 +112,13 @@ public:
     //---------------------------------------------------------------------------------------------
     VkFence A3D_APIENTRY GetVulkanFence() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      タイムラインセマフォを取得します.
+    //!
+    //! @return     タイムラインセマフォを返却します. 未サポートの場合は null_handle を返却します.
+    //---------------------------------------------------------------------------------------------
+    VkSemaphore A3D_APIENTRY GetVulkanTimelineSemaphore() const;
+
 private:
     //=============================================================================================
     // private variables.
@@ -93,6 +126,7 @@ private:
     std::atomic<uint32_t>   m_RefCount;         //!< 参照カウンタです.
     Device*                 m_pDevice;          //!< デバイスです.
     VkFence                 m_Fence;            //!< フェンスです.
+    VkSemaphore             m_Timeline;         //!< タイムラインセマフォです.
 
     //=============================================================================================
     // private methods.
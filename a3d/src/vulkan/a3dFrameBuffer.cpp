@@ -38,15 +38,23 @@ bool FrameBuffer::Init(IDevice* pDevice, const FrameBufferDesc* pDesc)
     m_pDevice = static_cast<Device*>(pDevice);
     m_pDevice->AddRef();
 
-    auto pNativeDevice = m_pDevice->GetVulkanDevice();
-    A3D_ASSERT(pNativeDevice != null_handle);
-
     memcpy( &m_Desc, pDesc, sizeof(m_Desc) );
 
-    VkAttachmentDescription attachmentDesc[9] = {};
-    VkAttachmentReference   attachmentRefs[9] = {};
-    VkImageView             imageViews    [9] = {};
-    VkAttachmentReference*  pDepthAttachmentRef = nullptr;
+    auto pCache = m_pDevice->GetRenderPassCache();
+    A3D_ASSERT(pCache != nullptr);
+
+    // キーはバイト列で比較されるのでゼロクリアしておく.
+    RenderPassKey  renderPassKey;
+    FrameBufferKey frameBufferKey;
+    memset(&renderPassKey,  0, sizeof(renderPassKey));
+    memset(&frameBufferKey, 0, sizeof(frameBufferKey));
+
+    renderPassKey.ColorCount     = pDesc->ColorCount;
+    renderPassKey.DepthFormat    = VK_FORMAT_UNDEFINED;
+    renderPassKey.LoadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    renderPassKey.StoreOp        = VK_ATTACHMENT_STORE_OP_STORE;
+    renderPassKey.StencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    renderPassKey.StencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
 
     uint32_t attachmentCount = pDesc->ColorCount;
     uint32_t width  = 0;
@@ -59,20 +67,10 @@ bool FrameBuffer::Init(IDevice* pDevice, const FrameBufferDesc* pDesc)
             A3D_ASSERT(pWrapTexture != nullptr);
 
             const auto& desc = pWrapTexture->GetTextureDesc();
-            attachmentDesc[i].format            = ToNativeFormat(desc.Format);
-            attachmentDesc[i].samples           = ToNativeSampleCountFlags(desc.SampleCount);
-            attachmentDesc[i].loadOp            = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[i].storeOp           = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[i].stencilLoadOp     = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[i].stencilStoreOp    = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[i].initialLayout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            attachmentDesc[i].finalLayout       = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            attachmentDesc[i].flags             = 0;
-
-            attachmentRefs[i].attachment    = i;
-            attachmentRefs[i].layout        = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            renderPassKey.ColorFormats[i] = ToNativeFormat(desc.Format);
+            renderPassKey.ColorSamples[i] = ToNativeSampleCountFlags(desc.SampleCount);
 
-            imageViews[i] = pWrapTexture->GetVulkanImageView();
+            frameBufferKey.Attachments[i] = pWrapTexture->GetVulkanImageView();
 
             if (width == 0 && height == 0 && layers == 0)
             {
@@ -91,21 +89,10 @@ bool FrameBuffer::Init(IDevice* pDevice, const FrameBufferDesc* pDesc)
 
             auto idx = pDesc->ColorCount;
             const auto& desc = pWrapTexture->GetTextureDesc();
-            attachmentDesc[idx].format          = ToNativeFormat(desc.Format);
-            attachmentDesc[idx].samples         = ToNativeSampleCountFlags(desc.SampleCount);
-            attachmentDesc[idx].loadOp          = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[idx].storeOp         = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[idx].stencilLoadOp   = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[idx].stencilStoreOp  = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[idx].initialLayout   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-            attachmentDesc[idx].finalLayout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            renderPassKey.DepthFormat  = ToNativeFormat(desc.Format);
+            renderPassKey.DepthSamples = ToNativeSampleCountFlags(desc.SampleCount);
 
-            attachmentRefs[idx].attachment  = idx;
-            attachmentRefs[idx].layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-            imageViews[idx] = pWrapTexture->GetVulkanImageView();
-
-            pDepthAttachmentRef = &attachmentRefs[idx];
+            frameBufferKey.Attachments[idx] = pWrapTexture->GetVulkanImageView();
 
             if (width == 0 && height == 0 && layers == 0)
             {
@@ -116,48 +103,21 @@ bool FrameBuffer::Init(IDevice* pDevice, const FrameBufferDesc* pDesc)
         }
     }
 
-    // レンダーパスを生成します.
-    {
-        VkSubpassDescription subpass = {};
-        subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.flags                   = 0;
-        subpass.inputAttachmentCount    = 0;
-        subpass.colorAttachmentCount    = pDesc->ColorCount;
-        subpass.pColorAttachments       = attachmentRefs;
-        subpass.pResolveAttachments     = nullptr;
-        subpass.pDepthStencilAttachment = pDepthAttachmentRef;
-        subpass.preserveAttachmentCount = 0;
-        subpass.pPreserveAttachments    = nullptr;
-
-        VkRenderPassCreateInfo info = {};
-        info.sType              = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        info.pNext              = nullptr;
-        info.flags              = 0;
-        info.attachmentCount    = attachmentCount;
-        info.pAttachments       = attachmentDesc;
-        info.subpassCount       = 1;
-        info.pSubpasses         = &subpass;
-
-        auto ret = vkCreateRenderPass(pNativeDevice, &info, nullptr, &m_RenderPass);
-        if ( ret != VK_SUCCESS )
-        { return false; }
-    }
+    // レンダーパスを取得します.
+    m_RenderPass = pCache->GetRenderPass(renderPassKey);
+    if (m_RenderPass == null_handle)
+    { return false; }
 
-    // フレームバッファを生成します.
+    // フレームバッファを取得します.
     {
-        VkFramebufferCreateInfo info = {};
-        info.sType              = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        info.pNext              = nullptr;
-        info.flags              = 0;
-        info.renderPass         = m_RenderPass;
-        info.attachmentCount    = attachmentCount;
-        info.pAttachments       = imageViews;
-        info.width              = width;
-        info.height             = height;
-        info.layers             = layers;
-
-        auto ret = vkCreateFramebuffer(pNativeDevice, &info, nullptr, &m_FrameBuffer);
-        if ( ret != VK_SUCCESS )
+        frameBufferKey.RenderPass       = m_RenderPass;
+        frameBufferKey.AttachmentCount  = attachmentCount;
+        frameBufferKey.Width            = width;
+        frameBufferKey.Height           = height;
+        frameBufferKey.Layers           = layers;
+
+        m_FrameBuffer = pCache->GetFrameBuffer(frameBufferKey);
+        if (m_FrameBuffer == null_handle)
         { return false; }
     }
 
@@ -186,20 +146,9 @@ void FrameBuffer::Term()
     if (m_pDevice == nullptr)
     { return; }
 
-    auto pNativeDevice = m_pDevice->GetVulkanDevice();
-    A3D_ASSERT(pNativeDevice != null_handle);
-
-    if ( m_FrameBuffer != null_handle )
-    {
-        vkDestroyFramebuffer( pNativeDevice, m_FrameBuffer, nullptr );
-        m_FrameBuffer = null_handle;
-    }
-
-    if ( m_RenderPass != null_handle )
-    {
-        vkDestroyRenderPass( pNativeDevice, m_RenderPass, nullptr );
-        m_RenderPass = null_handle;
-    }
+    // レンダーパスとフレームバッファはキャッシュが所有しているので破棄しない.
+    m_FrameBuffer = null_handle;
+    m_RenderPass  = null_handle;
 
     SafeRelease( m_pDevice );
     memset(&m_Desc, 0, sizeof(m_Desc));
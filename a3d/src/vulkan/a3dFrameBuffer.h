@@ -130,7 +130,7 @@ private:
     Device*                     m_pDevice;          //!< デバイスです.
     FrameBufferDesc             m_Desc;             //!< 構成設定です.
     VkFramebuffer               m_FrameBuffer;      //!< フレームバッファです.
-    VkRenderPass                m_RenderPass;       //!< レンダーパスです.
+    VkRenderPass                m_RenderPass;       //!< レンダーパスです. デバイスのキャッシュが所有します.
     VkRenderPassBeginInfo       m_BeginInfo;        //!< レンダーパス開始情報です.
 
     //=============================================================================================
@@ -0,0 +1,488 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dGpuProfiler.cpp
+// Desc : GPU Profiler Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace {
+
+//-------------------------------------------------------------------------------------------------
+//      フレーム開始・終了のクエリ番号です.
+//-------------------------------------------------------------------------------------------------
+const uint32_t FrameBeginQuery  = 0;
+const uint32_t FrameEndQuery    = 1;
+const uint32_t ScopeQueryOffset = 2;
+
+//-------------------------------------------------------------------------------------------------
+//      スコープ開始のクエリ番号を求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t ToBeginQuery(uint32_t scopeIndex)
+{ return ScopeQueryOffset + scopeIndex * 2; }
+
+//-------------------------------------------------------------------------------------------------
+//      スコープ終了のクエリ番号を求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t ToEndQuery(uint32_t scopeIndex)
+{ return ScopeQueryOffset + scopeIndex * 2 + 1; }
+
+} // namespace
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuProfiler class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+GpuProfiler::GpuProfiler()
+: m_RefCount        (1)
+, m_pDevice         (nullptr)
+, m_TimestampPeriod (1.0)
+, m_pFrames         (nullptr)
+, m_pTimestamps     (nullptr)
+, m_pStack          (nullptr)
+, m_StackDepth      (0)
+, m_FrameCount      (0)
+, m_IsRecording     (false)
+, m_pResolvedScopes (nullptr)
+, m_HasResolved     (false)
+{
+    memset(&m_Desc, 0, sizeof(m_Desc));
+    memset(&m_ResolvedFrame, 0, sizeof(m_ResolvedFrame));
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+GpuProfiler::~GpuProfiler()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::Init(IDevice* pDevice, const GpuProfilerDesc* pDesc)
+{
+    if (pDevice == nullptr || pDesc == nullptr)
+    { return false; }
+
+    if (pDesc->MaxScopeCount == 0)
+    { return false; }
+
+    m_pDevice = static_cast<Device*>(pDevice);
+    m_pDevice->AddRef();
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    // グラフィックスキューとコンピュートキューでタイムスタンプが使えることを前提とする.
+    auto props = m_pDevice->GetVulkanPhysicalDeviceProperties(0);
+    if (!props.limits.timestampComputeAndGraphics)
+    { return false; }
+
+    m_TimestampPeriod = double(props.limits.timestampPeriod);
+
+    memcpy(&m_Desc, pDesc, sizeof(m_Desc));
+    if (m_Desc.FrameLatency == 0)
+    { m_Desc.FrameLatency = Queue::DefaultFrameCount + 1; }
+
+    auto queryCount = ScopeQueryOffset + m_Desc.MaxScopeCount * 2;
+
+    m_pFrames = new (std::nothrow) Frame [m_Desc.FrameLatency];
+    if (m_pFrames == nullptr)
+    { return false; }
+
+    for(auto i=0u; i<m_Desc.FrameLatency; ++i)
+    {
+        m_pFrames[i].QueryPool  = null_handle;
+        m_pFrames[i].pScopes    = nullptr;
+        m_pFrames[i].ScopeCount = 0;
+        m_pFrames[i].FrameIndex = 0;
+        m_pFrames[i].IsPending  = false;
+    }
+
+    for(auto i=0u; i<m_Desc.FrameLatency; ++i)
+    {
+        auto& frame = m_pFrames[i];
+
+        VkQueryPoolCreateInfo info = {};
+        info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        info.pNext      = nullptr;
+        info.flags      = 0;
+        info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+        info.queryCount = queryCount;
+
+        auto ret = vkCreateQueryPool( pNativeDevice, &info, nullptr, &frame.QueryPool );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+
+        frame.pScopes = new (std::nothrow) Scope [m_Desc.MaxScopeCount];
+        if (frame.pScopes == nullptr)
+        { return false; }
+    }
+
+    m_pTimestamps = new (std::nothrow) uint64_t [queryCount];
+    if (m_pTimestamps == nullptr)
+    { return false; }
+
+    m_pStack = new (std::nothrow) uint32_t [m_Desc.MaxScopeCount];
+    if (m_pStack == nullptr)
+    { return false; }
+
+    m_pResolvedScopes = new (std::nothrow) Scope [m_Desc.MaxScopeCount];
+    if (m_pResolvedScopes == nullptr)
+    { return false; }
+
+    m_StackDepth  = 0;
+    m_FrameCount  = 0;
+    m_IsRecording = false;
+    m_HasResolved = false;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::Term()
+{
+    if (m_pDevice == nullptr)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    if (m_pFrames != nullptr)
+    {
+        for(auto i=0u; i<m_Desc.FrameLatency; ++i)
+        {
+            if (m_pFrames[i].QueryPool != null_handle)
+            {
+                vkDestroyQueryPool(pNativeDevice, m_pFrames[i].QueryPool, nullptr);
+                m_pFrames[i].QueryPool = null_handle;
+            }
+
+            if (m_pFrames[i].pScopes != nullptr)
+            {
+                delete [] m_pFrames[i].pScopes;
+                m_pFrames[i].pScopes = nullptr;
+            }
+        }
+
+        delete [] m_pFrames;
+        m_pFrames = nullptr;
+    }
+
+    if (m_pTimestamps != nullptr)
+    {
+        delete [] m_pTimestamps;
+        m_pTimestamps = nullptr;
+    }
+
+    if (m_pStack != nullptr)
+    {
+        delete [] m_pStack;
+        m_pStack = nullptr;
+    }
+
+    if (m_pResolvedScopes != nullptr)
+    {
+        delete [] m_pResolvedScopes;
+        m_pResolvedScopes = nullptr;
+    }
+
+    m_StackDepth  = 0;
+    m_IsRecording = false;
+    m_HasResolved = false;
+
+    SafeRelease(m_pDevice);
+    memset( &m_Desc, 0, sizeof(m_Desc) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      参照カウントを増やします.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::AddRef()
+{ m_RefCount++; }
+
+//-------------------------------------------------------------------------------------------------
+//      解放処理を行います.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::Release()
+{
+    m_RefCount--;
+    if (m_RefCount == 0)
+    { delete this; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      参照カウントを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t GpuProfiler::GetCount() const
+{ return m_RefCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      デバイスを取得します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::GetDevice(IDevice** ppDevice)
+{
+    *ppDevice = m_pDevice;
+    if (m_pDevice != nullptr)
+    { m_pDevice->AddRef(); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      構成設定を取得します.
+//-------------------------------------------------------------------------------------------------
+GpuProfilerDesc GpuProfiler::GetDesc() const
+{ return m_Desc; }
+
+//-------------------------------------------------------------------------------------------------
+//      フレームの計測を開始します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::BeginFrame(ICommandList* pCommandList)
+{
+    if (pCommandList == nullptr || m_IsRecording)
+    { return; }
+
+    auto pWrapCommandList = static_cast<CommandList*>(pCommandList);
+    A3D_ASSERT(pWrapCommandList != nullptr);
+
+    auto& frame = m_pFrames[m_FrameCount % m_Desc.FrameLatency];
+
+    // FrameLatency フレーム前の結果を回収する. 揃っていなければ待たずに捨てる.
+    if (frame.IsPending)
+    {
+        Resolve(frame);
+        frame.IsPending = false;
+    }
+
+    // 保留中のバリアはリセットより前に記録されたコマンドに対するものなので先に発行する.
+    pWrapCommandList->FlushBarrier();
+
+    vkCmdResetQueryPool(
+        pWrapCommandList->GetVulkanCommandBuffer(),
+        frame.QueryPool,
+        0,
+        ScopeQueryOffset + m_Desc.MaxScopeCount * 2);
+
+    frame.ScopeCount = 0;
+    frame.FrameIndex = m_FrameCount;
+
+    m_StackDepth  = 0;
+    m_IsRecording = true;
+
+    WriteTimestamp(pCommandList, FrameBeginQuery);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームの計測を終了します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::EndFrame(ICommandList* pCommandList)
+{
+    if (pCommandList == nullptr || !m_IsRecording)
+    { return; }
+
+    // 閉じられていないスコープの終了値が無いと結果が揃わないため，ここで閉じる.
+    while (m_StackDepth > 0)
+    {
+        m_StackDepth--;
+        if (m_StackDepth < m_Desc.MaxScopeCount && m_pStack[m_StackDepth] != InvalidIndex)
+        { WriteTimestamp(pCommandList, ToEndQuery(m_pStack[m_StackDepth])); }
+    }
+
+    WriteTimestamp(pCommandList, FrameEndQuery);
+
+    m_pFrames[m_FrameCount % m_Desc.FrameLatency].IsPending = true;
+
+    m_IsRecording = false;
+    m_FrameCount++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デバッグマーカーをプッシュし，スコープの計測を開始します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::PushMarker(ICommandList* pCommandList, const char* tag)
+{
+    if (pCommandList == nullptr)
+    { return; }
+
+    pCommandList->PushMarker(tag);
+
+    if (!m_IsRecording)
+    { return; }
+
+    auto& frame = m_pFrames[m_FrameCount % m_Desc.FrameLatency];
+
+    auto index = InvalidIndex;
+    if (frame.ScopeCount < m_Desc.MaxScopeCount)
+    {
+        index = frame.ScopeCount;
+        frame.ScopeCount++;
+
+        auto& scope = frame.pScopes[index];
+        scope.Depth       = m_StackDepth;
+        scope.ElapsedMsec = 0.0;
+
+        // タグは呼び出し側の寿命に依存しないよう複製しておく.
+        auto length = (tag != nullptr) ? strlen(tag) : 0;
+        if (length >= MaxTagLength)
+        { length = MaxTagLength - 1; }
+
+        if (length > 0)
+        { memcpy(scope.Tag, tag, length); }
+        scope.Tag[length] = '\0';
+
+        WriteTimestamp(pCommandList, ToBeginQuery(index));
+    }
+
+    if (m_StackDepth < m_Desc.MaxScopeCount)
+    { m_pStack[m_StackDepth] = index; }
+
+    m_StackDepth++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デバッグマーカーをポップし，スコープの計測を終了します.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::PopMarker(ICommandList* pCommandList)
+{
+    if (pCommandList == nullptr)
+    { return; }
+
+    if (m_IsRecording && m_StackDepth > 0)
+    {
+        m_StackDepth--;
+        if (m_StackDepth < m_Desc.MaxScopeCount && m_pStack[m_StackDepth] != InvalidIndex)
+        { WriteTimestamp(pCommandList, ToEndQuery(m_pStack[m_StackDepth])); }
+    }
+
+    pCommandList->PopMarker();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最後に回収したフレームの計測結果を取得します.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::GetFrame(GpuProfileFrame* pFrame) const
+{
+    if (pFrame == nullptr || !m_HasResolved)
+    { return false; }
+
+    *pFrame = m_ResolvedFrame;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最後に回収したフレームのスコープ計測結果を取得します.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::GetScope(uint32_t index, GpuProfileScope* pScope) const
+{
+    if (pScope == nullptr || !m_HasResolved || index >= m_ResolvedFrame.ScopeCount)
+    { return false; }
+
+    const auto& scope = m_pResolvedScopes[index];
+    pScope->Tag         = scope.Tag;
+    pScope->Depth       = scope.Depth;
+    pScope->ElapsedMsec = scope.ElapsedMsec;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームの計測結果を待機せずに回収します.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::Resolve(Frame& frame)
+{
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    auto queryCount = ScopeQueryOffset + frame.ScopeCount * 2;
+
+    // WAIT を指定しないので，GPUが処理中であれば VK_NOT_READY が返りストールしない.
+    auto ret = vkGetQueryPoolResults(
+        pNativeDevice,
+        frame.QueryPool,
+        0,
+        queryCount,
+        sizeof(uint64_t) * queryCount,
+        m_pTimestamps,
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+    if (ret != VK_SUCCESS)
+    { return false; }
+
+    auto toMsec = [&](uint32_t begin, uint32_t end)
+    {
+        auto ticks = (m_pTimestamps[end] > m_pTimestamps[begin])
+            ? m_pTimestamps[end] - m_pTimestamps[begin]
+            : 0;
+        return double(ticks) * m_TimestampPeriod / (1000.0 * 1000.0);
+    };
+
+    for(auto i=0u; i<frame.ScopeCount; ++i)
+    {
+        auto& dst = m_pResolvedScopes[i];
+        memcpy(&dst, &frame.pScopes[i], sizeof(dst));
+        dst.ElapsedMsec = toMsec(ToBeginQuery(i), ToEndQuery(i));
+    }
+
+    m_ResolvedFrame.FrameIndex  = frame.FrameIndex;
+    m_ResolvedFrame.ElapsedMsec = toMsec(FrameBeginQuery, FrameEndQuery);
+    m_ResolvedFrame.ScopeCount  = frame.ScopeCount;
+    m_HasResolved = true;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      タイムスタンプを書き込みます.
+//-------------------------------------------------------------------------------------------------
+void GpuProfiler::WriteTimestamp(ICommandList* pCommandList, uint32_t index)
+{
+    auto pWrapCommandList = static_cast<CommandList*>(pCommandList);
+    A3D_ASSERT(pWrapCommandList != nullptr);
+
+    auto& frame = m_pFrames[m_FrameCount % m_Desc.FrameLatency];
+
+    // 保留中のバリアを先に発行しておかないと, バリア待ちの時間が計測範囲からずれる.
+    pWrapCommandList->FlushBarrier();
+
+    // 先行するコマンドが全て完了した時点の値を書き込む.
+    vkCmdWriteTimestamp(
+        pWrapCommandList->GetVulkanCommandBuffer(),
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        frame.QueryPool,
+        index);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      生成処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool GpuProfiler::Create
+(
+    IDevice*                pDevice,
+    const GpuProfilerDesc*  pDesc,
+    IGpuProfiler**          ppProfiler
+)
+{
+    if (pDevice == nullptr || pDesc == nullptr || ppProfiler == nullptr)
+    { return false; }
+
+    auto instance = new GpuProfiler();
+    if (instance == nullptr)
+    { return false; }
+
+    if (!instance->Init(pDevice, pDesc))
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
+    *ppProfiler = instance;
+    return true;
+}
+
+} // namespace a3d
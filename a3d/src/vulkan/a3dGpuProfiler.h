@@ -0,0 +1,215 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dGpuProfiler.h
+// Desc : GPU Profiler Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuProfiler class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class A3D_API GpuProfiler : public IGpuProfiler, public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static const uint32_t   MaxTagLength    = 64;           //!< マーカー名の最大長です.
+    static const uint32_t   InvalidIndex    = UINT32_MAX;   //!< 無効なスコープ番号です.
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      生成処理を行います.
+    //!
+    //! @param[in]      pDevice         デバイスです.
+    //! @param[in]      pDesc           構成設定です.
+    //! @param[out]     ppProfiler      GPUプロファイラーの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY Create(
+        IDevice*                pDevice,
+        const GpuProfilerDesc*  pDesc,
+        IGpuProfiler**          ppProfiler);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      参照カウントを増やします.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY AddRef() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      解放処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Release() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      参照カウントを取得します.
+    //!
+    //! @return     参照カウントを返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetCount() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスを取得します.
+    //!
+    //! @param[out]     ppDevice        デバイスの格納先です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY GetDevice(IDevice** ppDevice) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //!
+    //! @return     構成設定を返却します.
+    //---------------------------------------------------------------------------------------------
+    GpuProfilerDesc A3D_APIENTRY GetDesc() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの計測を開始します.
+    //!
+    //! @param[in]      pCommandList    計測するコマンドリストです.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY BeginFrame(ICommandList* pCommandList) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの計測を終了します.
+    //!
+    //! @param[in]      pCommandList    計測するコマンドリストです.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY EndFrame(ICommandList* pCommandList) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバッグマーカーをプッシュし，スコープの計測を開始します.
+    //!
+    //! @param[in]      pCommandList    計測するコマンドリストです.
+    //! @param[in]      tag             マーカー名です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PushMarker(ICommandList* pCommandList, const char* tag) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバッグマーカーをポップし，スコープの計測を終了します.
+    //!
+    //! @param[in]      pCommandList    計測するコマンドリストです.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PopMarker(ICommandList* pCommandList) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最後に回収したフレームの計測結果を取得します.
+    //!
+    //! @param[out]     pFrame          計測結果の格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   回収済みのフレームがありません.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY GetFrame(GpuProfileFrame* pFrame) const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最後に回収したフレームのスコープ計測結果を取得します.
+    //!
+    //! @param[in]      index           スコープ番号です.
+    //! @param[out]     pScope          計測結果の格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   スコープ番号が範囲外です.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY GetScope(uint32_t index, GpuProfileScope* pScope) const override;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Scope structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Scope
+    {
+        char                Tag[MaxTagLength];  //!< マーカー名です.
+        uint32_t            Depth;              //!< 入れ子の深さです.
+        double              ElapsedMsec;        //!< GPU時間です(ミリ秒単位).
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Frame structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        VkQueryPool         QueryPool;          //!< タイムスタンプクエリプールです.
+        Scope*              pScopes;            //!< 計測中のスコープです.
+        uint32_t            ScopeCount;         //!< 計測中のスコープ数です.
+        uint64_t            FrameIndex;         //!< フレーム番号です.
+        bool                IsPending;          //!< 結果を回収していないかどうか?
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::atomic<uint32_t>   m_RefCount;         //!< 参照カウンタです.
+    Device*                 m_pDevice;          //!< デバイスです.
+    GpuProfilerDesc         m_Desc;             //!< 構成設定です.
+    double                  m_TimestampPeriod;  //!< 1カウントあたりの時間です(ナノ秒単位).
+    Frame*                  m_pFrames;          //!< フレームです.
+    uint64_t*               m_pTimestamps;      //!< 回収したタイムスタンプの一時領域です.
+    uint32_t*               m_pStack;           //!< 計測中のスコープ番号のスタックです.
+    uint32_t                m_StackDepth;       //!< スタックの深さです.
+    uint64_t                m_FrameCount;       //!< 計測を開始したフレーム数です.
+    bool                    m_IsRecording;      //!< フレームを計測中かどうか?
+    Scope*                  m_pResolvedScopes;  //!< 回収済みのスコープです.
+    GpuProfileFrame         m_ResolvedFrame;    //!< 回収済みのフレームです.
+    bool                    m_HasResolved;      //!< 回収済みのフレームがあるかどうか?
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    A3D_APIENTRY GpuProfiler();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    A3D_APIENTRY ~GpuProfiler();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDevice     デバイスです.
+    //! @param[in]      pDesc       構成設定です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Init(IDevice* pDevice, const GpuProfilerDesc* pDesc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームの計測結果を待機せずに回収します.
+    //!
+    //! @param[in]      frame       回収するフレームです.
+    //! @retval true    回収に成功.
+    //! @retval false   結果が揃っていません.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Resolve(Frame& frame);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      タイムスタンプを書き込みます.
+    //!
+    //! @param[in]      pCommandList    書き込むコマンドリストです.
+    //! @param[in]      index           クエリ番号です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY WriteTimestamp(ICommandList* pCommandList, uint32_t index);
+
+    GpuProfiler     (const GpuProfiler&) = delete;
+    void operator = (const GpuProfiler&) = delete;
+};
+
+} // namespace a3d
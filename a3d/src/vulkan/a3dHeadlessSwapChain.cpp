@@ -0,0 +1,668 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dHeadlessSwapChain.cpp
+// Desc : Headless SwapChain Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// HeadlessSwapChain class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+HeadlessSwapChain::HeadlessSwapChain()
+: m_RefCount            (1)
+, m_pDevice             (nullptr)
+, m_pQueue              (nullptr)
+, m_pCallback           (nullptr)
+, m_CommandPool         (null_handle)
+, m_pFrames             (nullptr)
+, m_RowPitch            (0)
+, m_CurrentBufferIndex  (0)
+, m_IsAcquired          (false)
+, m_PendingHead         (0)
+, m_PendingCount        (0)
+, m_FrameIndex          (0)
+{ memset( &m_Desc, 0, sizeof(m_Desc) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+HeadlessSwapChain::~HeadlessSwapChain()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::Init(IDevice* pDevice, const SwapChainDesc* pDesc, IFrameCallback* pCallback)
+{
+    if (pDevice == nullptr || pDesc == nullptr)
+    { return false; }
+
+    if (pDesc->BufferCount == 0 || pDesc->Extent.Width == 0 || pDesc->Extent.Height == 0)
+    { return false; }
+
+    m_pDevice = static_cast<Device*>(pDevice);
+    m_pDevice->AddRef();
+
+    m_pDevice->GetGraphicsQueue(reinterpret_cast<IQueue**>(&m_pQueue));
+
+    memcpy( &m_Desc, pDesc, sizeof(m_Desc) );
+
+    // 表示先のウィンドウが無いので，ウィンドウ関連の設定は無視する.
+    // また，読み戻すのは先頭ミップのみなので単一ミップ・単一サンプルに揃える.
+    m_Desc.MipLevels        = 1;
+    m_Desc.SampleCount      = 1;
+    m_Desc.InstanceHandle   = nullptr;
+    m_Desc.WindowHandle     = nullptr;
+    m_Desc.EnableFullScreen = false;
+
+    // 処理中のフレームがバックバッファを使い切らないよう，バッファ数を上限とする.
+    if (m_Desc.MaxFrameLatency == 0)
+    { m_Desc.MaxFrameLatency = Queue::DefaultFrameCount; }
+    if (m_Desc.MaxFrameLatency > m_Desc.BufferCount)
+    { m_Desc.MaxFrameLatency = m_Desc.BufferCount; }
+
+    m_pCallback = pCallback;
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    // コマンドプールを生成.
+    {
+        VkCommandPoolCreateInfo info = {};
+        info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        info.pNext            = nullptr;
+        info.queueFamilyIndex = m_pQueue->GetFamilyIndex();
+        info.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        auto ret = vkCreateCommandPool( pNativeDevice, &info, nullptr, &m_CommandPool );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    m_pFrames = new (std::nothrow) Frame [m_Desc.BufferCount];
+    if (m_pFrames == nullptr)
+    { return false; }
+
+    for(auto i=0u; i<m_Desc.BufferCount; ++i)
+    {
+        auto& frame = m_pFrames[i];
+        frame.pTexture      = nullptr;
+        frame.Buffer        = null_handle;
+        frame.Allocation    = nullptr;
+        frame.pPixels       = nullptr;
+        frame.CommandBuffer = null_handle;
+        frame.Fence         = null_handle;
+        frame.FrameIndex    = 0;
+        frame.SubmitValue   = 0;
+    }
+
+    // コマンドバッファとフェンスを生成.
+    for(auto i=0u; i<m_Desc.BufferCount; ++i)
+    {
+        auto& frame = m_pFrames[i];
+
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.pNext              = nullptr;
+        allocInfo.commandPool        = m_CommandPool;
+        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        auto ret = vkAllocateCommandBuffers( pNativeDevice, &allocInfo, &frame.CommandBuffer );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceInfo.pNext = nullptr;
+        fenceInfo.flags = 0;
+
+        ret = vkCreateFence( pNativeDevice, &fenceInfo, nullptr, &frame.Fence );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    if (!InitBuffers())
+    { return false; }
+
+    m_CurrentBufferIndex = 0;
+    m_IsAcquired         = false;
+    m_PendingHead        = 0;
+    m_PendingCount       = 0;
+    m_FrameIndex         = 0;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void HeadlessSwapChain::Term()
+{
+    if (m_pDevice == nullptr)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    // 処理中のフレームは完了を待ってから引き渡しておく.
+    while (m_PendingCount > 0)
+    {
+        if (!RetireFrame(UINT64_MAX))
+        {
+            m_pQueue->WaitIdle();
+            break;
+        }
+    }
+
+    TermBuffers();
+
+    if (m_pFrames != nullptr)
+    {
+        for(auto i=0u; i<m_Desc.BufferCount; ++i)
+        {
+            if (m_pFrames[i].Fence != null_handle)
+            {
+                vkDestroyFence(pNativeDevice, m_pFrames[i].Fence, nullptr);
+                m_pFrames[i].Fence = null_handle;
+            }
+
+            if (m_pFrames[i].CommandBuffer != null_handle)
+            {
+                vkFreeCommandBuffers(pNativeDevice, m_CommandPool, 1, &m_pFrames[i].CommandBuffer);
+                m_pFrames[i].CommandBuffer = null_handle;
+            }
+        }
+
+        delete [] m_pFrames;
+        m_pFrames = nullptr;
+    }
+
+    if (m_CommandPool != null_handle)
+    {
+        vkDestroyCommandPool(pNativeDevice, m_CommandPool, nullptr);
+        m_CommandPool = null_handle;
+    }
+
+    m_pCallback    = nullptr;
+    m_PendingHead  = 0;
+    m_PendingCount = 0;
+
+    SafeRelease( m_pQueue );
+    SafeRelease( m_pDevice );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      イメージと読み戻し用バッファを生成します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::InitBuffers()
+{
+    m_RowPitch = m_Desc.Extent.Width * ToByte(m_Desc.Format);
+    if (m_RowPitch == 0)
+    { return false; }
+
+    for(auto i=0u; i<m_Desc.BufferCount; ++i)
+    {
+        auto& frame = m_pFrames[i];
+
+        // 通常のスワップチェインと同様に，表示状態で引き渡す.
+        TextureDesc desc = {};
+        desc.Dimension          = RESOURCE_DIMENSION_TEXTURE2D;
+        desc.Width              = m_Desc.Extent.Width;
+        desc.Height             = m_Desc.Extent.Height;
+        desc.DepthOrArraySize   = 1;
+        desc.Format             = m_Desc.Format;
+        desc.MipLevels          = 1;
+        desc.SampleCount        = 1;
+        desc.Layout             = RESOURCE_LAYOUT_OPTIMAL;
+        desc.Usage              = RESOURCE_USAGE_COLOR_TARGET | RESOURCE_USAGE_COPY_SRC;
+        desc.InitState          = RESOURCE_STATE_PRESENT;
+        desc.HeapType           = HEAP_TYPE_DEFAULT;
+
+        if (!m_pDevice->CreateTexture(&desc, &frame.pTexture))
+        { return false; }
+
+        // コールバックが無ければ読み戻す必要が無い.
+        if (m_pCallback == nullptr)
+        { continue; }
+
+        VkBufferCreateInfo info = {};
+        info.sType                  = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        info.pNext                  = nullptr;
+        info.flags                  = 0;
+        info.pQueueFamilyIndices    = nullptr;
+        info.queueFamilyIndexCount  = 0;
+        info.sharingMode            = VK_SHARING_MODE_EXCLUSIVE;
+        info.size                   = VkDeviceSize(m_RowPitch) * m_Desc.Extent.Height;
+        info.usage                  = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+        // フレームごとにマップしなくて済むよう，破棄するまでマップしたままにする.
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo result = {};
+        auto ret = vmaCreateBuffer(m_pDevice->GetAllocator(), &info, &allocInfo, &frame.Buffer, &frame.Allocation, &result);
+        if ( ret != VK_SUCCESS )
+        { return false; }
+
+        frame.pPixels = result.pMappedData;
+        if (frame.pPixels == nullptr)
+        { return false; }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      イメージと読み戻し用バッファを破棄します.
+//-------------------------------------------------------------------------------------------------
+void HeadlessSwapChain::TermBuffers()
+{
+    if (m_pFrames == nullptr)
+    { return; }
+
+    for(auto i=0u; i<m_Desc.BufferCount; ++i)
+    {
+        auto& frame = m_pFrames[i];
+
+        SafeRelease(frame.pTexture);
+
+        if (frame.Buffer != null_handle)
+        {
+            vmaDestroyBuffer(m_pDevice->GetAllocator(), frame.Buffer, frame.Allocation);
+            frame.Buffer     = null_handle;
+            frame.Allocation = nullptr;
+        }
+
+        frame.pPixels = nullptr;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      参照カウントを増やします.
+//-------------------------------------------------------------------------------------------------
+void HeadlessSwapChain::AddRef()
+{ m_RefCount++; }
+
+//-------------------------------------------------------------------------------------------------
+//      解放処理を行います.
+//-------------------------------------------------------------------------------------------------
+void HeadlessSwapChain::Release()
+{
+    m_RefCount--;
+    if (m_RefCount == 0)
+    { delete this; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      参照カウントを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t HeadlessSwapChain::GetCount() const
+{ return m_RefCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      デバイスを取得します.
+//-------------------------------------------------------------------------------------------------
+void HeadlessSwapChain::GetDevice(IDevice** ppDevice)
+{
+    *ppDevice = m_pDevice;
+    if (m_pDevice != nullptr)
+    { m_pDevice->AddRef(); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      構成設定を取得します.
+//-------------------------------------------------------------------------------------------------
+SwapChainDesc HeadlessSwapChain::GetDesc() const
+{ return m_Desc; }
+
+//-------------------------------------------------------------------------------------------------
+//      画面に表示します.
+//-------------------------------------------------------------------------------------------------
+void HeadlessSwapChain::Present()
+{
+    // 一度も取得していない場合は表示できるイメージが無い.
+    if (!AcquireNextImage(UINT64_MAX))
+    { return; }
+
+    auto& frame = m_pFrames[m_CurrentBufferIndex];
+
+    VkSubmitInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    info.pNext = nullptr;
+
+    if (m_pCallback != nullptr)
+    {
+        auto cmdBuffer = frame.CommandBuffer;
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        auto ret = vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+        if (ret != VK_SUCCESS)
+        { return; }
+
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.pNext               = nullptr;
+        barrier.srcAccessMask       = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        barrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image               = static_cast<Texture*>(frame.pTexture)->GetVulkanImage();
+
+        barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.layerCount     = 1;
+        barrier.subresourceRange.levelCount     = 1;
+
+        // 描画がどのステージで終わっているか分からないので，全ステージの完了を待つ.
+        vkCmdPipelineBarrier(
+            cmdBuffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier );
+
+        VkBufferImageCopy region = {};
+        region.bufferOffset                     = 0;
+        region.bufferRowLength                  = 0;
+        region.bufferImageHeight                = 0;
+        region.imageSubresource.aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel        = 0;
+        region.imageSubresource.baseArrayLayer  = 0;
+        region.imageSubresource.layerCount      = 1;
+        region.imageOffset                      = { 0, 0, 0 };
+        region.imageExtent                      = { m_Desc.Extent.Width, m_Desc.Extent.Height, 1 };
+
+        vkCmdCopyImageToBuffer(
+            cmdBuffer,
+            barrier.image,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            frame.Buffer,
+            1, &region );
+
+        // 次に描画する前に表示状態へ戻しておく.
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout     = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        // コピー結果をCPUから読めるようにする.
+        VkBufferMemoryBarrier hostBarrier = {};
+        hostBarrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        hostBarrier.pNext               = nullptr;
+        hostBarrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask       = VK_ACCESS_HOST_READ_BIT;
+        hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.buffer              = frame.Buffer;
+        hostBarrier.offset              = 0;
+        hostBarrier.size                = VK_WHOLE_SIZE;
+
+        vkCmdPipelineBarrier(
+            cmdBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+            0, 0, nullptr, 1, &hostBarrier, 1, &barrier );
+
+        ret = vkEndCommandBuffer(cmdBuffer);
+        if (ret != VK_SUCCESS)
+        { return; }
+
+        info.commandBufferCount = 1;
+        info.pCommandBuffers    = &frame.CommandBuffer;
+    }
+
+    // 読み戻さない場合も，処理中のフレーム数を制限するためにフェンスだけはシグナルさせる.
+    // フェンスは先行する全てのサブミットの完了後にシグナルされるので，その時点の通し番号を控えておく.
+    auto submitCount = (m_pCallback != nullptr) ? 1u : 0u;
+    frame.SubmitValue = m_pQueue->GetSubmitValue();
+    auto ret = vkQueueSubmit(m_pQueue->GetVulkanQueue(), submitCount, &info, frame.Fence);
+    if (ret != VK_SUCCESS)
+    { return; }
+
+    frame.FrameIndex = m_FrameIndex++;
+
+    if (m_PendingCount == 0)
+    { m_PendingHead = m_CurrentBufferIndex; }
+    m_PendingCount++;
+
+    // 次のバッファの取得は WaitForFrameSlot() または GetCurrentBufferIndex() まで遅延させる.
+    m_CurrentBufferIndex = (m_CurrentBufferIndex + 1) % m_Desc.BufferCount;
+    m_IsAcquired = false;
+
+    // 既に完了しているフレームだけを待たずに引き渡す.
+    while (m_PendingCount > 0)
+    {
+        if (!RetireFrame(0))
+        { break; }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      現在のバッファ番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t HeadlessSwapChain::GetCurrentBufferIndex()
+{
+    AcquireNextImage(UINT64_MAX);
+    return m_CurrentBufferIndex;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッファを取得します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::GetBuffer(uint32_t index, ITexture** ppResource)
+{
+    if (index >= m_Desc.BufferCount)
+    { return false; }
+
+    *ppResource = m_pFrames[index].pTexture;
+    if (m_pFrames[index].pTexture != nullptr)
+    {
+        m_pFrames[index].pTexture->AddRef();
+        return true;
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッファをリサイズします.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::ResizeBuffers(uint32_t width, uint32_t height)
+{
+    if (width == 0 || height == 0)
+    { return false; }
+
+    m_pQueue->WaitIdle();
+
+    // 古いサイズのフレームは破棄する前に全て引き渡しておく.
+    while (m_PendingCount > 0)
+    {
+        if (!RetireFrame(UINT64_MAX))
+        { return false; }
+    }
+
+    TermBuffers();
+
+    m_Desc.Extent.Width  = width;
+    m_Desc.Extent.Height = height;
+
+    if (!InitBuffers())
+    { return false; }
+
+    m_CurrentBufferIndex = 0;
+    m_IsAcquired         = false;
+    m_PendingHead        = 0;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メタデータを設定します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::SetMetaData(META_DATA_TYPE type, void* pData)
+{
+    // 表示先が無いので非サポートです.
+    A3D_UNUSED(type);
+    A3D_UNUSED(pData);
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      色空間がサポートされているかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::CheckColorSpaceSupport(COLOR_SPACE_TYPE type)
+{ return type == COLOR_SPACE_SRGB; }
+
+//-------------------------------------------------------------------------------------------------
+//      色空間を設定します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::SetColorSpace(COLOR_SPACE_TYPE type)
+{ return CheckColorSpaceSupport(type); }
+
+//-------------------------------------------------------------------------------------------------
+//      フルスクリーンモードかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::IsFullScreenMode() const
+{ return false; }
+
+//-------------------------------------------------------------------------------------------------
+//      フルスクリーンモードを設定します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::SetFullScreenMode(bool enable)
+{
+    // 操作するウィンドウが無いので非サポートです.
+    A3D_UNUSED(enable);
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      CPUがGPUに先行できる最大フレーム数を設定します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::SetMaxFrameLatency(uint32_t count)
+{
+    if (count == 0 || count > m_Desc.BufferCount)
+    { return false; }
+
+    // 上限を下げた場合は，次の取得時に超過分の完了を待つ.
+    m_Desc.MaxFrameLatency = count;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      次のフレームを記録できるようになるまで待機します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::WaitForFrameSlot(uint32_t timeoutMsec)
+{
+    auto timeout = (timeoutMsec == UINT32_MAX)
+        ? UINT64_MAX
+        : uint64_t(timeoutMsec) * 1000 * 1000;
+
+    return AcquireNextImage(timeout);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      処理中のフレーム数が上限未満になるまで待ってから次のバックバッファを取得します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::AcquireNextImage(uint64_t timeout)
+{
+    if (m_IsAcquired)
+    { return true; }
+
+    // 上限はバッファ数以下なので，ここを抜ければ次のイメージを使った過去のコピーは完了している.
+    while (m_PendingCount >= m_Desc.MaxFrameLatency)
+    {
+        if (!RetireFrame(timeout))
+        { return false; }
+    }
+
+    m_IsAcquired = true;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最も古い処理中フレームの完了を待ってコールバックに引き渡します.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::RetireFrame(uint64_t timeout)
+{
+    if (m_PendingCount == 0)
+    { return false; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    auto& frame = m_pFrames[m_PendingHead];
+
+    // timeout が 0 の場合は状態を確認するだけで待機しない.
+    auto ret = vkWaitForFences(pNativeDevice, 1, &frame.Fence, VK_TRUE, timeout);
+    if (ret != VK_SUCCESS)
+    { return false; }
+
+    m_pQueue->NotifyCompleted(frame.SubmitValue);
+
+    if (m_pCallback != nullptr)
+    {
+        // ホストコヒーレントでないメモリの場合に備えて無効化しておく.
+        vmaInvalidateAllocation(m_pDevice->GetAllocator(), frame.Allocation, 0, VK_WHOLE_SIZE);
+
+        FrameImage image = {};
+        image.pPixels       = frame.pPixels;
+        image.Width         = m_Desc.Extent.Width;
+        image.Height        = m_Desc.Extent.Height;
+        image.RowPitch      = m_RowPitch;
+        image.Format        = m_Desc.Format;
+        image.FrameIndex    = frame.FrameIndex;
+
+        m_pCallback->OnFrame(image);
+    }
+
+    vkResetFences(pNativeDevice, 1, &frame.Fence);
+
+    m_PendingHead = (m_PendingHead + 1) % m_Desc.BufferCount;
+    m_PendingCount--;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      生成処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool HeadlessSwapChain::Create
+(
+    IDevice*                pDevice,
+    const SwapChainDesc*    pDesc,
+    IFrameCallback*         pCallback,
+    ISwapChain**            ppSwapChain
+)
+{
+    if (pDevice == nullptr || pDesc == nullptr || ppSwapChain == nullptr)
+    { return false; }
+
+    auto instance = new HeadlessSwapChain();
+    if (instance == nullptr)
+    { return false; }
+
+    if (!instance->Init(pDevice, pDesc, pCallback))
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
+    *ppSwapChain = instance;
+    return true;
+}
+
+} // namespace a3d
@@ -0,0 +1,275 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dHeadlessSwapChain.h
+// Desc : Headless SwapChain Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// HeadlessSwapChain class
+//! @brief      オフスクリーンのイメージで表示処理を代替するスワップチェインです.
+//!
+//! @note       表示するたびにイメージを読み戻し用バッファへコピーし，コピーが完了したフレームから
+//!             表示した順に IFrameCallback へ引き渡します. Present() はGPUの完了を待ちません.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class A3D_API HeadlessSwapChain : public IPresentable, public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      生成処理を行います.
+    //!
+    //! @param[in]      pDevice         デバイスです.
+    //! @param[in]      pDesc           構成設定です.
+    //! @param[in]      pCallback       フレームを受け取るコールバックです. nullptr の場合は読み戻しを行いません.
+    //! @param[out]     ppSwapChain     スワップチェインの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY Create(
+        IDevice*                pDevice,
+        const SwapChainDesc*    pDesc,
+        IFrameCallback*         pCallback,
+        ISwapChain**            ppSwapChain);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      参照カウントを増やします.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY AddRef() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      解放処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Release() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      参照カウントを取得します.
+    //!
+    //! @return     参照カウントを返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetCount() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスを取得します.
+    //!
+    //! @param[out]     ppDevice        デバイスの格納先です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY GetDevice(IDevice** ppDevice) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //!
+    //! @return     構成設定を返却します.
+    //---------------------------------------------------------------------------------------------
+    SwapChainDesc A3D_APIENTRY GetDesc() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画面に表示します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Present() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のバッファ番号を取得します.
+    //!
+    //! @return     現在のバッファ番号を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetCurrentBufferIndex() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定されたバッファを取得します.
+    //!
+    //! @param[in]      index       バッファ番号です.
+    //! @param[out]     ppResource  リソースの格納先です.
+    //! @retval true    バッファの取得に成功.
+    //! @retval false   バッファの取得に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY GetBuffer(uint32_t index, ITexture** ppResource) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファをリサイズします.
+    //!
+    //! @param[in]      width       リサイズする横幅.
+    //! @param[in]      height      リサイズする縦幅.
+    //! @retval true    リサイズに成功.
+    //! @retval false   リサイズに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY ResizeBuffers(uint32_t width, uint32_t height) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メタデータを設定します.
+    //!
+    //! @param[in]      type        メタデータタイプです.
+    //! @param[in]      pData       メタデータです.
+    //! @retval true    メタデータの設定に成功.
+    //! @retval false   メタデータの設定に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY SetMetaData(META_DATA_TYPE type, void* pData) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      色空間がサポートされているかチェックします.
+    //!
+    //! @param[in]      type        色空間タイプです.
+    //! @retval true    チェックに成功.
+    //! @retval false   チェックに失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY CheckColorSpaceSupport(COLOR_SPACE_TYPE type) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      色空間を設定します.
+    //!
+    //! @param[in]      type        色空間タイプです.
+    //! @retval true    設定に成功.
+    //! @retval false   設定に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY SetColorSpace(COLOR_SPACE_TYPE type) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フルスクリーンモードかどうかチェックします.
+    //!
+    //! @retval true    フルスクリーンモードです.
+    //! @retval false   ウィンドウモードです.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY IsFullScreenMode() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フルスクリーンモードを設定します.
+    //!
+    //! @param[in]      enable      フルスクリーンにする場合は true を，ウィンドウモードにする場合は falseを指定します.
+    //! @retval true    設定に成功.
+    //! @retval false   設定に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY SetFullScreenMode(bool enable) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      CPUがGPUに先行できる最大フレーム数を設定します.
+    //!
+    //! @param[in]      count       最大フレーム数です(1 ～ バックバッファ数).
+    //! @retval true    設定に成功.
+    //! @retval false   設定に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY SetMaxFrameLatency(uint32_t count) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      次のフレームを記録できるようになるまで待機します.
+    //!
+    //! @param[in]      timeoutMsec     タイムアウト時間です(ミリ秒単位).
+    //! @retval true    次のフレームのバックバッファを取得済みです.
+    //! @retval false   タイムアウトしました.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY WaitForFrameSlot(uint32_t timeoutMsec) override;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Frame structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        ITexture*           pTexture;           //!< 描画先のテクスチャです.
+        VkBuffer            Buffer;             //!< 読み戻し用バッファです.
+        VmaAllocation       Allocation;         //!< 読み戻し用バッファのメモリです.
+        void*               pPixels;            //!< マップ済みポインタです.
+        VkCommandBuffer     CommandBuffer;      //!< コピー用コマンドバッファです.
+        VkFence             Fence;              //!< コピーの完了を通知するフェンスです.
+        uint64_t            FrameIndex;         //!< 表示したフレーム番号です.
+        uint64_t            SubmitValue;        //!< 投入時点でキューが実行したサブミットの通し番号です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::atomic<uint32_t>   m_RefCount;             //!< 参照カウンタです.
+    Device*                 m_pDevice;              //!< デバイスです.
+    Queue*                  m_pQueue;               //!< コマンドキューです.
+    SwapChainDesc           m_Desc;                 //!< 構成設定です.
+    IFrameCallback*         m_pCallback;            //!< フレームを受け取るコールバックです.
+    VkCommandPool           m_CommandPool;          //!< コマンドプールです.
+    Frame*                  m_pFrames;              //!< フレームです.
+    uint32_t                m_RowPitch;             //!< 読み戻したイメージの1行あたりのバイト数です.
+    uint32_t                m_CurrentBufferIndex;   //!< 現在のバッファ番号です.
+    bool                    m_IsAcquired;           //!< 現在のバッファを取得済みかどうか?
+    uint32_t                m_PendingHead;          //!< 最も古い処理中フレームのバッファ番号です.
+    uint32_t                m_PendingCount;         //!< GPUで処理中のフレーム数です.
+    uint64_t                m_FrameIndex;           //!< 次に表示するフレーム番号です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    A3D_APIENTRY HeadlessSwapChain();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    A3D_APIENTRY ~HeadlessSwapChain();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDevice     デバイスです.
+    //! @param[in]      pDesc       構成設定です.
+    //! @param[in]      pCallback   フレームを受け取るコールバックです.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Init(IDevice* pDevice, const SwapChainDesc* pDesc, IFrameCallback* pCallback);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イメージと読み戻し用バッファを生成します.
+    //!
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY InitBuffers();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      イメージと読み戻し用バッファを破棄します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY TermBuffers();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      処理中のフレーム数が上限未満になるまで待ってから次のバックバッファを取得します.
+    //!
+    //! @param[in]      timeout     タイムアウト時間です(ナノ秒単位).
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY AcquireNextImage(uint64_t timeout);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最も古い処理中フレームの完了を待ってコールバックに引き渡します.
+    //!
+    //! @param[in]      timeout     タイムアウト時間です(ナノ秒単位). 0 の場合は待機しません.
+    //! @retval true    引き渡しに成功.
+    //! @retval false   フレームが完了していません.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY RetireFrame(uint64_t timeout);
+
+    HeadlessSwapChain   (const HeadlessSwapChain&) = delete;
+    void operator =     (const HeadlessSwapChain&) = delete;
+};
+
+} // namespace a3d
@@ -5,6 +5,15 @@
 //-------------------------------------------------------------------------------------------------
 #pragma once
 
+#include <cassert>
+
+#ifndef A3D_ASSERT
+    #if defined(DEBUG) || defined(_DEBUG)
+        #define     A3D_ASSERT(expression)  assert(expression)
+    #else
+        #define     A3D_ASSERT(expression)
+    #endif
+#endif
 
 //-------------------------------------------------------------------------------------------------
 // Includes
@@ -12,9 +21,15 @@
 #include <allocator/a3dBaseAllocator.h>
 #include <allocator/a3dStdAllocator.h>
 #include <a3d.h>
-#include <cassert>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <allocator/a3dRingAllocator.h>
 
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
@@ -29,6 +44,7 @@
 #include "a3dCommandList.h"
 #include "a3dQueue.h"
 #include "a3dSwapChain.h"
+#include "a3dHeadlessSwapChain.h"
 #include "a3dBuffer.h"
 #include "a3dBufferView.h"
 #include "a3dTexture.h"
@@ -39,16 +55,13 @@
 #include "a3dDescriptorSetLayout.h"
 #include "a3dDescriptorSet.h"
 #include "a3dPipelineState.h"
+#include "a3dPipelineCompiler.h"
 #include "a3dQueryPool.h"
+#include "a3dReadbackService.h"
+#include "a3dGpuProfiler.h"
+#include "a3dUploadRing.h"
+#include "a3dBindlessHeap.h"
+#include "a3dDescriptorAllocator.h"
+#include "a3dRenderPassCache.h"
 #include "a3dUtil.h"
 #include "a3dSpirv.h"
-
-
-
-#ifndef A3D_ASSERT
-    #if defined(DEBUG) || defined(_DEBUG)
-        #define     A3D_ASSERT(expression)  assert(expression)
-    #else
-        #define     A3D_ASSERT(expression)
-    #endif
-#endif
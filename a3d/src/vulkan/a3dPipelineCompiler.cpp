@@ -0,0 +1,176 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dPipelineCompiler.cpp
+// Desc : Asynchronous Pipeline Compiler.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PipelineCompiler class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+PipelineCompiler::PipelineCompiler()
+: m_pThreads    (nullptr)
+, m_ThreadCount (0)
+, m_IsRunning   (false)
+, m_IsTerminate (false)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+PipelineCompiler::~PipelineCompiler()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool PipelineCompiler::Init(uint32_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        // 呼び出しスレッド分を1つ空けておく.
+        auto hardwareCount = std::thread::hardware_concurrency();
+        threadCount = (hardwareCount > 1) ? hardwareCount - 1 : 1;
+    }
+
+    m_ThreadCount = threadCount;
+    m_IsRunning   = false;
+    m_IsTerminate = false;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void PipelineCompiler::Term()
+{
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+        m_IsTerminate = true;
+    }
+    m_PushCondition.notify_all();
+
+    if (m_pThreads != nullptr)
+    {
+        for(auto i=0u; i<m_ThreadCount; ++i)
+        {
+            if (m_pThreads[i].joinable())
+            { m_pThreads[i].join(); }
+        }
+
+        delete [] m_pThreads;
+        m_pThreads = nullptr;
+    }
+
+    // パイプラインステートはデバイスの参照を保持しているため，
+    // ここに到達した時点でキューは空になっているはず.
+    A3D_ASSERT(m_Queue.empty());
+    m_Queue.clear();
+
+    m_ThreadCount = 0;
+    m_IsRunning   = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パイプラインステートの生成を要求します.
+//-------------------------------------------------------------------------------------------------
+bool PipelineCompiler::Push(PipelineState** ppStates, uint32_t count)
+{
+    if (ppStates == nullptr || count == 0)
+    { return false; }
+
+    {
+        std::lock_guard<std::mutex> locker(m_Mutex);
+
+        if (m_IsTerminate)
+        { return false; }
+
+        // 最初の要求でワーカースレッドを起動する.
+        if (!m_IsRunning)
+        {
+            m_pThreads = new std::thread[m_ThreadCount];
+            if (m_pThreads == nullptr)
+            { return false; }
+
+            for(auto i=0u; i<m_ThreadCount; ++i)
+            { m_pThreads[i] = std::thread(&PipelineCompiler::Run, this); }
+
+            m_IsRunning = true;
+        }
+
+        for(auto i=0u; i<count; ++i)
+        {
+            A3D_ASSERT(ppStates[i] != nullptr);
+            ppStates[i]->m_Status = PipelineState::STATUS_PENDING;
+            m_Queue.push_back(ppStates[i]);
+        }
+    }
+
+    m_PushCondition.notify_all();
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パイプラインステートの生成完了を待機します.
+//-------------------------------------------------------------------------------------------------
+bool PipelineCompiler::Wait(const PipelineState* pState, uint32_t timeoutMsec)
+{
+    if (pState == nullptr)
+    { return false; }
+
+    std::unique_lock<std::mutex> locker(m_Mutex);
+    return m_CompleteCondition.wait_for(
+        locker,
+        std::chrono::milliseconds(timeoutMsec),
+        [pState]() { return pState->IsReady(); });
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ワーカースレッドの処理です.
+//-------------------------------------------------------------------------------------------------
+void PipelineCompiler::Run()
+{
+    PipelineState* batch[PipelineState::MaxCompileBatchCount];
+
+    for(;;)
+    {
+        uint32_t count = 0;
+
+        {
+            std::unique_lock<std::mutex> locker(m_Mutex);
+            m_PushCondition.wait(locker, [this]() { return m_IsTerminate || !m_Queue.empty(); });
+
+            if (m_Queue.empty())
+            { break; }
+
+            // 他のワーカースレッドにも仕事が行き渡るように均等に分ける.
+            auto share = uint32_t(m_Queue.size() / m_ThreadCount);
+            count = (share < 1) ? 1 : share;
+            if (count > PipelineState::MaxCompileBatchCount)
+            { count = PipelineState::MaxCompileBatchCount; }
+
+            for(auto i=0u; i<count; ++i)
+            {
+                batch[i] = m_Queue.front();
+                m_Queue.pop_front();
+            }
+        }
+
+        PipelineState::Compile(batch, count);
+
+        // 待機側が状態を確認してから待機に入るまでの間に通知しないようにロックを経由する.
+        {
+            std::lock_guard<std::mutex> locker(m_Mutex);
+        }
+        m_CompleteCondition.notify_all();
+    }
+}
+
+} // namespace a3d
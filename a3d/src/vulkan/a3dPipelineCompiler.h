@@ -0,0 +1,109 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dPipelineCompiler.h
+// Desc : Asynchronous Pipeline Compiler.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+class PipelineState;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PipelineCompiler class
+//! @brief      ワーカースレッドでパイプラインの生成を行うクラスです.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class PipelineCompiler : public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    PipelineCompiler();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~PipelineCompiler();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      threadCount     ワーカースレッド数です. 0 の場合はハードウェアスレッド数から決定します.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       ワーカースレッドは最初の Push() 呼び出し時に起動されます.
+    //---------------------------------------------------------------------------------------------
+    bool Init(uint32_t threadCount);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインステートの生成を要求します.
+    //!
+    //! @param[in]      ppStates        生成するパイプラインステートの配列です.
+    //! @param[in]      count           パイプラインステート数です.
+    //! @retval true    要求に成功.
+    //! @retval false   要求に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool Push(PipelineState** ppStates, uint32_t count);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインステートの生成完了を待機します.
+    //!
+    //! @param[in]      pState          待機するパイプラインステートです.
+    //! @param[in]      timeoutMsec     タイムアウト時間(ミリ秒)です.
+    //! @retval true    生成処理が完了しました.
+    //! @retval false   タイムアウトしました.
+    //---------------------------------------------------------------------------------------------
+    bool Wait(const PipelineState* pState, uint32_t timeoutMsec);
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::mutex                                              m_Mutex;                //!< ミューテックスです.
+    std::condition_variable                                 m_PushCondition;        //!< 生成要求通知用の条件変数です.
+    std::condition_variable                                 m_CompleteCondition;    //!< 生成完了通知用の条件変数です.
+    std::deque<PipelineState*, StdAllocator<PipelineState*>> m_Queue;               //!< 生成待ちキューです.
+    std::thread*                                            m_pThreads;             //!< ワーカースレッドです.
+    uint32_t                                                m_ThreadCount;          //!< ワーカースレッド数です.
+    bool                                                    m_IsRunning;            //!< ワーカースレッドが起動済みかどうか?
+    bool                                                    m_IsTerminate;          //!< 終了要求フラグです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ワーカースレッドの処理です.
+    //---------------------------------------------------------------------------------------------
+    void Run();
+
+    PipelineCompiler(const PipelineCompiler&) = delete;
+    void operator = (const PipelineCompiler&) = delete;
+};
+
+} // namespace a3d
@@ -78,8 +78,8 @@ void ToNativeVertexInputState
 (
     const a3d::InputLayoutDesc&             desc,
     VkPipelineVertexInputStateCreateInfo*   pInfo,
-    VkVertexInputBindingDescription*        pOutBind,   // 呼び出し側で解放すること.
-    VkVertexInputAttributeDescription*      pOutAttr    // 呼び出し側で解放すること.
+    VkVertexInputBindingDescription*&       pOutBind,   // 呼び出し側で解放すること.
+    VkVertexInputAttributeDescription*&     pOutAttr    // 呼び出し側で解放すること.
 )
 {
     // 必要な数を一回数える.
@@ -509,10 +509,75 @@ void ToNativeColorBlendState
     pInfo->blendConstants[3] = 0.0f;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      レンダーパスのキャッシュキーを設定します.
+//-------------------------------------------------------------------------------------------------
+void ToRenderPassKey
+(
+    uint32_t                    colorCount,
+    const a3d::TargetFormat*    pColorTargets,
+    const a3d::TargetFormat&    depthTarget,
+    a3d::RenderPassKey*         pKey
+)
+{
+    // キーはバイト列で比較されるのでゼロクリアしておく.
+    memset(pKey, 0, sizeof(*pKey));
+
+    // フレームバッファと同じ構成のレンダーパスを共有する.
+    pKey->ColorCount     = colorCount;
+    pKey->DepthFormat    = VK_FORMAT_UNDEFINED;
+    pKey->LoadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    pKey->StoreOp        = VK_ATTACHMENT_STORE_OP_STORE;
+    pKey->StencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    pKey->StencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+    for (auto i = 0u; i < colorCount; ++i)
+    {
+        pKey->ColorFormats[i] = a3d::ToNativeFormat(pColorTargets[i].Format);
+        pKey->ColorSamples[i] = a3d::ToNativeSampleCountFlags(pColorTargets[i].SampleCount);
+    }
+
+    if (depthTarget.Format != a3d::RESOURCE_FORMAT_UNKNOWN)
+    {
+        pKey->DepthFormat  = a3d::ToNativeFormat(depthTarget.Format);
+        pKey->DepthSamples = a3d::ToNativeSampleCountFlags(depthTarget.SampleCount);
+    }
+}
+
 } // namespace /* anonymous */
 
 namespace a3d {
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PipelineState::BuildInfo structure
+//! @brief  パイプライン生成情報です.
+//! @note   非同期生成時に呼び出し側の構成設定に依存しないように，生成に必要なデータを全て保持します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct PipelineState::BuildInfo
+{
+    VkPipelineShaderStageCreateInfo         ShaderInfos[5];         //!< シェーダステージ情報です.
+    char*                                   pEntryPoints[5];        //!< エントリーポイント名です.
+    uint32_t                                ShaderCount;            //!< シェーダ数です.
+    VkVertexInputBindingDescription*        pBindingDescs;          //!< 頂点バインディングです.
+    VkVertexInputAttributeDescription*      pInputAttrs;            //!< 頂点アトリビュートです.
+    VkPipelineVertexInputStateCreateInfo    VertexInputState;       //!< 頂点入力ステートです.
+    VkPipelineInputAssemblyStateCreateInfo  InputAssemblyState;     //!< 入力アセンブリステートです.
+    VkPipelineTessellationStateCreateInfo   TessellationState;      //!< テッセレーションステートです.
+    VkViewport                              Viewport;               //!< ビューポートです.
+    VkRect2D                                Scissor;                //!< シザー矩形です.
+    VkPipelineViewportStateCreateInfo       ViewportState;          //!< ビューポートステートです.
+    VkPipelineRasterizationStateCreateInfo  RasterizerState;        //!< ラスタライザーステートです.
+    VkPipelineMultisampleStateCreateInfo    MultisampleState;       //!< マルチサンプルステートです.
+    VkPipelineDepthStencilStateCreateInfo   DepthStencilState;      //!< 深度ステンシルステートです.
+    VkPipelineColorBlendAttachmentState     ColorAttachments[8];    //!< カラーブレンドアタッチメントです.
+    VkPipelineColorBlendStateCreateInfo     ColorBlendState;        //!< カラーブレンドステートです.
+    VkDynamicState                          DynamicElements[4];     //!< 動的ステートです.
+    VkPipelineDynamicStateCreateInfo        DynamicState;           //!< 動的ステート情報です.
+    IDescriptorSetLayout*                   pLayout;                //!< ディスクリプタセットレイアウトです.
+    VkGraphicsPipelineCreateInfo            GraphicsInfo;           //!< グラフィックスパイプライン生成情報です.
+    VkComputePipelineCreateInfo             ComputeInfo;            //!< コンピュートパイプライン生成情報です.
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // PipelineState class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -525,8 +590,9 @@ PipelineState::PipelineState()
 , m_pDevice         (nullptr)
 , m_PipelineState   (null_handle)
 , m_BindPoint       (VK_PIPELINE_BIND_POINT_GRAPHICS)
-, m_PipelineCache   (null_handle)
 , m_RenderPass      (null_handle)
+, m_Status          (STATUS_NONE)
+, m_pBuildInfo      (nullptr)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -552,242 +618,72 @@ bool PipelineState::InitAsGraphics(IDevice* pDevice, const GraphicsPipelineState
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT(pNativeDevice != null_handle);
 
-   {
-        VkAttachmentDescription attachmentDesc[9] = {};
-        VkAttachmentReference   attachmentRefs[9] = {};
-        VkAttachmentReference*  pDepthAttachmentRef = nullptr;
-
-        uint32_t attachmentCount = pDesc->ColorCount;
-
-        for (auto i = 0u; i < pDesc->ColorCount; ++i)
-        {
-            attachmentDesc[i].format            = ToNativeFormat(pDesc->ColorTarget[i].Format);
-            attachmentDesc[i].samples           = ToNativeSampleCountFlags(pDesc->ColorTarget[i].SampleCount);
-            attachmentDesc[i].loadOp            = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[i].storeOp           = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[i].stencilLoadOp     = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[i].stencilStoreOp    = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[i].initialLayout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            attachmentDesc[i].finalLayout       = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            attachmentDesc[i].flags             = 0;
-
-            attachmentRefs[i].attachment    = i;
-            attachmentRefs[i].layout        = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        }
-
-        if (pDesc->DepthTarget.Format != RESOURCE_FORMAT_UNKNOWN)
-        {
-            attachmentCount++;
-
-            auto idx = pDesc->ColorCount;
-            attachmentDesc[idx].format          = ToNativeFormat(pDesc->DepthTarget.Format);
-            attachmentDesc[idx].samples         = ToNativeSampleCountFlags(pDesc->DepthTarget.SampleCount);
-            attachmentDesc[idx].loadOp          = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[idx].storeOp         = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[idx].stencilLoadOp   = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[idx].stencilStoreOp  = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[idx].initialLayout   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-            attachmentDesc[idx].finalLayout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-            attachmentRefs[idx].attachment  = idx;
-            attachmentRefs[idx].layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-            pDepthAttachmentRef = &attachmentRefs[idx];
-        }
+    // 互換性のためだけに必要なので，デバイスのキャッシュから共有のレンダーパスを取得する.
+    {
+        RenderPassKey key;
+        ToRenderPassKey(pDesc->ColorCount, pDesc->ColorTarget, pDesc->DepthTarget, &key);
 
-        VkSubpassDescription subpass = {};
-        subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.flags                   = 0;
-        subpass.inputAttachmentCount    = 0;
-        subpass.colorAttachmentCount    = pDesc->ColorCount;
-        subpass.pColorAttachments       = attachmentRefs;
-        subpass.pResolveAttachments     = nullptr;
-        subpass.pDepthStencilAttachment = pDepthAttachmentRef;
-        subpass.preserveAttachmentCount = 0;
-        subpass.pPreserveAttachments    = nullptr;
-
-
-        VkRenderPassCreateInfo info = {};
-        info.sType              = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        info.pNext              = nullptr;
-        info.flags              = 0;
-        info.attachmentCount    = attachmentCount;
-        info.pAttachments       = attachmentDesc;
-        info.subpassCount       = 1;
-        info.pSubpasses         = &subpass;
-
-
-        auto ret = vkCreateRenderPass(pNativeDevice, &info, nullptr, &m_RenderPass);
-        if (ret != VK_SUCCESS)
-        { return false;  }
+        m_RenderPass = m_pDevice->GetRenderPassCache()->GetRenderPass(key);
+        if (m_RenderPass == null_handle)
+        { return false; }
     }
 
     m_BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 
-    // パイプラインキャッシュを生成.
+    // キャッシュデータはデバイスのパイプラインキャッシュにマージする.
+    // 互換性の無いデータの場合はマージに失敗するが，生成自体は続行する.
+    if (pDesc->pCachedPSO != nullptr)
+    { m_pDevice->MergeVulkanPipelineCache(pDesc->pCachedPSO); }
+
+    // 生成情報を構築.
     {
-        VkPipelineCacheCreateInfo info = {};
-        info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-        info.pNext           = nullptr;
-        info.flags           = 0;
-        info.initialDataSize = (pDesc->pCachedPSO != nullptr) ? size_t(pDesc->pCachedPSO->GetBufferSize()) : 0;
-        info.pInitialData    = (pDesc->pCachedPSO != nullptr) ? pDesc->pCachedPSO->GetBufferPointer() : nullptr;
-
-        auto ret = vkCreatePipelineCache(pNativeDevice, &info, nullptr, &m_PipelineCache);
-        if ( ret != VK_SUCCESS )
+        m_pBuildInfo = new BuildInfo();
+        if (m_pBuildInfo == nullptr)
         { return false; }
-    }
 
-    // パイプラインステートを生成.
-    {
-        VkPipelineShaderStageCreateInfo         shaderInfos[5]       = {};
-        VkVertexInputAttributeDescription*      pInputAttrs          = nullptr;
-        VkVertexInputBindingDescription*        pBindingDescs        = nullptr;
-        VkPipelineVertexInputStateCreateInfo    vertexInputState     = {};
-        VkPipelineInputAssemblyStateCreateInfo  inputAssemblyState   = {};
-        VkPipelineTessellationStateCreateInfo   tessellationState    = {};
-        VkPipelineViewportStateCreateInfo       viewportState        = {};
-        VkPipelineRasterizationStateCreateInfo  rasterizerState      = {};
-        VkPipelineMultisampleStateCreateInfo    multisampleState     = {};
-        VkPipelineDepthStencilStateCreateInfo   depthStencilState    = {};
-        VkPipelineColorBlendAttachmentState     colorAttachments[8]  = {};
-        VkPipelineColorBlendStateCreateInfo     colorBlendState      = {};
-
-        auto shaderCount = 0;
-        if (pDesc->VS.pByteCode != nullptr && pDesc->VS.ByteCodeSize != 0)
-        {
-            auto ret = ToNativeShaderStageInfo(
-                pNativeDevice,
-                pDesc->VS,
-                VK_SHADER_STAGE_VERTEX_BIT,
-                &shaderInfos[shaderCount]);
-            A3D_ASSERT(ret == true);
-            A3D_UNUSED(ret);
-            shaderCount++;
-        }
+        auto pInfo = m_pBuildInfo;
 
-        if (pDesc->DS.pByteCode != nullptr && pDesc->DS.ByteCodeSize != 0)
-        {
-            auto ret = ToNativeShaderStageInfo(
-                pNativeDevice,
-                pDesc->DS,
-                VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
-                &shaderInfos[shaderCount]);
-            A3D_ASSERT(ret == true);
-            A3D_UNUSED(ret);
-            shaderCount++;
-        }
+        const ShaderBinary* shaders[] = {
+            &pDesc->VS,
+            &pDesc->DS,
+            &pDesc->HS,
+            &pDesc->PS,
+        };
+        const VkShaderStageFlagBits stages[] = {
+            VK_SHADER_STAGE_VERTEX_BIT,
+            VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+            VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+        };
 
-        if (pDesc->HS.pByteCode != nullptr && pDesc->HS.ByteCodeSize != 0)
+        for(auto i=0u; i<CountOf(shaders); ++i)
         {
-            auto ret = ToNativeShaderStageInfo(
-                pNativeDevice,
-                pDesc->HS,
-                VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
-                &shaderInfos[shaderCount]);
-            A3D_ASSERT(ret == true);
-            A3D_UNUSED(ret);
-            shaderCount++;
-        }
+            if (shaders[i]->pByteCode == nullptr || shaders[i]->ByteCodeSize == 0)
+            { continue; }
 
-    #if 0
-        //if (pDesc->GS.pByteCode != nullptr && pDesc->GS.ByteCodeSize != 0)
-        //{
-        //    auto ret = ToNativeShaderStageInfo(
-        //        pNativeDevice,
-        //        pDesc->GS,
-        //        VK_SHADER_STAGE_GEOMETRY_BIT,
-        //        &shaderInfos[shaderCount]);
-        //    A3D_ASSERT(ret == true);
-        //    A3D_UNUSED(ret);
-        //    shaderCount++;
-        //}
-    #endif
-
-        if (pDesc->PS.pByteCode != nullptr && pDesc->PS.ByteCodeSize != 0)
-        {
-            auto ret = ToNativeShaderStageInfo(
-                pNativeDevice,
-                pDesc->PS,
-                VK_SHADER_STAGE_FRAGMENT_BIT,
-                &shaderInfos[shaderCount]);
-            A3D_ASSERT(ret == true);
-            A3D_UNUSED(ret);
-            shaderCount++;
+            if (!AddShaderStage(pNativeDevice, *shaders[i], stages[i]))
+            { return false; }
         }
 
-        VkDynamicState dynamicElements[] = {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR,
-            VK_DYNAMIC_STATE_BLEND_CONSTANTS,
-            VK_DYNAMIC_STATE_STENCIL_REFERENCE
-        };
-
-        VkPipelineDynamicStateCreateInfo dynamicState = {};
-        dynamicState.sType              = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicState.pNext              = nullptr;
-        dynamicState.flags              = 0;
-        dynamicState.dynamicStateCount  = 4;
-        dynamicState.pDynamicStates     = dynamicElements;
-
-        VkViewport viewports[16];
-        VkRect2D scissors[16];
-
-        ToNativeVertexInputState  (pDesc->InputLayout, &vertexInputState, pBindingDescs, pInputAttrs);
-        ToNativeInputAssemblyState(pDesc->PrimitiveTopology, &inputAssemblyState);
-        ToNativeTessellationState (pDesc->TessellationState, &tessellationState);
-        ToNativeRasterizationState(pDesc->RasterizerState,   &rasterizerState);
-        ToNativeMultisampleState  (pDesc->MultiSampleState,  &multisampleState);
-        ToNativeDepthState        (pDesc->DepthState,        &depthStencilState);
-        ToNativeStencilState      (pDesc->StencilState,      &depthStencilState);
-        ToNativeViewportState(viewports, scissors, &viewportState);
+        ToNativeVertexInputState  (pDesc->InputLayout, &pInfo->VertexInputState, pInfo->pBindingDescs, pInfo->pInputAttrs);
+        ToNativeInputAssemblyState(pDesc->PrimitiveTopology, &pInfo->InputAssemblyState);
+        ToNativeTessellationState (pDesc->TessellationState, &pInfo->TessellationState);
+        ToNativeRasterizationState(pDesc->RasterizerState,   &pInfo->RasterizerState);
+        ToNativeMultisampleState  (pDesc->MultiSampleState,  &pInfo->MultisampleState);
+        ToNativeDepthState        (pDesc->DepthState,        &pInfo->DepthStencilState);
+        ToNativeStencilState      (pDesc->StencilState,      &pInfo->DepthStencilState);
+        ToNativeViewportState(&pInfo->Viewport, &pInfo->Scissor, &pInfo->ViewportState);
         ToNativeColorBlendState(
             pDesc->BlendState,
             pDesc->ColorCount,
-            colorAttachments,
-            &colorBlendState );
+            pInfo->ColorAttachments,
+            &pInfo->ColorBlendState );
 
-        auto pWrapLayout = static_cast<DescriptorSetLayout*>(pDesc->pLayout);
-        A3D_ASSERT(pWrapLayout != nullptr);
+        SetupGraphicsCreateInfo(pDesc->pLayout);
 
-        VkGraphicsPipelineCreateInfo info = {};
-        info.sType                  = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        info.pNext                  = nullptr;
-        info.flags                  = 0;
-        info.stageCount             = shaderCount;
-        info.pStages                = shaderInfos;
-        info.pVertexInputState      = &vertexInputState;
-        info.pInputAssemblyState    = &inputAssemblyState;
-        info.pTessellationState     = &tessellationState;
-        info.pViewportState         = &viewportState;
-        info.pRasterizationState    = &rasterizerState;
-        info.pMultisampleState      = &multisampleState;
-        info.pDepthStencilState     = &depthStencilState;
-        info.pColorBlendState       = &colorBlendState;
-        info.pDynamicState          = &dynamicState;
-        info.layout                 = pWrapLayout->GetVulkanPipelineLayout();
-        info.renderPass             = m_RenderPass;
-        info.subpass                = 0;
-        info.basePipelineHandle     = null_handle;
-        info.basePipelineIndex      = 0;
-       
-        auto ret = vkCreateGraphicsPipelines(pNativeDevice, m_PipelineCache, 1, &info, nullptr, &m_PipelineState);
-
-        // メモリを解放.
-        delete [] pBindingDescs;
-        delete [] pInputAttrs;
-
-        for(auto i=0; i<shaderCount; ++i)
-        {
-            if (shaderInfos[i].module != VK_NULL_HANDLE)
-            {
-                vkDestroyShaderModule(pNativeDevice, shaderInfos[i].module, nullptr);
-                shaderInfos[i].module = VK_NULL_HANDLE;
-            }
-        }
-
-        if ( ret != VK_SUCCESS )
-        { return false; }
+        pInfo->GraphicsInfo.pVertexInputState   = &pInfo->VertexInputState;
+        pInfo->GraphicsInfo.pInputAssemblyState = &pInfo->InputAssemblyState;
+        pInfo->GraphicsInfo.pTessellationState  = &pInfo->TessellationState;
     }
 
     return true;
@@ -814,37 +710,35 @@ bool PipelineState::InitAsCompute(IDevice* pDevice, const ComputePipelineStateDe
 
     m_BindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
 
-    // パイプラインキャッシュを生成.
+    // キャッシュデータはデバイスのパイプラインキャッシュにマージする.
+    // 互換性の無いデータの場合はマージに失敗するが，生成自体は続行する.
+    if (pDesc->pCachedPSO != nullptr)
+    { m_pDevice->MergeVulkanPipelineCache(pDesc->pCachedPSO); }
+
+    // 生成情報を構築.
     {
-        VkPipelineCacheCreateInfo info = {};
-        info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-        info.pNext           = nullptr;
-        info.flags           = 0;
-        info.initialDataSize = (pDesc->pCachedPSO != nullptr) ? size_t(pDesc->pCachedPSO->GetBufferSize()) : 0;
-        info.pInitialData    = (pDesc->pCachedPSO != nullptr) ? pDesc->pCachedPSO->GetBufferPointer() : nullptr;
-
-        auto ret = vkCreatePipelineCache(pNativeDevice, &info, nullptr, &m_PipelineCache);
-        if ( ret != VK_SUCCESS )
+        m_pBuildInfo = new BuildInfo();
+        if (m_pBuildInfo == nullptr)
         { return false; }
-    }
 
-    // コンピュートパイプラインを生成します.
-    {
-        auto pWrapLayout = static_cast<DescriptorSetLayout*>(pDesc->pLayout);
-        A3D_ASSERT(pWrapLayout != nullptr);
+        auto pInfo = m_pBuildInfo;
 
-        VkComputePipelineCreateInfo info = {};
-        info.sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-        info.pNext              = nullptr;
-        info.flags              = 0;
-        info.layout             = pWrapLayout->GetVulkanPipelineLayout();
-        info.basePipelineHandle = null_handle;
-        info.basePipelineIndex  = 0;
-        ToNativeShaderStageInfo(pNativeDevice, pDesc->CS, VK_SHADER_STAGE_COMPUTE_BIT, &info.stage);
-
-        auto ret = vkCreateComputePipelines(pNativeDevice, m_PipelineCache, 1, &info, nullptr, &m_PipelineState);
-        if ( ret != VK_SUCCESS )
+        if (!AddShaderStage(pNativeDevice, pDesc->CS, VK_SHADER_STAGE_COMPUTE_BIT))
         { return false; }
+
+        pInfo->pLayout = pDesc->pLayout;
+        pInfo->pLayout->AddRef();
+
+        auto pWrapLayout = static_cast<DescriptorSetLayout*>(pInfo->pLayout);
+        A3D_ASSERT(pWrapLayout != nullptr);
+
+        pInfo->ComputeInfo.sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pInfo->ComputeInfo.pNext              = nullptr;
+        pInfo->ComputeInfo.flags              = 0;
+        pInfo->ComputeInfo.stage              = pInfo->ShaderInfos[0];
+        pInfo->ComputeInfo.layout             = pWrapLayout->GetVulkanPipelineLayout();
+        pInfo->ComputeInfo.basePipelineHandle = null_handle;
+        pInfo->ComputeInfo.basePipelineIndex  = 0;
     }
 
     return true;
@@ -867,216 +761,185 @@ bool PipelineState::InitAsGeometry(IDevice* pDevice, const GeometryPipelineState
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT(pNativeDevice != null_handle);
 
-   {
-        VkAttachmentDescription attachmentDesc[9] = {};
-        VkAttachmentReference   attachmentRefs[9] = {};
-        VkAttachmentReference*  pDepthAttachmentRef = nullptr;
-
-        uint32_t attachmentCount = pDesc->ColorCount;
-
-        for (auto i = 0u; i < pDesc->ColorCount; ++i)
-        {
-            attachmentDesc[i].format            = ToNativeFormat(pDesc->ColorTarget[i].Format);
-            attachmentDesc[i].samples           = ToNativeSampleCountFlags(pDesc->ColorTarget[i].SampleCount);
-            attachmentDesc[i].loadOp            = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[i].storeOp           = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[i].stencilLoadOp     = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[i].stencilStoreOp    = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[i].initialLayout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            attachmentDesc[i].finalLayout       = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            attachmentDesc[i].flags             = 0;
-
-            attachmentRefs[i].attachment    = i;
-            attachmentRefs[i].layout        = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        }
-
-        if (pDesc->DepthTarget.Format != RESOURCE_FORMAT_UNKNOWN)
-        {
-            attachmentCount++;
-
-            auto idx = pDesc->ColorCount;
-            attachmentDesc[idx].format          = ToNativeFormat(pDesc->DepthTarget.Format);
-            attachmentDesc[idx].samples         = ToNativeSampleCountFlags(pDesc->DepthTarget.SampleCount);
-            attachmentDesc[idx].loadOp          = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[idx].storeOp         = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[idx].stencilLoadOp   = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            attachmentDesc[idx].stencilStoreOp  = VK_ATTACHMENT_STORE_OP_STORE;
-            attachmentDesc[idx].initialLayout   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-            attachmentDesc[idx].finalLayout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-            attachmentRefs[idx].attachment  = idx;
-            attachmentRefs[idx].layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-            pDepthAttachmentRef = &attachmentRefs[idx];
-        }
+    // 互換性のためだけに必要なので，デバイスのキャッシュから共有のレンダーパスを取得する.
+    {
+        RenderPassKey key;
+        ToRenderPassKey(pDesc->ColorCount, pDesc->ColorTarget, pDesc->DepthTarget, &key);
 
-        VkSubpassDescription subpass = {};
-        subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.flags                   = 0;
-        subpass.inputAttachmentCount    = 0;
-        subpass.colorAttachmentCount    = pDesc->ColorCount;
-        subpass.pColorAttachments       = attachmentRefs;
-        subpass.pResolveAttachments     = nullptr;
-        subpass.pDepthStencilAttachment = pDepthAttachmentRef;
-        subpass.preserveAttachmentCount = 0;
-        subpass.pPreserveAttachments    = nullptr;
-
-
-        VkRenderPassCreateInfo info = {};
-        info.sType              = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        info.pNext              = nullptr;
-        info.flags              = 0;
-        info.attachmentCount    = attachmentCount;
-        info.pAttachments       = attachmentDesc;
-        info.subpassCount       = 1;
-        info.pSubpasses         = &subpass;
-
-
-        auto ret = vkCreateRenderPass(pNativeDevice, &info, nullptr, &m_RenderPass);
-        if (ret != VK_SUCCESS)
-        { return false;  }
+        m_RenderPass = m_pDevice->GetRenderPassCache()->GetRenderPass(key);
+        if (m_RenderPass == null_handle)
+        { return false; }
     }
 
     m_BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 
-    // パイプラインキャッシュを生成.
+    // キャッシュデータはデバイスのパイプラインキャッシュにマージする.
+    // 互換性の無いデータの場合はマージに失敗するが，生成自体は続行する.
+    if (pDesc->pCachedPSO != nullptr)
+    { m_pDevice->MergeVulkanPipelineCache(pDesc->pCachedPSO); }
+
+    // 生成情報を構築.
     {
-        VkPipelineCacheCreateInfo info = {};
-        info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-        info.pNext           = nullptr;
-        info.flags           = 0;
-        info.initialDataSize = (pDesc->pCachedPSO != nullptr) ? size_t(pDesc->pCachedPSO->GetBufferSize()) : 0;
-        info.pInitialData    = (pDesc->pCachedPSO != nullptr) ? pDesc->pCachedPSO->GetBufferPointer() : nullptr;
-
-        auto ret = vkCreatePipelineCache(pNativeDevice, &info, nullptr, &m_PipelineCache);
-        if ( ret != VK_SUCCESS )
+        m_pBuildInfo = new BuildInfo();
+        if (m_pBuildInfo == nullptr)
         { return false; }
-    }
 
-    // パイプラインステートを生成.
-    {
-        VkPipelineShaderStageCreateInfo         shaderInfos[3]       = {};
-        VkVertexInputAttributeDescription*      pInputAttrs          = nullptr;
-        VkVertexInputBindingDescription*        pBindingDescs        = nullptr;
-        VkPipelineVertexInputStateCreateInfo    vertexInputState     = {};
-        VkPipelineInputAssemblyStateCreateInfo  inputAssemblyState   = {};
-        VkPipelineTessellationStateCreateInfo   tessellationState    = {};
-        VkPipelineViewportStateCreateInfo       viewportState        = {};
-        VkPipelineRasterizationStateCreateInfo  rasterizerState      = {};
-        VkPipelineMultisampleStateCreateInfo    multisampleState     = {};
-        VkPipelineDepthStencilStateCreateInfo   depthStencilState    = {};
-        VkPipelineColorBlendAttachmentState     colorAttachments[8]  = {};
-        VkPipelineColorBlendStateCreateInfo     colorBlendState      = {};
-
-        auto shaderCount = 0;
-        if (pDesc->AS.pByteCode != nullptr && pDesc->AS.ByteCodeSize != 0)
-        {
-            auto ret = ToNativeShaderStageInfo(
-                pNativeDevice,
-                pDesc->AS,
-                VK_SHADER_STAGE_TASK_BIT_NV,
-                &shaderInfos[shaderCount]);
-            A3D_ASSERT(ret == true);
-            A3D_UNUSED(ret);
-            shaderCount++;
-        }
+        auto pInfo = m_pBuildInfo;
 
-        if (pDesc->MS.pByteCode != nullptr && pDesc->MS.ByteCodeSize != 0)
-        {
-            auto ret = ToNativeShaderStageInfo(
-                pNativeDevice,
-                pDesc->MS,
-                VK_SHADER_STAGE_MESH_BIT_NV,
-                &shaderInfos[shaderCount]);
-            A3D_ASSERT(ret == true);
-            A3D_UNUSED(ret);
-            shaderCount++;
-        }
+        const ShaderBinary* shaders[] = {
+            &pDesc->AS,
+            &pDesc->MS,
+            &pDesc->PS,
+        };
+        const VkShaderStageFlagBits stages[] = {
+            VK_SHADER_STAGE_TASK_BIT_NV,
+            VK_SHADER_STAGE_MESH_BIT_NV,
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+        };
 
-        if (pDesc->PS.pByteCode != nullptr && pDesc->PS.ByteCodeSize != 0)
+        for(auto i=0u; i<CountOf(shaders); ++i)
         {
-            auto ret = ToNativeShaderStageInfo(
-                pNativeDevice,
-                pDesc->PS,
-                VK_SHADER_STAGE_FRAGMENT_BIT,
-                &shaderInfos[shaderCount]);
-            A3D_ASSERT(ret == true);
-            A3D_UNUSED(ret);
-            shaderCount++;
-        }
+            if (shaders[i]->pByteCode == nullptr || shaders[i]->ByteCodeSize == 0)
+            { continue; }
 
-        VkDynamicState dynamicElements[] = {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR,
-            VK_DYNAMIC_STATE_BLEND_CONSTANTS,
-            VK_DYNAMIC_STATE_STENCIL_REFERENCE
-        };
+            if (!AddShaderStage(pNativeDevice, *shaders[i], stages[i]))
+            { return false; }
+        }
 
-        VkPipelineDynamicStateCreateInfo dynamicState = {};
-        dynamicState.sType              = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicState.pNext              = nullptr;
-        dynamicState.flags              = 0;
-        dynamicState.dynamicStateCount  = 4;
-        dynamicState.pDynamicStates     = dynamicElements;
-
-        VkViewport  viewports[16];
-        VkRect2D    scissors[16];
-
-        ToNativeRasterizationState(pDesc->RasterizerState,   &rasterizerState);
-        ToNativeMultisampleState  (pDesc->MultiSampleState,  &multisampleState);
-        ToNativeDepthState        (pDesc->DepthState,        &depthStencilState);
-        ToNativeStencilState      (pDesc->StencilState,      &depthStencilState);
-        ToNativeViewportState(viewports, scissors, &viewportState);
+        ToNativeRasterizationState(pDesc->RasterizerState,   &pInfo->RasterizerState);
+        ToNativeMultisampleState  (pDesc->MultiSampleState,  &pInfo->MultisampleState);
+        ToNativeDepthState        (pDesc->DepthState,        &pInfo->DepthStencilState);
+        ToNativeStencilState      (pDesc->StencilState,      &pInfo->DepthStencilState);
+        ToNativeViewportState(&pInfo->Viewport, &pInfo->Scissor, &pInfo->ViewportState);
         ToNativeColorBlendState(
             pDesc->BlendState,
             pDesc->ColorCount,
-            colorAttachments,
-            &colorBlendState );
+            pInfo->ColorAttachments,
+            &pInfo->ColorBlendState );
 
-        auto pWrapLayout = static_cast<DescriptorSetLayout*>(pDesc->pLayout);
-        A3D_ASSERT(pWrapLayout != nullptr);
+        // メッシュシェーダパイプラインでは頂点入力とテッセレーションは無視される.
+        SetupGraphicsCreateInfo(pDesc->pLayout);
+    }
+
+    return true;
+}
 
-        VkGraphicsPipelineCreateInfo info = {};
-        info.sType                  = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        info.pNext                  = nullptr;
-        info.flags                  = 0;
-        info.stageCount             = shaderCount;
-        info.pStages                = shaderInfos;
-        info.pVertexInputState      = &vertexInputState;
-        info.pInputAssemblyState    = &inputAssemblyState;
-        info.pTessellationState     = &tessellationState;
-        info.pViewportState         = &viewportState;
-        info.pRasterizationState    = &rasterizerState;
-        info.pMultisampleState      = &multisampleState;
-        info.pDepthStencilState     = &depthStencilState;
-        info.pColorBlendState       = &colorBlendState;
-        info.pDynamicState          = &dynamicState;
-        info.layout                 = pWrapLayout->GetVulkanPipelineLayout();
-        info.renderPass             = m_RenderPass;
-        info.subpass                = 0;
-        info.basePipelineHandle     = null_handle;
-        info.basePipelineIndex      = 0;
-       
-        auto ret = vkCreateGraphicsPipelines(pNativeDevice, m_PipelineCache, 1, &info, nullptr, &m_PipelineState);
-
-        // メモリを解放.
-        delete [] pBindingDescs;
-        delete [] pInputAttrs;
-
-        for(auto i=0; i<shaderCount; ++i)
+//-------------------------------------------------------------------------------------------------
+//      シェーダステージを追加します.
+//-------------------------------------------------------------------------------------------------
+bool PipelineState::AddShaderStage
+(
+    VkDevice                device,
+    const ShaderBinary&     binary,
+    VkShaderStageFlagBits   stage
+)
+{
+    auto pInfo = m_pBuildInfo;
+    A3D_ASSERT(pInfo != nullptr);
+
+    if (pInfo->ShaderCount >= CountOf(pInfo->ShaderInfos))
+    { return false; }
+
+    auto& shaderInfo = pInfo->ShaderInfos[pInfo->ShaderCount];
+    if (!ToNativeShaderStageInfo(device, binary, stage, &shaderInfo))
+    { return false; }
+
+    // エントリーポイント名はシェーダバイナリを指しているので複製しておく.
+    auto length = strlen(shaderInfo.pName);
+    auto pEntryPoint = new char[length + 1];
+    if (pEntryPoint == nullptr)
+    {
+        vkDestroyShaderModule(device, shaderInfo.module, nullptr);
+        shaderInfo.module = null_handle;
+        return false;
+    }
+
+    memcpy(pEntryPoint, shaderInfo.pName, length + 1);
+    shaderInfo.pName = pEntryPoint;
+
+    pInfo->pEntryPoints[pInfo->ShaderCount] = pEntryPoint;
+    pInfo->ShaderCount++;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      グラフィックスパイプライン生成情報を設定します.
+//-------------------------------------------------------------------------------------------------
+void PipelineState::SetupGraphicsCreateInfo(IDescriptorSetLayout* pLayout)
+{
+    auto pInfo = m_pBuildInfo;
+    A3D_ASSERT(pInfo != nullptr);
+
+    pInfo->pLayout = pLayout;
+    pInfo->pLayout->AddRef();
+
+    auto pWrapLayout = static_cast<DescriptorSetLayout*>(pLayout);
+    A3D_ASSERT(pWrapLayout != nullptr);
+
+    pInfo->DynamicElements[0] = VK_DYNAMIC_STATE_VIEWPORT;
+    pInfo->DynamicElements[1] = VK_DYNAMIC_STATE_SCISSOR;
+    pInfo->DynamicElements[2] = VK_DYNAMIC_STATE_BLEND_CONSTANTS;
+    pInfo->DynamicElements[3] = VK_DYNAMIC_STATE_STENCIL_REFERENCE;
+
+    pInfo->DynamicState.sType              = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    pInfo->DynamicState.pNext              = nullptr;
+    pInfo->DynamicState.flags              = 0;
+    pInfo->DynamicState.dynamicStateCount  = 4;
+    pInfo->DynamicState.pDynamicStates     = pInfo->DynamicElements;
+
+    auto& info = pInfo->GraphicsInfo;
+    info.sType                  = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    info.pNext                  = nullptr;
+    info.flags                  = 0;
+    info.stageCount             = pInfo->ShaderCount;
+    info.pStages                = pInfo->ShaderInfos;
+    info.pVertexInputState      = nullptr;
+    info.pInputAssemblyState    = nullptr;
+    info.pTessellationState     = nullptr;
+    info.pViewportState         = &pInfo->ViewportState;
+    info.pRasterizationState    = &pInfo->RasterizerState;
+    info.pMultisampleState      = &pInfo->MultisampleState;
+    info.pDepthStencilState     = &pInfo->DepthStencilState;
+    info.pColorBlendState       = &pInfo->ColorBlendState;
+    info.pDynamicState          = &pInfo->DynamicState;
+    info.layout                 = pWrapLayout->GetVulkanPipelineLayout();
+    info.renderPass             = m_RenderPass;
+    info.subpass                = 0;
+    info.basePipelineHandle     = null_handle;
+    info.basePipelineIndex      = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      生成情報を破棄します.
+//-------------------------------------------------------------------------------------------------
+void PipelineState::DestroyBuildInfo()
+{
+    if (m_pBuildInfo == nullptr)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    for(auto i=0u; i<m_pBuildInfo->ShaderCount; ++i)
+    {
+        if (m_pBuildInfo->ShaderInfos[i].module != null_handle)
         {
-            if (shaderInfos[i].module != VK_NULL_HANDLE)
-            {
-                vkDestroyShaderModule(pNativeDevice, shaderInfos[i].module, nullptr);
-                shaderInfos[i].module = VK_NULL_HANDLE;
-            }
+            vkDestroyShaderModule(pNativeDevice, m_pBuildInfo->ShaderInfos[i].module, nullptr);
+            m_pBuildInfo->ShaderInfos[i].module = null_handle;
         }
 
-        if ( ret != VK_SUCCESS )
-        { return false; }
+        delete [] m_pBuildInfo->pEntryPoints[i];
+        m_pBuildInfo->pEntryPoints[i] = nullptr;
     }
 
-    return true;
+    delete [] m_pBuildInfo->pBindingDescs;
+    delete [] m_pBuildInfo->pInputAttrs;
+
+    SafeRelease(m_pBuildInfo->pLayout);
+
+    delete m_pBuildInfo;
+    m_pBuildInfo = nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1087,6 +950,12 @@ void PipelineState::Term()
     if (m_pDevice == nullptr)
     { return; }
 
+    // 非同期生成中の場合は完了を待つ.
+    if (m_Status == STATUS_PENDING)
+    { m_pDevice->WaitPipelineCompile(this, UINT32_MAX); }
+
+    DestroyBuildInfo();
+
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT(pNativeDevice != null_handle);
 
@@ -1096,17 +965,8 @@ void PipelineState::Term()
         m_PipelineState = null_handle;
     }
 
-    if (m_PipelineCache != null_handle)
-    {
-        vkDestroyPipelineCache( pNativeDevice, m_PipelineCache, nullptr );
-        m_PipelineCache = null_handle;
-    }
-
-    if (m_RenderPass != null_handle)
-    {
-        vkDestroyRenderPass( pNativeDevice, m_RenderPass, nullptr );
-        m_RenderPass = null_handle;
-    }
+    // レンダーパスはキャッシュが所有しているので破棄しない.
+    m_RenderPass = null_handle;
 
     SafeRelease(m_pDevice);
 }
@@ -1148,22 +1008,28 @@ void PipelineState::GetDevice(IDevice** ppDevice)
 //-------------------------------------------------------------------------------------------------
 bool PipelineState::GetCachedBlob(IBlob** ppBlob)
 {
-    auto pNativeDevice = m_pDevice->GetVulkanDevice();
-    A3D_ASSERT(pNativeDevice != null_handle);
-
-    size_t  size  = 0;
-    void*   pData = nullptr;
-    auto ret = vkGetPipelineCacheData(pNativeDevice, m_PipelineCache, &size, pData);
-    if ( ret != VK_SUCCESS )
-    { return false; }
+    // パイプラインキャッシュはデバイスで共有しているので，デバイス全体のデータを返却する.
+    return m_pDevice->GetPipelineCacheBlob(ppBlob);
+}
 
-    if (!Blob::Create(size, ppBlob))
-    { return false; }
+//-------------------------------------------------------------------------------------------------
+//      パイプラインステートの生成処理が完了しているかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool PipelineState::IsReady() const
+{ return m_Status == STATUS_READY || m_Status == STATUS_FAILED; }
 
-    void* pPtr = (*ppBlob)->GetBufferPointer();
-    memcpy(pPtr, pData, size);
+//-------------------------------------------------------------------------------------------------
+//      パイプラインステートの生成完了を待機します.
+//-------------------------------------------------------------------------------------------------
+bool PipelineState::Wait(uint32_t timeoutMsec)
+{
+    if (!IsReady())
+    {
+        if (!m_pDevice->WaitPipelineCompile(this, timeoutMsec))
+        { return false; }
+    }
 
-    return true;
+    return m_Status == STATUS_READY;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1178,6 +1044,94 @@ VkPipeline PipelineState::GetVulkanPipeline() const
 VkPipelineBindPoint PipelineState::GetVulkanPipelineBindPoint() const
 { return m_BindPoint; }
 
+//-------------------------------------------------------------------------------------------------
+//      パイプラインをまとめてコンパイルします.
+//-------------------------------------------------------------------------------------------------
+void PipelineState::Compile(PipelineState** ppStates, uint32_t count)
+{
+    if (ppStates == nullptr || count == 0)
+    { return; }
+
+    auto pDevice = ppStates[0]->m_pDevice;
+    A3D_ASSERT(pDevice != nullptr);
+
+    auto pNativeDevice = pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    auto pipelineCache = pDevice->GetVulkanPipelineCache();
+
+    VkGraphicsPipelineCreateInfo    graphicsInfos   [MaxCompileBatchCount];
+    PipelineState*                  graphicsStates  [MaxCompileBatchCount];
+    VkPipeline                      graphicsPipes   [MaxCompileBatchCount];
+    VkComputePipelineCreateInfo     computeInfos    [MaxCompileBatchCount];
+    PipelineState*                  computeStates   [MaxCompileBatchCount];
+    VkPipeline                      computePipes    [MaxCompileBatchCount];
+
+    for(auto offset=0u; offset<count; offset+=MaxCompileBatchCount)
+    {
+        auto batchCount    = count - offset;
+        if (batchCount > MaxCompileBatchCount)
+        { batchCount = MaxCompileBatchCount; }
+
+        auto graphicsCount = 0u;
+        auto computeCount  = 0u;
+
+        // バインドポイントごとに振り分ける.
+        for(auto i=0u; i<batchCount; ++i)
+        {
+            auto pState = ppStates[offset + i];
+            A3D_ASSERT(pState->m_pBuildInfo != nullptr);
+            A3D_ASSERT(pState->m_pDevice == pDevice);
+
+            if (pState->m_BindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+            {
+                computeInfos [computeCount] = pState->m_pBuildInfo->ComputeInfo;
+                computeStates[computeCount] = pState;
+                computePipes [computeCount] = null_handle;
+                computeCount++;
+            }
+            else
+            {
+                graphicsInfos [graphicsCount] = pState->m_pBuildInfo->GraphicsInfo;
+                graphicsStates[graphicsCount] = pState;
+                graphicsPipes [graphicsCount] = null_handle;
+                graphicsCount++;
+            }
+        }
+
+        // 1回の呼び出しでまとめて生成する.
+        // 一部の生成に失敗した場合, 失敗したパイプラインには VK_NULL_HANDLE が格納される.
+        // 生成同士は並行してよいが, キャッシュのマージとは排他にする.
+        {
+            std::shared_lock<std::shared_mutex> locker(pDevice->GetPipelineCacheMutex());
+
+            if (graphicsCount > 0)
+            { vkCreateGraphicsPipelines(pNativeDevice, pipelineCache, graphicsCount, graphicsInfos, nullptr, graphicsPipes); }
+
+            if (computeCount > 0)
+            { vkCreateComputePipelines(pNativeDevice, pipelineCache, computeCount, computeInfos, nullptr, computePipes); }
+        }
+
+        for(auto i=0u; i<graphicsCount; ++i)
+        { graphicsStates[i]->Complete(graphicsPipes[i]); }
+
+        for(auto i=0u; i<computeCount; ++i)
+        { computeStates[i]->Complete(computePipes[i]); }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      生成処理を完了します.
+//-------------------------------------------------------------------------------------------------
+void PipelineState::Complete(VkPipeline pipeline)
+{
+    m_PipelineState = pipeline;
+    DestroyBuildInfo();
+
+    // 待機側がこのオブジェクトを破棄する可能性があるため，状態の更新は最後に行うこと.
+    m_Status = (pipeline != null_handle) ? STATUS_READY : STATUS_FAILED;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      グラフィクスパイプランステートとして生成します.
 //-------------------------------------------------------------------------------------------------
@@ -1201,6 +1155,13 @@ bool PipelineState::CreateAsGraphics
         return false;
     }
 
+    Compile(&instance, 1);
+    if (instance->m_Status != STATUS_READY)
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
     *ppPipelineState = instance;
     return true;
 }
@@ -1228,6 +1189,13 @@ bool PipelineState::CreateAsCompute
         return false;
     }
 
+    Compile(&instance, 1);
+    if (instance->m_Status != STATUS_READY)
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
     *ppPipelineState = instance;
     return true;
 }
@@ -1255,9 +1223,96 @@ bool PipelineState::CreateAsGeometry
         return false;
     }
 
+    Compile(&instance, 1);
+    if (instance->m_Status != STATUS_READY)
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
     *ppPipelineState = instance;
     return true;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      グラフィックスパイプラインステートとして非同期生成を要求します.
+//-------------------------------------------------------------------------------------------------
+bool PipelineState::CreateAsGraphicsAsync
+(
+    IDevice*                            pDevice,
+    const GraphicsPipelineStateDesc*    pDesc,
+    PipelineState**                     ppPipelineState
+)
+{
+    if (pDevice == nullptr || pDesc == nullptr || ppPipelineState == nullptr)
+    { return false; }
+
+    auto instance = new PipelineState;
+    if (instance == nullptr)
+    { return false; }
+
+    if (!instance->InitAsGraphics(pDevice, pDesc))
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
+    *ppPipelineState = instance;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      コンピュートパイプラインステートとして非同期生成を要求します.
+//-------------------------------------------------------------------------------------------------
+bool PipelineState::CreateAsComputeAsync
+(
+    IDevice*                        pDevice,
+    const ComputePipelineStateDesc* pDesc,
+    PipelineState**                 ppPipelineState
+)
+{
+    if (pDevice == nullptr || pDesc == nullptr || ppPipelineState == nullptr)
+    { return false; }
+
+    auto instance = new PipelineState;
+    if (instance == nullptr)
+    { return false; }
+
+    if (!instance->InitAsCompute(pDevice, pDesc))
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
+    *ppPipelineState = instance;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ジオメトリパイプラインステートとして非同期生成を要求します.
+//-------------------------------------------------------------------------------------------------
+bool PipelineState::CreateAsGeometryAsync
+(
+    IDevice*                            pDevice,
+    const GeometryPipelineStateDesc*    pDesc,
+    PipelineState**                     ppPipelineState
+)
+{
+    if (pDevice == nullptr || pDesc == nullptr || ppPipelineState == nullptr)
+    { return false; }
+
+    auto instance = new PipelineState;
+    if (instance == nullptr)
+    { return false; }
+
+    if (!instance->InitAsGeometry(pDevice, pDesc))
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
+    *ppPipelineState = instance;
+    return true;
+}
 
 } // namespace a3d
@@ -16,13 +16,13 @@ class A3D_API PipelineState : public IPipelineState, public BaseAllocator
     //=============================================================================================
     // list of friend classes and methods.
     //=============================================================================================
-    /* NOTHING */
+    friend class PipelineCompiler;
 
 public:
     //=============================================================================================
     // public variables.
     //=============================================================================================
-    /* NOTHING */
+    static const uint32_t   MaxCompileBatchCount = 16;      //!< 1回の生成呼び出しでまとめる最大パイプライン数です.
 
     //=============================================================================================
     // public methods.
@@ -68,6 +68,61 @@ public:
         const GeometryPipelineStateDesc*    pDesc,
         IPipelineState**                    ppPipelineState);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      グラフィックスパイプラインとして非同期生成用に生成します.
+    //!
+    //! @param[in]      pDevice             デバイスです.
+    //! @param[in]      pDesc               構成設定です.
+    //! @param[out]     ppPipelineState     パイプラインステートの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //! @note       生成情報の構築のみを行います. パイプラインの生成は Compile() で行います.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY CreateAsGraphicsAsync(
+        IDevice*                            pDevice,
+        const GraphicsPipelineStateDesc*    pDesc,
+        PipelineState**                     ppPipelineState);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンピュートパイプラインとして非同期生成用に生成します.
+    //!
+    //! @param[in]      pDevice             デバイスです.
+    //! @param[in]      pDesc               構成設定です.
+    //! @param[out]     ppPipelineState     パイプラインステートの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //! @note       生成情報の構築のみを行います. パイプラインの生成は Compile() で行います.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY CreateAsComputeAsync(
+        IDevice*                            pDevice,
+        const ComputePipelineStateDesc*     pDesc,
+        PipelineState**                     ppPipelineState);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ジオメトリパイプラインとして非同期生成用に生成します.
+    //!
+    //! @param[in]      pDevice             デバイスです.
+    //! @param[in]      pDesc               構成設定です.
+    //! @param[out]     ppPipelineState     パイプラインステートの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //! @note       生成情報の構築のみを行います. パイプラインの生成は Compile() で行います.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY CreateAsGeometryAsync(
+        IDevice*                            pDevice,
+        const GeometryPipelineStateDesc*    pDesc,
+        PipelineState**                     ppPipelineState);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインをまとめて生成します.
+    //!
+    //! @param[in]      ppStates        生成するパイプラインステートの配列です.
+    //! @param[in]      count           パイプラインステート数です.
+    //! @note       バインドポイントごとに最大 MaxCompileBatchCount 個ずつ,
+    //!             1回の vkCreate*Pipelines() 呼び出しにまとめて生成します.
+    //---------------------------------------------------------------------------------------------
+    static void A3D_APIENTRY Compile(PipelineState** ppStates, uint32_t count);
+
     //---------------------------------------------------------------------------------------------
     //! @brief      参照カウントを増やします.
     //---------------------------------------------------------------------------------------------
@@ -101,6 +156,23 @@ public:
     //---------------------------------------------------------------------------------------------
     bool A3D_APIENTRY GetCachedBlob(IBlob** ppBlob) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインステートの生成処理が完了しているかどうかチェックします.
+    //!
+    //! @retval true    生成処理が完了しています.
+    //! @retval false   生成処理中です.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY IsReady() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パイプラインステートの生成完了を待機します.
+    //!
+    //! @param[in]      timeoutMsec     タイムアウト時間(ミリ秒)です.
+    //! @retval true    生成に成功.
+    //! @retval false   タイムアウトしたか，生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Wait(uint32_t timeoutMsec) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      パイプラインステートを取得します.
     //!
@@ -116,6 +188,22 @@ public:
     VkPipelineBindPoint A3D_APIENTRY GetVulkanPipelineBindPoint() const;
 
 private:
+    //=============================================================================================
+    // private structures.
+    //=============================================================================================
+    struct BuildInfo;
+
+    //=============================================================================================
+    // private constants.
+    //=============================================================================================
+    enum STATUS
+    {
+        STATUS_NONE     = 0,    //!< 生成要求前です.
+        STATUS_PENDING,         //!< 生成待ちです.
+        STATUS_READY,           //!< 生成済みです.
+        STATUS_FAILED,          //!< 生成に失敗しました.
+    };
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
@@ -123,8 +211,9 @@ private:
     Device*                 m_pDevice;              //!< デバイスです.
     VkPipeline              m_PipelineState;        //!< パイプラインステートです.
     VkPipelineBindPoint     m_BindPoint;            //!< バインドポイントです.
-    VkPipelineCache         m_PipelineCache;        //!< パイプラインキャッシュです.
-    VkRenderPass            m_RenderPass;           //!< レンダーパスです.
+    VkRenderPass            m_RenderPass;           //!< レンダーパスです. デバイスのキャッシュが所有します.
+    std::atomic<uint32_t>   m_Status;               //!< 生成状態です.
+    BuildInfo*              m_pBuildInfo;           //!< 生成情報です(生成完了後に破棄されます).
 
     //=============================================================================================
     // private methods.
@@ -175,6 +264,39 @@ private:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Term();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      シェーダステージを追加します.
+    //!
+    //! @param[in]      device          デバイスです.
+    //! @param[in]      binary          シェーダバイナリです.
+    //! @param[in]      stage           シェーダステージです.
+    //! @retval true    追加に成功.
+    //! @retval false   追加に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY AddShaderStage(
+        VkDevice                device,
+        const ShaderBinary&     binary,
+        VkShaderStageFlagBits   stage);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      グラフィックスパイプライン生成情報を設定します.
+    //!
+    //! @param[in]      pLayout         ディスクリプタセットレイアウトです.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY SetupGraphicsCreateInfo(IDescriptorSetLayout* pLayout);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      生成情報を破棄します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY DestroyBuildInfo();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      生成処理を完了します.
+    //!
+    //! @param[in]      pipeline        生成したパイプラインです. 失敗した場合は null_handle です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Complete(VkPipeline pipeline);
+
     PipelineState   (const PipelineState&) = delete;
     void operator = (const PipelineState&) = delete;
 };
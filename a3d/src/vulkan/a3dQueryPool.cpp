@@ -136,6 +136,119 @@ void QueryPool::GetDevice(IDevice** ppDevice)
 QueryPoolDesc QueryPool::GetDesc() const
 { return m_Desc; }
 
+//-------------------------------------------------------------------------------------------------
+//      GPUへのコピーを介さずにクエリ結果を取得します.
+//-------------------------------------------------------------------------------------------------
+bool QueryPool::GetResults
+(
+    uint32_t    startIndex,
+    uint32_t    queryCount,
+    size_t      dataSize,
+    void*       pData,
+    uint32_t    flags
+)
+{
+    if (pData == nullptr || queryCount == 0 || startIndex + queryCount > m_Desc.Count)
+    { return false; }
+
+    auto withAvailability = (flags & QUERY_RESULT_FLAG_WITH_AVAILABILITY) != 0;
+    auto partial          = (flags & QUERY_RESULT_FLAG_PARTIAL) != 0;
+
+    // タイムスタンプには途中の値が存在しないため VK_QUERY_RESULT_PARTIAL_BIT は指定できない.
+    if (partial && m_Type == VK_QUERY_TYPE_TIMESTAMP)
+    { return false; }
+
+    auto stride = size_t(GetResultSize());
+    if (withAvailability)
+    { stride += sizeof(uint64_t); }
+
+    if (dataSize < stride * queryCount)
+    { return false; }
+
+    VkQueryResultFlags nativeFlags = VK_QUERY_RESULT_64_BIT;
+    if (flags & QUERY_RESULT_FLAG_WAIT)
+    { nativeFlags |= VK_QUERY_RESULT_WAIT_BIT; }
+    if (withAvailability)
+    { nativeFlags |= VK_QUERY_RESULT_WITH_AVAILABILITY_BIT; }
+    if (partial)
+    { nativeFlags |= VK_QUERY_RESULT_PARTIAL_BIT; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != VK_NULL_HANDLE);
+
+    if (m_Type != VK_QUERY_TYPE_PIPELINE_STATISTICS)
+    {
+        auto ret = vkGetQueryPoolResults(
+            pNativeDevice,
+            m_Pool,
+            startIndex,
+            queryCount,
+            dataSize,
+            pData,
+            stride,
+            nativeFlags);
+
+        return ret == VK_SUCCESS;
+    }
+
+    // パイプライン統計は PipelineStatistics よりも返却される値が少ないため，1つずつ詰め替える.
+    const uint32_t NativeValueCount = 11;
+
+    auto pDst   = static_cast<uint8_t*>(pData);
+    auto result = true;
+
+    for(auto i=0u; i<queryCount; ++i)
+    {
+        uint64_t values[NativeValueCount + 1] = {};
+
+        auto ret = vkGetQueryPoolResults(
+            pNativeDevice,
+            m_Pool,
+            startIndex + i,
+            1,
+            sizeof(values),
+            values,
+            sizeof(values),
+            nativeFlags);
+
+        if (ret != VK_SUCCESS)
+        {
+            if (ret != VK_NOT_READY)
+            { return false; }
+
+            result = false;
+
+            // 値が書き込まれていないので詰め替えない.
+            if (!withAvailability && !partial)
+            {
+                pDst += stride;
+                continue;
+            }
+        }
+
+        PipelineStatistics stats = {};
+        memcpy(&stats, values, sizeof(uint64_t) * NativeValueCount);
+        memcpy(pDst, &stats, sizeof(stats));
+
+        if (withAvailability)
+        { memcpy(pDst + sizeof(stats), &values[NativeValueCount], sizeof(uint64_t)); }
+
+        pDst += stride;
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      クエリ1つあたりの結果のサイズを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t QueryPool::GetResultSize() const
+{
+    return (m_Type == VK_QUERY_TYPE_PIPELINE_STATISTICS)
+        ? uint32_t(sizeof(PipelineStatistics))
+        : uint32_t(sizeof(uint64_t));
+}
+
 //-------------------------------------------------------------------------------------------------
 //      クエリプールを取得します.
 //-------------------------------------------------------------------------------------------------
@@ -73,6 +73,31 @@ public:
     //---------------------------------------------------------------------------------------------
     QueryPoolDesc A3D_APIENTRY GetDesc() const override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      GPUへのコピーを介さずにクエリ結果を取得します.
+    //!
+    //! @param[in]      startIndex      取得するクエリのオフセットです.
+    //! @param[in]      queryCount      取得するクエリ数です.
+    //! @param[in]      dataSize        書き込み先のサイズです(バイト単位).
+    //! @param[out]     pData           書き込み先です.
+    //! @param[in]      flags           QUERY_RESULT_FLAG の組み合わせです.
+    //! @retval true    全ての結果が揃っています.
+    //! @retval false   揃っていない結果があるか，引数が不正です.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY GetResults(
+        uint32_t    startIndex,
+        uint32_t    queryCount,
+        size_t      dataSize,
+        void*       pData,
+        uint32_t    flags) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      クエリ1つあたりの結果のサイズを取得します.
+    //!
+    //! @return     クエリ1つあたりの結果のサイズを返却します(バイト単位).
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetResultSize() const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      クエリプールを取得します.
     //!
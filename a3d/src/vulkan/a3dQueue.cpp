@@ -19,17 +19,41 @@ Queue::Queue()
 , m_pDevice             (nullptr)
 , m_Queue               (null_handle)
 , m_SubmitIndex         (0)
+, m_CommitCount         (0)
+, m_pSubmitEntry        (nullptr)
 , m_pSubmitList         (nullptr)
 , m_FamilyIndex         (0)
 , m_MaxSubmitCount      (0)
+, m_SubmitValue         (0)
+, m_CompletedValue      (0)
+, m_FrameCount          (DefaultFrameCount)
+, m_AcquirePending      (false)
+, m_PresentPending      (false)
 , m_CurrentBufferIndex  (0)
 , m_PreviousBufferIndex (0)
+, m_TimelineWaitCount   (0)
+, m_TrackHead           (0)
+, m_TrackCount          (0)
 {
-    for(auto i=0u; i<MaxBufferCount; ++i)
+    for(auto i=0u; i<MaxFrameCount; ++i)
     {
         m_WaitSemaphore[i]   = null_handle;
         m_SignalSemaphore[i] = null_handle;
         m_Fence[i]           = null_handle;
+        m_FenceActive[i]     = false;
+        m_FenceValue[i]      = 0;
+    }
+
+    for(auto i=0u; i<MaxTimelineWaitCount; ++i)
+    {
+        m_TimelineWait[i]      = null_handle;
+        m_TimelineWaitValue[i] = 0;
+    }
+
+    for(auto i=0u; i<MaxTrackFenceCount; ++i)
+    {
+        m_TrackFence[i] = null_handle;
+        m_TrackValue[i] = 0;
     }
 }
 
@@ -66,7 +90,7 @@ bool Queue::Init
         info.pNext = nullptr;
         info.flags = 0;
 
-        for(auto i=0u; i<MaxBufferCount; ++i)
+        for(auto i=0u; i<MaxFrameCount; ++i)
         {
             auto ret = vkCreateSemaphore( pNativeDevice, &info, nullptr, &m_SignalSemaphore[i]);
             if ( ret != VK_SUCCESS )
@@ -84,7 +108,7 @@ bool Queue::Init
         info.pNext = nullptr;
         info.flags = 0;
 
-        for(auto i=0; i<MaxBufferCount; ++i)
+        for(auto i=0u; i<MaxFrameCount; ++i)
         {
             auto ret = vkCreateFence( pNativeDevice, &info, nullptr, &m_Fence[i]);
             if ( ret != VK_SUCCESS )
@@ -95,7 +119,19 @@ bool Queue::Init
             {
                 info.flags = 0;
             }
+
+            m_FenceActive[i] = false;
         }
+
+        for(auto i=0u; i<MaxTrackFenceCount; ++i)
+        {
+            auto ret = vkCreateFence( pNativeDevice, &info, nullptr, &m_TrackFence[i]);
+            if ( ret != VK_SUCCESS )
+            { return false; }
+        }
+
+        m_TrackHead  = 0;
+        m_TrackCount = 0;
     }
 
     vkGetDeviceQueue(pNativeDevice, familyIndex, queueIndex, &m_Queue);
@@ -103,14 +139,27 @@ bool Queue::Init
     m_MaxSubmitCount = maxSubmitCount;
     m_FamilyIndex    = familyIndex;
 
-    m_pSubmitList = new VkCommandBuffer[maxSubmitCount];
+    // 追跡対象リソースの補正用コマンドバッファも含めるため2倍確保する.
+    m_pSubmitList = new VkCommandBuffer[maxSubmitCount * 2];
     if (m_pSubmitList == nullptr)
     { return false; }
 
-    for(auto i=0u; i<maxSubmitCount; ++i)
+    m_pSubmitEntry = new SubmitEntry[maxSubmitCount];
+    if (m_pSubmitEntry == nullptr)
+    { return false; }
+
+    for(auto i=0u; i<maxSubmitCount * 2; ++i)
     { m_pSubmitList[i] = null_handle; }
 
+    for(auto i=0u; i<maxSubmitCount; ++i)
+    {
+        m_pSubmitEntry[i].SortKey       = 0;
+        m_pSubmitEntry[i].Order         = 0;
+        m_pSubmitEntry[i].pCommandList  = nullptr;
+    }
+
     m_SubmitIndex = 0;
+    m_CommitCount = 0;
     m_CurrentBufferIndex  = 0;
     m_PreviousBufferIndex = 0;
 
@@ -132,7 +181,7 @@ void Queue::Term()
     if (m_Queue != null_handle)
     { vkQueueWaitIdle( m_Queue ); }
 
-    for(auto i=0u; i<MaxBufferCount; ++i)
+    for(auto i=0u; i<MaxFrameCount; ++i)
     {
         if (m_SignalSemaphore[i] != null_handle)
         {
@@ -153,16 +202,36 @@ void Queue::Term()
         }
     }
 
+    for(auto i=0u; i<MaxTrackFenceCount; ++i)
+    {
+        if (m_TrackFence[i] != null_handle)
+        {
+            vkDestroyFence(pNativeDevice, m_TrackFence[i], nullptr);
+            m_TrackFence[i] = null_handle;
+        }
+    }
+
+    m_TrackHead  = 0;
+    m_TrackCount = 0;
+
     if (m_pSubmitList != nullptr)
     {
         delete [] m_pSubmitList;
         m_pSubmitList = nullptr;
     }
 
-    m_SubmitIndex    = 0;
-    m_MaxSubmitCount = 0;
-    m_FamilyIndex    = 0;
-    m_Queue          = null_handle;
+    if (m_pSubmitEntry != nullptr)
+    {
+        delete [] m_pSubmitEntry;
+        m_pSubmitEntry = nullptr;
+    }
+
+    m_SubmitIndex       = 0;
+    m_CommitCount       = 0;
+    m_TimelineWaitCount = 0;
+    m_MaxSubmitCount    = 0;
+    m_FamilyIndex       = 0;
+    m_Queue             = null_handle;
     SafeRelease( m_pDevice );
 }
 
@@ -202,19 +271,38 @@ void Queue::GetDevice(IDevice** ppDevice)
 //      コマンドリストを登録します.
 //-------------------------------------------------------------------------------------------------
 bool Queue::Submit(ICommandList* pCommandList)
-{
-    std::lock_guard<std::mutex> locker(m_Mutex);
+{ return Submit(pCommandList, 0); }
 
-    if (m_SubmitIndex + 1 >= m_MaxSubmitCount)
+//-------------------------------------------------------------------------------------------------
+//      ソートキーを指定してコマンドリストを登録します.
+//-------------------------------------------------------------------------------------------------
+bool Queue::Submit(ICommandList* pCommandList, uint64_t sortKey)
+{
+    auto pWrapList = static_cast<CommandList*>(pCommandList);
+    if (pWrapList == nullptr)
     { return false; }
 
-    auto pWrapList = static_cast<CommandList*>(pCommandList);
-    A3D_ASSERT( pWrapList != nullptr );
+    // ロックを取らずにスロットを予約する.
+    // 溢れた分を後から取り消すと Execute() のリセットと競合するので, 上限未満の場合のみ進める.
+    auto index = m_SubmitIndex.load(std::memory_order_relaxed);
+    do
+    {
+        if (index >= m_MaxSubmitCount)
+        {
+            // 黙って捨てると描画が欠けるだけで原因が分からないので，デバッグ時は止める.
+            A3D_ASSERT(index < m_MaxSubmitCount);
+            return false;
+        }
+    }
+    while (!m_SubmitIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
 
-    auto pNativeCommandBuffer = pWrapList->GetVulkanCommandBuffer();
+    auto& entry = m_pSubmitEntry[index];
+    entry.SortKey       = sortKey;
+    entry.Order         = index;
+    entry.pCommandList  = pWrapList;
 
-    m_pSubmitList[m_SubmitIndex] = pNativeCommandBuffer;
-    m_SubmitIndex++;
+    // 書き込み完了を Execute() に公開する.
+    m_CommitCount.fetch_add(1, std::memory_order_release);
     return true;
 }
 
@@ -223,51 +311,255 @@ bool Queue::Submit(ICommandList* pCommandList)
 //-------------------------------------------------------------------------------------------------
 void Queue::Execute(IFence* pFence)
 {
-    VkPipelineStageFlags stageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    auto count = m_SubmitIndex.load(std::memory_order_acquire);
+    if (count > m_MaxSubmitCount)
+    { count = m_MaxSubmitCount; }
+
+    // 予約済みで書き込み途中のエントリーがあれば完了を待つ.
+    while (m_CommitCount.load(std::memory_order_acquire) < count)
+    { std::this_thread::yield(); }
+
+    // ソートキー順に並べ替える. 同じキーの場合は登録順を保つ.
+    for(auto i=1u; i<count; ++i)
+    {
+        auto entry = m_pSubmitEntry[i];
+        auto j = i;
+        while (j > 0)
+        {
+            auto& prev = m_pSubmitEntry[j - 1];
+            if (prev.SortKey < entry.SortKey
+            || (prev.SortKey == entry.SortKey && prev.Order < entry.Order))
+            { break; }
+
+            m_pSubmitEntry[j] = prev;
+            j--;
+        }
+        m_pSubmitEntry[j] = entry;
+    }
+
+    // 追跡対象リソースの状態は実行順に解決し，必要な補正バリアを直前に挟む.
+    auto commandBufferCount = 0u;
+    for(auto i=0u; i<count; ++i)
+    {
+        auto pCommandList = m_pSubmitEntry[i].pCommandList;
+
+        auto fixupCommandBuffer = pCommandList->ResolveTrackedState();
+        if (fixupCommandBuffer != null_handle)
+        {
+            m_pSubmitList[commandBufferCount] = fixupCommandBuffer;
+            commandBufferCount++;
+        }
+
+        m_pSubmitList[commandBufferCount] = pCommandList->GetVulkanCommandBuffer();
+        commandBufferCount++;
+    }
+
+    VkSemaphore          waitSemaphores[MaxTimelineWaitCount + 1];
+    VkPipelineStageFlags waitStages    [MaxTimelineWaitCount + 1];
+    uint64_t             waitValues    [MaxTimelineWaitCount + 1];
+    uint32_t             waitCount = 0;
 
     VkFence nativeFence = VK_NULL_HANDLE;
-    VkSubmitInfo info = {};
+
+    // スワップチェインのイメージを取得済みであれば，フェンス付きの実行をフレームの提出として扱う.
+    auto isFrameSubmit = ( pFence != nullptr && m_AcquirePending );
 
     if ( pFence != nullptr )
     {
-        info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        info.pNext                  = nullptr;
-        info.pCommandBuffers        = m_pSubmitList;
-        info.commandBufferCount     = m_SubmitIndex;
-        info.waitSemaphoreCount     = 1;
-        info.pWaitSemaphores        = &m_WaitSemaphore[m_CurrentBufferIndex];
-        info.pWaitDstStageMask      = &stageMask;
-        info.signalSemaphoreCount   = 0;
-        info.pSignalSemaphores      = nullptr;
-
         auto pWrapFence = reinterpret_cast<Fence*>(pFence);
         A3D_ASSERT(pWrapFence != nullptr);
 
         nativeFence = pWrapFence->GetVulkanFence();
     }
-    else
+
+    // フレームの提出以外はフレームスロットのフェンスで完了を検出できないので，追跡用のフェンスを付ける.
+    // 空きが無い場合は追跡しないが，後続のサブミットの完了で合わせて完了扱いになる.
+    auto    trackIndex = 0u;
+    VkFence trackFence = VK_NULL_HANDLE;
+    if ( !isFrameSubmit )
     {
-        info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        info.pNext                  = nullptr;
-        info.pCommandBuffers        = m_pSubmitList;
-        info.commandBufferCount     = m_SubmitIndex;
-        info.waitSemaphoreCount     = 0;
-        info.pWaitSemaphores        = nullptr;
-        info.pWaitDstStageMask      = &stageMask;
-        info.signalSemaphoreCount   = 0;
-        info.pSignalSemaphores      = nullptr;
+        std::lock_guard<std::mutex> locker(m_TrackMutex);
+        PollTrackFence();
+
+        if (m_TrackCount < MaxTrackFenceCount)
+        {
+            trackIndex = (m_TrackHead + m_TrackCount) % MaxTrackFenceCount;
+            trackFence = m_TrackFence[trackIndex];
+        }
     }
- 
-    auto ret = vkQueueSubmit( m_Queue, 1, &info, nativeFence );
+
+    if ( isFrameSubmit )
+    {
+        waitSemaphores[waitCount] = m_WaitSemaphore[m_CurrentBufferIndex];
+        waitStages    [waitCount] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        waitValues    [waitCount] = 0;  // バイナリセマフォなので無視される.
+        waitCount++;
+    }
+
+    // 他のキューとの依存関係.
+    for(auto i=0u; i<m_TimelineWaitCount; ++i)
+    {
+        waitSemaphores[waitCount] = m_TimelineWait[i];
+        waitStages    [waitCount] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        waitValues    [waitCount] = m_TimelineWaitValue[i];
+        waitCount++;
+    }
+
+    VkSubmitInfo info = {};
+    info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    info.pNext                  = nullptr;
+    info.pCommandBuffers        = m_pSubmitList;
+    info.commandBufferCount     = commandBufferCount;
+    info.waitSemaphoreCount     = waitCount;
+    info.pWaitSemaphores        = (waitCount > 0) ? waitSemaphores : nullptr;
+    info.pWaitDstStageMask      = (waitCount > 0) ? waitStages : nullptr;
+    info.signalSemaphoreCount   = 0;
+    info.pSignalSemaphores      = nullptr;
+
+    // 表示が描画の完了を待てるようにシグナルする.
+    uint64_t signalValue = 0;   // バイナリセマフォなので無視される.
+    if ( isFrameSubmit )
+    {
+        info.signalSemaphoreCount   = 1;
+        info.pSignalSemaphores      = &m_SignalSemaphore[m_CurrentBufferIndex];
+    }
+
+#if defined(VK_KHR_timeline_semaphore)
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+    if (m_TimelineWaitCount > 0)
+    {
+        timelineInfo.sType                      = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timelineInfo.pNext                      = nullptr;
+        timelineInfo.waitSemaphoreValueCount    = waitCount;
+        timelineInfo.pWaitSemaphoreValues       = waitValues;
+        timelineInfo.signalSemaphoreValueCount  = info.signalSemaphoreCount;
+        timelineInfo.pSignalSemaphoreValues     = (info.signalSemaphoreCount > 0) ? &signalValue : nullptr;
+
+        info.pNext = &timelineInfo;
+    }
+#endif
+
+    // ユーザーのフェンスが無ければ追跡用のフェンスで直接シグナルする.
+    auto ret = vkQueueSubmit( m_Queue, 1, &info, (nativeFence != VK_NULL_HANDLE) ? nativeFence : trackFence );
     A3D_ASSERT( ret == VK_SUCCESS );
     A3D_UNUSED( ret );
 
+    auto submitValue = m_SubmitValue.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    if ( trackFence != VK_NULL_HANDLE )
+    {
+        // ユーザーのフェンスは待機時にリセットされるため，空のサブミットで追跡用のフェンスもシグナルする.
+        if ( nativeFence != VK_NULL_HANDLE )
+        {
+            ret = vkQueueSubmit( m_Queue, 0, nullptr, trackFence );
+            A3D_ASSERT( ret == VK_SUCCESS );
+        }
+
+        std::lock_guard<std::mutex> locker(m_TrackMutex);
+        m_TrackValue[trackIndex] = submitValue;
+        m_TrackCount++;
+    }
+
+    if ( isFrameSubmit )
+    {
+        // 空のサブミットでフレームスロットのフェンスをシグナルし，スロット再利用時の待機に使う.
+        ret = vkQueueSubmit( m_Queue, 0, nullptr, m_Fence[m_CurrentBufferIndex] );
+        A3D_ASSERT( ret == VK_SUCCESS );
+
+        m_FenceActive[m_CurrentBufferIndex] = true;
+        m_FenceValue [m_CurrentBufferIndex] = submitValue;
+        m_AcquirePending = false;
+        m_PresentPending = true;
+    }
+
     // 実行したら戻す.
-    m_SubmitIndex = 0;
+    m_CommitCount.store(0, std::memory_order_relaxed);
+    m_SubmitIndex.store(0, std::memory_order_release);
+    m_TimelineWaitCount = 0;
+}
 
-    // バッファリング.
-    m_PreviousBufferIndex = m_CurrentBufferIndex;
-    m_CurrentBufferIndex  = (m_CurrentBufferIndex + 1) % MaxBufferCount;
+//-------------------------------------------------------------------------------------------------
+//      フェンスのタイムライン値が指定値に達するまでGPU側で待機させます.
+//-------------------------------------------------------------------------------------------------
+bool Queue::Wait(IFence* pFence, uint64_t value)
+{
+    auto pWrapFence = static_cast<Fence*>(pFence);
+    if (pWrapFence == nullptr)
+    { return false; }
+
+    auto semaphore = pWrapFence->GetVulkanTimelineSemaphore();
+    if (semaphore == null_handle)
+    { return false; }
+
+    // 同じフェンスへの待機は大きい方の値だけ待てばよい.
+    for(auto i=0u; i<m_TimelineWaitCount; ++i)
+    {
+        if (m_TimelineWait[i] == semaphore)
+        {
+            if (m_TimelineWaitValue[i] < value)
+            { m_TimelineWaitValue[i] = value; }
+            return true;
+        }
+    }
+
+    if (m_TimelineWaitCount >= MaxTimelineWaitCount)
+    { return false; }
+
+    m_TimelineWait     [m_TimelineWaitCount] = semaphore;
+    m_TimelineWaitValue[m_TimelineWaitCount] = value;
+    m_TimelineWaitCount++;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      それまでに実行したコマンドリストの完了時にフェンスのタイムライン値をシグナルします.
+//-------------------------------------------------------------------------------------------------
+bool Queue::Signal(IFence* pFence, uint64_t value)
+{
+    auto pWrapFence = static_cast<Fence*>(pFence);
+    if (pWrapFence == nullptr)
+    { return false; }
+
+    auto semaphore = pWrapFence->GetVulkanTimelineSemaphore();
+    if (semaphore == null_handle)
+    { return false; }
+
+#if defined(VK_KHR_timeline_semaphore)
+    // コマンドバッファを持たないバッチでシグナルする.
+    // シグナル操作は先行してサブミットされた全コマンドの完了後に行われる.
+    // 登録済みの待機は次回の Execute() でも必要なので，ここでは消費しない.
+    VkPipelineStageFlags waitStages[MaxTimelineWaitCount];
+    for(auto i=0u; i<m_TimelineWaitCount; ++i)
+    { waitStages[i] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT; }
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+    timelineInfo.sType                      = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineInfo.pNext                      = nullptr;
+    timelineInfo.waitSemaphoreValueCount    = m_TimelineWaitCount;
+    timelineInfo.pWaitSemaphoreValues       = (m_TimelineWaitCount > 0) ? m_TimelineWaitValue : nullptr;
+    timelineInfo.signalSemaphoreValueCount  = 1;
+    timelineInfo.pSignalSemaphoreValues     = &value;
+
+    VkSubmitInfo info = {};
+    info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    info.pNext                  = &timelineInfo;
+    info.commandBufferCount     = 0;
+    info.pCommandBuffers        = nullptr;
+    info.waitSemaphoreCount     = m_TimelineWaitCount;
+    info.pWaitSemaphores        = (m_TimelineWaitCount > 0) ? m_TimelineWait : nullptr;
+    info.pWaitDstStageMask      = (m_TimelineWaitCount > 0) ? waitStages : nullptr;
+    info.signalSemaphoreCount   = 1;
+    info.pSignalSemaphores      = &semaphore;
+
+    auto ret = vkQueueSubmit( m_Queue, 1, &info, VK_NULL_HANDLE );
+    A3D_ASSERT( ret == VK_SUCCESS );
+
+    return ret == VK_SUCCESS;
+#else
+    A3D_UNUSED(value);
+    return false;
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -275,12 +567,13 @@ void Queue::Execute(IFence* pFence)
 //-------------------------------------------------------------------------------------------------
 void Queue::WaitIdle()
 {
+    auto value = m_SubmitValue.load(std::memory_order_acquire);
+
     auto ret = vkQueueWaitIdle( m_Queue );
     A3D_ASSERT( ret == VK_SUCCESS );
-    A3D_UNUSED( ret );
 
-    m_PreviousBufferIndex = m_CurrentBufferIndex;
-    m_CurrentBufferIndex  = 0;
+    if ( ret == VK_SUCCESS )
+    { NotifyCompleted(value); }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -288,7 +581,8 @@ void Queue::WaitIdle()
 //-------------------------------------------------------------------------------------------------
 void Queue::Present(ISwapChain* pSwapChain)
 {
-    auto pWrapSwapChain = reinterpret_cast<SwapChain*>(pSwapChain);
+    // 通常のスワップチェインとヘッドレススワップチェインのどちらも受け付ける.
+    auto pWrapSwapChain = static_cast<IPresentable*>(pSwapChain);
     if (pWrapSwapChain == nullptr)
     { return; }
 
@@ -306,7 +600,7 @@ VkQueue Queue::GetVulkanQueue() const
 //-------------------------------------------------------------------------------------------------
 VkSemaphore Queue::GetVulkanSignalSemaphore(uint32_t index) const
 {
-    A3D_ASSERT(0 <= index && index < MaxBufferCount);
+    A3D_ASSERT(0 <= index && index < MaxFrameCount);
     return m_SignalSemaphore[index];
 }
 
@@ -315,7 +609,7 @@ VkSemaphore Queue::GetVulkanSignalSemaphore(uint32_t index) const
 //-------------------------------------------------------------------------------------------------
 VkSemaphore Queue::GetVulkanWaitSemaphore(uint32_t index) const
 {
-    A3D_ASSERT(0 <= index && index < MaxBufferCount);
+    A3D_ASSERT(0 <= index && index < MaxFrameCount);
     return m_WaitSemaphore[index];
 }
 
@@ -324,7 +618,7 @@ VkSemaphore Queue::GetVulkanWaitSemaphore(uint32_t index) const
 //-------------------------------------------------------------------------------------------------
 VkFence Queue::GetVulkanFence(uint32_t index) const
 {
-    A3D_ASSERT(0 <= index && index < MaxBufferCount);
+    A3D_ASSERT(0 <= index && index < MaxFrameCount);
     return m_Fence[index];
 }
 
@@ -359,7 +653,7 @@ bool Queue::ResetSyncObject()
     A3D_ASSERT(pNativeDevice != null_handle);
 
     // 一旦破棄.
-    for(auto i=0u; i<MaxBufferCount; ++i)
+    for(auto i=0u; i<MaxFrameCount; ++i)
     {
         if (m_SignalSemaphore[i] != null_handle)
         {
@@ -387,7 +681,7 @@ bool Queue::ResetSyncObject()
         info.pNext = nullptr;
         info.flags = 0;
 
-        for(auto i=0u; i<MaxBufferCount; ++i)
+        for(auto i=0u; i<MaxFrameCount; ++i)
         {
             auto ret = vkCreateSemaphore( pNativeDevice, &info, nullptr, &m_SignalSemaphore[i]);
             if ( ret != VK_SUCCESS )
@@ -406,7 +700,7 @@ bool Queue::ResetSyncObject()
         info.pNext = nullptr;
         info.flags = 0;
 
-        for(auto i=0; i<MaxBufferCount; ++i)
+        for(auto i=0u; i<MaxFrameCount; ++i)
         {
             auto ret = vkCreateFence( pNativeDevice, &info, nullptr, &m_Fence[i]);
             if ( ret != VK_SUCCESS )
@@ -417,16 +711,204 @@ bool Queue::ResetSyncObject()
             {
                 info.flags = 0;
             }
+
+            m_FenceActive[i] = false;
         }
     }
 
     // バッファ番号リセット.
     m_PreviousBufferIndex = 0;
     m_CurrentBufferIndex  = 0;
+    m_AcquirePending      = false;
+    m_PresentPending      = false;
 
     return true;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      同時に処理中にできるフレーム数を設定します.
+//-------------------------------------------------------------------------------------------------
+bool Queue::SetFrameCount(uint32_t count)
+{
+    if (count == 0 || count > MaxFrameCount)
+    { return false; }
+
+    if (count == m_FrameCount)
+    { return true; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    // スロットの割り当てが変わるので，処理中のフレームを全て完了させておく.
+    for(auto i=0u; i<MaxFrameCount; ++i)
+    {
+        if (!m_FenceActive[i])
+        { continue; }
+
+        vkWaitForFences(pNativeDevice, 1, &m_Fence[i], VK_TRUE, UINT64_MAX);
+        vkResetFences(pNativeDevice, 1, &m_Fence[i]);
+        m_FenceActive[i] = false;
+        NotifyCompleted(m_FenceValue[i]);
+    }
+
+    // 現在のスロットが範囲外になる場合は，取得済みのセマフォごと先頭のスロットに移す.
+    if (m_CurrentBufferIndex >= count)
+    {
+        std::swap(m_WaitSemaphore  [0], m_WaitSemaphore  [m_CurrentBufferIndex]);
+        std::swap(m_SignalSemaphore[0], m_SignalSemaphore[m_CurrentBufferIndex]);
+        m_CurrentBufferIndex = 0;
+    }
+
+    if (m_PreviousBufferIndex >= count)
+    { m_PreviousBufferIndex = count - 1; }
+
+    m_FrameCount = count;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      同時に処理中にできるフレーム数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t Queue::GetFrameCount() const
+{ return m_FrameCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      現在のフレームスロットを以前使用したフレームの完了を待機します.
+//-------------------------------------------------------------------------------------------------
+bool Queue::WaitFrameSlot(uint64_t timeout)
+{
+    // CPUが FrameCount 分先行していなければ待たない.
+    if (!m_FenceActive[m_CurrentBufferIndex])
+    { return true; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    auto fence = m_Fence[m_CurrentBufferIndex];
+    auto ret   = vkWaitForFences(pNativeDevice, 1, &fence, VK_TRUE, timeout);
+    if (ret != VK_SUCCESS)
+    { return false; }
+
+    vkResetFences(pNativeDevice, 1, &fence);
+    m_FenceActive[m_CurrentBufferIndex] = false;
+    NotifyCompleted(m_FenceValue[m_CurrentBufferIndex]);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      イメージを取得したことを通知します.
+//-------------------------------------------------------------------------------------------------
+void Queue::NotifyImageAcquired()
+{ m_AcquirePending = true; }
+
+//-------------------------------------------------------------------------------------------------
+//      表示時に待機するセマフォを取り出します.
+//-------------------------------------------------------------------------------------------------
+VkSemaphore Queue::PopPresentSemaphore()
+{
+    // 描画せずに表示する場合も，取得したイメージのセマフォを消費しておく必要がある.
+    if (m_AcquirePending)
+    {
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+        VkSubmitInfo info = {};
+        info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.pNext                  = nullptr;
+        info.commandBufferCount     = 0;
+        info.pCommandBuffers        = nullptr;
+        info.waitSemaphoreCount     = 1;
+        info.pWaitSemaphores        = &m_WaitSemaphore[m_CurrentBufferIndex];
+        info.pWaitDstStageMask      = &waitStage;
+        info.signalSemaphoreCount   = 1;
+        info.pSignalSemaphores      = &m_SignalSemaphore[m_CurrentBufferIndex];
+
+        auto ret = vkQueueSubmit( m_Queue, 1, &info, m_Fence[m_CurrentBufferIndex] );
+        A3D_ASSERT( ret == VK_SUCCESS );
+        A3D_UNUSED( ret );
+
+        m_FenceActive[m_CurrentBufferIndex] = true;
+        m_FenceValue [m_CurrentBufferIndex] = m_SubmitValue.load(std::memory_order_acquire);
+        m_AcquirePending = false;
+        m_PresentPending = true;
+    }
+
+    if (!m_PresentPending)
+    { return null_handle; }
+
+    m_PresentPending = false;
+    return m_SignalSemaphore[m_CurrentBufferIndex];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      次のフレームスロットに進めます.
+//-------------------------------------------------------------------------------------------------
+void Queue::AdvanceFrame()
+{
+    m_PreviousBufferIndex = m_CurrentBufferIndex;
+    m_CurrentBufferIndex  = (m_CurrentBufferIndex + 1) % m_FrameCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      これまでに実行したサブミットの通し番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint64_t Queue::GetSubmitValue() const
+{ return m_SubmitValue.load(std::memory_order_acquire); }
+
+//-------------------------------------------------------------------------------------------------
+//      GPUでの完了を確認できたサブミットの通し番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint64_t Queue::GetCompletedValue() const
+{ return m_CompletedValue.load(std::memory_order_acquire); }
+
+//-------------------------------------------------------------------------------------------------
+//      追跡用のフェンスを確認し, 完了したサブミットの通し番号を更新します.
+//-------------------------------------------------------------------------------------------------
+void Queue::PollCompleted()
+{
+    std::lock_guard<std::mutex> locker(m_TrackMutex);
+    PollTrackFence();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      シグナル済みの追跡用フェンスを回収します.
+//-------------------------------------------------------------------------------------------------
+void Queue::PollTrackFence()
+{
+    if (m_TrackCount == 0)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    // サブミットは順番に完了するので, 先頭からシグナル済みのものだけ回収すればよい.
+    while (m_TrackCount > 0)
+    {
+        auto& fence = m_TrackFence[m_TrackHead];
+        if (vkGetFenceStatus(pNativeDevice, fence) != VK_SUCCESS)
+        { break; }
+
+        vkResetFences(pNativeDevice, 1, &fence);
+        NotifyCompleted(m_TrackValue[m_TrackHead]);
+
+        m_TrackHead = (m_TrackHead + 1) % MaxTrackFenceCount;
+        m_TrackCount--;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定した通し番号までのサブミットが完了したことを通知します.
+//-------------------------------------------------------------------------------------------------
+void Queue::NotifyCompleted(uint64_t value)
+{
+    // 複数のスレッドから通知されうるので, 値が戻らないように大きい場合のみ更新する.
+    auto current = m_CompletedValue.load(std::memory_order_relaxed);
+    while (current < value)
+    {
+        if (m_CompletedValue.compare_exchange_weak(current, value, std::memory_order_acq_rel))
+        { break; }
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
@@ -22,7 +22,10 @@ public:
     //=============================================================================================
     // public variables.
     //=============================================================================================
-    static const uint32_t       MaxBufferCount = 2;                 //!< 最大バッファ数です.
+    static const uint32_t       MaxFrameCount = 8;                  //!< 同時に処理中にできる最大フレーム数です.
+    static const uint32_t       DefaultFrameCount = 2;              //!< 既定の処理中フレーム数です.
+    static const uint32_t       MaxTimelineWaitCount = 8;           //!< 最大タイムライン待機数です.
+    static const uint32_t       MaxTrackFenceCount = 16;            //!< サブミットの完了を検出するフェンスの最大数です.
 
     //=============================================================================================
     // public methods.
@@ -74,9 +77,20 @@ public:
     //! @brief      コマンドリストを登録します.
     //!
     //! @param[in]      pCommandList        登録するコマンドリストです.
+    //! @note       ソートキー0として登録されます.
     //---------------------------------------------------------------------------------------------
     bool A3D_APIENTRY Submit( ICommandList* pCommandList ) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ソートキーを指定してコマンドリストを登録します.
+    //!
+    //! @param[in]      pCommandList        登録するコマンドリストです.
+    //! @param[in]      sortKey             実行順を決めるソートキーです.
+    //! @retval true    登録に成功.
+    //! @retval false   登録に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Submit( ICommandList* pCommandList, uint64_t sortKey ) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      登録したコマンドリストを実行します.
     //!
@@ -84,6 +98,26 @@ public:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Execute( IFence* pFence ) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フェンスのタイムライン値が指定値に達するまでGPU側で待機させます.
+    //!
+    //! @param[in]      pFence          待機するフェンスです.
+    //! @param[in]      value           待機する値です.
+    //! @retval true    登録に成功.
+    //! @retval false   登録に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Wait( IFence* pFence, uint64_t value ) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      それまでに実行したコマンドリストの完了時にフェンスのタイムライン値をシグナルします.
+    //!
+    //! @param[in]      pFence          シグナルするフェンスです.
+    //! @param[in]      value           設定する値です.
+    //! @retval true    シグナルの発行に成功.
+    //! @retval false   シグナルの発行に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Signal( IFence* pFence, uint64_t value ) override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      コマンドの実行が完了するまで待機します.
     //---------------------------------------------------------------------------------------------
@@ -154,23 +188,122 @@ public:
     //---------------------------------------------------------------------------------------------
     bool A3D_APIENTRY ResetSyncObject();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      同時に処理中にできるフレーム数を設定します.
+    //!
+    //! @param[in]      count       フレーム数です(1 ～ MaxFrameCount).
+    //! @retval true    設定に成功.
+    //! @retval false   設定に失敗.
+    //! @note       処理中のフレームが全て完了するまで待機してから切り替えます.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY SetFrameCount(uint32_t count);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      同時に処理中にできるフレーム数を取得します.
+    //!
+    //! @return     フレーム数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetFrameCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のフレームスロットを以前使用したフレームの完了を待機します.
+    //!
+    //! @param[in]      timeout     タイムアウト時間です(ナノ秒単位).
+    //! @retval true    スロットが使用可能です.
+    //! @retval false   タイムアウトしました.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY WaitFrameSlot(uint64_t timeout);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      現在のフレームスロットのウェイトセマフォでイメージを取得したことを通知します.
+    //! @note       次にフェンス付きで Execute() した際にウェイトセマフォを待機します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY NotifyImageAcquired();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      表示時に待機するセマフォを取り出します.
+    //!
+    //! @return     描画完了時にシグナルされるセマフォを返却します. 描画が無い場合は null_handle を返却します.
+    //---------------------------------------------------------------------------------------------
+    VkSemaphore A3D_APIENTRY PopPresentSemaphore();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      次のフレームスロットに進めます.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY AdvanceFrame();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      これまでに実行したサブミットの通し番号を取得します.
+    //!
+    //! @return     最後に実行したサブミットの通し番号を返却します. 未実行の場合はゼロです.
+    //---------------------------------------------------------------------------------------------
+    uint64_t A3D_APIENTRY GetSubmitValue() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      GPUでの完了を確認できたサブミットの通し番号を取得します.
+    //!
+    //! @return     完了済みのサブミットの通し番号を返却します.
+    //! @note       フレームスロットや追跡用のフェンスの完了, WaitIdle() によって更新されます.
+    //!             追跡用のフェンスは PollCompleted() で確認します.
+    //---------------------------------------------------------------------------------------------
+    uint64_t A3D_APIENTRY GetCompletedValue() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡用のフェンスを確認し, 完了したサブミットの通し番号を更新します.
+    //! @note       待機は行いません.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PollCompleted();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定した通し番号までのサブミットが完了したことを通知します.
+    //!
+    //! @param[in]      value       完了したサブミットの通し番号です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY NotifyCompleted(uint64_t value);
+
 private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // SubmitEntry structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct SubmitEntry
+    {
+        uint64_t            SortKey;            //!< ソートキーです.
+        uint32_t            Order;              //!< 登録順です.
+        CommandList*        pCommandList;       //!< コマンドリストです.
+    };
+
     //=============================================================================================
     // private variables.
     //=============================================================================================
     std::atomic<uint32_t>       m_RefCount;                         //!< 参照カウンタです.
-    std::mutex                  m_Mutex;                            //!< ミューテックスです.
     Device*                     m_pDevice;                          //!< デバイスです.
     VkQueue                     m_Queue;                            //!< コマンドキューです.
-    uint32_t                    m_SubmitIndex;                      //!< サブミット番号です.
+    std::atomic<uint32_t>       m_SubmitIndex;                      //!< 予約済みのサブミット番号です.
+    std::atomic<uint32_t>       m_CommitCount;                      //!< 書き込みが完了したサブミット数です.
+    SubmitEntry*                m_pSubmitEntry;                     //!< サブミットエントリーです.
     VkCommandBuffer*            m_pSubmitList;                      //!< コマンドバッファです.
     uint32_t                    m_FamilyIndex;                      //!< ファミリーインデックスです.
     uint32_t                    m_MaxSubmitCount;                   //!< 最大サブミット数です.
-    VkSemaphore                 m_SignalSemaphore[MaxBufferCount];  //!< シグナルセマフォです.
-    VkSemaphore                 m_WaitSemaphore[MaxBufferCount];    //!< ウェイトセマフォです.
-    VkFence                     m_Fence[MaxBufferCount];            //!< フェンスです.
+    VkSemaphore                 m_SignalSemaphore[MaxFrameCount];   //!< シグナルセマフォです.
+    VkSemaphore                 m_WaitSemaphore[MaxFrameCount];     //!< ウェイトセマフォです.
+    VkFence                     m_Fence[MaxFrameCount];             //!< フレームの完了を検出するフェンスです.
+    bool                        m_FenceActive[MaxFrameCount];       //!< フェンスのシグナル待ちかどうか.
+    uint64_t                    m_FenceValue[MaxFrameCount];        //!< フェンスのシグナルで完了するサブミットの通し番号です.
+    std::atomic<uint64_t>       m_SubmitValue;                      //!< 実行したサブミットの通し番号です.
+    std::atomic<uint64_t>       m_CompletedValue;                   //!< 完了を確認したサブミットの通し番号です.
+    uint32_t                    m_FrameCount;                       //!< 同時に処理中にできるフレーム数です.
+    bool                        m_AcquirePending;                   //!< イメージ取得の待機が必要かどうか.
+    bool                        m_PresentPending;                   //!< 表示時にシグナルセマフォの待機が必要かどうか.
     uint32_t                    m_CurrentBufferIndex;               //!< 現在のバッファ番号です.
     uint32_t                    m_PreviousBufferIndex;              //!< 以前のバッファ番号です.
+    VkSemaphore                 m_TimelineWait[MaxTimelineWaitCount];       //!< 待機するタイムラインセマフォです.
+    uint64_t                    m_TimelineWaitValue[MaxTimelineWaitCount];  //!< 待機するタイムライン値です.
+    uint32_t                    m_TimelineWaitCount;                //!< タイムライン待機数です.
+    VkFence                     m_TrackFence[MaxTrackFenceCount];   //!< フレームの提出以外のサブミットの完了を検出するフェンスです.
+    uint64_t                    m_TrackValue[MaxTrackFenceCount];   //!< 追跡用のフェンスのシグナルで完了するサブミットの通し番号です.
+    uint32_t                    m_TrackHead;                        //!< シグナル待ちの追跡用フェンスの先頭位置です.
+    uint32_t                    m_TrackCount;                       //!< シグナル待ちの追跡用フェンス数です.
+    std::mutex                  m_TrackMutex;                       //!< 追跡用フェンスのミューテックスです.
 
     //=============================================================================================
     // private methods.
@@ -207,6 +340,12 @@ private:
     //---------------------------------------------------------------------------------------------
     void A3D_APIENTRY Term();
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      シグナル済みの追跡用フェンスを回収します.
+    //! @note       m_TrackMutex をロックしてから呼び出す必要があります.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PollTrackFence();
+
     Queue           (const Queue&) = delete;
     void operator = (const Queue&) = delete;
 };
@@ -0,0 +1,725 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dReadbackService.cpp
+// Desc : Readback Service Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ReadbackService class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ReadbackService::ReadbackService()
+: m_RefCount        (1)
+, m_pDevice         (nullptr)
+, m_pQueue          (nullptr)
+, m_Buffer          (null_handle)
+, m_Allocation      (nullptr)
+, m_pMappedPtr      (nullptr)
+, m_CommandPool     (null_handle)
+, m_pBatches        (nullptr)
+, m_BatchHead       (0)
+, m_BatchCount      (0)
+, m_IsRecording     (false)
+, m_NextBatchValue  (1)
+, m_NextTicket      (1)
+, m_SubmittedTicket (0)
+, m_CompletedTicket (0)
+{ memset(&m_Desc, 0, sizeof(m_Desc)); }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+ReadbackService::~ReadbackService()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool ReadbackService::Init(IDevice* pDevice, const ReadbackServiceDesc* pDesc)
+{
+    if (pDevice == nullptr || pDesc == nullptr)
+    { return false; }
+
+    if (pDesc->Size == 0 || pDesc->MaxBatchCount == 0)
+    { return false; }
+
+    m_pDevice = static_cast<Device*>(pDevice);
+    m_pDevice->AddRef();
+
+    m_pDevice->GetGraphicsQueue(reinterpret_cast<IQueue**>(&m_pQueue));
+
+    memcpy(&m_Desc, pDesc, sizeof(m_Desc));
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    // ステージングバッファを生成します.
+    {
+        VkBufferCreateInfo info = {};
+        info.sType                  = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        info.pNext                  = nullptr;
+        info.flags                  = 0;
+        info.pQueueFamilyIndices    = nullptr;
+        info.queueFamilyIndexCount  = 0;
+        info.sharingMode            = VK_SHARING_MODE_EXCLUSIVE;
+        info.size                   = m_Desc.Size;
+        info.usage                  = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+        // 要求のたびにマップしなくて済むよう，破棄するまでマップしたままにする.
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo result = {};
+        auto ret = vmaCreateBuffer(m_pDevice->GetAllocator(), &info, &allocInfo, &m_Buffer, &m_Allocation, &result);
+        if ( ret != VK_SUCCESS )
+        { return false; }
+
+        m_pMappedPtr = static_cast<uint8_t*>(result.pMappedData);
+        if (m_pMappedPtr == nullptr)
+        { return false; }
+    }
+
+    if (!m_Ring.Init(size_t(m_Desc.Size), 0, m_Desc.MaxBatchCount))
+    { return false; }
+
+    // コマンドプールを生成.
+    {
+        VkCommandPoolCreateInfo info = {};
+        info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        info.pNext            = nullptr;
+        info.queueFamilyIndex = m_pQueue->GetFamilyIndex();
+        info.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        auto ret = vkCreateCommandPool( pNativeDevice, &info, nullptr, &m_CommandPool );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    m_pBatches = new (std::nothrow) Batch [m_Desc.MaxBatchCount];
+    if (m_pBatches == nullptr)
+    { return false; }
+
+    for(auto i=0u; i<m_Desc.MaxBatchCount; ++i)
+    {
+        m_pBatches[i].CommandBuffer = null_handle;
+        m_pBatches[i].Fence         = null_handle;
+        m_pBatches[i].Value         = 0;
+        m_pBatches[i].SubmitValue   = 0;
+    }
+
+    // コマンドバッファとフェンスを生成.
+    for(auto i=0u; i<m_Desc.MaxBatchCount; ++i)
+    {
+        auto& batch = m_pBatches[i];
+
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.pNext              = nullptr;
+        allocInfo.commandPool        = m_CommandPool;
+        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        auto ret = vkAllocateCommandBuffers( pNativeDevice, &allocInfo, &batch.CommandBuffer );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceInfo.pNext = nullptr;
+        fenceInfo.flags = 0;
+
+        ret = vkCreateFence( pNativeDevice, &fenceInfo, nullptr, &batch.Fence );
+        if ( ret != VK_SUCCESS )
+        { return false; }
+    }
+
+    m_BatchHead       = 0;
+    m_BatchCount      = 0;
+    m_IsRecording     = false;
+    m_NextBatchValue  = 1;
+    m_NextTicket      = 1;
+    m_SubmittedTicket = 0;
+    m_CompletedTicket = 0;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ReadbackService::Term()
+{
+    if (m_pDevice == nullptr)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    // 記録途中のバッチも投入し，全ての要求を引き渡してから破棄する.
+    Submit();
+    while (m_BatchCount > 0)
+    {
+        if (!RetireBatch(UINT64_MAX))
+        {
+            m_pQueue->WaitIdle();
+            break;
+        }
+    }
+    m_Requests.clear();
+
+    if (m_pBatches != nullptr)
+    {
+        for(auto i=0u; i<m_Desc.MaxBatchCount; ++i)
+        {
+            if (m_pBatches[i].Fence != null_handle)
+            {
+                vkDestroyFence(pNativeDevice, m_pBatches[i].Fence, nullptr);
+                m_pBatches[i].Fence = null_handle;
+            }
+
+            if (m_pBatches[i].CommandBuffer != null_handle)
+            {
+                vkFreeCommandBuffers(pNativeDevice, m_CommandPool, 1, &m_pBatches[i].CommandBuffer);
+                m_pBatches[i].CommandBuffer = null_handle;
+            }
+        }
+
+        delete [] m_pBatches;
+        m_pBatches = nullptr;
+    }
+
+    if (m_CommandPool != null_handle)
+    {
+        vkDestroyCommandPool(pNativeDevice, m_CommandPool, nullptr);
+        m_CommandPool = null_handle;
+    }
+
+    m_Ring.Term();
+
+    if (m_Buffer != null_handle)
+    {
+        vmaDestroyBuffer(m_pDevice->GetAllocator(), m_Buffer, m_Allocation);
+        m_Buffer     = null_handle;
+        m_Allocation = nullptr;
+        m_pMappedPtr = nullptr;
+    }
+
+    m_BatchHead  = 0;
+    m_BatchCount = 0;
+
+    SafeRelease(m_pQueue);
+    SafeRelease(m_pDevice);
+    memset( &m_Desc, 0, sizeof(m_Desc) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      参照カウントを増やします.
+//-------------------------------------------------------------------------------------------------
+void ReadbackService::AddRef()
+{ m_RefCount++; }
+
+//-------------------------------------------------------------------------------------------------
+//      解放処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ReadbackService::Release()
+{
+    m_RefCount--;
+    if (m_RefCount == 0)
+    { delete this; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      参照カウントを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t ReadbackService::GetCount() const
+{ return m_RefCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      デバイスを取得します.
+//-------------------------------------------------------------------------------------------------
+void ReadbackService::GetDevice(IDevice** ppDevice)
+{
+    *ppDevice = m_pDevice;
+    if (m_pDevice != nullptr)
+    { m_pDevice->AddRef(); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      構成設定を取得します.
+//-------------------------------------------------------------------------------------------------
+ReadbackServiceDesc ReadbackService::GetDesc() const
+{ return m_Desc; }
+
+//-------------------------------------------------------------------------------------------------
+//      バッファの読み戻しを要求します.
+//-------------------------------------------------------------------------------------------------
+bool ReadbackService::ReadBuffer
+(
+    IBuffer*            pSrcBuffer,
+    uint64_t            srcOffset,
+    uint64_t            size,
+    IReadbackCallback*  pCallback,
+    uint64_t*           pTicket
+)
+{
+    if (pSrcBuffer == nullptr || pCallback == nullptr || size == 0)
+    { return false; }
+
+    auto pWrapBuffer = static_cast<Buffer*>(pSrcBuffer);
+    A3D_ASSERT(pWrapBuffer != nullptr);
+
+    if (srcOffset + size > pWrapBuffer->GetDesc().Size)
+    { return false; }
+
+    uint64_t offset = 0;
+    if (!Allocate(size, 16, &offset))
+    { return false; }
+
+    auto commandBuffer = BeginBatch();
+    if (commandBuffer == null_handle)
+    { return false; }
+
+    VkBufferCopy region = {};
+    region.srcOffset = srcOffset;
+    region.dstOffset = offset;
+    region.size      = size;
+
+    vkCmdCopyBuffer(commandBuffer, pWrapBuffer->GetVulkanBuffer(), m_Buffer, 1, &region);
+
+    Request request = {};
+    request.Offset      = offset;
+    request.Size        = size;
+    request.RowPitch    = size;
+    request.RowCount    = 1;
+    request.SlicePitch  = size;
+    request.pCallback   = pCallback;
+    PushRequest(request, pTicket);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      テクスチャの読み戻しを要求します.
+//-------------------------------------------------------------------------------------------------
+bool ReadbackService::ReadTexture
+(
+    ITexture*           pSrcTexture,
+    uint32_t            srcSubresource,
+    RESOURCE_STATE      srcState,
+    Offset3D            srcOffset,
+    Extent3D            srcExtent,
+    IReadbackCallback*  pCallback,
+    uint64_t*           pTicket
+)
+{
+    if (pSrcTexture == nullptr || pCallback == nullptr)
+    { return false; }
+
+    if (srcExtent.Width == 0 || srcExtent.Height == 0 || srcExtent.Depth == 0)
+    { return false; }
+
+    auto pWrapTexture = static_cast<Texture*>(pSrcTexture);
+    A3D_ASSERT(pWrapTexture != nullptr);
+
+    const auto& desc = pWrapTexture->GetDesc();
+
+    // 行間に隙間の無いレイアウトで格納する.
+    uint64_t slicePitch = 0;
+    uint64_t rowPitch   = 0;
+    uint64_t rowCount   = 0;
+    CalcSubresourceSize(desc.Format, srcExtent.Width, srcExtent.Height, slicePitch, rowPitch, rowCount);
+
+    auto texelSize = uint64_t(ToByte(desc.Format));
+    if (slicePitch == 0 || texelSize == 0)
+    { return false; }
+
+    // オフセットはテクセルサイズと 4 の両方の倍数である必要がある.
+    // リングアロケータは2の累乗のアライメントしか扱えないため，それ以外は余分に確保して切り上げる.
+    auto alignment = texelSize * 4;
+    auto isPow2    = (alignment & (alignment - 1)) == 0;
+
+    uint64_t offset = 0;
+    if (isPow2)
+    {
+        if (!Allocate(slicePitch * srcExtent.Depth, alignment, &offset))
+        { return false; }
+    }
+    else
+    {
+        if (!Allocate(slicePitch * srcExtent.Depth + alignment, 4, &offset))
+        { return false; }
+
+        offset = (offset + alignment - 1) / alignment * alignment;
+    }
+
+    auto commandBuffer = BeginBatch();
+    if (commandBuffer == null_handle)
+    { return false; }
+
+    // 3次元テクスチャは奥行がサブリソースに含まれない.
+    auto arraySize = (desc.Dimension == RESOURCE_DIMENSION_TEXTURE3D) ? 1u : uint32_t(desc.DepthOrArraySize);
+
+    uint32_t mipSlice   = 0;
+    uint32_t arraySlice = 0;
+    uint32_t planeSlice = 0;
+    DecomposeSubresource(srcSubresource, desc.MipLevels, arraySize, mipSlice, arraySlice, planeSlice);
+
+    auto aspectMask = pWrapTexture->GetVulkanImageAspectFlags();
+
+    // 深度ステンシルは一方のアスペクトずつしかコピーできない.
+    auto copyAspect = aspectMask;
+    if ((aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) && (aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT))
+    { copyAspect = (planeSlice == 0) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_STENCIL_BIT; }
+
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.pNext               = nullptr;
+    barrier.srcAccessMask       = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.oldLayout           = ToNativeImageLayout(srcState);
+    barrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image               = pWrapTexture->GetVulkanImage();
+
+    barrier.subresourceRange.aspectMask     = aspectMask;
+    barrier.subresourceRange.baseMipLevel   = mipSlice;
+    barrier.subresourceRange.levelCount     = 1;
+    barrier.subresourceRange.baseArrayLayer = arraySlice;
+    barrier.subresourceRange.layerCount     = 1;
+
+    // 既にコピー元の状態であればレイアウト遷移は不要.
+    auto needTransition = (barrier.oldLayout != barrier.newLayout);
+
+    if (needTransition)
+    {
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier );
+    }
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset                     = offset;
+    region.bufferRowLength                  = 0;
+    region.bufferImageHeight                = 0;
+    region.imageSubresource.aspectMask      = copyAspect;
+    region.imageSubresource.mipLevel        = mipSlice;
+    region.imageSubresource.baseArrayLayer  = arraySlice;
+    region.imageSubresource.layerCount      = 1;
+    region.imageOffset.x                    = srcOffset.X;
+    region.imageOffset.y                    = srcOffset.Y;
+    region.imageOffset.z                    = srcOffset.Z;
+    region.imageExtent.width                = srcExtent.Width;
+    region.imageExtent.height               = srcExtent.Height;
+    region.imageExtent.depth                = srcExtent.Depth;
+
+    vkCmdCopyImageToBuffer(
+        commandBuffer,
+        barrier.image,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        m_Buffer,
+        1, &region );
+
+    // 呼び出し側が把握している状態に戻しておく.
+    if (needTransition)
+    {
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout     = ToNativeImageLayout(srcState);
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier );
+    }
+
+    Request request = {};
+    request.Offset      = offset;
+    request.Size        = slicePitch * srcExtent.Depth;
+    request.RowPitch    = rowPitch;
+    request.RowCount    = rowCount;
+    request.SlicePitch  = slicePitch;
+    request.pCallback   = pCallback;
+    PushRequest(request, pTicket);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要求済みのコピーをGPUに投入します.
+//-------------------------------------------------------------------------------------------------
+void ReadbackService::Submit()
+{
+    if (!m_IsRecording)
+    { return; }
+
+    auto& batch = m_pBatches[(m_BatchHead + m_BatchCount) % m_Desc.MaxBatchCount];
+
+    // コピー結果をCPUから読めるようにする.
+    VkMemoryBarrier barrier = {};
+    barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.pNext         = nullptr;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        batch.CommandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr );
+
+    auto ret = vkEndCommandBuffer(batch.CommandBuffer);
+    A3D_ASSERT(ret == VK_SUCCESS);
+
+    VkSubmitInfo info = {};
+    info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    info.pNext              = nullptr;
+    info.commandBufferCount = 1;
+    info.pCommandBuffers    = &batch.CommandBuffer;
+
+    // フェンスは先行する全てのサブミットの完了後にシグナルされるので，その時点の通し番号を控えておく.
+    batch.SubmitValue = m_pQueue->GetSubmitValue();
+    ret = vkQueueSubmit(m_pQueue->GetVulkanQueue(), 1, &info, batch.Fence);
+    A3D_ASSERT(ret == VK_SUCCESS);
+    A3D_UNUSED(ret);
+
+    // バッチの開始時にスロットの空きを確認しているので失敗しない.
+    m_Ring.EndFrame(batch.Value);
+
+    m_BatchCount++;
+    m_IsRecording     = false;
+    m_SubmittedTicket = m_NextTicket - 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      完了済みのバッチを待機せずに回収し，コールバックに引き渡します.
+//-------------------------------------------------------------------------------------------------
+uint32_t ReadbackService::Poll()
+{
+    auto prevTicket = m_CompletedTicket;
+
+    while (m_BatchCount > 0)
+    {
+        if (!RetireBatch(0))
+        { break; }
+    }
+
+    // チケットは連番なので差分が引き渡した要求数になる.
+    return uint32_t(m_CompletedTicket - prevTicket);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定したチケットまでの読み戻しが完了するまで待機します.
+//-------------------------------------------------------------------------------------------------
+bool ReadbackService::Wait(uint64_t ticket, uint32_t timeoutMsec)
+{
+    if (ticket == 0 || ticket >= m_NextTicket)
+    { return false; }
+
+    if (ticket <= m_CompletedTicket)
+    { return true; }
+
+    // 未投入のままでは完了しないので投入しておく.
+    if (ticket > m_SubmittedTicket)
+    { Submit(); }
+
+    auto timeout = (timeoutMsec == UINT32_MAX)
+        ? UINT64_MAX
+        : uint64_t(timeoutMsec) * 1000 * 1000;
+
+    while (m_CompletedTicket < ticket)
+    {
+        if (!RetireBatch(timeout))
+        { return false; }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定したチケットがコールバックに引き渡し済みかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool ReadbackService::IsCompleted(uint64_t ticket) const
+{ return ticket != 0 && ticket <= m_CompletedTicket; }
+
+//-------------------------------------------------------------------------------------------------
+//      ステージングリングから領域を割り当てます.
+//-------------------------------------------------------------------------------------------------
+bool ReadbackService::Allocate(uint64_t size, uint64_t alignment, uint64_t* pOffset)
+{
+    if (size > m_Desc.Size)
+    { return false; }
+
+    auto block = m_Ring.Alloc(size_t(size), size_t(alignment));
+    while (block.Size == 0)
+    {
+        // 処理中のバッチが無ければ，記録中のバッチを投入してその完了を待つ.
+        if (m_BatchCount == 0)
+        {
+            if (!m_IsRecording)
+            { return false; }
+
+            Submit();
+        }
+
+        if (!RetireBatch(UINT64_MAX))
+        { return false; }
+
+        block = m_Ring.Alloc(size_t(size), size_t(alignment));
+    }
+
+    *pOffset = uint64_t(block.Offset);
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バッチの記録を開始します.
+//-------------------------------------------------------------------------------------------------
+VkCommandBuffer ReadbackService::BeginBatch()
+{
+    auto& batch = m_pBatches[(m_BatchHead + m_BatchCount) % m_Desc.MaxBatchCount];
+    if (m_IsRecording)
+    { return batch.CommandBuffer; }
+
+    // 全てのスロットが処理中の場合は最も古いバッチの完了を待つ.
+    if (m_BatchCount >= m_Desc.MaxBatchCount)
+    {
+        if (!RetireBatch(UINT64_MAX))
+        { return null_handle; }
+    }
+
+    auto& nextBatch = m_pBatches[(m_BatchHead + m_BatchCount) % m_Desc.MaxBatchCount];
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.pNext = nullptr;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    auto ret = vkBeginCommandBuffer(nextBatch.CommandBuffer, &beginInfo);
+    if (ret != VK_SUCCESS)
+    { return null_handle; }
+
+    // 先に投入された書き込みがコピーから見えるようにする.
+    VkMemoryBarrier barrier = {};
+    barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.pNext         = nullptr;
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        nextBatch.CommandBuffer,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr );
+
+    nextBatch.Value = m_NextBatchValue++;
+    m_IsRecording   = true;
+
+    return nextBatch.CommandBuffer;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      要求を登録します.
+//-------------------------------------------------------------------------------------------------
+void ReadbackService::PushRequest(Request& request, uint64_t* pTicket)
+{
+    A3D_ASSERT(m_IsRecording);
+
+    request.Ticket     = m_NextTicket++;
+    request.BatchValue = m_pBatches[(m_BatchHead + m_BatchCount) % m_Desc.MaxBatchCount].Value;
+    m_Requests.push_back(request);
+
+    if (pTicket != nullptr)
+    { *pTicket = request.Ticket; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最も古い処理中バッチの完了を待って回収し，コールバックに引き渡します.
+//-------------------------------------------------------------------------------------------------
+bool ReadbackService::RetireBatch(uint64_t timeout)
+{
+    if (m_BatchCount == 0)
+    { return false; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    auto& batch = m_pBatches[m_BatchHead];
+
+    // timeout が 0 の場合は状態を確認するだけで待機しない.
+    auto ret = vkWaitForFences(pNativeDevice, 1, &batch.Fence, VK_TRUE, timeout);
+    if (ret != VK_SUCCESS)
+    { return false; }
+
+    m_pQueue->NotifyCompleted(batch.SubmitValue);
+
+    // ホストコヒーレントでないメモリの場合に備えて無効化しておく.
+    vmaInvalidateAllocation(m_pDevice->GetAllocator(), m_Allocation, 0, VK_WHOLE_SIZE);
+
+    while (!m_Requests.empty() && m_Requests.front().BatchValue == batch.Value)
+    {
+        const auto& request = m_Requests.front();
+
+        ReadbackResult result = {};
+        result.Ticket       = request.Ticket;
+        result.pData        = m_pMappedPtr + request.Offset;
+        result.Size         = request.Size;
+        result.RowPitch     = request.RowPitch;
+        result.RowCount     = request.RowCount;
+        result.SlicePitch   = request.SlicePitch;
+
+        request.pCallback->OnReadback(result);
+
+        m_CompletedTicket = request.Ticket;
+        m_Requests.pop_front();
+    }
+
+    // コールバックが済んだので領域を再利用できるようにする.
+    m_Ring.PopFrame();
+    vkResetFences(pNativeDevice, 1, &batch.Fence);
+
+    m_BatchHead = (m_BatchHead + 1) % m_Desc.MaxBatchCount;
+    m_BatchCount--;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      生成処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool ReadbackService::Create
+(
+    IDevice*                    pDevice,
+    const ReadbackServiceDesc*  pDesc,
+    IReadbackService**          ppReadbackService
+)
+{
+    if (pDevice == nullptr || pDesc == nullptr || ppReadbackService == nullptr)
+    { return false; }
+
+    auto instance = new ReadbackService();
+    if (instance == nullptr)
+    { return false; }
+
+    if (!instance->Init(pDevice, pDesc))
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
+    *ppReadbackService = instance;
+    return true;
+}
+
+} // namespace a3d
@@ -0,0 +1,265 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dReadbackService.h
+// Desc : Readback Service Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ReadbackService class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class A3D_API ReadbackService : public IReadbackService, public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      生成処理を行います.
+    //!
+    //! @param[in]      pDevice             デバイスです.
+    //! @param[in]      pDesc               構成設定です.
+    //! @param[out]     ppReadbackService   読み戻しサービスの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY Create(
+        IDevice*                    pDevice,
+        const ReadbackServiceDesc*  pDesc,
+        IReadbackService**          ppReadbackService);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      参照カウントを増やします.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY AddRef() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      解放処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Release() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      参照カウントを取得します.
+    //!
+    //! @return     参照カウントを返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetCount() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスを取得します.
+    //!
+    //! @param[out]     ppDevice        デバイスの格納先です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY GetDevice(IDevice** ppDevice) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //!
+    //! @return     構成設定を返却します.
+    //---------------------------------------------------------------------------------------------
+    ReadbackServiceDesc A3D_APIENTRY GetDesc() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッファの読み戻しを要求します.
+    //!
+    //! @param[in]      pSrcBuffer      読み戻すバッファです.
+    //! @param[in]      srcOffset       読み戻す領域のオフセットです.
+    //! @param[in]      size            読み戻すサイズです(バイト単位).
+    //! @param[in]      pCallback       完了を受け取るコールバックです.
+    //! @param[out]     pTicket         チケットの格納先です.
+    //! @retval true    要求に成功.
+    //! @retval false   要求に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY ReadBuffer(
+        IBuffer*            pSrcBuffer,
+        uint64_t            srcOffset,
+        uint64_t            size,
+        IReadbackCallback*  pCallback,
+        uint64_t*           pTicket) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      テクスチャの読み戻しを要求します.
+    //!
+    //! @param[in]      pSrcTexture     読み戻すテクスチャです.
+    //! @param[in]      srcSubresource  読み戻すサブリソースです.
+    //! @param[in]      srcState        読み戻す時点のリソースステートです.
+    //! @param[in]      srcOffset       読み戻す領域のオフセットです.
+    //! @param[in]      srcExtent       読み戻す領域の大きさです.
+    //! @param[in]      pCallback       完了を受け取るコールバックです.
+    //! @param[out]     pTicket         チケットの格納先です.
+    //! @retval true    要求に成功.
+    //! @retval false   要求に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY ReadTexture(
+        ITexture*           pSrcTexture,
+        uint32_t            srcSubresource,
+        RESOURCE_STATE      srcState,
+        Offset3D            srcOffset,
+        Extent3D            srcExtent,
+        IReadbackCallback*  pCallback,
+        uint64_t*           pTicket) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要求済みのコピーをGPUに投入します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Submit() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了済みのバッチを待機せずに回収し，コールバックに引き渡します.
+    //!
+    //! @return     引き渡した要求数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY Poll() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定したチケットまでの読み戻しが完了するまで待機します.
+    //!
+    //! @param[in]      ticket          待機するチケットです.
+    //! @param[in]      timeoutMsec     タイムアウト時間です(ミリ秒単位).
+    //! @retval true    完了しました.
+    //! @retval false   タイムアウトしたか，不正なチケットです.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Wait(uint64_t ticket, uint32_t timeoutMsec) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定したチケットがコールバックに引き渡し済みかどうかチェックします.
+    //!
+    //! @param[in]      ticket          チェックするチケットです.
+    //! @retval true    引き渡し済みです.
+    //! @retval false   処理中です.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY IsCompleted(uint64_t ticket) const override;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Batch structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Batch
+    {
+        VkCommandBuffer     CommandBuffer;      //!< コピー用コマンドバッファです.
+        VkFence             Fence;              //!< バッチの完了を通知するフェンスです.
+        uint64_t            Value;              //!< バッチ番号です.
+        uint64_t            SubmitValue;        //!< 投入時点でキューが実行したサブミットの通し番号です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Request structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Request
+    {
+        uint64_t            Ticket;             //!< チケットです.
+        uint64_t            BatchValue;         //!< 所属するバッチ番号です.
+        uint64_t            Offset;             //!< ステージングリング上のオフセットです.
+        uint64_t            Size;               //!< データサイズです.
+        uint64_t            RowPitch;           //!< 1行あたりのバイト数です.
+        uint64_t            RowCount;           //!< 行数です.
+        uint64_t            SlicePitch;         //!< 1スライスあたりのバイト数です.
+        IReadbackCallback*  pCallback;          //!< 完了を受け取るコールバックです.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::atomic<uint32_t>   m_RefCount;         //!< 参照カウンタです.
+    Device*                 m_pDevice;          //!< デバイスです.
+    Queue*                  m_pQueue;           //!< コピーを投入するキューです.
+    ReadbackServiceDesc     m_Desc;             //!< 構成設定です.
+    VkBuffer                m_Buffer;           //!< ステージングバッファです.
+    VmaAllocation           m_Allocation;       //!< ステージングバッファのメモリです.
+    uint8_t*                m_pMappedPtr;       //!< マップ済みポインタです.
+    RingAllocator           m_Ring;             //!< ステージングバッファの領域を管理するリングアロケータです.
+    VkCommandPool           m_CommandPool;      //!< コマンドプールです.
+    Batch*                  m_pBatches;         //!< バッチです.
+    uint32_t                m_BatchHead;        //!< 最も古い処理中バッチの位置です.
+    uint32_t                m_BatchCount;       //!< GPUで処理中のバッチ数です.
+    bool                    m_IsRecording;      //!< 未投入のバッチを記録中かどうか?
+    uint64_t                m_NextBatchValue;   //!< 次に開始するバッチ番号です.
+    uint64_t                m_NextTicket;       //!< 次に発行するチケットです.
+    uint64_t                m_SubmittedTicket;  //!< 投入済みの最新のチケットです.
+    uint64_t                m_CompletedTicket;  //!< 引き渡し済みの最新のチケットです.
+    std::deque<Request, StdAllocator<Request>>  m_Requests;    //!< 未完了の要求です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    A3D_APIENTRY ReadbackService();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    A3D_APIENTRY ~ReadbackService();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDevice     デバイスです.
+    //! @param[in]      pDesc       構成設定です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Init(IDevice* pDevice, const ReadbackServiceDesc* pDesc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ステージングリングから領域を割り当てます.
+    //!
+    //! @param[in]      size        割り当てサイズです.
+    //! @param[in]      alignment   アライメントです.
+    //! @param[out]     pOffset     割り当てたオフセットの格納先です.
+    //! @retval true    割り当てに成功.
+    //! @retval false   リング全体でも不足しています.
+    //! @note       空きが無い場合は古いバッチから完了を待って回収します.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Allocate(uint64_t size, uint64_t alignment, uint64_t* pOffset);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バッチの記録を開始します. 記録中の場合は何もしません.
+    //!
+    //! @return     記録先のコマンドバッファを返却します. 失敗した場合は null_handle を返却します.
+    //---------------------------------------------------------------------------------------------
+    VkCommandBuffer A3D_APIENTRY BeginBatch();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      要求を登録します.
+    //!
+    //! @param[in]      request     登録する要求です. チケットとバッチ番号はこの関数で設定します.
+    //! @param[out]     pTicket     チケットの格納先です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PushRequest(Request& request, uint64_t* pTicket);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最も古い処理中バッチの完了を待って回収し，コールバックに引き渡します.
+    //!
+    //! @param[in]      timeout     タイムアウト時間です(ナノ秒単位). 0 の場合は待機しません.
+    //! @retval true    回収に成功.
+    //! @retval false   バッチが完了していません.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY RetireBatch(uint64_t timeout);
+
+    ReadbackService (const ReadbackService&) = delete;
+    void operator = (const ReadbackService&) = delete;
+};
+
+} // namespace a3d
@@ -0,0 +1,235 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dRenderPassCache.cpp
+// Desc : Render Pass and Frame Buffer Object Cache.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+//      レンダーパスを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateNativeRenderPass
+(
+    VkDevice                    device,
+    const a3d::RenderPassKey&   key,
+    VkRenderPass*               pRenderPass
+)
+{
+    VkAttachmentDescription attachmentDesc[9] = {};
+    VkAttachmentReference   attachmentRefs[9] = {};
+    VkAttachmentReference*  pDepthAttachmentRef = nullptr;
+
+    uint32_t attachmentCount = key.ColorCount;
+
+    for (auto i = 0u; i < key.ColorCount; ++i)
+    {
+        attachmentDesc[i].format            = key.ColorFormats[i];
+        attachmentDesc[i].samples           = key.ColorSamples[i];
+        attachmentDesc[i].loadOp            = key.LoadOp;
+        attachmentDesc[i].storeOp           = key.StoreOp;
+        attachmentDesc[i].stencilLoadOp     = key.StencilLoadOp;
+        attachmentDesc[i].stencilStoreOp    = key.StencilStoreOp;
+        attachmentDesc[i].initialLayout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachmentDesc[i].finalLayout       = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachmentDesc[i].flags             = 0;
+
+        attachmentRefs[i].attachment    = i;
+        attachmentRefs[i].layout        = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+
+    if (key.DepthFormat != VK_FORMAT_UNDEFINED)
+    {
+        attachmentCount++;
+
+        auto idx = key.ColorCount;
+        attachmentDesc[idx].format          = key.DepthFormat;
+        attachmentDesc[idx].samples         = key.DepthSamples;
+        attachmentDesc[idx].loadOp          = key.LoadOp;
+        attachmentDesc[idx].storeOp         = key.StoreOp;
+        attachmentDesc[idx].stencilLoadOp   = key.StencilLoadOp;
+        attachmentDesc[idx].stencilStoreOp  = key.StencilStoreOp;
+        attachmentDesc[idx].initialLayout   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        attachmentDesc[idx].finalLayout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        attachmentRefs[idx].attachment  = idx;
+        attachmentRefs[idx].layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        pDepthAttachmentRef = &attachmentRefs[idx];
+    }
+
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.flags                   = 0;
+    subpass.inputAttachmentCount    = 0;
+    subpass.colorAttachmentCount    = key.ColorCount;
+    subpass.pColorAttachments       = attachmentRefs;
+    subpass.pResolveAttachments     = nullptr;
+    subpass.pDepthStencilAttachment = pDepthAttachmentRef;
+    subpass.preserveAttachmentCount = 0;
+    subpass.pPreserveAttachments    = nullptr;
+
+    VkRenderPassCreateInfo info = {};
+    info.sType              = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    info.pNext              = nullptr;
+    info.flags              = 0;
+    info.attachmentCount    = attachmentCount;
+    info.pAttachments       = attachmentDesc;
+    info.subpassCount       = 1;
+    info.pSubpasses         = &subpass;
+
+    auto ret = vkCreateRenderPass(device, &info, nullptr, pRenderPass);
+    return ret == VK_SUCCESS;
+}
+
+} // namespace /* anonymous */
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RenderPassCache class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+RenderPassCache::RenderPassCache()
+: m_pDevice(nullptr)
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+RenderPassCache::~RenderPassCache()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool RenderPassCache::Init(Device* pDevice)
+{
+    if (pDevice == nullptr)
+    { return false; }
+
+    m_pDevice = pDevice;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void RenderPassCache::Term()
+{
+    if (m_pDevice == nullptr)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    // フレームバッファはレンダーパスを参照するので先に破棄する.
+    {
+        std::lock_guard<std::mutex> locker(m_FrameBufferMutex);
+        for(auto& itr : m_FrameBuffers)
+        { vkDestroyFramebuffer(pNativeDevice, itr.second, nullptr); }
+        m_FrameBuffers.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> locker(m_RenderPassMutex);
+        for(auto& itr : m_RenderPasses)
+        { vkDestroyRenderPass(pNativeDevice, itr.second, nullptr); }
+        m_RenderPasses.clear();
+    }
+
+    m_pDevice = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レンダーパスを取得します.
+//-------------------------------------------------------------------------------------------------
+VkRenderPass RenderPassCache::GetRenderPass(const RenderPassKey& key)
+{
+    std::lock_guard<std::mutex> locker(m_RenderPassMutex);
+
+    auto itr = m_RenderPasses.find(key);
+    if (itr != m_RenderPasses.end())
+    { return itr->second; }
+
+    VkRenderPass renderPass = null_handle;
+    if (!CreateNativeRenderPass(m_pDevice->GetVulkanDevice(), key, &renderPass))
+    { return null_handle; }
+
+    m_RenderPasses.insert(std::make_pair(key, renderPass));
+    return renderPass;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームバッファを取得します.
+//-------------------------------------------------------------------------------------------------
+VkFramebuffer RenderPassCache::GetFrameBuffer(const FrameBufferKey& key)
+{
+    std::lock_guard<std::mutex> locker(m_FrameBufferMutex);
+
+    auto itr = m_FrameBuffers.find(key);
+    if (itr != m_FrameBuffers.end())
+    { return itr->second; }
+
+    VkFramebufferCreateInfo info = {};
+    info.sType              = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    info.pNext              = nullptr;
+    info.flags              = 0;
+    info.renderPass         = key.RenderPass;
+    info.attachmentCount    = key.AttachmentCount;
+    info.pAttachments       = key.Attachments;
+    info.width              = key.Width;
+    info.height             = key.Height;
+    info.layers             = key.Layers;
+
+    VkFramebuffer frameBuffer = null_handle;
+    auto ret = vkCreateFramebuffer(m_pDevice->GetVulkanDevice(), &info, nullptr, &frameBuffer);
+    if ( ret != VK_SUCCESS )
+    { return null_handle; }
+
+    m_FrameBuffers.insert(std::make_pair(key, frameBuffer));
+    return frameBuffer;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定したイメージビューを参照するフレームバッファを破棄します.
+//-------------------------------------------------------------------------------------------------
+void RenderPassCache::EvictFrameBuffers(VkImageView view)
+{
+    if (view == null_handle)
+    { return; }
+
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    std::lock_guard<std::mutex> locker(m_FrameBufferMutex);
+
+    // ハンドル値が再利用されても古いフレームバッファに一致しないよう，ビューの破棄と同時に取り除く.
+    auto itr = m_FrameBuffers.begin();
+    while (itr != m_FrameBuffers.end())
+    {
+        auto found = false;
+        for(auto i=0u; i<itr->first.AttachmentCount; ++i)
+        {
+            if (itr->first.Attachments[i] == view)
+            {
+                found = true;
+                break;
+            }
+        }
+
+        if (found)
+        {
+            vkDestroyFramebuffer(pNativeDevice, itr->second, nullptr);
+            itr = m_FrameBuffers.erase(itr);
+        }
+        else
+        { ++itr; }
+    }
+}
+
+} // namespace a3d
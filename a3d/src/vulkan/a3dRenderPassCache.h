@@ -0,0 +1,187 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dRenderPassCache.h
+// Desc : Render Pass and Frame Buffer Object Cache.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+class Device;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RenderPassKey structure
+//! @brief      レンダーパスのキャッシュキーです.
+//! @note       バイト列として比較するため，使用しない要素も含めてゼロクリアしてから設定してください.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct RenderPassKey
+{
+    uint32_t                ColorCount;         //!< カラーターゲット数です.
+    VkFormat                ColorFormats[8];    //!< カラーターゲットのフォーマットです.
+    VkSampleCountFlagBits   ColorSamples[8];    //!< カラーターゲットのサンプル数です.
+    VkFormat                DepthFormat;        //!< 深度ターゲットのフォーマットです. 無い場合は VK_FORMAT_UNDEFINED です.
+    VkSampleCountFlagBits   DepthSamples;       //!< 深度ターゲットのサンプル数です.
+    VkAttachmentLoadOp      LoadOp;             //!< ロード操作です.
+    VkAttachmentStoreOp     StoreOp;            //!< ストア操作です.
+    VkAttachmentLoadOp      StencilLoadOp;      //!< ステンシルのロード操作です.
+    VkAttachmentStoreOp     StencilStoreOp;     //!< ステンシルのストア操作です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameBufferKey structure
+//! @brief      フレームバッファのキャッシュキーです.
+//! @note       バイト列として比較するため，使用しない要素も含めてゼロクリアしてから設定してください.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct FrameBufferKey
+{
+    VkImageView             Attachments[9];     //!< アタッチメントです. 深度ターゲットはカラーターゲットの後に続きます.
+    VkRenderPass            RenderPass;         //!< レンダーパスです.
+    uint32_t                AttachmentCount;    //!< アタッチメント数です.
+    uint32_t                Width;              //!< 横幅です.
+    uint32_t                Height;             //!< 縦幅です.
+    uint32_t                Layers;             //!< レイヤー数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RenderPassCache class
+//! @brief      デバイスが所有するレンダーパスとフレームバッファのキャッシュです.
+//! @note       同じ構成のフレームバッファとパイプラインステートで1つのレンダーパスを共有します.
+//!             キャッシュしたオブジェクトはデバイスの破棄まで保持されますが，
+//!             フレームバッファはアタッチメントのイメージビューが破棄された時点で取り除かれます.
+//!             スレッドセーフです.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class RenderPassCache : public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    RenderPassCache();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~RenderPassCache();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDevice         デバイスです.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //! @note       循環参照となるため, デバイスの参照カウントは増やしません.
+    //---------------------------------------------------------------------------------------------
+    bool Init(Device* pDevice);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レンダーパスを取得します.
+    //!
+    //! @param[in]      key             キャッシュキーです.
+    //! @return     レンダーパスを返却します. 生成に失敗した場合は null_handle を返却します.
+    //! @note       キャッシュに無い場合は生成します. 返却したレンダーパスは破棄しないでください.
+    //---------------------------------------------------------------------------------------------
+    VkRenderPass GetRenderPass(const RenderPassKey& key);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームバッファを取得します.
+    //!
+    //! @param[in]      key             キャッシュキーです.
+    //! @return     フレームバッファを返却します. 生成に失敗した場合は null_handle を返却します.
+    //! @note       キャッシュに無い場合は生成します. 返却したフレームバッファは破棄しないでください.
+    //---------------------------------------------------------------------------------------------
+    VkFramebuffer GetFrameBuffer(const FrameBufferKey& key);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定したイメージビューを参照するフレームバッファを破棄します.
+    //!
+    //! @param[in]      view            破棄されるイメージビューです.
+    //! @note       イメージビューを破棄する前に呼び出してください.
+    //---------------------------------------------------------------------------------------------
+    void EvictFrameBuffers(VkImageView view);
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // KeyHash structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    struct KeyHash
+    {
+        size_t operator()(const T& key) const
+        {
+            // FNV-1a.
+            auto pBytes = reinterpret_cast<const uint8_t*>(&key);
+            auto hash   = uint64_t(14695981039346656037ull);
+            for(auto i=0u; i<sizeof(T); ++i)
+            {
+                hash ^= pBytes[i];
+                hash *= uint64_t(1099511628211ull);
+            }
+            return size_t(hash);
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // KeyEqual structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    struct KeyEqual
+    {
+        bool operator()(const T& lhs, const T& rhs) const
+        { return memcmp(&lhs, &rhs, sizeof(T)) == 0; }
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    using RenderPassMap = std::unordered_map<
+        RenderPassKey,
+        VkRenderPass,
+        KeyHash<RenderPassKey>,
+        KeyEqual<RenderPassKey>,
+        StdAllocator<std::pair<const RenderPassKey, VkRenderPass>>>;
+
+    using FrameBufferMap = std::unordered_map<
+        FrameBufferKey,
+        VkFramebuffer,
+        KeyHash<FrameBufferKey>,
+        KeyEqual<FrameBufferKey>,
+        StdAllocator<std::pair<const FrameBufferKey, VkFramebuffer>>>;
+
+    Device*         m_pDevice;              //!< デバイスです.
+    std::mutex      m_RenderPassMutex;      //!< レンダーパス用ミューテックスです.
+    RenderPassMap   m_RenderPasses;         //!< キャッシュしたレンダーパスです.
+    std::mutex      m_FrameBufferMutex;     //!< フレームバッファ用ミューテックスです.
+    FrameBufferMap  m_FrameBuffers;         //!< キャッシュしたフレームバッファです.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+    RenderPassCache (const RenderPassCache&) = delete;
+    void operator = (const RenderPassCache&) = delete;
+};
+
+} // namespace a3d
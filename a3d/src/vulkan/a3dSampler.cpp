@@ -77,6 +77,7 @@ Sampler::Sampler()
 : m_RefCount(1)
 , m_pDevice (nullptr)
 , m_Sampler (null_handle)
+, m_DescriptorIndex(UINT32_MAX)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -123,6 +124,11 @@ bool Sampler::Init(IDevice* pDevice, const SamplerDesc* pDesc)
     if ( ret != VK_SUCCESS )
     { return false; }
 
+    // バインドレスディスクリプタヒープに登録.
+    auto pHeap = m_pDevice->GetBindlessHeap();
+    if (pHeap != nullptr)
+    { m_DescriptorIndex = pHeap->AllocSampler(m_Sampler); }
+
     return true;
 }
 
@@ -137,6 +143,12 @@ void Sampler::Term()
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT(pNativeDevice != null_handle);
 
+    if (m_DescriptorIndex != UINT32_MAX)
+    {
+        m_pDevice->GetBindlessHeap()->Free(BindlessHeap::HEAP_TYPE_SAMPLER, m_DescriptorIndex);
+        m_DescriptorIndex = UINT32_MAX;
+    }
+
     vkDestroySampler(pNativeDevice, m_Sampler, nullptr);
     m_Sampler = null_handle;
 
@@ -181,6 +193,12 @@ void Sampler::GetDevice(IDevice** ppDevice)
 VkSampler Sampler::GetVulkanSampler() const
 { return m_Sampler; }
 
+//-------------------------------------------------------------------------------------------------
+//      バインドレスディスクリプタヒープ上の番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t Sampler::GetDescriptorIndex() const
+{ return m_DescriptorIndex; }
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
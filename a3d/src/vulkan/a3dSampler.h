@@ -66,6 +66,13 @@ public:
     //---------------------------------------------------------------------------------------------
     VkSampler A3D_APIENTRY GetVulkanSampler() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バインドレスディスクリプタヒープ上の番号を取得します.
+    //!
+    //! @return     ヒープ上の番号を返却します. 登録されていない場合は UINT32_MAX を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetDescriptorIndex() const override;
+
 private:
     //=============================================================================================
     // private variables.
@@ -73,6 +80,7 @@ private:
     std::atomic<uint32_t>   m_RefCount;     //!< 参照カウンタです.
     Device*                 m_pDevice;      //!< デバイスです.
     VkSampler               m_Sampler;      //!< サンプラーです.
+    uint32_t                m_DescriptorIndex;  //!< バインドレスディスクリプタヒープ上の番号です.
 
     //=============================================================================================
     // private methods.
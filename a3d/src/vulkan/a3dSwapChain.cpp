@@ -33,7 +33,11 @@ SwapChain::SwapChain()
 , m_pBuffers            (nullptr)
 , m_pImages             (nullptr)
 , m_pImageViews         (nullptr)
+, m_CurrentBufferIndex  (0)
+, m_IsAcquired          (false)
+, m_IsOutOfDate         (false)
 , m_IsFullScreen        (false)
+, m_IsHeadless          (false)
 , m_SurfaceFormatCount  (0)
 , m_pSurfaceFormats     (nullptr)
 { memset( &m_Desc, 0, sizeof(m_Desc) ); }
@@ -62,8 +66,16 @@ bool SwapChain::Init(IDevice* pDevice, const SwapChainDesc* pDesc)
 
     memcpy( &m_Desc, pDesc, sizeof(m_Desc) );
 
-    #if A3D_IS_WIN
+    if (m_IsHeadless)
     {
+        // 表示先のウィンドウが無いので，ウィンドウ関連の設定は無視する.
+        m_Desc.InstanceHandle   = nullptr;
+        m_Desc.WindowHandle     = nullptr;
+        m_Desc.EnableFullScreen = false;
+    }
+    else
+    {
+    #if A3D_IS_WIN
         m_hInstance = static_cast<HINSTANCE>(pDesc->InstanceHandle);
         m_hWnd      = static_cast<HWND>(pDesc->WindowHandle);
 
@@ -76,22 +88,25 @@ bool SwapChain::Init(IDevice* pDevice, const SwapChainDesc* pDesc)
             m_Desc.Extent.Height = GetSystemMetrics(SM_CYSCREEN);
             SetFullScreenMode(pDesc->EnableFullScreen);
         }
-    }
     #elif A3D_IS_LINUX
-    { /* TODO : Implement. */ }
+        /* TODO : Implement. */
     #elif A3D_IS_ANDROID
-    { /* DO_NOTHING */ }
+        /* DO_NOTHING */
     #elif A3D_IS_NX
-    { /* DO_NOTHING */ }
+        /* DO_NOTHING */
     #elif A3D_IS_IOS
-    { /* DO_NOTHING */ }
+        /* DO_NOTHING */
     #elif A3D_IS_MAC
-    { /* TODO : Implementation */ }
+        /* TODO : Implementation */
     #elif A3D_IS_GGP
-    { /* TODO : Implementation */ }
+        /* TODO : Implementation */
     #endif
+    }
 
-    if (!InitSurface(&m_Surface))
+    auto isSurfaceCreated = (m_IsHeadless)
+        ? InitHeadlessSurface(&m_Surface)
+        : InitSurface(&m_Surface);
+    if (!isSurfaceCreated)
     { return false; }
 
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
@@ -162,7 +177,8 @@ bool SwapChain::Init(IDevice* pDevice, const SwapChainDesc* pDesc)
         else
         { m_PreTransform = capabilities.currentTransform; }
 
-        if (capabilities.maxImageCount < m_Desc.BufferCount)
+        // maxImageCount が 0 の場合は上限無し.
+        if (capabilities.maxImageCount != 0 && capabilities.maxImageCount < m_Desc.BufferCount)
         { return false; }
 
         if (capabilities.minImageCount > m_Desc.BufferCount)
@@ -394,26 +410,19 @@ bool SwapChain::Init(IDevice* pDevice, const SwapChainDesc* pDesc)
         SafeRelease(pCmdList);
     }
 
-    // バックバッファ取得.
-    {
-        auto index      = m_pQueue->GetCurrentBufferIndex();
-        auto semaphore  = m_pQueue->GetVulkanWaitSemaphore(index);
-        auto fence      = m_pQueue->GetVulkanFence(index);
-
-        auto ret = vkAcquireNextImage(
-            pNativeDevice,
-            m_SwapChain,
-            UINT64_MAX,
-            semaphore,
-            fence,
-            &m_CurrentBufferIndex);
-        if ( ret != VK_SUCCESS )
-        { return false; }
+    // 同時に処理中にできるフレーム数を設定.
+    // バッファ数を超えて先行させてもイメージの取得で待たされるだけなので, バッファ数以下に制限する.
+    if (m_Desc.MaxFrameLatency == 0)
+    { m_Desc.MaxFrameLatency = Queue::DefaultFrameCount; }
+    m_Desc.MaxFrameLatency = Min(m_Desc.MaxFrameLatency, Min(m_Desc.BufferCount, uint32_t(Queue::MaxFrameCount)));
 
-        // 待機.
-        vkWaitForFences(pNativeDevice, 1, &fence, VK_FALSE, UINT64_MAX);
-        vkResetFences(pNativeDevice, 1, &fence);
-    }
+    if (!m_pQueue->SetFrameCount(m_Desc.MaxFrameLatency))
+    { return false; }
+
+    // バックバッファ取得.
+    m_IsAcquired = false;
+    if (!AcquireNextImage(UINT64_MAX))
+    { return false; }
 
     return true;
 }
@@ -439,6 +448,9 @@ void SwapChain::Term()
         A3D_ASSERT(pNativeQueue != null_handle);
 
         vkQueueWaitIdle(pNativeQueue);
+
+        // 取得済みのイメージのセマフォが残らないよう同期オブジェクトを初期状態に戻す.
+        m_pQueue->ResetSyncObject();
     }
 
     if (m_pImageViews != nullptr)
@@ -546,47 +558,160 @@ SwapChainDesc SwapChain::GetDesc() const
 //-------------------------------------------------------------------------------------------------
 void SwapChain::Present()
 {
+    // 一度も取得していない場合は表示できるイメージが無い.
+    if (!AcquireNextImage(UINT64_MAX))
+    { return; }
+
+    // 描画の完了はGPU側でセマフォにより待機させ，CPUはここでは待たない.
+    auto semaphore = m_pQueue->PopPresentSemaphore();
+
     VkPresentInfoKHR info = {};
-    info.sType          = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-    info.pNext          = nullptr;
-    info.swapchainCount = 1;
-    info.pSwapchains    = &m_SwapChain;
-    info.pImageIndices  = &m_CurrentBufferIndex;
+    info.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    info.pNext              = nullptr;
+    info.waitSemaphoreCount = (semaphore != null_handle) ? 1 : 0;
+    info.pWaitSemaphores    = (semaphore != null_handle) ? &semaphore : nullptr;
+    info.swapchainCount     = 1;
+    info.pSwapchains        = &m_SwapChain;
+    info.pImageIndices      = &m_CurrentBufferIndex;
+
+    // セマフォの待機は結果に関わらず実行されるので, ここではスワップチェインの状態だけ確認する.
+    // 作り直しは次のイメージ取得まで遅延させる.
+    auto ret = vkQueuePresentKHR(m_pQueue->GetVulkanQueue(), &info);
+    if (ret == VK_ERROR_OUT_OF_DATE_KHR)
+    { m_IsOutOfDate = true; }
+    else if (ret == VK_SUBOPTIMAL_KHR)
+    {
+        // 変換の違いだけで毎フレーム作り直さないよう, サイズが変わった場合に限る.
+        VkExtent2D extent;
+        if (GetSurfaceExtent(&extent)
+        && (extent.width != m_Desc.Extent.Width || extent.height != m_Desc.Extent.Height))
+        { m_IsOutOfDate = true; }
+    }
 
-    auto pNativeDevice = m_pDevice->GetVulkanDevice();
-    A3D_ASSERT(pNativeDevice != null_handle);
+    // 次のイメージ取得は WaitForFrameSlot() または GetCurrentBufferIndex() まで遅延させる.
+    m_IsAcquired = false;
+    m_pQueue->AdvanceFrame();
+}
 
-    auto index      = m_pQueue->GetCurrentBufferIndex();
-    auto semaphore  = m_pQueue->GetVulkanWaitSemaphore(index);
+//-------------------------------------------------------------------------------------------------
+//      現在のバッファ番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t SwapChain::GetCurrentBufferIndex()
+{
+    AcquireNextImage(UINT64_MAX);
+    return m_CurrentBufferIndex;
+}
 
-    auto ret = vkQueuePresentKHR(m_pQueue->GetVulkanQueue(), &info);
-    if (ret != VK_SUCCESS)
-    { return; }
+//-------------------------------------------------------------------------------------------------
+//      CPUがGPUに先行できる最大フレーム数を設定します.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::SetMaxFrameLatency(uint32_t count)
+{
+    if (count == 0)
+    { return false; }
+
+    count = Min(count, Min(m_Desc.BufferCount, uint32_t(Queue::MaxFrameCount)));
+
+    if (!m_pQueue->SetFrameCount(count))
+    { return false; }
+
+    m_Desc.MaxFrameLatency = count;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      次のフレームを記録できるようになるまで待機します.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::WaitForFrameSlot(uint32_t timeoutMsec)
+{
+    auto timeout = (timeoutMsec == UINT32_MAX)
+        ? UINT64_MAX
+        : uint64_t(timeoutMsec) * 1000 * 1000;
+
+    return AcquireNextImage(timeout);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームスロットの空きを待ってから次のバックバッファを取得します.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::AcquireNextImage(uint64_t timeout)
+{
+    if (m_IsAcquired)
+    { return true; }
+
+    // 表示またはイメージ取得でサーフェイスと一致しなくなったと分かった場合は作り直す.
+    if (m_IsOutOfDate)
+    {
+        VkExtent2D extent = { m_Desc.Extent.Width, m_Desc.Extent.Height };
+        GetSurfaceExtent(&extent);
+
+        // 最小化中は作り直せないので, 元に戻るまで取得に失敗させる.
+        if (extent.width == 0 || extent.height == 0)
+        { return false; }
+
+        m_IsOutOfDate = false;
+
+        // ResizeBuffers() はイメージの取得まで行う.
+        if (!ResizeBuffers(extent.width, extent.height))
+        {
+            m_IsOutOfDate = true;
+            return false;
+        }
 
-    const uint64_t Infinite = 0xFFFFFFFF;
+        return m_IsAcquired;
+    }
 
-    auto fence = m_pQueue->GetVulkanFence(index);
-    A3D_ASSERT(fence != null_handle);
+    // スロットのセマフォを再利用するため，同じスロットを使った過去のフレームの完了を待つ.
+    if (!m_pQueue->WaitFrameSlot(timeout))
+    { return false; }
 
-    ret = vkAcquireNextImageKHR(
+    auto pNativeDevice = m_pDevice->GetVulkanDevice();
+    A3D_ASSERT(pNativeDevice != null_handle);
+
+    auto semaphore = m_pQueue->GetVulkanWaitSemaphore(m_pQueue->GetCurrentBufferIndex());
+    A3D_ASSERT(semaphore != null_handle);
+
+    // フェンスは使わず，取得完了はセマフォでGPU側に待機させる.
+    auto ret = vkAcquireNextImage(
         pNativeDevice,
         m_SwapChain,
-        Infinite,
+        timeout,
         semaphore,
-        fence,
+        null_handle,
         &m_CurrentBufferIndex);
-        A3D_ASSERT( ret == VK_SUCCESS );
+    if ( ret == VK_ERROR_OUT_OF_DATE_KHR )
+    {
+        m_IsOutOfDate = true;
+        return false;
+    }
+    if ( ret != VK_SUCCESS && ret != VK_SUBOPTIMAL_KHR )
+    { return false; }
 
-    // 取得待ち.
-    vkWaitForFences(pNativeDevice, 1, &fence, VK_FALSE, Infinite);
-    vkResetFences(pNativeDevice, 1, &fence);
+    m_pQueue->NotifyImageAcquired();
+    m_IsAcquired = true;
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//      現在のバッファ番号を取得します.
+//      サーフェイスの現在のサイズを取得します.
 //-------------------------------------------------------------------------------------------------
-uint32_t SwapChain::GetCurrentBufferIndex()
-{ return m_CurrentBufferIndex; }
+bool SwapChain::GetSurfaceExtent(VkExtent2D* pExtent) const
+{
+    auto pNativePhysicalDevice = m_pDevice->GetVulkanPhysicalDevice(0);
+    A3D_ASSERT(pNativePhysicalDevice != null_handle);
+
+    VkSurfaceCapabilitiesKHR capabilities;
+    auto ret = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(pNativePhysicalDevice, m_Surface, &capabilities);
+    if ( ret != VK_SUCCESS )
+    { return false; }
+
+    // サイズがスワップチェインで決まるサーフェイス.
+    if (capabilities.currentExtent.width == UINT32_MAX)
+    { return false; }
+
+    *pExtent = capabilities.currentExtent;
+    return true;
+}
 
 //-------------------------------------------------------------------------------------------------
 //      バッファを取得します.
@@ -637,7 +762,7 @@ bool SwapChain::ResizeBuffers(uint32_t width, uint32_t height)
         else
         { m_PreTransform = capabilities.currentTransform; }
 
-        if (capabilities.maxImageCount < m_Desc.BufferCount)
+        if (capabilities.maxImageCount != 0 && capabilities.maxImageCount < m_Desc.BufferCount)
         { return false; }
 
         if (capabilities.minImageCount > m_Desc.BufferCount)
@@ -856,29 +981,9 @@ bool SwapChain::ResizeBuffers(uint32_t width, uint32_t height)
     m_pQueue->ResetSyncObject();
 
     // バックバッファ取得.
-    {
-        auto index      = m_pQueue->GetCurrentBufferIndex();
-        auto semaphore  = m_pQueue->GetVulkanWaitSemaphore(index);
-        auto fence      = m_pQueue->GetVulkanFence(index);
-        A3D_ASSERT(semaphore != null_handle);
-        A3D_ASSERT(fence != null_handle);
-
-        uint64_t Infinite = 0xFFFFFFFF;
-
-        auto ret = vkAcquireNextImageKHR(
-            pNativeDevice,
-            m_SwapChain,
-            Infinite,
-            semaphore, 
-            fence,
-            &m_CurrentBufferIndex);
-        if ( ret != VK_SUCCESS )
-        { return false; }
-
-        // 取得できるまで待機.
-        vkWaitForFences(pNativeDevice, 1, &fence, VK_FALSE, Infinite);
-        vkResetFences(pNativeDevice, 1, &fence);
-    }
+    m_IsAcquired = false;
+    if (!AcquireNextImage(UINT64_MAX))
+    { return false; }
 
     return true;
 }
@@ -992,6 +1097,66 @@ bool SwapChain::Create
     return true;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      ヘッドレススワップチェインを生成します.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::CreateHeadless
+(
+    IDevice*                pDevice,
+    const SwapChainDesc*    pDesc,
+    ISwapChain**            ppSwapChain
+)
+{
+    if (pDevice == nullptr || pDesc == nullptr || ppSwapChain == nullptr)
+    { return false; }
+
+    if (!static_cast<Device*>(pDevice)->IsSupportHeadlessSurface())
+    { return false; }
+
+    auto instance = new SwapChain();
+    if (instance == nullptr)
+    { return false; }
+
+    instance->m_IsHeadless = true;
+
+    if (!instance->Init(pDevice, pDesc))
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
+    *ppSwapChain = instance;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ヘッドレスサーフェイスを作成します.
+//-------------------------------------------------------------------------------------------------
+bool SwapChain::InitHeadlessSurface(VkSurfaceKHR* pSurface)
+{
+#if defined(VK_EXT_headless_surface)
+    if (vkCreateHeadlessSurface == nullptr)
+    { return false; }
+
+    VkHeadlessSurfaceCreateInfoEXT info = {};
+    info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+    info.pNext = nullptr;
+    info.flags = 0;
+
+    auto pNativeInstance = m_pDevice->GetVulkanInstance();
+    A3D_ASSERT(pNativeInstance != null_handle);
+
+    auto ret = vkCreateHeadlessSurface(pNativeInstance, &info, nullptr, pSurface);
+    if (ret != VK_SUCCESS)
+    { return false; }
+
+    return true;
+#else
+    A3D_UNUSED(pSurface);
+    return false;
+#endif
+}
+
 #if A3D_IS_WIN
 //-------------------------------------------------------------------------------------------------
 //      Windows向けにサーフェイスを作成します.
@@ -1020,6 +1185,10 @@ bool SwapChain::InitSurface(VkSurfaceKHR* pSurface)
 //-------------------------------------------------------------------------------------------------
 bool SwapChain::SetFullScreenMode(bool enable)
 {
+    // ヘッドレスの場合は操作するウィンドウが無い.
+    if (m_IsHeadless)
+    { return false; }
+
     if (enable)
     {
         // ウィンドウサイズを保存しておく.
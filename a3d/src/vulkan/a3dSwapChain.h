@@ -14,10 +14,29 @@ namespace a3d {
 class Texture;
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// IPresentable interface
+//! @brief      Queue::Present() から表示処理を呼び出せるスワップチェインです.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct A3D_API IPresentable : public ISwapChain
+{
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    virtual A3D_APIENTRY ~IPresentable()
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      画面に表示します.
+    //---------------------------------------------------------------------------------------------
+    virtual void A3D_APIENTRY Present() = 0;
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // SwapChain class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-class A3D_API SwapChain : public ISwapChain, public BaseAllocator
+class A3D_API SwapChain : public IPresentable, public BaseAllocator
 {
     //=============================================================================================
     // list of friend classes and methods.
@@ -48,6 +67,20 @@ public:
         const SwapChainDesc*    pDesc,
         ISwapChain**            ppSwapChain);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      VK_EXT_headless_surface を用いたウィンドウを持たないスワップチェインを生成します.
+    //!
+    //! @param[in]      pDevice         デバイスです.
+    //! @param[in]      pDesc           構成設定です. ウィンドウ関連の設定は無視されます.
+    //! @param[out]     ppSwapChain     スワップチェインの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY CreateHeadless(
+        IDevice*                pDevice,
+        const SwapChainDesc*    pDesc,
+        ISwapChain**            ppSwapChain);
+
     //---------------------------------------------------------------------------------------------
     //! @brief      参照カウントを増やします.
     //---------------------------------------------------------------------------------------------
@@ -82,7 +115,7 @@ public:
     //---------------------------------------------------------------------------------------------
     //! @brief      画面に表示します.
     //---------------------------------------------------------------------------------------------
-    void A3D_APIENTRY Present();
+    void A3D_APIENTRY Present() override;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      現在のバッファ番号を取得します.
@@ -156,6 +189,24 @@ public:
     //---------------------------------------------------------------------------------------------
     bool A3D_APIENTRY SetFullScreenMode(bool enable) override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      CPUがGPUに先行できる最大フレーム数を設定します.
+    //!
+    //! @param[in]      count       最大フレーム数です(1 ～ Queue::MaxFrameCount).
+    //! @retval true    設定に成功.
+    //! @retval false   設定に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY SetMaxFrameLatency(uint32_t count) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      次のフレームを記録できるようになるまで待機します.
+    //!
+    //! @param[in]      timeoutMsec     タイムアウト時間です(ミリ秒単位).
+    //! @retval true    次のフレームのバックバッファを取得済みです.
+    //! @retval false   タイムアウトしました.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY WaitForFrameSlot(uint32_t timeoutMsec) override;
+
 private:
     //=============================================================================================
     // private variables.
@@ -170,11 +221,14 @@ private:
     VkImage*                        m_pImages;              //!< イメージです.
     VkImageView*                    m_pImageViews;          //!< イメージビューです.
     uint32_t                        m_CurrentBufferIndex;   //!< 現在のバッファ番号です.
+    bool                            m_IsAcquired;           //!< 現在のバッファを取得済みかどうか?
+    bool                            m_IsOutOfDate;          //!< 次の取得前に再生成が必要かどうか?
     VkPresentModeKHR                m_PresentMode;          //!< 表示モード.
     VkCompositeAlphaFlagBitsKHR     m_CompositeAlpha;       //!< コンポジットアルファ.
     VkFormat                        m_ImageFormat;          //!< イメージフォーマット.
     VkColorSpaceKHR                 m_ColorSpace;           //!< カラースペース.
     bool                            m_IsFullScreen;         //!< フルスクリーンかどうか?
+    bool                            m_IsHeadless;           //!< ヘッドレスサーフェイスを使うかどうか?
     VkSurfaceTransformFlagBitsKHR   m_PreTransform;         //!< サーフェイス変換フラグ.
     uint32_t                        m_SurfaceFormatCount;   //!< サーフェイスフォーマット数.
     VkSurfaceFormatKHR*             m_pSurfaceFormats;      //!< サーフェイスフォーマット.
@@ -228,6 +282,33 @@ private:
     //---------------------------------------------------------------------------------------------
     bool A3D_APIENTRY InitSurface(VkSurfaceKHR* pSurface);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ヘッドレスサーフェイスの初期化を行います.
+    //!
+    //! @param[in]      pSurface        初期化するサーフェイス.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY InitHeadlessSurface(VkSurfaceKHR* pSurface);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームスロットの空きを待ってから次のバックバッファを取得します.
+    //!
+    //! @param[in]      timeout     タイムアウト時間です(ナノ秒単位).
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY AcquireNextImage(uint64_t timeout);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      サーフェイスの現在のサイズを取得します.
+    //!
+    //! @param[out]     pExtent     サイズの格納先です.
+    //! @retval true    取得に成功.
+    //! @retval false   取得に失敗したか, サイズがスワップチェインで決まるサーフェイスです.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY GetSurfaceExtent(VkExtent2D* pExtent) const;
+
     SwapChain       (const SwapChain&) = delete;
     void operator = (const SwapChain&) = delete;
 };
@@ -205,6 +205,8 @@ Texture::Texture()
 , m_Image           (null_handle)
 , m_Allocation      (null_handle)
 , m_ImageAspectFlags(VK_IMAGE_ASPECT_COLOR_BIT)
+, m_IsExternal      (false)
+, m_pTrackedStates  (nullptr)
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
@@ -297,6 +299,19 @@ bool Texture::Init(IDevice* pDevice, const TextureDesc* pDesc)
 
     m_IsExternal = false;
 
+    // サブリソースごとのリソースステートを追跡する場合.
+    if (pDesc->Usage & RESOURCE_USAGE_STATE_TRACKING)
+    {
+        auto count = GetTrackedSubresourceCount();
+
+        m_pTrackedStates = new (std::nothrow) RESOURCE_STATE [count];
+        if (m_pTrackedStates == nullptr)
+        { return false; }
+
+        for(auto i=0u; i<count; ++i)
+        { m_pTrackedStates[i] = pDesc->InitState; }
+    }
+
     return true;
 }
 
@@ -326,6 +341,12 @@ void Texture::Term()
         m_Allocation = null_handle;
     }
 
+    if (m_pTrackedStates != nullptr)
+    {
+        delete [] m_pTrackedStates;
+        m_pTrackedStates = nullptr;
+    }
+
     memset( &m_Desc, 0, sizeof(m_Desc) );
 
     SafeRelease(m_pDevice);
@@ -471,6 +492,42 @@ VkImageAspectFlags Texture::GetVulkanImageAspectFlags() const
 RESOURCE_KIND Texture::GetKind() const
 { return RESOURCE_KIND_TEXTURE; }
 
+//-------------------------------------------------------------------------------------------------
+//      リソースステートを追跡するかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool Texture::IsTracked() const
+{ return m_pTrackedStates != nullptr; }
+
+//-------------------------------------------------------------------------------------------------
+//      追跡するサブリソース数を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t Texture::GetTrackedSubresourceCount() const
+{
+    // 3Dテクスチャは奥行きをまとめて1つの配列要素として扱う.
+    auto arraySize = (m_Desc.Dimension != RESOURCE_DIMENSION_TEXTURE3D) ? m_Desc.DepthOrArraySize : 1;
+    return arraySize * m_Desc.MipLevels;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      追跡中のリソースステートを取得します.
+//-------------------------------------------------------------------------------------------------
+RESOURCE_STATE Texture::GetTrackedState(uint32_t index) const
+{
+    A3D_ASSERT(m_pTrackedStates != nullptr);
+    A3D_ASSERT(index < GetTrackedSubresourceCount());
+    return m_pTrackedStates[index];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      追跡中のリソースステートを設定します.
+//-------------------------------------------------------------------------------------------------
+void Texture::SetTrackedState(uint32_t index, RESOURCE_STATE state)
+{
+    A3D_ASSERT(m_pTrackedStates != nullptr);
+    A3D_ASSERT(index < GetTrackedSubresourceCount());
+    m_pTrackedStates[index] = state;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
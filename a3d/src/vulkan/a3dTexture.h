@@ -132,6 +132,37 @@ public:
     //---------------------------------------------------------------------------------------------
     RESOURCE_KIND A3D_APIENTRY GetKind() const override;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      リソースステートを追跡するかどうかチェックします.
+    //!
+    //! @retval true    追跡します.
+    //! @retval false   追跡しません.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY IsTracked() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡するサブリソース数を取得します.
+    //!
+    //! @return     追跡するサブリソース数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetTrackedSubresourceCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡中のリソースステートを取得します.
+    //!
+    //! @param[in]      index       サブリソース番号(配列番号 * ミップレベル数 + ミップレベル)です.
+    //! @return     リソースステートを返却します.
+    //---------------------------------------------------------------------------------------------
+    RESOURCE_STATE A3D_APIENTRY GetTrackedState(uint32_t index) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      追跡中のリソースステートを設定します.
+    //!
+    //! @param[in]      index       サブリソース番号(配列番号 * ミップレベル数 + ミップレベル)です.
+    //! @param[in]      state       リソースステートです.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY SetTrackedState(uint32_t index, RESOURCE_STATE state);
+
 private:
     //=============================================================================================
     // private variables.
@@ -143,6 +174,7 @@ private:
     VkImageAspectFlags      m_ImageAspectFlags;     //!< イメージアスペクトフラグです.
     bool                    m_IsExternal;           //!< 外部リソースかどうか
     VmaAllocation           m_Allocation;           //!< アロケート情報.
+    RESOURCE_STATE*         m_pTrackedStates;       //!< サブリソースごとのリソースステートです.
 
     //=============================================================================================
     // private methods.
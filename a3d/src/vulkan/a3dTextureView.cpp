@@ -20,6 +20,7 @@ TextureView::TextureView()
 , m_pTexture        (nullptr)
 , m_ImageView       (null_handle)
 , m_ImageAspectFlags(VK_IMAGE_ASPECT_COLOR_BIT)
+, m_DescriptorIndex (UINT32_MAX)
 { memset( &m_Desc, 0, sizeof(m_Desc) ); }
 
 //-------------------------------------------------------------------------------------------------
@@ -90,6 +91,17 @@ bool TextureView::Init(IDevice* pDevice, ITexture* pTexture, const TextureViewDe
         { return false; }
     }
 
+    // バインドレスディスクリプタヒープに登録.
+    auto pHeap = m_pDevice->GetBindlessHeap();
+    if (pHeap != nullptr && (m_pTexture->GetDesc().Usage & RESOURCE_USAGE_SHADER_RESOURCE))
+    {
+        auto layout = (m_ImageAspectFlags == VK_IMAGE_ASPECT_COLOR_BIT)
+            ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+        m_DescriptorIndex = pHeap->AllocTexture(m_ImageView, layout);
+    }
+
     return true;
 }
 
@@ -104,8 +116,19 @@ void TextureView::Term()
     auto pNativeDevice = m_pDevice->GetVulkanDevice();
     A3D_ASSERT( pNativeDevice != null_handle );
 
+    if ( m_DescriptorIndex != UINT32_MAX )
+    {
+        m_pDevice->GetBindlessHeap()->Free(BindlessHeap::HEAP_TYPE_TEXTURE, m_DescriptorIndex);
+        m_DescriptorIndex = UINT32_MAX;
+    }
+
     if ( m_ImageView != null_handle )
     {
+        // キャッシュされたフレームバッファが破棄済みのビューを参照しないようにする.
+        auto pCache = m_pDevice->GetRenderPassCache();
+        if (pCache != nullptr)
+        { pCache->EvictFrameBuffers(m_ImageView); }
+
         vkDestroyImageView( pNativeDevice, m_ImageView, nullptr );
         m_ImageView = null_handle;
     }
@@ -195,6 +218,12 @@ VkImageAspectFlags TextureView::GetVulkanImageAspectFlags() const
 ITexture* TextureView::GetResource() const
 { return m_pTexture; }
 
+//-------------------------------------------------------------------------------------------------
+//      バインドレスディスクリプタヒープ上の番号を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t TextureView::GetDescriptorIndex() const
+{ return m_DescriptorIndex; }
+
 //-------------------------------------------------------------------------------------------------
 //      生成処理を行います.
 //-------------------------------------------------------------------------------------------------
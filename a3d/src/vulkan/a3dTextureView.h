@@ -103,6 +103,13 @@ public:
     //---------------------------------------------------------------------------------------------
     VkImageAspectFlags A3D_APIENTRY GetVulkanImageAspectFlags() const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バインドレスディスクリプタヒープ上の番号を取得します.
+    //!
+    //! @return     ヒープ上の番号を返却します. 登録されていない場合は UINT32_MAX を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetDescriptorIndex() const override;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      リソースを取得します.
     //!
@@ -120,6 +127,7 @@ private:
     Texture*                m_pTexture;             //!< テクスチャです.
     VkImageView             m_ImageView;            //!< イメージビューです.
     VkImageAspectFlags      m_ImageAspectFlags;     //!< アスペクトフラグです.
+    uint32_t                m_DescriptorIndex;      //!< バインドレスディスクリプタヒープ上の番号です.
 
     //=============================================================================================
     // private methods.
@@ -0,0 +1,313 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dUploadRing.cpp
+// Desc : Upload Ring Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// UploadRing class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+UploadRing::UploadRing()
+: m_RefCount    (1)
+, m_pDevice     (nullptr)
+, m_pBuffer     (nullptr)
+, m_pMappedPtr  (nullptr)
+, m_Alignment   (1)
+, m_pFrames     (nullptr)
+, m_FrameHead   (0)
+, m_FrameCount  (0)
+{ memset(&m_Desc, 0, sizeof(m_Desc)); }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+UploadRing::~UploadRing()
+{ Term(); }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool UploadRing::Init(IDevice* pDevice, const UploadRingDesc* pDesc)
+{
+    if (pDevice == nullptr || pDesc == nullptr)
+    { return false; }
+
+    if (pDesc->Size == 0 || pDesc->MaxFrameCount == 0)
+    { return false; }
+
+    // 回収判定は IFence::GetCompletedValue() に依存するため，タイムラインセマフォが必須.
+    // 非対応だと常に 0 が返り，GPUが参照中の領域を再利用してしまう.
+#if defined(VK_KHR_timeline_semaphore)
+    if (!static_cast<Device*>(pDevice)->IsSupportExtension(Device::EXT_KHR_TIMELINE_SEMAPHORE))
+    { return false; }
+#else
+    return false;
+#endif
+
+    m_pDevice = static_cast<Device*>(pDevice);
+    m_pDevice->AddRef();
+
+    memcpy(&m_Desc, pDesc, sizeof(m_Desc));
+
+    if (m_Desc.Usage == 0)
+    { m_Desc.Usage = RESOURCE_USAGE_CONSTANT_BUFFER; }
+
+    m_Alignment = m_pDevice->GetInfo().ConstantBufferMemoryAlignment;
+    if (m_Alignment == 0)
+    { m_Alignment = 1; }
+
+    // バッファを生成します.
+    {
+        BufferDesc desc = {};
+        desc.Size       = pDesc->Size;
+        desc.Stride     = 0;
+        desc.Usage      = m_Desc.Usage;
+        desc.InitState  = RESOURCE_STATE_GENERAL;
+        desc.HeapType   = HEAP_TYPE_UPLOAD;
+
+        if (!m_pDevice->CreateBuffer(&desc, &m_pBuffer))
+        { return false; }
+    }
+
+    // 割り当てのたびにマップしなくて済むよう，破棄するまでマップしたままにする.
+    m_pMappedPtr = static_cast<uint8_t*>(m_pBuffer->Map());
+    if (m_pMappedPtr == nullptr)
+    { return false; }
+
+    if (!m_Ring.Init(size_t(m_Desc.Size), 0, m_Desc.MaxFrameCount))
+    { return false; }
+
+    m_pFrames = new (std::nothrow) FrameEntry [m_Desc.MaxFrameCount];
+    if (m_pFrames == nullptr)
+    { return false; }
+
+    for(auto i=0u; i<m_Desc.MaxFrameCount; ++i)
+    {
+        m_pFrames[i].pFence = nullptr;
+        m_pFrames[i].Value  = 0;
+    }
+
+    m_FrameHead  = 0;
+    m_FrameCount = 0;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      終了処理を行います.
+//-------------------------------------------------------------------------------------------------
+void UploadRing::Term()
+{
+    if (m_pDevice == nullptr)
+    { return; }
+
+    if (m_pFrames != nullptr)
+    {
+        // GPUが参照している可能性があるので完了を待ってから破棄する.
+        while (m_FrameCount > 0)
+        {
+            auto& frame = m_pFrames[m_FrameHead];
+            frame.pFence->Wait(frame.Value, UINT32_MAX);
+            PopFrame();
+        }
+
+        delete [] m_pFrames;
+        m_pFrames = nullptr;
+    }
+
+    m_Ring.Term();
+
+    if (m_pMappedPtr != nullptr)
+    {
+        m_pBuffer->Unmap();
+        m_pMappedPtr = nullptr;
+    }
+
+    SafeRelease(m_pBuffer);
+    SafeRelease(m_pDevice);
+    memset( &m_Desc, 0, sizeof(m_Desc) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      参照カウントを増やします.
+//-------------------------------------------------------------------------------------------------
+void UploadRing::AddRef()
+{ m_RefCount++; }
+
+//-------------------------------------------------------------------------------------------------
+//      解放処理を行います.
+//-------------------------------------------------------------------------------------------------
+void UploadRing::Release()
+{
+    m_RefCount--;
+    if (m_RefCount == 0)
+    { delete this; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      参照カウントを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t UploadRing::GetCount() const
+{ return m_RefCount; }
+
+//-------------------------------------------------------------------------------------------------
+//      デバイスを取得します.
+//-------------------------------------------------------------------------------------------------
+void UploadRing::GetDevice(IDevice** ppDevice)
+{
+    *ppDevice = m_pDevice;
+    if (m_pDevice != nullptr)
+    { m_pDevice->AddRef(); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      構成設定を取得します.
+//-------------------------------------------------------------------------------------------------
+UploadRingDesc UploadRing::GetDesc() const
+{ return m_Desc; }
+
+//-------------------------------------------------------------------------------------------------
+//      割り当て元のバッファを取得します.
+//-------------------------------------------------------------------------------------------------
+void UploadRing::GetBuffer(IBuffer** ppBuffer)
+{
+    *ppBuffer = m_pBuffer;
+    if (m_pBuffer != nullptr)
+    { m_pBuffer->AddRef(); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      領域を割り当てます.
+//-------------------------------------------------------------------------------------------------
+bool UploadRing::Allocate(uint64_t size, UploadAllocation* pResult)
+{
+    if (size == 0 || pResult == nullptr)
+    { return false; }
+
+    // 先頭位置は常にアライメント済みなので，サイズを揃えておけば次の割り当てもそのまま使える.
+    auto alignedSize = (size + m_Alignment - 1) / m_Alignment * m_Alignment;
+    if (alignedSize > m_Desc.Size)
+    { return false; }
+
+    for(auto retry=0; retry<2; ++retry)
+    {
+        auto block = m_Ring.Alloc(size_t(alignedSize), size_t(m_Alignment));
+        if (block.Size != 0)
+        {
+            auto offset = uint64_t(block.Offset);
+
+            pResult->pCpuAddress = m_pMappedPtr + offset;
+            pResult->pBuffer     = m_pBuffer;
+            pResult->Offset      = offset;
+            pResult->Size        = alignedSize;
+            return true;
+        }
+
+        // 空きが無い場合のみ完了済みフレームの回収を試みる.
+        if (retry == 0)
+        { Retire(); }
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      フレームを終了し，割り当てた領域をフェンスに関連付けます.
+//-------------------------------------------------------------------------------------------------
+void UploadRing::EndFrame(IFence* pFence, uint64_t value)
+{
+    if (pFence == nullptr)
+    { return; }
+
+    A3D_ASSERT(static_cast<Fence*>(pFence)->GetVulkanTimelineSemaphore() != null_handle);
+
+    Retire();
+
+    // 処理中のフレームが多すぎる場合は最も古いフレームの完了を待つ.
+    if (m_FrameCount >= m_Desc.MaxFrameCount)
+    {
+        auto& oldest = m_pFrames[m_FrameHead];
+        oldest.pFence->Wait(oldest.Value, UINT32_MAX);
+        PopFrame();
+    }
+
+    auto index = (m_FrameHead + m_FrameCount) % m_Desc.MaxFrameCount;
+
+    auto& frame = m_pFrames[index];
+    frame.pFence = pFence;
+    frame.pFence->AddRef();
+    frame.Value  = value;
+
+    m_Ring.EndFrame(value);
+    m_FrameCount++;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      完了済みのフレームが使用していた領域を回収します.
+//-------------------------------------------------------------------------------------------------
+void UploadRing::Retire()
+{
+    while (m_FrameCount > 0)
+    {
+        auto& frame = m_pFrames[m_FrameHead];
+        if (frame.pFence->GetCompletedValue() < frame.Value)
+        { break; }
+
+        PopFrame();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最も古いフレームが使用していた領域を回収します.
+//-------------------------------------------------------------------------------------------------
+void UploadRing::PopFrame()
+{
+    A3D_ASSERT(m_FrameCount > 0);
+
+    auto& frame = m_pFrames[m_FrameHead];
+
+    // フェンスはフレーム毎に異なる可能性があるので, 完了判定はこちらで行いリングの回収だけ委ねる.
+    m_Ring.PopFrame();
+
+    SafeRelease(frame.pFence);
+    frame.Value = 0;
+
+    m_FrameHead = (m_FrameHead + 1) % m_Desc.MaxFrameCount;
+    m_FrameCount--;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      生成処理を行います.
+//-------------------------------------------------------------------------------------------------
+bool UploadRing::Create
+(
+    IDevice*                pDevice,
+    const UploadRingDesc*   pDesc,
+    IUploadRing**           ppUploadRing
+)
+{
+    if (pDevice == nullptr || pDesc == nullptr || ppUploadRing == nullptr)
+    { return false; }
+
+    auto instance = new UploadRing;
+    if (instance == nullptr)
+    { return false; }
+
+    if (!instance->Init(pDevice, pDesc))
+    {
+        SafeRelease(instance);
+        return false;
+    }
+
+    *ppUploadRing = instance;
+    return true;
+}
+
+} // namespace a3d
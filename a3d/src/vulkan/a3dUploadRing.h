@@ -0,0 +1,168 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dUploadRing.h
+// Desc : Upload Ring Implementation.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+
+namespace a3d {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// UploadRing class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class A3D_API UploadRing : public IUploadRing, public BaseAllocator
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      生成処理を行います.
+    //!
+    //! @param[in]      pDevice         デバイスです.
+    //! @param[in]      pDesc           構成設定です.
+    //! @param[out]     ppUploadRing    アップロードリングの格納先です.
+    //! @retval true    生成に成功.
+    //! @retval false   生成に失敗.
+    //---------------------------------------------------------------------------------------------
+    static bool A3D_APIENTRY Create(
+        IDevice*                pDevice,
+        const UploadRingDesc*   pDesc,
+        IUploadRing**           ppUploadRing);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      参照カウントを増やします.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY AddRef() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      解放処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Release() override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      参照カウントを取得します.
+    //!
+    //! @return     参照カウントを返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t A3D_APIENTRY GetCount() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デバイスを取得します.
+    //!
+    //! @param[out]     ppDevice        デバイスの格納先です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY GetDevice(IDevice** ppDevice) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      構成設定を取得します.
+    //!
+    //! @return     構成設定を返却します.
+    //---------------------------------------------------------------------------------------------
+    UploadRingDesc A3D_APIENTRY GetDesc() const override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      割り当て元のバッファを取得します.
+    //!
+    //! @param[out]     ppBuffer        バッファの格納先です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY GetBuffer(IBuffer** ppBuffer) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      領域を割り当てます.
+    //!
+    //! @param[in]      size            割り当てサイズです(バイト単位).
+    //! @param[out]     pResult         割り当て結果の格納先です.
+    //! @retval true    割り当てに成功.
+    //! @retval false   空き領域が不足しています.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Allocate(uint64_t size, UploadAllocation* pResult) override;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      フレームを終了し，割り当てた領域をフェンスに関連付けます.
+    //!
+    //! @param[in]      pFence          フレームの完了を通知するフェンスです.
+    //! @param[in]      value           フレーム完了時のタイムライン値です.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY EndFrame(IFence* pFence, uint64_t value) override;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // FrameEntry structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct FrameEntry
+    {
+        IFence*         pFence;         //!< フレームの完了を通知するフェンスです.
+        uint64_t        Value;          //!< フレーム完了時のタイムライン値です.
+    };
+
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    std::atomic<uint32_t>   m_RefCount;         //!< 参照カウンタです.
+    Device*                 m_pDevice;          //!< デバイスです.
+    UploadRingDesc          m_Desc;             //!< 構成設定です.
+    IBuffer*                m_pBuffer;          //!< バッファです.
+    uint8_t*                m_pMappedPtr;       //!< マップ済みポインタです.
+    uint64_t                m_Alignment;        //!< アライメントです.
+    RingAllocator           m_Ring;             //!< 領域の割り当てを管理するリングアロケータです.
+    FrameEntry*             m_pFrames;          //!< GPUで処理中のフレームです.
+    uint32_t                m_FrameHead;        //!< 最も古いフレームの位置です.
+    uint32_t                m_FrameCount;       //!< GPUで処理中のフレーム数です.
+
+    //=============================================================================================
+    // private methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    A3D_APIENTRY UploadRing();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    A3D_APIENTRY ~UploadRing();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pDevice     デバイスです.
+    //! @param[in]      pDesc       構成設定です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //---------------------------------------------------------------------------------------------
+    bool A3D_APIENTRY Init(IDevice* pDevice, const UploadRingDesc* pDesc);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Term();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      完了済みのフレームが使用していた領域を回収します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY Retire();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      最も古いフレームが使用していた領域を回収します.
+    //---------------------------------------------------------------------------------------------
+    void A3D_APIENTRY PopFrame();
+
+    UploadRing      (const UploadRing&) = delete;
+    void operator = (const UploadRing&) = delete;
+};
+
+} // namespace a3d
@@ -306,6 +306,8 @@ VkDescriptorType ToNativeDescriptorType(DESCRIPTOR_TYPE type)
         VK_DESCRIPTOR_TYPE_SAMPLER,
         VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
         VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
     };
 
     return table[type];
@@ -570,6 +572,72 @@ VkAccessFlags ToNativeAccessFlags(a3d::RESOURCE_STATE state)
     return result;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      パイプラインステージフラグに変換します.
+//-------------------------------------------------------------------------------------------------
+VkPipelineStageFlags ToNativePipelineStageFlags(a3d::RESOURCE_STATE state)
+{
+    // デバイスで有効化されていないステージは, コマンドリスト側でキューの対応ステージと合わせて除外する.
+    const VkPipelineStageFlags ShaderStages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT
+                                            | VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT
+                                            | VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT
+                                            | VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT
+                                        #if defined(VK_NV_mesh_shader)
+                                            | VK_PIPELINE_STAGE_TASK_SHADER_BIT_NV
+                                            | VK_PIPELINE_STAGE_MESH_SHADER_BIT_NV
+                                        #endif
+                                            | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                                            | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    VkPipelineStageFlags result = 0;
+    switch( state )
+    {
+    case a3d::RESOURCE_STATE_UNKNOWN:
+    case a3d::RESOURCE_STATE_PRESENT:
+        { result = 0; }
+        break;
+
+    case a3d::RESOURCE_STATE_VERTEX_BUFFER:
+    case a3d::RESOURCE_STATE_INDEX_BUFFER:
+        { result = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT; }
+        break;
+
+    case a3d::RESOURCE_STATE_CONSTANT_BUFFER:
+    case a3d::RESOURCE_STATE_UNORDERED_ACCESS:
+    case a3d::RESOURCE_STATE_SHADER_READ:
+        { result = ShaderStages; }
+        break;
+
+    case a3d::RESOURCE_STATE_COLOR_WRITE:
+    case a3d::RESOURCE_STATE_COLOR_READ:
+        { result = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT; }
+        break;
+
+    case a3d::RESOURCE_STATE_DEPTH_WRITE:
+    case a3d::RESOURCE_STATE_DEPTH_READ:
+        { result = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT; }
+        break;
+
+    case a3d::RESOURCE_STATE_INDIRECT_ARGUMENT:
+        { result = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT; }
+        break;
+
+    case a3d::RESOURCE_STATE_COPY_DST:
+    case a3d::RESOURCE_STATE_COPY_SRC:
+    case a3d::RESOURCE_STATE_RESOLVE_DST:
+    case a3d::RESOURCE_STATE_RESOLVE_SRC:
+        { result = VK_PIPELINE_STAGE_TRANSFER_BIT; }
+        break;
+
+    case a3d::RESOURCE_STATE_GENERAL:
+    case a3d::RESOURCE_STATE_STREAM_OUT:
+    case a3d::RESOURCE_STATE_PREDICATION:
+        { result = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT; }
+        break;
+    }
+    return result;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      サブリソースを計算します.
 //-------------------------------------------------------------------------------------------------
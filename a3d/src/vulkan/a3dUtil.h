@@ -103,6 +103,15 @@ void SetImageLayout(
 //-------------------------------------------------------------------------------------------------
 VkAccessFlags ToNativeAccessFlags(RESOURCE_STATE state);
 
+//-------------------------------------------------------------------------------------------------
+//! @brief      ネイティブパイプラインステージフラグに変換します.
+//!
+//! @param[in]      state       リソースステートです.
+//! @return     リソースにアクセスするパイプラインステージを返却します.
+//!             UNKNOWN と PRESENT はパイプライン内でアクセスされないため 0 を返却します.
+//-------------------------------------------------------------------------------------------------
+VkPipelineStageFlags ToNativePipelineStageFlags(RESOURCE_STATE state);
+
 //-------------------------------------------------------------------------------------------------
 //! @brief      イメージビュータイプに変換します.
 //-------------------------------------------------------------------------------------------------
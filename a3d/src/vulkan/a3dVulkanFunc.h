@@ -17,6 +17,10 @@ extern PFN_vkGetPhysicalDevicePresentRectanglesKHR  vkGetPhysicalDevicePresentRe
 extern PFN_vkAcquireNextImage2KHR                   vkAcquireNextImage2;
 #endif
 
+#if defined(VK_EXT_headless_surface)
+extern PFN_vkCreateHeadlessSurfaceEXT       vkCreateHeadlessSurface;
+#endif
+
 #if defined(VK_EXT_debug_marker)
 extern PFN_vkDebugMarkerSetObjectTagEXT     vkDebugMarkerSetObjectTag;
 extern PFN_vkDebugMarkerSetObjectNameEXT    vkDebugMarkerSetObjectName;
@@ -29,6 +33,16 @@ extern PFN_vkCmdDebugMarkerInsertEXT        vkCmdDebugMarkerInsert;
 extern PFN_vkCmdPushDescriptorSetKHR        vkCmdPushDescriptorSet;
 #endif
 
+#if defined(VK_KHR_descriptor_update_template)
+extern PFN_vkCreateDescriptorUpdateTemplateKHR      a3d_vkCreateDescriptorUpdateTemplate;
+extern PFN_vkDestroyDescriptorUpdateTemplateKHR     a3d_vkDestroyDescriptorUpdateTemplate;
+extern PFN_vkUpdateDescriptorSetWithTemplateKHR     a3d_vkUpdateDescriptorSetWithTemplate;
+#endif
+
+#if defined(VK_KHR_push_descriptor) && defined(VK_KHR_descriptor_update_template)
+extern PFN_vkCmdPushDescriptorSetWithTemplateKHR    a3d_vkCmdPushDescriptorSetWithTemplate;
+#endif
+
 #if defined(VK_EXT_hdr_metadata)
 extern PFN_vkSetHdrMetadataEXT              vkSetHdrMetadata;
 #endif
@@ -37,4 +51,10 @@ extern PFN_vkSetHdrMetadataEXT              vkSetHdrMetadata;
 extern PFN_vkCmdDrawMeshTasksNV                 vkCmdDrawMeshTasks;
 extern PFN_vkCmdDrawMeshTasksIndirectNV         vkCmdDrawMeshTasksIndirect;
 extern PFN_vkCmdDrawMeshTasksIndirectCountNV    vkCmdDrawMeshTasksIndirectCount;
+#endif
+
+#if defined(VK_KHR_timeline_semaphore)
+extern PFN_vkGetSemaphoreCounterValueKHR    a3d_vkGetSemaphoreCounterValue;
+extern PFN_vkWaitSemaphoresKHR              a3d_vkWaitSemaphores;
+extern PFN_vkSignalSemaphoreKHR             a3d_vkSignalSemaphore;
 #endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : a3dBlockAllocatorTest.cpp
+// Desc : BlockAllocator Test.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+#define A3D_ASSERT(expression)  assert(expression)
+#include "allocator/a3dBlockAllocator.h"
+
+
+//-------------------------------------------------------------------------------------------------
+//      メモリを確保します.
+//-------------------------------------------------------------------------------------------------
+void* a3d_alloc(size_t size, size_t alignment)
+{
+    (void)alignment;
+    return malloc(size);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      メモリを解放します.
+//-------------------------------------------------------------------------------------------------
+void a3d_free(void* ptr)
+{ free(ptr); }
+
+
+namespace {
+
+//-------------------------------------------------------------------------------------------------
+// Global Variables.
+//-------------------------------------------------------------------------------------------------
+int g_FailCount = 0;
+
+//-------------------------------------------------------------------------------------------------
+//      条件をチェックします.
+//-------------------------------------------------------------------------------------------------
+#define CHECK(expression)                                                   \
+    do {                                                                    \
+        if (!(expression)) {                                                \
+            fprintf(stderr, "%s(%d): CHECK(%s) failed.\n",                  \
+                    __FILE__, __LINE__, #expression);                       \
+            g_FailCount++;                                                  \
+        }                                                                   \
+    } while(0)
+
+//-------------------------------------------------------------------------------------------------
+//      全体と同じサイズを整列済みの先頭から確保できるかテストします.
+//-------------------------------------------------------------------------------------------------
+void TestExactFitWhole()
+{
+    a3d::BlockAllocator allocator;
+    CHECK(allocator.Init(65536, 0));
+    CHECK(allocator.CanAlloc(65536, 256));
+
+    auto block = allocator.Alloc(65536, 256);
+    CHECK(block.Size   == 65536);
+    CHECK(block.Offset == 0);
+    CHECK(!allocator.CanAlloc(1, 1));
+
+    allocator.Free(block);
+    CHECK(allocator.IsEmpty());
+    CHECK(allocator.GetStatistics().LargestFreeBlock == 65536);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アライメントと同じサイズのブロックで領域を使い切れるかテストします.
+//-------------------------------------------------------------------------------------------------
+void TestExactFitFill()
+{
+    a3d::BlockAllocator allocator;
+    CHECK(allocator.Init(1024, 0));
+
+    a3d::Block blocks[4];
+    for(auto i=0; i<4; ++i)
+    {
+        blocks[i] = allocator.Alloc(256, 256);
+        CHECK(blocks[i].Size   == 256);
+        CHECK(blocks[i].Offset == ptrdiff_t(i * 256));
+    }
+
+    CHECK(allocator.Alloc(256, 256).Size == 0);
+
+    for(auto i=0; i<4; ++i)
+    { allocator.Free(blocks[i]); }
+
+    auto stats = allocator.GetStatistics();
+    CHECK(stats.AllocationCount  == 0);
+    CHECK(stats.FreeBlockCount   == 1);
+    CHECK(stats.LargestFreeBlock == 1024);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パディング込みでは収まらないが実際には収まるサイズを確保できるかテストします.
+//-------------------------------------------------------------------------------------------------
+void TestExactFitNearlyWhole()
+{
+    const size_t N = 4096;
+
+    a3d::BlockAllocator allocator;
+    CHECK(allocator.Init(N, 0));
+
+    auto block = allocator.Alloc(N - 8, 16);
+    CHECK(block.Size   == N - 8);
+    CHECK(block.Offset == 0);
+
+    // 後方の余りは整列できないので確保できない.
+    CHECK(allocator.Alloc(8, 16).Size == 0);
+
+    auto tail = allocator.Alloc(8, 8);
+    CHECK(tail.Size   == 8);
+    CHECK(tail.Offset == ptrdiff_t(N - 8));
+
+    allocator.Free(block);
+    allocator.Free(tail);
+    CHECK(allocator.IsEmpty());
+}
+
+//-------------------------------------------------------------------------------------------------
+//      先頭オフセットを考慮してアライメントされるかテストします.
+//-------------------------------------------------------------------------------------------------
+void TestOffsetAlignment()
+{
+    a3d::BlockAllocator allocator;
+    CHECK(allocator.Init(1024, 128));
+
+    // 先頭オフセットが 256 に揃っていないので, 全体は確保できない.
+    CHECK(allocator.Alloc(1024, 256).Size == 0);
+
+    auto block = allocator.Alloc(896, 256);
+    CHECK(block.Size   == 896);
+    CHECK(block.Offset == 256);
+
+    auto front = allocator.Alloc(128, 128);
+    CHECK(front.Size   == 128);
+    CHECK(front.Offset == 128);
+
+    allocator.Free(front);
+    allocator.Free(block);
+    CHECK(allocator.GetStatistics().FreeBlockCount == 1);
+}
+
+} // namespace
+
+
+//-------------------------------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-------------------------------------------------------------------------------------------------
+int main()
+{
+    TestExactFitWhole();
+    TestExactFitFill();
+    TestExactFitNearlyWhole();
+    TestOffsetAlignment();
+
+    if (g_FailCount > 0)
+    {
+        fprintf(stderr, "%d check(s) failed.\n", g_FailCount);
+        return EXIT_FAILURE;
+    }
+
+    printf("All tests passed.\n");
+    return EXIT_SUCCESS;
+}